@@ -0,0 +1,9 @@
+#define BIL_PROGNAME  "Bil, a modeling platform based on FEM/FVM"
+#define BIL_COPYRIGHT "Copyright (C) 2002 Patrick Dangla"
+#define BIL_DATE      "Sun Oct 18 15:45:10 UTC 2026"
+#define BIL_HOST      "vm: 192.0.2.2 fd00::2 "
+#define BIL_PACKAGER  "root"
+#define BIL_OS        "Linux 6.18.44-fc-v139"
+#define BIL_SHORT_LICENSE "GNU General Public License"
+#define BIL_URL       "http://bil.ifsttar.fr"
+#define BIL_EMAIL     "patrick.dangla@ifsttar.fr"
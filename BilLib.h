@@ -0,0 +1 @@
+#define LAPACKLIB   /usr/lib/x86_64-linux-gnu
@@ -0,0 +1 @@
+#define BIL_PATH "/root/repo"
@@ -0,0 +1,4 @@
+#define BIL_MAJOR_VERSION 2
+#define BIL_MINOR_VERSION 8
+#define BIL_PATCH_VERSION 2
+#define BIL_VERSION   "2.8.2"
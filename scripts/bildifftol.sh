@@ -0,0 +1,25 @@
+#!/bin/sh
+
+# Compare two output files of Bil within a tolerance: usage
+#   bildifftol.sh file1 file2 [tol]
+# The values of a column should not differ by more than tol (1.e-5 by
+# default) times the largest magnitude of the column in file1.
+# The exit status is 1 if they do.
+
+awk -v tol="${3:-1.e-5}" '
+  function abs(x) {return((x < 0) ? -x : x)}
+  /^#/ || NF == 0 {next}
+  FNR == NR {n1++ ; for(j = 1 ; j <= NF ; j++) {v[n1,j] = $j ; if(abs($j) > m[j]) m[j] = abs($j)} ; next}
+  {
+    n2++
+    for(j = 1 ; j <= NF ; j++) {
+      d = abs($j - v[n2,j])
+      if(m[j] > 0) d /= m[j]
+      if(d > dmax) {dmax = d ; l = n2 ; c = j}
+    }
+  }
+  END {
+    if(n1 != n2) {print "Different nb of lines: " n1 " and " n2 ; exit(1)}
+    printf("Maximum deviation = %e (line %d, column %d), tolerance = %e\n",dmax,l,c,tol)
+    if(dmax > tol) {print "Tolerance exceeded" ; exit(1)}
+  }' "$1" "$2"
@@ -8,9 +8,9 @@
 
 Buffer_t* Buffer_Create(size_t size)
 {
-  Buffer_t* buffer = (Buffer_t*) Mry_New(Buffer_t) ;
+  Buffer_t* buffer = (Buffer_t*) Mry_NewIn(Buffer,Buffer_t) ;
   
-  Buffer_GetBeginOfBuffer(buffer) = (void*) Mry_Allocate(size) ;
+  Buffer_GetBeginOfBuffer(buffer) = (void*) Mry_AllocateIn(size,Mry_Category(Buffer)) ;
   
   Buffer_GetEndOfBuffer(buffer) = (char*) Buffer_GetBeginOfBuffer(buffer) + size ;
   Buffer_GetSize(buffer) = size ;
@@ -36,8 +36,8 @@ void Buffer_Delete(void* self)
   Buffer_t** pbuffer = (Buffer_t**) self ;
   Buffer_t*   buffer = *pbuffer ;
   
-  free(Buffer_GetBeginOfBuffer(buffer)) ;
-  free(buffer) ;
+  Mry_Free(Buffer_GetBeginOfBuffer(buffer)) ;
+  Mry_Free(buffer) ;
 }
 
 
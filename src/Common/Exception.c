@@ -1,3 +1,4 @@
+#define _POSIX_C_SOURCE 200809L
 #include "Message.h"
 #include "Exception.h"
 #include "Session.h"
@@ -32,7 +33,12 @@ static void SignalHandler(int) ;
 
 Exception_t*  (Exception_GetInstance)(void)
 {
-  GenericData_t* gdat = Session_FindGenericData(Exception_t,"Exception") ;
+  static const char* handle = NULL ;
+  GenericData_t* gdat ;
+  
+  if(!handle) handle = GenericData_InternName("Exception") ;
+  
+  gdat = Session_FindGenericDataWithHandle(Exception_t,handle) ;
   
   if(!gdat) {
     Exception_t* exc = Exception_Create() ;
@@ -41,7 +47,7 @@ Exception_t*  (Exception_GetInstance)(void)
     
     Session_AddGenericData(gdat) ;
     
-    assert(gdat == Session_FindGenericData(Exception_t,"Exception")) ;
+    assert(gdat == Session_FindGenericDataWithHandle(Exception_t,handle)) ;
   }
   
   return((Exception_t*) GenericData_GetData(gdat)) ;
@@ -108,6 +114,16 @@ void (SignalHandler)(int sigid)
     Message_FatalError("An error occured while setting a signal handler.\n") ;
   }
   
+  /* The handler is left by a long jump which does not restore the
+   * signal mask: unblock the signal so that it can be caught again */
+  {
+    sigset_t set ;
+    
+    sigemptyset(&set) ;
+    sigaddset(&set,sigid) ;
+    sigprocmask(SIG_UNBLOCK,&set,NULL) ;
+  }
+  
   switch(sigid) {
     case SIGSEGV:
   
@@ -115,36 +131,42 @@ void (SignalHandler)(int sigid)
       Message_Direct("Check the possible issues:\n") ;
       Message_Direct("- A bad \"iperm\" file? (if so remove it!)\n") ;
       Message_Direct("- A mesh with physical index out of range?\n") ;
+      Exception_ReturnErrorIfCaught ;
       Exception_BackupAndTerminate ;
       return ;
     
     case SIGFPE:
   
       Message_Direct("Floating-point error.\n") ;
+      Exception_ReturnErrorIfCaught ;
       Exception_BackupAndTerminate ;
       return ;
       
     case SIGINT:
   
       Message_Direct("Program interrupted.\n") ;
+      Exception_ReturnErrorIfCaught ;
       Exception_BackupAndTerminate ;
       return ;
       
     case SIGABRT:
   
       Message_Direct("Abnormal termination.\n") ;
+      Exception_ReturnErrorIfCaught ;
       Exception_BackupAndTerminate ;
       return ;
       
     case SIGILL:
   
       Message_Direct("Illegal operation.\n") ;
+      Exception_ReturnErrorIfCaught ;
       Exception_BackupAndTerminate ;
       return ;
       
     case SIGTERM:
   
       Message_Direct("Termination request.\n") ;
+      Exception_ReturnErrorIfCaught ;
       Exception_BackupAndTerminate ;
       return ;
       
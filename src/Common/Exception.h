@@ -14,6 +14,8 @@ extern void            (Exception_Delete)(void*) ;
 #define Exception_GetEnvironment(exception)        ((exception)->env)
 #define Exception_GetExceptionType(exception)      ((exception)->type)
 #define Exception_GetDelete(exception)             ((exception)->Delete)
+#define Exception_GetErrorEnvironment(exception)   ((exception)->errenv)
+#define Exception_GetCatchErrors(exception)        ((exception)->catcherrors)
 
 
 #include <signal.h>
@@ -72,11 +74,38 @@ extern void            (Exception_Delete)(void*) ;
         (Exception_ExceptionType == 3)
 
 
+
+/* Errors returned to the caller instead of terminating the program
+ * (used by the embedding API). The environment is distinct from the
+ * one saved by the algorithms at each time step. */
+#define Exception_ErrorEnvironment \
+        Exception_GetErrorEnvironment(Exception_GetInstance())
+
+#define Exception_SaveErrorEnvironment \
+        (setjmp(Exception_ErrorEnvironment))
+
+#define Exception_CatchErrors(val) \
+        (Exception_GetCatchErrors(Exception_GetInstance()) = (val))
+
+#define Exception_ErrorsAreCaught \
+        (Exception_GetCatchErrors(Exception_GetInstance()))
+
+#define Exception_ReturnErrorIfCaught \
+        do { \
+          if(Exception_ErrorsAreCaught) { \
+            Exception_CatchErrors(0) ; \
+            longjmp(Exception_ErrorEnvironment,1) ; \
+          } \
+        } while(0)
+
+
 #include <GenericObject.h>
 
 struct Exception_s {        /* Exception handler */
   jmp_buf env ;             /* Environment */
   int type ;                /* Signal read by longjmp (1,2,3) and return by setjmp after a long jump */
+  jmp_buf errenv ;          /* Environment restored on errors if they are caught */
+  int catcherrors ;         /* Errors are caught (1) or terminate the program (0) */
   GenericObject_Delete_t* Delete ;
 } ;
 
@@ -12,6 +12,28 @@
 
 static void           (GenericData_Remove)(GenericData_t**) ;
 
+static const char*    (GenericData_LookUpName)(const char*,int) ;
+static unsigned int   (GenericData_HashName)(const char*,size_t) ;
+static unsigned int   (GenericData_HashKey)(const char*,TypeId_t) ;
+
+static GenericDataIndex_t* (GenericDataIndex_Create)(unsigned int) ;
+static void           (GenericDataIndex_Delete)(GenericDataIndex_t*) ;
+static void           (GenericDataIndex_Insert)(GenericDataIndex_t*,GenericData_t*) ;
+static void           (GenericDataIndex_Remove)(GenericDataIndex_t*,GenericData_t*) ;
+static GenericData_t* (GenericDataIndex_Find)(GenericDataIndex_t*,TypeId_t,const char*) ;
+static void           (GenericDataIndex_Resize)(GenericDataIndex_t*,unsigned int) ;
+
+
+/* Marker of a deleted slot in the hash indexes */
+static GenericData_t  deletedslot ;
+#define GenericDataIndex_DeletedSlot   (&deletedslot)
+
+
+/* The table of interned names (open addressing, linear probing) */
+static char**         internedname = NULL ;
+static unsigned int   nbofinternednameslots = 0 ;
+static unsigned int   nbofinternednames = 0 ;
+
 
 /* Global functions */
 
@@ -19,20 +41,14 @@ GenericData_t* (GenericData_New)(void)
 {
   GenericData_t* gdat = (GenericData_t*) Mry_New(GenericData_t) ;
   
-  /* Allocation for the name */
-  {
-    char* name = (char*) Mry_New(char[GenericData_MaxLengthOfKeyWord + 1]) ;
-    
-    GenericData_GetName(gdat) = name ;
-  }
-  
   {
     GenericData_GetTypeId(gdat) = TypeId_Create(undefined) ;
-    strcpy(GenericData_GetName(gdat),"\0") ;
+    GenericData_GetName(gdat) = GenericData_InternName("") ;
     GenericData_GetNbOfData(gdat) = 0 ;
     GenericData_GetData(gdat) = NULL ;
     GenericData_GetNextGenericData(gdat) = NULL ;
     GenericData_GetPreviousGenericData(gdat) = NULL ;
+    GenericData_GetIndex(gdat) = NULL ;
   }
   
   GenericData_GetDelete(gdat) = GenericData_Delete ;
@@ -74,6 +90,33 @@ void (GenericData_Remove)(GenericData_t** pgdat)
   if(prev) GenericData_GetNextGenericData(prev) = next ;
   if(next) GenericData_GetPreviousGenericData(next) = prev ;
   
+  /* Update the index of the remaining generic data */
+  {
+    GenericDataIndex_t* index = GenericData_GetIndex(gdat) ;
+    
+    if(index) {
+      GenericDataIndex_Remove(index,gdat) ;
+      
+      if(!prev && !next) {
+        GenericDataIndex_Delete(index) ;
+      } else {
+        /* Index a possible homonym hidden by gdat */
+        GenericData_t* homonym = GenericData_Find_(prev ? prev : next,GenericData_GetTypeId(gdat),GenericData_GetName(gdat)) ;
+        
+        if(!homonym) {
+          GenericData_t* gd = GenericData_First(prev ? prev : next) ;
+          
+          for(; gd ; gd = GenericData_GetNextGenericData(gd)) {
+            if(GenericData_IsWithHandle(gd,GenericData_GetTypeId(gdat),GenericData_GetName(gdat))) {
+              GenericDataIndex_Insert(index,gd) ;
+              break ;
+            }
+          }
+        }
+      }
+    }
+  }
+  
   {
     TypeId_t typ = GenericData_GetTypeId(gdat) ;
     void* data = GenericData_GetData(gdat) ;
@@ -100,12 +143,8 @@ void (GenericData_Initialize_)(GenericData_t* gdat,int n,void* data,TypeId_t typ
   GenericData_GetNbOfData(gdat) = n ;
   GenericData_GetData(gdat) = data ;
     
-  {
-    int len = MIN(strlen(name),GenericData_MaxLengthOfKeyWord) ;
-      
-    strncpy(GenericData_GetName(gdat),name,len) ;
-    GenericData_GetName(gdat)[len] = '\0' ;
-  }
+  /* Names are truncated to GenericData_MaxLengthOfKeyWord characters */
+  GenericData_GetName(gdat) = GenericData_InternName(name) ;
 }
 
 
@@ -127,9 +166,33 @@ GenericData_t* (GenericData_Append)(GenericData_t* a,GenericData_t* b)
     /* The condition is useless since "lasta" must not be NULL.  */
     if(lasta) GenericData_GetNextGenericData(lasta) = b ;
     if(b) GenericData_GetPreviousGenericData(b) = lasta ;
+  }
+  
+  /* Share the index of a with b and its followers */
+  {
+    GenericDataIndex_t* index = GenericData_GetIndex(a) ;
+    GenericData_t* gd ;
+    
+    if(!index) {
+      index = GenericDataIndex_Create(8) ;
+      
+      for(gd = GenericData_First(a) ; gd != b ; gd = GenericData_GetNextGenericData(gd)) {
+        GenericData_GetIndex(gd) = index ;
+        GenericDataIndex_Insert(index,gd) ;
+      }
+    }
+    
+    if(b && GenericData_GetIndex(b) && GenericData_GetIndex(b) != index) {
+      GenericDataIndex_Delete(GenericData_GetIndex(b)) ;
+    }
     
-    return(a) ;
+    for(gd = b ; gd ; gd = GenericData_GetNextGenericData(gd)) {
+      GenericData_GetIndex(gd) = index ;
+      GenericDataIndex_Insert(index,gd) ;
+    }
   }
+  
+  return(a) ;
 }
 
 
@@ -166,11 +229,58 @@ GenericData_t* (GenericData_First)(GenericData_t* gdat)
 GenericData_t* (GenericData_Find_)(GenericData_t* gdat,TypeId_t typ,const char* name)
 /** Return the generic data named as "name" or NULL pointer. */
 {
+  if(!gdat) return(NULL) ;
+  
+  /* Short lists are searched by comparing the names, which is cheaper
+   * than hashing "name" to get its interned handle */
+  {
+    GenericDataIndex_t* index = GenericData_GetIndex(gdat) ;
+    
+    if(!index || index->nbofentries <= GenericData_MaxNbOfDataForLinearSearch) {
+      GenericData_t* next = gdat ;
+      GenericData_t* prev = gdat ;
+      
+      while(next) {
+        if(GenericData_Is(next,typ,name)) return(next) ;
+        next = GenericData_GetNextGenericData(next) ;
+      }
+      
+      while(prev) {
+        if(GenericData_Is(prev,typ,name)) return(prev) ;
+        prev = GenericData_GetPreviousGenericData(prev) ;
+      }
+      
+      return(NULL) ;
+    }
+  }
+  
+  {
+    const char* handle = GenericData_LookUpName(name,0) ;
+    
+    /* A name which was never interned cannot be found */
+    if(!handle) return(NULL) ;
+    
+    return(GenericData_FindWithHandle_(gdat,typ,handle)) ;
+  }
+}
+
+
+
+GenericData_t* (GenericData_FindWithHandle_)(GenericData_t* gdat,TypeId_t typ,const char* handle)
+/** Return the generic data whose name has the interned handle "handle"
+ *  or NULL pointer. */
+{
+  if(!gdat) return(NULL) ;
+  
+  if(GenericData_GetIndex(gdat)) {
+    return(GenericDataIndex_Find(GenericData_GetIndex(gdat),typ,handle)) ;
+  }
+  
   {
     GenericData_t* next = gdat ;
     
     while(next) {
-      if(GenericData_Is(next,typ,name)) return(next) ;
+      if(GenericData_IsWithHandle(next,typ,handle)) return(next) ;
       next = GenericData_GetNextGenericData(next) ;
     }
   }
@@ -179,7 +289,7 @@ GenericData_t* (GenericData_Find_)(GenericData_t* gdat,TypeId_t typ,const char*
     GenericData_t* prev = gdat ;
     
     while(prev) {
-      if(GenericData_Is(prev,typ,name)) return(prev) ;
+      if(GenericData_IsWithHandle(prev,typ,handle)) return(prev) ;
       prev = GenericData_GetPreviousGenericData(prev) ;
     }
   }
@@ -189,6 +299,245 @@ GenericData_t* (GenericData_Find_)(GenericData_t* gdat,TypeId_t typ,const char*
 
 
 
+const char* (GenericData_InternName)(const char* name)
+/** Return the unique copy of "name" (truncated to
+ *  GenericData_MaxLengthOfKeyWord characters). */
+{
+  return(GenericData_LookUpName(name,1)) ;
+}
+
+
+
+void (GenericData_DeleteInternedNames)(void)
+/** Free the interned names. To be called once no generic data
+ *  and no cached handle are used any longer. */
+{
+  unsigned int i ;
+  
+  for(i = 0 ; i < nbofinternednameslots ; i++) {
+    Mry_Free(internedname[i]) ;
+  }
+  
+  Mry_Free(internedname) ;
+  
+  internedname = NULL ;
+  nbofinternednameslots = 0 ;
+  nbofinternednames = 0 ;
+}
+
+
+
+const char* (GenericData_LookUpName)(const char* name,int add)
+/** Return the interned copy of "name". If the name is not yet interned
+ *  add it if "add" is not 0, otherwise return NULL. */
+{
+  size_t len = strlen(name) ;
+  
+  if(len > GenericData_MaxLengthOfKeyWord) len = GenericData_MaxLengthOfKeyWord ;
+  
+  /* Grow the table to keep the load factor below 1/2 */
+  if(add && 2*(nbofinternednames + 1) > nbofinternednameslots) {
+    unsigned int oldsize = nbofinternednameslots ;
+    char** old = internedname ;
+    unsigned int size = (oldsize) ? 2*oldsize : 64 ;
+    unsigned int i ;
+    
+    internedname = (char**) Mry_New(char*[size]) ;
+    nbofinternednameslots = size ;
+    
+    for(i = 0 ; i < oldsize ; i++) {
+      char* str = old[i] ;
+      
+      if(str) {
+        unsigned int j = GenericData_HashName(str,strlen(str)) & (size - 1) ;
+        
+        while(internedname[j]) j = (j + 1) & (size - 1) ;
+        
+        internedname[j] = str ;
+      }
+    }
+    
+    Mry_Free(old) ;
+  }
+  
+  if(!nbofinternednameslots) return(NULL) ;
+  
+  {
+    unsigned int mask = nbofinternednameslots - 1 ;
+    unsigned int j = GenericData_HashName(name,len) & mask ;
+    char* str ;
+    
+    while((str = internedname[j])) {
+      if(!strncmp(str,name,len) && str[len] == '\0') return(str) ;
+      
+      j = (j + 1) & mask ;
+    }
+    
+    if(!add) return(NULL) ;
+    
+    str = (char*) Mry_New(char[len + 1]) ;
+    
+    strncpy(str,name,len) ;
+    str[len] = '\0' ;
+    
+    internedname[j] = str ;
+    nbofinternednames += 1 ;
+    
+    return(str) ;
+  }
+}
+
+
+
+unsigned int (GenericData_HashName)(const char* name,size_t len)
+/** FNV-1a hash of the first "len" characters of "name" */
+{
+  unsigned int h = 2166136261u ;
+  size_t i ;
+  
+  for(i = 0 ; i < len ; i++) {
+    h ^= (unsigned char) name[i] ;
+    h *= 16777619u ;
+  }
+  
+  return(h) ;
+}
+
+
+
+unsigned int (GenericData_HashKey)(const char* handle,TypeId_t typ)
+/** Hash of the pair (interned name,type id) */
+{
+  size_t p = (size_t) handle ;
+  unsigned int h = (unsigned int) ((p >> 4) ^ (p >> 20)) ;
+  
+  h ^= (unsigned int) typ * 0x9e3779b1u ;
+  h ^= h >> 16 ;
+  
+  return(h) ;
+}
+
+
+
+/* GenericDataIndex_t
+ * ------------------*/
+GenericDataIndex_t* (GenericDataIndex_Create)(unsigned int size)
+{
+  GenericDataIndex_t* index = (GenericDataIndex_t*) Mry_New(GenericDataIndex_t) ;
+  
+  index->size = size ;
+  index->nbofentries = 0 ;
+  index->nbofusedslots = 0 ;
+  index->slot = (GenericData_t**) Mry_New(GenericData_t*[size]) ;
+  
+  return(index) ;
+}
+
+
+
+void (GenericDataIndex_Delete)(GenericDataIndex_t* index)
+{
+  Mry_Free(index->slot) ;
+  Mry_Free(index) ;
+}
+
+
+
+void (GenericDataIndex_Resize)(GenericDataIndex_t* index,unsigned int size)
+{
+  GenericData_t** old = index->slot ;
+  unsigned int oldsize = index->size ;
+  unsigned int i ;
+  
+  index->size = size ;
+  index->nbofentries = 0 ;
+  index->nbofusedslots = 0 ;
+  index->slot = (GenericData_t**) Mry_New(GenericData_t*[size]) ;
+  
+  for(i = 0 ; i < oldsize ; i++) {
+    if(old[i] && old[i] != GenericDataIndex_DeletedSlot) {
+      GenericDataIndex_Insert(index,old[i]) ;
+    }
+  }
+  
+  Mry_Free(old) ;
+}
+
+
+
+void (GenericDataIndex_Insert)(GenericDataIndex_t* index,GenericData_t* gdat)
+/** Insert "gdat" unless a generic data with the same name and type is
+ *  already indexed (the first appended one is then found). */
+{
+  TypeId_t typ = GenericData_GetTypeId(gdat) ;
+  const char* handle = GenericData_GetName(gdat) ;
+  
+  if(GenericDataIndex_Find(index,typ,handle)) return ;
+  
+  if(2*(index->nbofusedslots + 1) > index->size) {
+    unsigned int size = index->size ;
+    
+    /* Grow only if deleted slots are not enough to be reclaimed */
+    if(2*(index->nbofentries + 1) > size/2) size *= 2 ;
+    
+    GenericDataIndex_Resize(index,size) ;
+  }
+  
+  {
+    unsigned int mask = index->size - 1 ;
+    unsigned int j = GenericData_HashKey(handle,typ) & mask ;
+    
+    while(index->slot[j] && index->slot[j] != GenericDataIndex_DeletedSlot) {
+      j = (j + 1) & mask ;
+    }
+    
+    if(!index->slot[j]) index->nbofusedslots += 1 ;
+    
+    index->slot[j] = gdat ;
+    index->nbofentries += 1 ;
+  }
+}
+
+
+
+void (GenericDataIndex_Remove)(GenericDataIndex_t* index,GenericData_t* gdat)
+{
+  unsigned int mask = index->size - 1 ;
+  unsigned int j = GenericData_HashKey(GenericData_GetName(gdat),GenericData_GetTypeId(gdat)) & mask ;
+  GenericData_t* gd ;
+  
+  while((gd = index->slot[j])) {
+    if(gd == gdat) {
+      index->slot[j] = GenericDataIndex_DeletedSlot ;
+      index->nbofentries -= 1 ;
+      return ;
+    }
+    
+    j = (j + 1) & mask ;
+  }
+}
+
+
+
+GenericData_t* (GenericDataIndex_Find)(GenericDataIndex_t* index,TypeId_t typ,const char* handle)
+{
+  unsigned int mask = index->size - 1 ;
+  unsigned int j = GenericData_HashKey(handle,typ) & mask ;
+  GenericData_t* gd ;
+  
+  while((gd = index->slot[j])) {
+    if(gd != GenericDataIndex_DeletedSlot && GenericData_IsWithHandle(gd,typ,handle)) {
+      return(gd) ;
+    }
+    
+    j = (j + 1) & mask ;
+  }
+  
+  return(NULL) ;
+}
+
+
+
 #if 0
 void (GenericData_InsertBefore)(GenericData_t* a,GenericData_t* b)
 /** Insert "b" in the linked list before "a". */
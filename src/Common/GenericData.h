@@ -5,6 +5,7 @@
 
 /* class-like structure */
 struct GenericData_s     ; typedef struct GenericData_s     GenericData_t ;
+struct GenericDataIndex_s; typedef struct GenericDataIndex_s GenericDataIndex_t ;
 
 
 
@@ -25,12 +26,19 @@ extern GenericData_t* (GenericData_Append)       (GenericData_t*,GenericData_t*)
 extern GenericData_t* (GenericData_First)        (GenericData_t*) ;
 extern GenericData_t* (GenericData_Last)         (GenericData_t*) ;
 extern GenericData_t* (GenericData_Find_)        (GenericData_t*,TypeId_t,const char*) ;
+extern GenericData_t* (GenericData_FindWithHandle_)(GenericData_t*,TypeId_t,const char*) ;
+extern const char*    (GenericData_InternName)   (const char*) ;
+extern void           (GenericData_DeleteInternedNames)(void) ;
 
 
 
 
 #define GenericData_MaxLengthOfKeyWord           (30)
 
+/* Lists with up to this nb of generic data are searched by names
+ * without their hash index */
+#define GenericData_MaxNbOfDataForLinearSearch   (16)
+
 
 
 #define GenericData_GetTypeId(GD)                ((GD)->typ)
@@ -40,6 +48,7 @@ extern GenericData_t* (GenericData_Find_)        (GenericData_t*,TypeId_t,const
 #define GenericData_GetNextGenericData(GD)       ((GD)->next)
 #define GenericData_GetPreviousGenericData(GD)   ((GD)->prev)
 #define GenericData_GetDelete(GD)                ((GD)->Delete)
+#define GenericData_GetIndex(GD)                 ((GD)->index)
 
 
 
@@ -54,13 +63,28 @@ extern GenericData_t* (GenericData_Find_)        (GenericData_t*,TypeId_t,const
         GenericData_Find_(GD,TypeId_Create(T),N)
         
         
+/* Handles are interned names: two names are equal iff their handles
+ * are the same pointers. Hot paths may cache a handle once, e.g.
+ *   static const char* h = NULL ;
+ *   if(!h) h = GenericData_InternName("FEM") ;
+ *   gdat = GenericData_FindWithHandle(gdat,FEM_t,h) ; */
+#define GenericData_FindWithHandle(GD,T,H) \
+        GenericData_FindWithHandle_(GD,TypeId_Create(T),H)
+        
+        
 #define GenericData_Is(GD,I,S) \
-        ((GenericData_GetTypeId(GD) == I) && !strcmp(GenericData_GetName(GD),S))
+        ((GenericData_GetTypeId(GD) == I) && !strncmp(GenericData_GetName(GD),S,GenericData_MaxLengthOfKeyWord))
+        
+#define GenericData_IsWithHandle(GD,I,H) \
+        ((GenericData_GetTypeId(GD) == I) && (GenericData_GetName(GD) == (H)))
         
         
 #define GenericData_FindData(GD,T,N) \
         (GenericData_Find(GD,T,N) ? GenericData_GetData(GenericData_Find(GD,T,N)) : NULL)
         
+#define GenericData_FindDataWithHandle(GD,T,H) \
+        (GenericData_FindWithHandle(GD,T,H) ? GenericData_GetData(GenericData_FindWithHandle(GD,T,H)) : NULL)
+        
         
 #define GenericData_Merge(A,B) \
         GenericData_Append(A,GenericData_First(B))
@@ -77,13 +101,22 @@ extern GenericData_t* (GenericData_Find_)        (GenericData_t*,TypeId_t,const
 /* Generic data */
 struct GenericData_s {
   TypeId_t typ ;                /* The type id of data */
-  char*    name ;               /* Name of the data */
+  const char* name ;            /* Interned name of the data */
   int n ;                       /* Nb of data */
   void* data ;                  /* The data */
   GenericData_t* prev ;         /* Previous generic data */
   GenericData_t* next ;         /* Next generic data */
+  GenericDataIndex_t* index ;   /* Hash index shared by the linked generic data */
   GenericObject_Delete_t* Delete ;
 } ;
 
 
+/* Open-addressing hash table keyed on (interned name,type id) */
+struct GenericDataIndex_s {
+  unsigned int size ;           /* Nb of slots (a power of 2) */
+  unsigned int nbofentries ;    /* Nb of generic data in the table */
+  unsigned int nbofusedslots ;  /* Nb of entries and deleted slots */
+  GenericData_t** slot ;
+} ;
+
 #endif
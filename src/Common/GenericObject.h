@@ -117,12 +117,15 @@ extern const void*      (GenericObject_ClassOf)(const void*) ;
 #define GenericObject_DefineGetInstance(GO,...) \
         GenericObject_DeclareGetInstance(GO,__VA_ARGS__) \
         { \
-          GenericData_t* gdat = Session_FindGenericData(GenericObject_Type(GO),Utils_STR(GO)) ; \
+          static const char* handle = NULL ; \
+          GenericData_t* gdat ; \
+          if(!handle) handle = GenericData_InternName(Utils_STR(GO)) ; \
+          gdat = Session_FindGenericDataWithHandle(GenericObject_Type(GO),handle) ; \
           if(!gdat) { \
             GenericObject_Type(GO)* obj = Utils_CAT(GO,_Create)(__VA_ARGS__) ; \
             gdat = GenericData_Create(1,obj,GenericObject_Type(GO),Utils_STR(GO)) ; \
             Session_AddGenericData(gdat) ; \
-            assert(gdat == Session_FindGenericData(GenericObject_Type(GO),Utils_STR(GO))) ; \
+            assert(gdat == Session_FindGenericDataWithHandle(GenericObject_Type(GO),handle)) ; \
           } \
           return((GenericObject_Type(GO)*) GenericData_GetData(gdat)) ; \
         }
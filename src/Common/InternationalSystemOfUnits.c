@@ -61,7 +61,12 @@ void (InternationalSystemOfUnits_Delete)(void* self)
 
 InternationalSystemOfUnits_t*  (InternationalSystemOfUnits_GetInstance)(void)
 {
-  GenericData_t* gdat = Session_FindGenericData(InternationalSystemOfUnits_t,"InternationalSystemOfUnits") ;
+  static const char* handle = NULL ;
+  GenericData_t* gdat ;
+  
+  if(!handle) handle = GenericData_InternName("InternationalSystemOfUnits") ;
+  
+  gdat = Session_FindGenericDataWithHandle(InternationalSystemOfUnits_t,handle) ;
   
   if(!gdat) {
     InternationalSystemOfUnits_t* isu = InternationalSystemOfUnits_Create() ;
@@ -70,7 +75,7 @@ InternationalSystemOfUnits_t*  (InternationalSystemOfUnits_GetInstance)(void)
     
     Session_AddGenericData(gdat) ;
     
-    assert(gdat == Session_FindGenericData(InternationalSystemOfUnits_t,"InternationalSystemOfUnits")) ;
+    assert(gdat == Session_FindGenericDataWithHandle(InternationalSystemOfUnits_t,handle)) ;
   }
   
   return((InternationalSystemOfUnits_t*) GenericData_GetData(gdat)) ;
@@ -1,4 +1,5 @@
 #include "Message.h"
+#include "Exception.h"
 #include "Session.h"
 #include "GenericData.h"
 #include <stdio.h>
@@ -22,7 +23,12 @@ static Message_t*  (Message_Create)(void) ;
 /* Extern functions */
 Message_t*  (Message_GetInstance)(void)
 {
-  GenericData_t* gdat = Session_FindGenericData(Message_t,"Message") ;
+  static const char* handle = NULL ;
+  GenericData_t* gdat ;
+  
+  if(!handle) handle = GenericData_InternName("Message") ;
+  
+  gdat = Session_FindGenericDataWithHandle(Message_t,handle) ;
   
   if(!gdat) {
     Message_t* msg = Message_Create() ;
@@ -31,7 +37,7 @@ Message_t*  (Message_GetInstance)(void)
     
     Session_AddGenericData(gdat) ;
     
-    assert(gdat == Session_FindGenericData(Message_t,"Message")) ;
+    assert(gdat == Session_FindGenericDataWithHandle(Message_t,handle)) ;
   }
   
   return((Message_t*) GenericData_GetData(gdat)) ;
@@ -139,6 +145,8 @@ void (Message_FatalError0)(const char* fmt, ...)
   fprintf(stderr,"\n...stop\n") ;
   fflush(stderr) ;
   
+  Exception_ReturnErrorIfCaught ;
+  
   exit(EXIT_SUCCESS) ;
 }
 
@@ -149,6 +157,7 @@ void (Message_RuntimeError0)(const char* fmt, ...)
   Message_t* msg = Message_GetInstance() ;
   
   if(!msg || Message_GetVerbosity(msg) < 1) {
+    Exception_ReturnErrorIfCaught ;
     exit(EXIT_SUCCESS) ;
     return ;
   }
@@ -167,6 +176,8 @@ void (Message_RuntimeError0)(const char* fmt, ...)
   fprintf(stderr,"\n...stop\n") ;
   fflush(stderr) ;
   
+  Exception_ReturnErrorIfCaught ;
+  
   exit(EXIT_SUCCESS) ;
 }
 
@@ -1,56 +1,286 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <assert.h>
 #include "Mry.h"
 #include "Message.h"
 
 
 
+/* Tracked-allocation mode:
+ * the current and peak sizes of the memory allocated through Mry are
+ * accounted per category. Blocks released by Mry_Free or Mry_Realloc
+ * are subtracted. Blocks released by a plain free are subtracted only
+ * when their address is allocated again. */
+
+static void    (Mry_Track)(void*,size_t,MryCategory_t) ;
+static void    (Mry_Untrack)(void*) ;
+static size_t  (Mry_FindSlot)(void*) ;
+static void    (Mry_ResizeTable)(size_t) ;
+
+
+/* Table of the tracked blocks (open addressing, linear probing) */
+struct MryBlock_s ; typedef struct MryBlock_s MryBlock_t ;
+
+struct MryBlock_s {
+  void*  ptr ;
+  size_t size ;
+  MryCategory_t category ;
+} ;
+
+static int          tracking = 0 ;
+static MryBlock_t*  block = NULL ;
+static size_t       nbofblockslots = 0 ;
+static size_t       nbofusedslots = 0 ;   /* tracked or deleted */
+static size_t       nbofblocks = 0 ;      /* tracked */
+static char         deletedblock ;
+#define Mry_DeletedBlock   ((void*) &deletedblock)
+
+static size_t  currentsize[MryCategory_NbOfCategories] ;
+static size_t  peaksize[MryCategory_NbOfCategories] ;
+static size_t  currenttotalsize = 0 ;
+static size_t  peaktotalsize = 0 ;
+
+static const char* categoryname[MryCategory_NbOfCategories] = {
+  "other","mesh","matrix","factor","element terms","buffer","chemistry","output"
+} ;
+
+
+
 void* Mry_Allocate(size_t size)
+{
+  return(Mry_AllocateIn(size,MryCategory_Other)) ;
+}
+
+
+
+void* Mry_AllocateZeroed(size_t num, size_t size)
+{
+  return(Mry_AllocateZeroedIn(num,size,MryCategory_Other)) ;
+}
+
+
+
+void* Mry_Realloc(void* ptr, size_t size)
+{
+  return(Mry_ReallocIn(ptr,size,MryCategory_Other)) ;
+}
+
+
+
+void Mry_Free(void* ptr)
+{
+  if(ptr == NULL) return;
+  if(tracking) Mry_Untrack(ptr) ;
+  free(ptr);
+}
+
+
+
+void* Mry_AllocateIn(size_t size,MryCategory_t cat)
 {
   void* ptr ;
 
   if(!size) return (NULL);
-  
+
   ptr = malloc(size) ;
-  
+
   assert(ptr) ;
-  
+
+  if(tracking) Mry_Track(ptr,size,cat) ;
+
   return (ptr);
 }
 
 
 
-void* Mry_AllocateZeroed(size_t num, size_t size)
+void* Mry_AllocateZeroedIn(size_t num,size_t size,MryCategory_t cat)
 {
   void* ptr;
 
   if(!size) return (NULL);
-  
+
   ptr = calloc(num, size);
-  
+
   assert(ptr) ;
-  
+
+  if(tracking) Mry_Track(ptr,num*size,cat) ;
+
   return (ptr);
 }
 
 
 
-void* Mry_Realloc(void* ptr, size_t size)
+void* Mry_ReallocIn(void* ptr,size_t size,MryCategory_t cat)
 {
   if(!size) return (NULL);
-  
+
+  if(tracking && ptr) Mry_Untrack(ptr) ;
+
   ptr = realloc(ptr, size);
-  
+
   assert(ptr) ;
-  
+
+  if(tracking) Mry_Track(ptr,size,cat) ;
+
   return (ptr);
 }
 
 
 
-void Mry_Free(void* ptr)
+void Mry_EnableTracking(void)
+/** Start the accounting of the memory allocated through Mry.
+ *  The blocks allocated before are ignored. */
 {
-  if(ptr == NULL) return;
-  free(ptr);
+  tracking = 1 ;
+}
+
+
+
+int Mry_IsTracking(void)
+{
+  return(tracking) ;
+}
+
+
+
+void Mry_PrintMemoryUsage(void)
+/** Print the current and peak sizes of the tracked memory per category. */
+{
+  int i ;
+
+  if(!tracking) return ;
+
+  Message_Direct("\n") ;
+  Message_Direct("Memory usage (MB):\n") ;
+  Message_Direct("  %-15s %12s %12s\n","category","current","peak") ;
+
+  for(i = 0 ; i < MryCategory_NbOfCategories ; i++) {
+    double cur  = currentsize[i]/1048576. ;
+    double peak = peaksize[i]/1048576. ;
+
+    Message_Direct("  %-15s %12.3f %12.3f\n",categoryname[i],cur,peak) ;
+  }
+
+  {
+    double cur  = currenttotalsize/1048576. ;
+    double peak = peaktotalsize/1048576. ;
+
+    Message_Direct("  %-15s %12.3f %12.3f\n","total",cur,peak) ;
+  }
+}
+
+
+
+/* Intern functions */
+
+void Mry_Track(void* ptr,size_t size,MryCategory_t cat)
+{
+  /* Keep the load factor below 1/2 */
+  if(2*(nbofusedslots + 1) > nbofblockslots) {
+    size_t nslots = 1024 ;
+    
+    while(nslots < 4*(nbofblocks + 1)) nslots *= 2 ;
+    
+    Mry_ResizeTable(nslots) ;
+  }
+
+  {
+    size_t j = Mry_FindSlot(ptr) ;
+
+    /* The block was released by a plain free */
+    if(block[j].ptr == ptr) {
+      Mry_Untrack(ptr) ;
+      j = Mry_FindSlot(ptr) ;
+    }
+
+    if(!block[j].ptr) nbofusedslots += 1 ;
+    nbofblocks += 1 ;
+
+    block[j].ptr = ptr ;
+    block[j].size = size ;
+    block[j].category = cat ;
+  }
+
+  currentsize[cat] += size ;
+  currenttotalsize += size ;
+
+  if(currentsize[cat] > peaksize[cat]) peaksize[cat] = currentsize[cat] ;
+  if(currenttotalsize > peaktotalsize) peaktotalsize = currenttotalsize ;
+}
+
+
+
+void Mry_Untrack(void* ptr)
+{
+  if(!nbofblockslots) return ;
+
+  {
+    size_t j = Mry_FindSlot(ptr) ;
+
+    /* Blocks allocated before tracking started are not found */
+    if(block[j].ptr == ptr) {
+      MryCategory_t cat = block[j].category ;
+      size_t size = block[j].size ;
+
+      currentsize[cat] -= size ;
+      currenttotalsize -= size ;
+
+      block[j].ptr = Mry_DeletedBlock ;
+      nbofblocks -= 1 ;
+    }
+  }
+}
+
+
+
+size_t Mry_FindSlot(void* ptr)
+/** Return the slot of ptr if tracked, otherwise the first free slot
+ *  (deleted or empty) met while probing. */
+{
+  size_t mask = nbofblockslots - 1 ;
+  size_t j = (((uintptr_t) ptr) >> 4) * 2654435761u & mask ;
+  size_t freeslot = nbofblockslots ;
+
+  while(block[j].ptr) {
+    if(block[j].ptr == ptr) return(j) ;
+
+    if(block[j].ptr == Mry_DeletedBlock && freeslot == nbofblockslots) {
+      freeslot = j ;
+    }
+
+    j = (j + 1) & mask ;
+  }
+
+  return((freeslot < nbofblockslots) ? freeslot : j) ;
+}
+
+
+
+void Mry_ResizeTable(size_t size)
+/** Rehash the tracked blocks into a table of size slots (a power of 2).
+ *  The deleted slots are dropped. */
+{
+  MryBlock_t* old = block ;
+  size_t oldsize = nbofblockslots ;
+  size_t i ;
+
+  /* Not tracked itself */
+  block = (MryBlock_t*) calloc(size,sizeof(MryBlock_t)) ;
+  assert(block) ;
+  nbofblockslots = size ;
+  nbofusedslots = 0 ;
+
+  for(i = 0 ; i < oldsize ; i++) {
+    void* ptr = old[i].ptr ;
+
+    if(ptr && ptr != Mry_DeletedBlock) {
+      size_t j = Mry_FindSlot(ptr) ;
+
+      block[j] = old[i] ;
+      nbofusedslots += 1 ;
+    }
+  }
+
+  free(old) ;
 }
@@ -2,12 +2,35 @@
 #define MRY_H
 
 
+enum MryCategory_e {          /* Categories of allocated memory */
+  MryCategory_Other,
+  MryCategory_Mesh,           /* nodes, elements, data set */
+  MryCategory_Matrix,         /* matrix and solver arrays */
+  MryCategory_Factor,         /* factorization work space */
+  MryCategory_ElementTerms,   /* implicit, explicit and constant terms */
+  MryCategory_Buffer,         /* buffers */
+  MryCategory_Chemistry,      /* chemistry objects */
+  MryCategory_Output,         /* outputs */
+  MryCategory_NbOfCategories
+} ;
+
+
+/* vacuous declarations and typedef names */
+typedef enum MryCategory_e    MryCategory_t ;
+
+
 #include <stdlib.h>
 
 extern void*     (Mry_Allocate)(size_t) ;
 extern void*     (Mry_AllocateZeroed)(size_t,size_t) ;
 extern void*     (Mry_Realloc)(void*,size_t) ;
 extern void      (Mry_Free)(void*) ;
+extern void*     (Mry_AllocateIn)(size_t,MryCategory_t) ;
+extern void*     (Mry_AllocateZeroedIn)(size_t,size_t,MryCategory_t) ;
+extern void*     (Mry_ReallocIn)(void*,size_t,MryCategory_t) ;
+extern void      (Mry_EnableTracking)(void) ;
+extern int       (Mry_IsTracking)(void) ;
+extern void      (Mry_PrintMemoryUsage)(void) ;
 
 
 #include <stdarg.h>
@@ -23,6 +46,20 @@ extern void      (Mry_Free)(void*) ;
 
 #define Mry_New_2(T,N) \
         Mry_AllocateZeroed((size_t) (N),sizeof(T))
-        
+
+
+/* Same as Mry_New with a category, e.g. Mry_NewIn(Matrix,double[n]) */
+#define Mry_NewIn(CAT,...) \
+        Utils_CAT_NARG(Mry_NewIn_,__VA_ARGS__)(CAT,__VA_ARGS__)
+
+#define Mry_NewIn_1(CAT,T) \
+        Mry_AllocateZeroedIn(1,sizeof(T),Mry_Category(CAT))
+
+#define Mry_NewIn_2(CAT,T,N) \
+        Mry_AllocateZeroedIn((size_t) (N),sizeof(T),Mry_Category(CAT))
+
+#define Mry_Category(KEY) \
+        ((MryCategory_t) Utils_CAT(MryCategory_,KEY))
+
 
 #endif
@@ -27,6 +27,7 @@ Options_t*  (Options_Create)(Context_t* ctx)
   
     assert(c) ;
 
+    Options_GetKeyWords(options)          = c ;
     Options_GetPrintedInfos(options)      = c ;
     Options_GetResolutionMethod(options)  = (c += max_mot_debug) ;
     Options_GetPrintLevel(options)        = (c += max_mot_debug) ;
@@ -47,11 +48,12 @@ Options_t*  (Options_Create)(Context_t* ctx)
 
 
 void Options_Delete(void* self)
+/** The context is not deleted: it owns the options. */
 {
   Options_t** options = (Options_t**) self ;
   
-  Context_Delete(&(Options_GetContext(*options))) ;
-  free(Options_GetPrintedInfos(*options)) ;
+  /* The keywords may point to the arguments of the command line */
+  free(Options_GetKeyWords(*options)) ;
   free(*options) ;
   *options = NULL ;
 }
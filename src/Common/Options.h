@@ -24,6 +24,7 @@ extern void        (Options_Delete)(void*) ;
 #define Options_GetNodalOrderingMethod(OPT)    ((OPT)->nordering)
 #define Options_GetPostProcessingMethod(OPT)   ((OPT)->postprocess)
 #define Options_GetContext(OPT)                ((OPT)->context)
+#define Options_GetKeyWords(OPT)               ((OPT)->keywords)
 
 
 
@@ -69,6 +70,12 @@ extern void        (Options_Delete)(void*) ;
 #define Options_DefaultFillFactor (2)
 
 
+/* Factorization in single precision refined in double precision */
+#define Options_IsSinglePrecisionFactorization(OPT) \
+        ((Options_GetContext(OPT)) && (Context_GetSolver(Options_GetContext(OPT))) && \
+        (!strcmp(((char**) Context_GetSolver(Options_GetContext(OPT)))[2],"-sp")))
+
+
 /* Implementations */
 
 #define Options_ResolutionMethodIs(OPT,M) \
@@ -94,6 +101,7 @@ struct Options_s {            /* options */
   char*   nordering ;         /* Nodal ordering method */
   char*   postprocess ;       /* Post-processing method */
   Context_t* context ;
+  char*   keywords ;          /* Storage of the default keywords */
 } ;
 
 
@@ -41,6 +41,9 @@ extern Session_t*     (Session_Close)(void) ;
 #define Session_FindGenericData(T,N) \
         GenericData_Find(Session_GenericData,T,N)
         
+#define Session_FindGenericDataWithHandle(T,H) \
+        GenericData_FindWithHandle(Session_GenericData,T,H)
+        
         
 #define Session_AddGenericData(GD) \
         do {Session_GenericData = GenericData_Append(Session_GenericData,GD);} while(0)
@@ -10,25 +10,32 @@
 #include "FVM.h"
 #include "Exception.h"
 #include "InternationalSystemOfUnits.h"
+#include "Elasticity.h"
+#include "Plasticity.h"
+#include "Damage.h"
+#include "Solver.h"
 
 
 
 
 
 void  (TypeId_Delete)(TypeId_t typ,void* self)
+/** self points to the pointer to the object to be deleted */
 {
+  if(!*((void**) self)) return ;
+  
   switch(typ) {
     case TypeId_undefined       : break ;
-    case TypeId_unsigned_char   : free(self); return ;
-    case TypeId_char            : free(self); return ;
-    case TypeId_double          : free(self); return ;
-    case TypeId_long_double     : free(self); return ;
-    case TypeId_float           : free(self); return ;
-    case TypeId_unsigned_int    : free(self); return ;
-    case TypeId_short_int       : free(self); return ;
-    case TypeId_int             : free(self); return ;
-    case TypeId_unsigned_long   : free(self); return ;
-    case TypeId_long_int        : free(self); return ;
+    case TypeId_unsigned_char   : free(*((void**) self)); return ;
+    case TypeId_char            : free(*((void**) self)); return ;
+    case TypeId_double          : free(*((void**) self)); return ;
+    case TypeId_long_double     : free(*((void**) self)); return ;
+    case TypeId_float           : free(*((void**) self)); return ;
+    case TypeId_unsigned_int    : free(*((void**) self)); return ;
+    case TypeId_short_int       : free(*((void**) self)); return ;
+    case TypeId_int             : free(*((void**) self)); return ;
+    case TypeId_unsigned_long   : free(*((void**) self)); return ;
+    case TypeId_long_int        : free(*((void**) self)); return ;
     case TypeId_BCond_t         : break ;
     case TypeId_BConds_t        : break ;
     case TypeId_Buffer_t        : break ;
@@ -37,11 +44,12 @@ void  (TypeId_Delete)(TypeId_t typ,void* self)
     case TypeId_Curve_t         : break ;
     case TypeId_Curves_t        : break ;
     case TypeId_CurvesFile_t    : break ;
-    case TypeId_Damage_t        : break ;
+    case TypeId_Damage_t        : Damage_Delete(self); return ;
     case TypeId_DataFile_t      : break ;
     case TypeId_DataSet_t       : break ;
     case TypeId_Date_t          : break ;
     case TypeId_Dates_t         : break ;
+    case TypeId_Elasticity_t    : Elasticity_Delete(self); return ;
     case TypeId_Element_t       : break ;
     case TypeId_Elements_t      : break ;
     case TypeId_ElementSol_t    : break ;
@@ -85,6 +93,7 @@ void  (TypeId_Delete)(TypeId_t typ,void* self)
     case TypeId_OutputFiles_t   : break ;
     case TypeId_Periodicity_t   : break ;
     case TypeId_Periodicities_t : break ;
+    case TypeId_Plasticity_t    : Plasticity_Delete(self); return ;
     case TypeId_Point_t         : break ;
     case TypeId_Points_t        : break ;
     case TypeId_Result_t        : break ;
@@ -94,7 +103,7 @@ void  (TypeId_Delete)(TypeId_t typ,void* self)
     case TypeId_ShapeFcts_t     : break ;
     case TypeId_Solution_t      : break ;
     case TypeId_Solutions_t     : break ;
-    case TypeId_Solver_t        : break ;
+    case TypeId_Solver_t        : Solver_Delete(self); return ;
     case TypeId_TextFile_t      : break ;
     case TypeId_TimeStep_t      : break ;
     case TypeId_Unit_t          : break ;
@@ -150,14 +150,14 @@ void BCond_Scan(BCond_t* bcond,DataFile_t* datafile)
     int n = String_FindAndScanExp(line,"Equ",","," = %s",name) ;
       
     if(n) {
+      if(strlen(name) > BCond_MaxLengthOfKeyWord-1)  {
+        arret("BCond_Scan: too long name of equation") ;
+      }
+      
       strcpy(BCond_GetNameOfEquation(bcond),name) ;
     } else {
       strcpy(BCond_GetNameOfEquation(bcond)," ") ;
     }
-      
-    if(strlen(name) > BCond_MaxLengthOfKeyWord-1)  {
-      arret("BCond_Scan: too long name of equation") ;
-    }
         
     if(isdigit(BCond_GetNameOfEquation(bcond)[0])) {
       if(BCond_GetNameOfEquation(bcond)[0] < '1') {
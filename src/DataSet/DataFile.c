@@ -62,8 +62,8 @@ void (DataFile_Delete)(void* self)
   DataFile_t*   datafile = *pdatafile ;
   
   TextFile_Delete(&DataFile_GetTextFile(datafile)) ;
-  free(DataFile_GetTextLine(datafile)) ;
-  free(datafile) ;
+  Mry_Free(DataFile_GetTextLine(datafile)) ;
+  Mry_Free(datafile) ;
 }
 
 
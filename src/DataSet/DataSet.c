@@ -150,6 +150,14 @@ DataSet_t*  (DataSet_Create)(char* filename,Options_t* opt)
   if(!strcmp(debug,"points")) DataSet_PrintData(jdd,debug) ;
   
   
+  /* Requested views */
+  {
+    DataFile_t*    datafile = DataSet_GetDataFile(jdd) ;
+  
+    DataSet_GetRequestedViews(jdd) = Views_CreateRequestedViews(datafile) ;
+  }
+  
+  
   /* Dates */
   {
     DataFile_t*    datafile = DataSet_GetDataFile(jdd) ;
@@ -190,6 +198,23 @@ DataSet_t*  (DataSet_Create)(char* filename,Options_t* opt)
   if(!strcmp(debug,"iter")) DataSet_PrintData(jdd,debug) ;
   
   
+  /* Checkpoint */
+  {
+    DataFile_t*    datafile = DataSet_GetDataFile(jdd) ;
+    
+    DataSet_GetCheckpoint(jdd) = Checkpoint_Create(datafile) ;
+  }
+  
+  
+  /* Sensitivity */
+  {
+    DataFile_t*    datafile = DataSet_GetDataFile(jdd) ;
+    Materials_t*   materials = DataSet_GetMaterials(jdd) ;
+    
+    DataSet_GetSensitivity(jdd) = Sensitivity_Create(datafile,materials) ;
+  }
+  
+  
   /* Modules */
   DataSet_GetModules(jdd) = Modules_Create() ;
   if(!strcmp(debug,"module")) DataSet_PrintData(jdd,debug) ;
@@ -227,6 +252,29 @@ DataSet_t*  (DataSet_Create)(char* filename,Options_t* opt)
 
 
 
+void  (DataSet_Delete)(void* self)
+/** Free the data set in the reverse order of its creation. The options
+ *  belong to the caller. The materials, fields, functions, conditions,
+ *  points, dates, objective values, time steps and iterative process
+ *  have no destructor yet and are kept. */
+{
+  DataSet_t** pjdd = (DataSet_t**) self ;
+  DataSet_t*   jdd = *pjdd ;
+  
+  if(DataSet_GetModules(jdd))        Modules_Delete(&DataSet_GetModules(jdd)) ;
+  if(DataSet_GetSensitivity(jdd))    Sensitivity_Delete(&DataSet_GetSensitivity(jdd)) ;
+  if(DataSet_GetCheckpoint(jdd))     Checkpoint_Delete(&DataSet_GetCheckpoint(jdd)) ;
+  if(DataSet_GetRequestedViews(jdd)) Views_Delete(&DataSet_GetRequestedViews(jdd)) ;
+  if(DataSet_GetMesh(jdd))           Mesh_Delete(&DataSet_GetMesh(jdd)) ;
+  if(DataSet_GetGeometry(jdd))       Geometry_Delete(&DataSet_GetGeometry(jdd)) ;
+  if(DataSet_GetDataFile(jdd))       DataFile_Delete(&DataSet_GetDataFile(jdd)) ;
+  
+  Mry_Free(jdd) ;
+  *pjdd = NULL ;
+}
+
+
+
 DataSet_t*  (DataSet_Create1)(char* filename,Options_t* opt)
 {
   DataSet_t* jdd = DataSet_New() ;
@@ -10,6 +10,7 @@ struct DataSet_s      ; typedef struct DataSet_s      DataSet_t ;
 #include "Options.h"
 
 extern DataSet_t*  (DataSet_Create)(char*,Options_t*) ;
+extern void        (DataSet_Delete)(void*) ;
 extern DataSet_t*  (DataSet_Create1)(char*,Options_t*) ;
 
 
@@ -39,6 +40,9 @@ extern DataSet_t*  (DataSet_Create1)(char*,Options_t*) ;
 #define DataSet_GetIterProcess(DS)    ((DS)->iterprocess)
 #define DataSet_GetOptions(DS)        ((DS)->options)
 #define DataSet_GetModules(DS)        ((DS)->modules)
+#define DataSet_GetRequestedViews(DS) ((DS)->requestedviews)
+#define DataSet_GetCheckpoint(DS)     ((DS)->checkpoint)
+#define DataSet_GetSensitivity(DS)    ((DS)->sensitivity)
 
 
 
@@ -58,6 +62,9 @@ extern DataSet_t*  (DataSet_Create1)(char*,Options_t*) ;
 #include "TimeStep.h"
 #include "IterProcess.h"
 #include "Modules.h"
+#include "Views.h"
+#include "Checkpoint.h"
+#include "Sensitivity.h"
 
 struct DataSet_s {               /* set of data for the problem to work out */
   DataFile_t*    datafile ;      /* data file */
@@ -78,6 +85,9 @@ struct DataSet_s {               /* set of data for the problem to work out */
   IterProcess_t* iterprocess ;   /* iterative process */
   Options_t*     options ;       /* options */
   Modules_t*     modules ;       /* modules */
+  Views_t*       requestedviews ; /* Views requested in outputs (NULL = all) */
+  Checkpoint_t*  checkpoint ;    /* Periodic saves (NULL = none) */
+  Sensitivity_t* sensitivity ;   /* Forward sensitivities (NULL = none) */
 } ;
 
 
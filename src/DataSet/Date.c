@@ -14,9 +14,7 @@
 
 Date_t*  Date_Create(int n_dates)
 {
-  Date_t* date = (Date_t*) malloc(n_dates*sizeof(Date_t)) ;
-  
-  if(!date) arret("Date_Create") ;
+  Date_t* date = (Date_t*) Mry_NewIn(Mesh,Date_t[n_dates]) ;
   
   return(date) ;
 }
@@ -61,7 +61,7 @@ Dates_t*  Dates_Create(DataFile_t* datafile)
       }
     }
     
-    free(t) ;
+    Mry_Free(t) ;
   }
   
   
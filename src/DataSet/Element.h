@@ -235,6 +235,9 @@ extern double*  (Element_ComputeCoordinateVector)               (Element_t*,doub
 #define Element_FindMaterialData(ELT,T,N) \
         Material_FindData(Element_GetMaterial(ELT),T,N)
 
+#define Element_FindMaterialDataWithHandle(ELT,T,H) \
+        Material_FindDataWithHandle(Element_GetMaterial(ELT),T,H)
+
 
 
 
@@ -251,6 +254,12 @@ extern double*  (Element_ComputeCoordinateVector)               (Element_t*,doub
 #define Element_GetNameOfUnknown(ELT) \
         Material_GetNameOfUnknown(Element_GetMaterial(ELT))
 
+#define Element_EquationIsCoupledToUnknown(ELT,i,j) \
+        Model_EquationIsCoupledToUnknown(Element_GetModel(ELT),i,j)
+
+#define Element_HasStructuralZeros(ELT) \
+        Model_HasStructuralZeros(Element_GetModel(ELT))
+
 
 
 /* Methods and procedures */
@@ -272,6 +281,9 @@ extern double*  (Element_ComputeCoordinateVector)               (Element_t*,doub
 #define Element_ComputeResidu(ELT,...) \
         (Model_GetComputeResidu(Element_GetModel(ELT)))(ELT,__VA_ARGS__)
 
+#define Element_ComputeResiduAndMatrix(ELT,...) \
+        (Model_GetComputeResiduAndMatrix(Element_GetModel(ELT)))(ELT,__VA_ARGS__)
+
 #define Element_ComputeOutputs(ELT,...) \
         (Model_GetComputeOutputs(Element_GetModel(ELT)))(ELT,__VA_ARGS__)
 
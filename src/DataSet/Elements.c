@@ -24,7 +24,7 @@ static double   (Elements_ComputeMinimumSizeOfElements)(Elements_t*) ;
 
 Elements_t*  Elements_New(const int n,const int nc)
 {
-  Elements_t* elts = (Elements_t*) Mry_New(Elements_t) ;
+  Elements_t* elts = (Elements_t*) Mry_NewIn(Mesh,Elements_t) ;
   
   Elements_GetNbOfElements(elts) = n ;
   Elements_GetNbOfConnectivities(elts) = nc ;
@@ -32,7 +32,7 @@ Elements_t*  Elements_New(const int n,const int nc)
   
   /* Allocation of space for the elements */
   {
-    Element_t* el = (Element_t*) Mry_New(Element_t[n]) ;
+    Element_t* el = (Element_t*) Mry_NewIn(Mesh,Element_t[n]) ;
     
     Elements_GetElement(elts) = el ;
   }
@@ -40,7 +40,7 @@ Elements_t*  Elements_New(const int n,const int nc)
   
   /* Allocation of space for the pointers to "node" */
   {
-    Node_t** pnode = (Node_t**) Mry_New(Node_t*[nc]) ;
+    Node_t** pnode = (Node_t**) Mry_NewIn(Mesh,Node_t*[nc]) ;
     Element_t* el = Elements_GetElement(elts) ;
     
     Element_GetPointerToNode(el) = pnode ;
@@ -86,11 +86,11 @@ void Elements_Delete(void* self)
     Element_t* el = Elements_GetElement(elements) ;
     Node_t** pnode = Element_GetPointerToNode(el) ;
     
-    free(pnode) ;
-    free(el) ;
+    Mry_Free(pnode) ;
+    Mry_Free(el) ;
   }
   
-  free(elements) ;
+  Mry_Free(elements) ;
 }
 
 
@@ -144,8 +144,8 @@ void Elements_CreateMore(Elements_t* elements)
   
     /* Memory space allocation with initialization to 0 */
     {
-      //short int* pos = (short int* ) calloc(2*n_pos,sizeof(short int)) ;
-      short int* upos = (short int* ) Mry_New(short int[2*n_pos]) ;
+      //short int* pos = (short int* ) Mry_NewIn(Mesh,short int[2*n_pos]) ;
+      short int* upos = (short int* ) Mry_NewIn(Mesh,short int[2*n_pos]) ;
       short int* epos = upos + n_pos ;
       
       for(ie = 0 ; ie < 2*n_pos ; ie++) upos[ie] = 0 ;
@@ -267,7 +267,7 @@ void Elements_DeleteMore(void* self)
     ShapeFcts_t* shapefcts = Elements_GetShapeFcts(elements) ;
     IntFcts_t* intfcts = Elements_GetIntFcts(elements) ;
     
-    free(upos) ;
+    Mry_Free(upos) ;
     Buffer_Delete(&buf) ;
     ShapeFcts_Delete(&shapefcts) ;
     IntFcts_Delete(&intfcts) ;
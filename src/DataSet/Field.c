@@ -54,8 +54,8 @@ void Field_Delete(void* self)
     }
   }
   
-  free(Field_GetType(field)) ;
-  free(field) ;
+  Mry_Free(Field_GetType(field)) ;
+  Mry_Free(field) ;
   
   *pfield = NULL ;
 }
@@ -196,13 +196,9 @@ void Field_Scan(Field_t* field,DataFile_t* datafile)
 #if 0
 FieldGrid_t* FieldGrid_Create(char* filename,int dim)
 {
-  FieldGrid_t* grid = (FieldGrid_t*) malloc(sizeof(FieldGrid_t)) ;
+  FieldGrid_t* grid = (FieldGrid_t*) Mry_NewIn(Mesh,FieldGrid_t) ;
   int    n_x = 1,n_y = 1,n_z = 1 ;
   
-  if(!grid) {
-    arret("FieldGrid_Create(1): allocation impossible") ;
-  }
-        
   /* Read the numbers */
   {
     DataFile_t* dfile = DataFile_Create(filename) ;
@@ -234,11 +230,7 @@ FieldGrid_t* FieldGrid_Create(char* filename,int dim)
   /* Allocation of memory space for the file name */
   {
     size_t sz = Field_MaxLengthOfFileName*sizeof(char) ;
-    char* name = (char*) malloc(sz) ;
-    
-    if(!name) {
-      arret("FieldGrid_Create(2): allocation impossible") ;
-    }
+    char* name = (char*) Mry_AllocateIn(sz,Mry_Category(Mesh)) ;
     
     FieldGrid_GetFileName(grid) = name ;
         
@@ -252,14 +244,10 @@ FieldGrid_t* FieldGrid_Create(char* filename,int dim)
   /* Allocation of memory space for the coordinate */
   {
     size_t sz = (n_x + n_y + n_z)*sizeof(double) ;
-    double* x = (double*) malloc(sz) ;
+    double* x = (double*) Mry_AllocateIn(sz,Mry_Category(Mesh)) ;
     double* y = x + n_x ;
     double* z = y + n_y ;
     
-    if(!x) {
-      arret("FieldGrid_Create(3): allocation impossible") ;
-    }
-
     FieldGrid_GetCoordinateAlongX(grid) = x ;
     FieldGrid_GetCoordinateAlongY(grid) = y ;
     FieldGrid_GetCoordinateAlongZ(grid) = z ;
@@ -274,11 +262,7 @@ FieldGrid_t* FieldGrid_Create(char* filename,int dim)
   /* Allocation of memory space for the values */
   {
     size_t sz = n_x*n_y*n_z*sizeof(double) ;
-    double* v = (double*) malloc(sz) ;
-    
-    if(!v) {
-      arret("FieldGrid_Create(4): allocation impossible") ;
-    }
+    double* v = (double*) Mry_AllocateIn(sz,Mry_Category(Mesh)) ;
     
     FieldGrid_GetValue(grid) = v ;
   }
@@ -469,8 +453,8 @@ void FieldAffine_Delete(void* self)
   FieldAffine_t** pfield = (FieldAffine_t**) self ;
   FieldAffine_t*   field = *pfield ;
   
-  free(FieldAffine_GetGradient(field)) ;
-  free(field) ;
+  Mry_Free(FieldAffine_GetGradient(field)) ;
+  Mry_Free(field) ;
   
   *pfield = NULL ;
 }
@@ -651,14 +635,12 @@ void lit_grille(FieldGrid_t* grille,int dim,char* nom)
   FieldGrid_GetNbOfPointsAlongZ(grille) = n_z ;
 
   /* reservation de la memoire */
-  FieldGrid_GetCoordinateAlongX(grille) = (double*) malloc((n_x+n_y+n_z)*sizeof(double)) ;
-  if(!FieldGrid_GetCoordinateAlongX(grille)) arret("lit_grille(3) : impossible d\'allouer la memoire") ;
+  FieldGrid_GetCoordinateAlongX(grille) = (double*) Mry_NewIn(Mesh,double[n_x+n_y+n_z]) ;
 
   FieldGrid_GetCoordinateAlongY(grille) = FieldGrid_GetCoordinateAlongX(grille) + n_x ;
   FieldGrid_GetCoordinateAlongZ(grille) = FieldGrid_GetCoordinateAlongY(grille) + n_y ;
 
-  FieldGrid_GetValue(grille) = (double*)   malloc(n_x*n_y*n_z*sizeof(double)) ;
-  if(!FieldGrid_GetValue(grille)) arret("lit_grille(4) : impossible d\'allouer la memoire") ;
+  FieldGrid_GetValue(grille) = (double*)   Mry_NewIn(Mesh,double[n_x*n_y*n_z]) ;
 
   /* lecture de la grille */
   if(n_x > 0) FieldGrid_GetCoordinateAlongX(grille)[0] = 0. ;
@@ -253,10 +253,8 @@ int Function_ReadInFile(Function_t* fn,char* line1)
 
     /* reservation de la memoire */
     {
-      double* t = (double*) malloc(n_points*sizeof(double)) ;
-      double* f = (double*) malloc(n_fonctions*n_points*sizeof(double)) ;
-      if(!t) arret("Function_ReadInFile: unable to allocate the memory") ;
-      if(!f) arret("Function_ReadInFile: unable to allocate the memory") ;
+      double* t = (double*) Mry_NewIn(Mesh,double[n_points]) ;
+      double* f = (double*) Mry_NewIn(Mesh,double[n_fonctions*n_points]) ;
     
       for(i = 0 ; i < n_fonctions ;i++) {
         Function_GetNbOfPoints(fn + i) = n_points ;
@@ -108,10 +108,8 @@ int lit_fonction(Function_t* fn,char* nom)
 
   /* reservation de la memoire */
   {
-    double* t = (double*) malloc(n_points*sizeof(double)) ;
-    double* f = (double*) malloc(n_fonctions*n_points*sizeof(double)) ;
-    if(!t) arret("lit_fonction(2) : impossible d\'allouer la memoire") ;
-    if(!f) arret("lit_fonction(3) : impossible d\'allouer la memoire") ;
+    double* t = (double*) Mry_NewIn(Mesh,double[n_points]) ;
+    double* f = (double*) Mry_NewIn(Mesh,double[n_fonctions*n_points]) ;
     
     for(i = 0 ; i < n_fonctions ;i++) {
       Function_GetNbOfPoints(fn + i) = n_points ;
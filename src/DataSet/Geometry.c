@@ -32,9 +32,11 @@ void Geometry_Delete(void* self)
   Geometry_t** pgeom = (Geometry_t**) self ;
   Geometry_t*   geom = *pgeom ;
   
-  Periodicities_Delete(&Geometry_GetPeriodicities(geom)) ;
+  if(Geometry_GetPeriodicities(geom)) {
+    Periodicities_Delete(&Geometry_GetPeriodicities(geom)) ;
+  }
   
-  free(geom) ;
+  Mry_Free(geom) ;
   
   *pgeom = NULL ;
 }
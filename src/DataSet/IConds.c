@@ -192,12 +192,8 @@ void   IConds_AssignInitialConditions(IConds_t* iconds,Mesh_t* mesh,double t)
       int i ;
       
       /* Work table */
-      work = (double*) malloc(n_nodes*sizeof(double)) ;
+      work = (double*) Mry_NewIn(Mesh,double[n_nodes]) ;
   
-      if(!work) {
-        arret("IConds_AssignInitialConditions(1): not enough memory") ;
-      }
-
       fic_ini = fopen(nom,"r") ;
       
       if(!fic_ini) {
@@ -253,6 +249,6 @@ void   IConds_AssignInitialConditions(IConds_t* iconds,Mesh_t* mesh,double t)
       }
     }
 
-    free(work) ;
+    Mry_Free(work) ;
   }
 }
@@ -61,11 +61,11 @@ void IntFct_Delete(void* self)
     char* p = IntFct_GetType(intfct) ;
     double* weight = IntFct_GetWeight(intfct) ;
     
-    free(p) ;
-    free(weight) ;
+    Mry_Free(p) ;
+    Mry_Free(weight) ;
   }
   
-  //free(intfct) ;
+  //Mry_Free(intfct) ;
 }
 
 
@@ -46,10 +46,10 @@ void IntFcts_Delete(void* self)
       IntFct_Delete(&intfct_i) ;
     }
     
-    free(intfct) ;
+    Mry_Free(intfct) ;
   }
   
-  free(intfcts) ;
+  Mry_Free(intfcts) ;
 }
 
 
@@ -14,6 +14,9 @@
 #include "Mry.h"
 
 
+static void  (IterProcess_CountFactorization)(IterProcess_t*,const int) ;
+
+
 
 
 IterProcess_t*  IterProcess_New(void)
@@ -37,6 +40,42 @@ IterProcess_t*  IterProcess_New(void)
     IterProcess_GetNbOfRepetitions(iterprocess) = 0 ;
     IterProcess_GetRepetitionIndex(iterprocess) = 0 ;
   }
+  
+  /* Factorization of the matrix (by default at each iteration) */
+  {
+    IterProcess_GetRefactorizationPeriod(iterprocess) = 1 ;
+    IterProcess_GetRefactorizationRate(iterprocess) = 0 ;
+    IterProcess_OrderToRefactorize(iterprocess) ;
+    IterProcess_GetNbOfFactorizations(iterprocess) = 0 ;
+    IterProcess_GetNbOfSavedFactorizations(iterprocess) = 0 ;
+  }
+  
+  /* Line search (none by default) */
+  {
+    IterProcess_GetMaxNbOfBacktrackings(iterprocess) = 0 ;
+  }
+  
+  /* Convergence on the residu (none by default) */
+  {
+    IterProcess_GetResidualTolerance(iterprocess) = 0 ;
+    IterProcess_GetResidualConvergence(iterprocess) = 0 ;
+  }
+  
+  /* Krylov solver of the jacobian-free resolution */
+  {
+    IterProcess_GetKrylovDimension(iterprocess) = 30 ;
+    IterProcess_GetMaxNbOfKrylovIterations(iterprocess) = 150 ;
+    IterProcess_GetKrylovTolerance(iterprocess) = 1.e-6 ;
+  }
+  
+  /* Statistics */
+  {
+    IterProcess_GetTotalNbOfIterations(iterprocess) = 0 ;
+    IterProcess_GetNbOfBacktrackings(iterprocess) = 0 ;
+    IterProcess_GetNbOfLimitedIncrements(iterprocess) = 0 ;
+    IterProcess_GetNbOfRejectedSteps(iterprocess) = 0 ;
+    IterProcess_GetNbOfSkippedResolutions(iterprocess) = 0 ;
+  }
 
   return(iterprocess) ;
 }
@@ -103,6 +142,122 @@ IterProcess_t*  IterProcess_Create(DataFile_t* datafile,ObVals_t* obvals)
       IterProcess_GetNbOfRepetitions(iterprocess) = i ;
     }
   }
+    
+  /* Reuse of the factorized matrix (modified Newton):
+   * Refactorization = k     refactorize every k iterations
+   * Convergence Rate = r    refactorize as soon as the error
+   *                         is not divided by at least 1/r */
+  {
+    int i ;
+    int n = String_FindAndScanExp(c,"Refactorization",","," = %d",&i) ;
+    
+    if(n) {
+      if(i < 0) {
+        arret("IterProcess_Create: negative refactorization period") ;
+      }
+      
+      IterProcess_GetRefactorizationPeriod(iterprocess) = i ;
+    }
+  }
+  
+  {
+    double rate ;
+    int n = String_FindAndScanExp(c,"Convergence Rate",","," = %lf",&rate) ;
+    
+    if(n) {
+      IterProcess_GetRefactorizationRate(iterprocess) = rate ;
+    }
+  }
+  
+  /* Backtracking line search on the norm of the residu:
+   * Line Search = n         at most n halvings of the Newton step */
+  {
+    int i ;
+    int n = String_FindAndScanExp(c,"Line Search",","," = %d",&i) ;
+    
+    if(n) {
+      if(i < 0) {
+        arret("IterProcess_Create: negative nb of halvings") ;
+      }
+      
+      IterProcess_GetMaxNbOfBacktrackings(iterprocess) = i ;
+    }
+  }
+  
+  /* Convergence on the residu:
+   * Residu = r              converged as soon as the residu of each
+   *                         equation, scaled by its value at the first
+   *                         iteration, is less than r */
+  {
+    double restol ;
+    int n = String_FindAndScanExp(c,"Residu",","," = %lf",&restol) ;
+    
+    if(n) {
+      if(restol < 0) {
+        arret("IterProcess_Create: negative tolerance on the residu") ;
+      }
+      
+      IterProcess_GetResidualTolerance(iterprocess) = restol ;
+    }
+  }
+  
+  /* Krylov solver of the jacobian-free resolution:
+   * Krylov Dimension = m    restart GMRES every m iterations
+   * Krylov Max Steps = n    at most n iterations per resolution
+   * Krylov Precision = e    relative tolerance on the residu
+   * (the keywords Iter and Tol are searched as substrings, hence
+   * the keywords above avoid them) */
+  {
+    int i ;
+    int n = String_FindAndScanExp(c,"Krylov Dimension",","," = %d",&i) ;
+    
+    if(n) {
+      if(i <= 0) {
+        arret("IterProcess_Create: the Krylov dimension must be positive") ;
+      }
+      
+      IterProcess_GetKrylovDimension(iterprocess) = i ;
+    }
+  }
+  
+  {
+    int i ;
+    int n = String_FindAndScanExp(c,"Krylov Max Steps",","," = %d",&i) ;
+    
+    if(n) {
+      if(i <= 0) {
+        arret("IterProcess_Create: the nb of Krylov iterations must be positive") ;
+      }
+      
+      IterProcess_GetMaxNbOfKrylovIterations(iterprocess) = i ;
+    }
+  }
+  
+  {
+    double tol ;
+    int n = String_FindAndScanExp(c,"Krylov Precision",","," = %lf",&tol) ;
+    
+    if(n) {
+      if(tol <= 0) {
+        arret("IterProcess_Create: the Krylov tolerance must be positive") ;
+      }
+      
+      IterProcess_GetKrylovTolerance(iterprocess) = tol ;
+    }
+  }
+  
+  if(IterProcess_IsResidualCheck(iterprocess)) {
+    int n_obj = ObVals_GetNbOfObVals(obvals) ;
+    double* scale = (double*) Mry_New(double[2*n_obj]) ;
+    
+    IterProcess_GetResidualScale(iterprocess) = scale ;
+  }
+  
+  if(IterProcess_GetRefactorizationPeriod(iterprocess) == 0) {
+    if(IterProcess_GetRefactorizationRate(iterprocess) <= 0) {
+      arret("IterProcess_Create: a convergence rate is needed") ;
+    }
+  }
 
 
   return(iterprocess) ;
@@ -114,43 +269,67 @@ int IterProcess_SetCurrentError(IterProcess_t* iterprocess,Nodes_t* nodes,Solver
 {
   double*   x     = Solver_GetSolution(solver) ;
   int       nrows = Solver_GetNbOfRows(solver) ;
-  ObVal_t*  obval = IterProcess_GetObVal(iterprocess) ;
-  Node_t*   node  = Nodes_GetNode(nodes) ;
-  unsigned int nb_nodes = Nodes_GetNbOfNodes(nodes) ;
+  int       n_dof = Nodes_GetNbOfDOF(nodes) ;
+  int*      colind = Nodes_GetMatrixColumnIndex(nodes) ;
+  double*   obval = Nodes_GetObjectiveValueOfDOF(nodes) ;
+  double*   u_n   = Nodes_GetPreviousUnknown(nodes) ;
   double err = 0. ;
   int    obvalindex = 0 ;
   int    nodeindex  = -1 ;
-  unsigned int i ;
-          
-  for(i = 0 ; i < nb_nodes ; i++) {
-    Node_t* nodi = node + i ;
-    int nin = Node_GetNbOfUnknowns(nodi) ;
-    int j ;
-            
-    for(j = 0 ; j < nin ; j++) {
-      int   k = Node_GetMatrixColumnIndex(nodi)[j] ;
+  int    dofindex   = -1 ;
+  
+  /* Max-norm over all the dof. Each thread reduces a chunk of
+   * the dof then the partial maxima are merged. */
+  #ifdef _OPENMP
+  #pragma omp parallel if(n_dof > Nodes_MinNbOfDOFForThreads)
+  #endif
+  {
+    double err_th = 0. ;
+    int    dof_th = -1 ;
+    int    i ;
+    
+    #ifdef _OPENMP
+    #pragma omp for schedule(static) nowait
+    #endif
+    for(i = 0 ; i < n_dof ; i++) {
+      int   k = colind[i] ;
               
       if(k >= 0) {
-        ObVal_t* obval_j = obval + Node_GetObValIndex(nodi)[j] ;
-        double val = ObVal_GetValue(obval_j) ;
-        double re = fabs(x[k])/val ;
+        double re = fabs(x[k])/obval[i] ;
                 
-        if(ObVal_IsRelativeValue(obval_j)) {
-          double* u_n = Node_GetPreviousUnknown(nodi) ;
-                  
-          if(fabs(u_n[j]) > 0.) re /= fabs(u_n[j]) ;
+        if(Nodes_ObjectiveValueOfDOFIsRelative(nodes,i)) {
+          if(fabs(u_n[i]) > 0.) re /= fabs(u_n[i]) ;
         }
 
         /* Sometimes re is strictly equal to zero hence the >= */
-        if(re >= err) {
-          err = re ;
-          obvalindex = Node_GetObValIndex(nodi)[j] ;
-          nodeindex = i ;
+        if(re >= err_th) {
+          err_th = re ;
+          dof_th = i ;
         }
       }
     }
+    
+    /* Keep the last dof of maximum error as in a serial loop */
+    #ifdef _OPENMP
+    #pragma omp critical
+    #endif
+    {
+      if(dof_th >= 0) {
+        if(err_th > err || (err_th == err && dof_th > dofindex)) {
+          err = err_th ;
+          dofindex = dof_th ;
+        }
+      }
+    }
+  }
+  
+  if(dofindex >= 0) {
+    obvalindex = Nodes_GetObValIndex(nodes)[dofindex] ;
+    nodeindex  = Nodes_FindNodeIndexOfDOF(nodes,dofindex) ;
   }
   
+  IterProcess_GetPreviousError(iterprocess) = IterProcess_GetCurrentError(iterprocess) ;
+  
   if(nrows > 0 && nodeindex < 0) {
     /* Raise an interrupt signal instead of exit */
     Message_Warning("IterProcess_SetCurrentError: can't compute error!") ;
@@ -174,6 +353,198 @@ void IterProcess_PrintCurrentError(IterProcess_t* iterprocess)
   int    iter = IterProcess_GetIterationIndex(iterprocess) ;
   int    inode = IterProcess_GetNodeIndexOfCurrentError(iterprocess) ;
 
+  if(IterProcess_GetResidualConvergence(iterprocess)) {
+    double res = IterProcess_GetResidualError(iterprocess) ;
+    
+    Message_Direct("  (%s[%d])Error = %4.2e Residu = %4.2e (%d iters)\n",name,inode,err,res,iter) ;
+    return ;
+  }
+  
   Message_Direct("  (%s[%d])Error = %4.2e (%d iters)\n",name,inode,err,iter) ;
   //Message_Direct("  (%s)Error = %4.2e (%d iters)\n",name,err,iter) ;
 }
+
+
+
+int IterProcess_MatrixIsToBeFactorized(IterProcess_t* iterprocess)
+/** Return 1 if the matrix must be computed and factorized at the current
+ *  iteration, 0 if the last factorization can be reused instead. */
+{
+  int    nfact = IterProcess_GetRefactorizationPeriod(iterprocess) ;
+  double rate  = IterProcess_GetRefactorizationRate(iterprocess) ;
+  int    age   = IterProcess_GetAgeOfFactorization(iterprocess) ;
+  int    iter  = IterProcess_GetIterationIndex(iterprocess) ;
+  int    refact = 0 ;
+  
+  if(age == 0) refact = 1 ;
+  
+  if(nfact > 0 && age >= nfact) refact = 1 ;
+  
+  /* The convergence rate is only known from the 3rd iteration of a step */
+  if(rate > 0 && iter > 2) {
+    double err  = IterProcess_GetCurrentError(iterprocess) ;
+    double err0 = IterProcess_GetPreviousError(iterprocess) ;
+    
+    if(err > rate*err0) refact = 1 ;
+  }
+  
+  IterProcess_CountFactorization(iterprocess,refact) ;
+  
+  return(refact) ;
+}
+
+
+
+int IterProcess_PreconditionerIsToBeUpdated(IterProcess_t* iterprocess)
+/** Return 1 if the matrix used as preconditioner by the jacobian-free
+ *  resolution must be computed and factorized at the current iteration,
+ *  0 otherwise. The matrix is updated at the first iteration of each
+ *  step, the refactorization period being ignored. */
+{
+  double rate  = IterProcess_GetRefactorizationRate(iterprocess) ;
+  int    age   = IterProcess_GetAgeOfFactorization(iterprocess) ;
+  int    iter  = IterProcess_GetIterationIndex(iterprocess) ;
+  int    refact = 0 ;
+  
+  if(age == 0 || iter == 1) refact = 1 ;
+  
+  if(rate > 0 && iter > 2) {
+    double err  = IterProcess_GetCurrentError(iterprocess) ;
+    double err0 = IterProcess_GetPreviousError(iterprocess) ;
+    
+    if(err > rate*err0) refact = 1 ;
+  }
+  
+  IterProcess_CountFactorization(iterprocess,refact) ;
+  
+  return(refact) ;
+}
+
+
+
+int IterProcess_ResidualConvergenceIsMet(IterProcess_t* iterprocess,Nodes_t* nodes,Solver_t* solver)
+/** Check the convergence on the residu stored in the right hand side
+ *  of the solver. The max of the residu over the dof of each objective
+ *  value is scaled by its value at the first iteration of the step.
+ *  Return 1 if the greatest scaled residu is less than the tolerance on
+ *  the residu and the last correction was small, 0 otherwise. */
+{
+  if(!IterProcess_IsResidualCheck(iterprocess)) return(0) ;
+  
+  {
+    double*   r      = Solver_GetRHS(solver) ;
+    int       n_dof  = Nodes_GetNbOfDOF(nodes) ;
+    int*      colind = Nodes_GetMatrixColumnIndex(nodes) ;
+    unsigned short* obvalindex = Nodes_GetObValIndex(nodes) ;
+    int       n_obj  = ObVals_GetNbOfObVals(IterProcess_GetObVals(iterprocess)) ;
+    double*   scale  = IterProcess_GetResidualScale(iterprocess) ;
+    double*   rmax   = scale + n_obj ;
+    int       iter   = IterProcess_GetIterationIndex(iterprocess) ;
+    double    err = 0 ;
+    int i ;
+    
+    for(i = 0 ; i < n_obj ; i++) rmax[i] = 0 ;
+    
+    for(i = 0 ; i < n_dof ; i++) {
+      int   k = colind[i] ;
+      
+      if(k >= 0) {
+        int    j = obvalindex[i] ;
+        double a = fabs(r[k]) ;
+        
+        if(a > rmax[j]) rmax[j] = a ;
+      }
+    }
+    
+    if(iter == 1) {
+      for(i = 0 ; i < n_obj ; i++) scale[i] = rmax[i] ;
+      
+      IterProcess_GetResidualError(iterprocess) = 1 ;
+      
+      return(0) ;
+    }
+    
+    /* A residu not vanishing at the first iteration is not scaled */
+    for(i = 0 ; i < n_obj ; i++) {
+      double e = (scale[i] > 0) ? rmax[i]/scale[i] : rmax[i] ;
+      
+      if(e > err) err = e ;
+    }
+    
+    IterProcess_GetResidualError(iterprocess) = err ;
+    
+    if(err < IterProcess_GetResidualTolerance(iterprocess)) {
+      if(IterProcess_ResidualConvergenceMayBeMet(iterprocess)) {
+        IterProcess_GetResidualConvergence(iterprocess) = 1 ;
+        IterProcess_GetNbOfSkippedResolutions(iterprocess) += 1 ;
+        
+        return(1) ;
+      }
+    }
+  }
+  
+  return(0) ;
+}
+
+
+
+void IterProcess_PrintStatistics(IterProcess_t* iterprocess)
+{
+  unsigned long nbfact  = IterProcess_GetNbOfFactorizations(iterprocess) ;
+  unsigned long nbsaved = IterProcess_GetNbOfSavedFactorizations(iterprocess) ;
+  unsigned long nbiter  = IterProcess_GetTotalNbOfIterations(iterprocess) ;
+  unsigned long nbrej   = IterProcess_GetNbOfRejectedSteps(iterprocess) ;
+  unsigned long nbbt    = IterProcess_GetNbOfBacktrackings(iterprocess) ;
+  unsigned long nblim   = IterProcess_GetNbOfLimitedIncrements(iterprocess) ;
+  
+  /* The statistics are printed only for the features in use */
+  if(IterProcess_GetRefactorizationPeriod(iterprocess) != 1 || IterProcess_GetRefactorizationRate(iterprocess) > 0) {
+    Message_Info("%lu iterations, %lu rejected time steps\n",nbiter,nbrej) ;
+    Message_Info("%lu matrix factorizations (%lu saved by reuse)\n",nbfact,nbsaved) ;
+  }
+  
+  /* Line search and trust limits of the increments */
+  {
+    ObVals_t* obvals = IterProcess_GetObVals(iterprocess) ;
+    ObVal_t* obval = ObVals_GetObVal(obvals) ;
+    int n_obj = ObVals_GetNbOfObVals(obvals) ;
+    int islimited = 0 ;
+    int i ;
+    
+    for(i = 0 ; i < n_obj ; i++) {
+      if(ObVal_IncrementIsLimited(obval + i)) islimited = 1 ;
+    }
+    
+    if(IterProcess_IsLineSearch(iterprocess) || islimited) {
+      Message_Info("%lu step halvings, %lu limited increments\n",nbbt,nblim) ;
+    }
+  }
+  
+  if(IterProcess_GetNbOfKrylovIterations(iterprocess)) {
+    unsigned long nbkry = IterProcess_GetNbOfKrylovIterations(iterprocess) ;
+    
+    Message_Info("%lu Krylov iterations\n",nbkry) ;
+  }
+  
+  if(IterProcess_IsResidualCheck(iterprocess)) {
+    unsigned long nbskip = IterProcess_GetNbOfSkippedResolutions(iterprocess) ;
+    
+    Message_Info("%lu final resolutions skipped by the check on the residu\n",nbskip) ;
+  }
+}
+
+
+
+/* Intern functions */
+
+void (IterProcess_CountFactorization)(IterProcess_t* iterprocess,const int refact)
+/** Update the age of the factorization and the statistics. */
+{
+  if(refact) {
+    IterProcess_GetAgeOfFactorization(iterprocess) = 1 ;
+    IterProcess_GetNbOfFactorizations(iterprocess) += 1 ;
+  } else {
+    IterProcess_GetAgeOfFactorization(iterprocess) += 1 ;
+    IterProcess_GetNbOfSavedFactorizations(iterprocess) += 1 ;
+  }
+}
@@ -16,6 +16,10 @@ extern IterProcess_t*  IterProcess_New(void) ;
 extern IterProcess_t*  IterProcess_Create(DataFile_t*,ObVals_t*) ;
 extern int             IterProcess_SetCurrentError(IterProcess_t*,Nodes_t*,Solver_t*) ;
 extern void            IterProcess_PrintCurrentError(IterProcess_t*) ;
+extern int             IterProcess_MatrixIsToBeFactorized(IterProcess_t*) ;
+extern int             IterProcess_PreconditionerIsToBeUpdated(IterProcess_t*) ;
+extern int             IterProcess_ResidualConvergenceIsMet(IterProcess_t*,Nodes_t*,Solver_t*) ;
+extern void            IterProcess_PrintStatistics(IterProcess_t*) ;
 
 
 #define IterProcess_GetNbOfIterations(IPR)           ((IPR)->niter)
@@ -27,6 +31,26 @@ extern void            IterProcess_PrintCurrentError(IterProcess_t*) ;
 #define IterProcess_GetObValIndexOfCurrentError(IPR) ((IPR)->obvalindex)
 #define IterProcess_GetNodeIndexOfCurrentError(IPR)  ((IPR)->nodeindex)
 #define IterProcess_GetObVals(IPR)                   ((IPR)->obvals)
+#define IterProcess_GetPreviousError(IPR)            ((IPR)->preverror)
+#define IterProcess_GetRefactorizationPeriod(IPR)    ((IPR)->nfact)
+#define IterProcess_GetRefactorizationRate(IPR)      ((IPR)->rate)
+#define IterProcess_GetAgeOfFactorization(IPR)       ((IPR)->agefact)
+#define IterProcess_GetNbOfFactorizations(IPR)       ((IPR)->nbfact)
+#define IterProcess_GetNbOfSavedFactorizations(IPR)  ((IPR)->nbsavedfact)
+#define IterProcess_GetMaxNbOfBacktrackings(IPR)     ((IPR)->nbtmax)
+#define IterProcess_GetTotalNbOfIterations(IPR)      ((IPR)->nbiter)
+#define IterProcess_GetNbOfBacktrackings(IPR)        ((IPR)->nbbacktrack)
+#define IterProcess_GetNbOfLimitedIncrements(IPR)    ((IPR)->nblimited)
+#define IterProcess_GetNbOfRejectedSteps(IPR)        ((IPR)->nbrejected)
+#define IterProcess_GetNbOfKrylovIterations(IPR)     ((IPR)->nbkrylov)
+#define IterProcess_GetResidualTolerance(IPR)        ((IPR)->restol)
+#define IterProcess_GetResidualError(IPR)            ((IPR)->reserror)
+#define IterProcess_GetResidualScale(IPR)            ((IPR)->resscale)
+#define IterProcess_GetResidualConvergence(IPR)      ((IPR)->resconv)
+#define IterProcess_GetNbOfSkippedResolutions(IPR)   ((IPR)->nbskipped)
+#define IterProcess_GetKrylovDimension(IPR)          ((IPR)->krylovdim)
+#define IterProcess_GetMaxNbOfKrylovIterations(IPR)  ((IPR)->krylovitermax)
+#define IterProcess_GetKrylovTolerance(IPR)          ((IPR)->krylovtol)
 
 
 
@@ -36,7 +60,9 @@ extern void            IterProcess_PrintCurrentError(IterProcess_t*) ;
 
 /* Operations on iterations */
 #define IterProcess_IncrementIterationIndex(IPR) \
-        (IterProcess_GetIterationIndex(IPR)++)
+        (IterProcess_GetResidualConvergence(IPR) = 0, \
+         IterProcess_GetTotalNbOfIterations(IPR)++, \
+         IterProcess_GetIterationIndex(IPR)++)
 
 #define IterProcess_LastIterationIsNotReached(IPR) \
         (IterProcess_GetIterationIndex(IPR) < IterProcess_GetNbOfIterations(IPR))
@@ -47,7 +73,8 @@ extern void            IterProcess_PrintCurrentError(IterProcess_t*) ;
 
 /* Operations on repetitions */
 #define IterProcess_IncrementRepetitionIndex(IPR) \
-       (IterProcess_GetRepetitionIndex(IPR)++)
+       (IterProcess_GetNbOfRejectedSteps(IPR)++, \
+        IterProcess_GetRepetitionIndex(IPR)++)
 
 #define IterProcess_LastRepetitionIsNotReached(IPR) \
         (IterProcess_GetRepetitionIndex(IPR) < IterProcess_GetNbOfRepetitions(IPR))
@@ -58,12 +85,42 @@ extern void            IterProcess_PrintCurrentError(IterProcess_t*) ;
 
 /* Operations on convergence */
 #define IterProcess_ConvergenceIsMet(IPR) \
-        (IterProcess_GetCurrentError(IPR) < IterProcess_GetTolerance(IPR))
+        (IterProcess_GetCurrentError(IPR) < IterProcess_GetTolerance(IPR) || \
+         IterProcess_GetResidualConvergence(IPR))
 
 #define IterProcess_ConvergenceIsNotMet(IPR) \
         (!IterProcess_ConvergenceIsMet(IPR))
 
 
+/* Operations on the factorization of the matrix */
+#define IterProcess_OrderToRefactorize(IPR) \
+        (IterProcess_GetAgeOfFactorization(IPR) = 0)
+
+
+/* Operations on the line search */
+#define IterProcess_IsLineSearch(IPR) \
+        (IterProcess_GetMaxNbOfBacktrackings(IPR) > 0)
+
+/* Armijo's condition of sufficient decrease of the residual norm */
+#define IterProcess_LineSearchSufficientDecrease  (1.e-4)
+
+
+/* Operations on the convergence on the residu.
+ * The residu of each equation is scaled by its value at the first
+ * iteration of the step. The check only applies if the last correction
+ * was within this factor of the tolerance. */
+#define IterProcess_ResidualCheckCorrectionFactor  (10.)
+
+#define IterProcess_IsResidualCheck(IPR) \
+        (IterProcess_GetResidualTolerance(IPR) > 0)
+
+#define IterProcess_ResidualConvergenceMayBeMet(IPR) \
+        (IterProcess_IsResidualCheck(IPR) && \
+         IterProcess_GetIterationIndex(IPR) > 1 && \
+         IterProcess_GetCurrentError(IPR) < \
+         IterProcess_ResidualCheckCorrectionFactor*IterProcess_GetTolerance(IPR))
+
+
 /* Error on which unknown? */
 #define IterProcess_GetNameOfTheCurrentError(IPR) \
         (ObVal_GetNameOfUnknown(IterProcess_GetObVal(IPR) + IterProcess_GetObValIndexOfCurrentError(IPR)))
@@ -79,6 +136,26 @@ struct IterProcess_s {        /* Iterative process */
   int    obvalindex ;         /* Objective value index pertaining to the greatest error */
   int    nodeindex ;          /* Node index pertaining to the greatest error */
   ObVals_t* obvals ;          /* Objective variations */
+  double preverror ;          /* Error at the previous iteration */
+  int    nfact ;              /* Refactorize the matrix every nfact iterations (0 = never) */
+  double rate ;               /* Refactorize if the error ratio exceeds this rate */
+  int    agefact ;            /* Nb of iterations using the current factorization (0 if none) */
+  unsigned long nbfact ;      /* Nb of factorizations */
+  unsigned long nbsavedfact ; /* Nb of factorizations saved by reuse */
+  int    nbtmax ;             /* Max nb of step halvings in the line search */
+  unsigned long nbiter ;      /* Total nb of iterations */
+  unsigned long nbbacktrack ; /* Nb of step halvings */
+  unsigned long nblimited ;   /* Nb of increments reduced by their limit */
+  unsigned long nbrejected ;  /* Nb of rejected time steps */
+  unsigned long nbkrylov ;    /* Nb of Krylov iterations (jacobian-free resolution) */
+  double restol ;             /* Tolerance on the scaled residu (0 = no check) */
+  double reserror ;           /* Current scaled residu */
+  double* resscale ;          /* Scales of the residu per objective value */
+  int    resconv ;            /* Convergence met on the residu (1) or not (0) */
+  unsigned long nbskipped ;   /* Nb of resolutions skipped by the check on the residu */
+  int    krylovdim ;          /* Dimension of the Krylov subspace (jacobian-free resolution) */
+  int    krylovitermax ;      /* Max nb of Krylov iterations per resolution */
+  double krylovtol ;          /* Relative tolerance of the Krylov solver */
 } ;
 
 #endif
@@ -74,11 +74,11 @@ void Material_Delete(void* self)
   Material_t** pmaterial = (Material_t**) self ;
   Material_t*   material = *pmaterial ;
   
-  free(Material_GetCodeNameOfModel(material)) ;
+  Mry_Free(Material_GetCodeNameOfModel(material)) ;
   GenericData_Delete(&Material_GetGenericData(material)) ;
   Curves_Delete(&Material_GetCurves(material)) ;
-  free(Material_GetMethod(material)) ;
-  free(material) ;
+  Mry_Free(Material_GetMethod(material)) ;
+  Mry_Free(material) ;
   *pmaterial = NULL ;
 }
 
@@ -276,7 +276,16 @@ void (Material_ScanProperties)(Material_t* mat,DataFile_t* datafile,int (*pm)(co
 {
   int    nd = Material_GetNbOfProperties(mat) ;
   short int    cont = 1 ;
-  
+
+  /* Keep pm in the model so that the properties can be found by name */
+  {
+    Model_t* model = Material_GetModel(mat) ;
+
+    if(pm && model && !Model_GetComputePropertyIndex(model)) {
+      Model_GetComputePropertyIndex(model) = pm ;
+    }
+  }
+
 
   while(cont) {
     char   mot[Material_MaxLengthOfKeyWord] = {'\n'} ;
@@ -347,6 +356,32 @@ void (Material_ScanProperties)(Material_t* mat,DataFile_t* datafile,int (*pm)(co
     
   }
 
+  /* Properties overriding those of the data file (see Sweep.h) */
+  if(pm && Material_GetPropertyOverrides(mat)) {
+    char* line = Material_GetPropertyOverrides(mat) ;
+    
+    while(line && *line) {
+      char   mot[Material_MaxLengthOfKeyWord] = {'\0'} ;
+      char*  p = String_FindChar(line,'=') ;
+      
+      String_Scan(line," %[^= ]",mot) ;
+      
+      if(p) {
+        int i = (*pm)(mot) ;
+        
+        if(i >= 0) {
+          String_Scan(p+1,"%lf",Material_GetProperty(mat) + i) ;
+          nd = (nd > i + 1) ? nd : i + 1 ;
+        } else {
+          Message_RuntimeError("%s is not known",mot) ;
+        }
+      }
+      
+      line = String_FindEndOfLine(line) ;
+      if(line) line++ ;
+    }
+  }
+
   Material_GetNbOfProperties(mat) = nd ;
   return ;
 }
@@ -43,6 +43,7 @@ extern void        (Material_ScanProperties2) (Material_t*,FILE*,Model_ComputePr
 #define Material_GetGenericData(MAT)      ((MAT)->genericdata)
 #define Material_GetUsedModels(MAT)       ((MAT)->models)
 #define Material_GetModelIndex(MAT)       ((MAT)->modelindex)
+#define Material_GetPropertyOverrides(MAT) ((MAT)->propoverrides)
 
 
 
@@ -117,6 +118,9 @@ extern void        (Material_ScanProperties2) (Material_t*,FILE*,Model_ComputePr
 #define Material_FindData(MAT,...) \
         GenericData_FindData(Material_GetGenericData(MAT),__VA_ARGS__)
         
+#define Material_FindDataWithHandle(MAT,...) \
+        GenericData_FindDataWithHandle(Material_GetGenericData(MAT),__VA_ARGS__)
+        
 #define Material_AppendData(MAT,...) \
         Material_AppendGenericData(MAT,GenericData_Create(__VA_ARGS__))
 
@@ -142,6 +146,7 @@ struct Material_s {           /* material */
   Models_t* models ;          /**< Used models */
   Model_t* model ;            /**< Model */
   int modelindex ;            /**< Model index */
+  char* propoverrides ;       /**< Lines "name = value" overriding the data file */
   
   /* for compatibility with former version (should be eliminated) */
   unsigned short int neq ;    /**< nombre d'equations du modele */
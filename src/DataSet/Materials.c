@@ -12,6 +12,9 @@
 #include "Mry.h"
 
 
+static void  (Materials_SetFilePosition)(DataFile_t*,int) ;
+
+
 /* Extern functions */
 
 Materials_t* (Materials_New)(const int n_mats)
@@ -188,19 +191,8 @@ Materials_t* (Materials_Create)(DataFile_t* datafile,Geometry_t* geom,Fields_t*
     
     for(i = 0 ; i < n_mats ; i++) {
       Material_t* mat = Materials_GetMaterial(materials) + i ;
-      char* c = DataFile_FindNthToken(datafile,"MATE,Material",",",i + 1) ;
-      
-      c = String_SkipLine(c) ;
       
-      /* This for Material_ScanProperties1/2 */
-      {
-        DataFile_SetFilePositionAfterKey(datafile,"MATE,Material",",",i + 1) ;
-        {
-          char* c1 = DataFile_ReadLineFromCurrentFilePosition(datafile) ;
-        }
-      }
-      
-      DataFile_SetCurrentPositionInFileContent(datafile,c) ;
+      Materials_SetFilePosition(datafile,i) ;
   
       Message_Direct("Enter in %s %d","Material",i+1) ;
       Message_Direct("\n") ;
@@ -217,3 +209,73 @@ Materials_t* (Materials_Create)(DataFile_t* datafile,Geometry_t* geom,Fields_t*
   return(materials) ;
 }
 #endif
+
+
+
+void (Materials_RescanMaterial)(Materials_t* materials,DataFile_t* datafile,Geometry_t* geom,int i)
+/** Scan again the material i in the data file, e.g. after its property
+ *  overrides have changed. The material keeps its place so that the
+ *  elements still point to it. */
+{
+  Material_t* mat = Materials_GetMaterial(materials) + i ;
+  Material_t* newmat = Material_New() ;
+  
+  Material_GetUsedModels(newmat) = Material_GetUsedModels(mat) ;
+  Material_GetFields(newmat) = Material_GetFields(mat) ;
+  Material_GetFunctions(newmat) = Material_GetFunctions(mat) ;
+  Material_GetPropertyOverrides(newmat) = Material_GetPropertyOverrides(mat) ;
+  
+  DataFile_OpenFile(datafile,"r") ;
+  
+  Materials_SetFilePosition(datafile,i) ;
+  
+  Material_Scan(newmat,datafile,geom) ;
+  
+  DataFile_CloseFile(datafile) ;
+  
+  /* Swap the contents so that newmat holds the former ones */
+  {
+    Material_t oldmat = *mat ;
+    
+    *mat = *newmat ;
+    *newmat = oldmat ;
+  }
+  
+  /* Delete the former contents. The used models, fields and functions
+   * are shared. The data sets stored by the models have no destructor
+   * (see TypeId_Delete) and are kept. */
+  {
+    GenericData_t* gdat = Material_GetGenericData(newmat) ;
+    
+    for(gdat = GenericData_First(gdat) ; gdat ; gdat = GenericData_GetNextGenericData(gdat)) {
+      if(TypeId_Is(GenericData_GetTypeId(gdat),DataSet_t)) {
+        GenericData_GetData(gdat) = NULL ;
+      }
+    }
+    
+    Material_Delete(&newmat) ;
+  }
+}
+
+
+
+/* Intern functions */
+
+void (Materials_SetFilePosition)(DataFile_t* datafile,int i)
+/** Set the current position in the file content after the line
+ *  of the (i + 1)-th keyword of a material */
+{
+  char* c = DataFile_FindNthToken(datafile,"MATE,Material",",",i + 1) ;
+  
+  c = String_SkipLine(c) ;
+  
+  /* This for Material_ScanProperties1/2 */
+  {
+    DataFile_SetFilePositionAfterKey(datafile,"MATE,Material",",",i + 1) ;
+    {
+      char* c1 = DataFile_ReadLineFromCurrentFilePosition(datafile) ;
+    }
+  }
+  
+  DataFile_SetCurrentPositionInFileContent(datafile,c) ;
+}
@@ -1,9 +1,20 @@
+/* mmap, open and fstat (POSIX) */
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
 #include <strings.h>
 #include <assert.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef _POSIX_MAPPED_FILES
+#include <sys/mman.h>
+#endif
 #include "Symmetry.h"
 #include "Elements.h"
 #include "Nodes.h"
@@ -33,6 +44,51 @@ extern void   mc43ad_(int*,int*,int*,int*,int*,int*,int*,int*,int*,int*,int*) ;
   }
 #endif
 
+/* Mesh file under the format GMSH mapped in memory */
+struct gmsh_File_s ; typedef struct gmsh_File_s gmsh_File_t ;
+
+struct gmsh_File_s {
+  char*   begin ;
+  char*   end ;
+  char*   c ;              /* current position */
+  int     binary ;
+  int     datasize ;       /* size of size_t in binary files */
+} ;
+
+#define gmsh_FileGetBegin(GF)              ((GF)->begin)
+#define gmsh_FileGetEnd(GF)                ((GF)->end)
+#define gmsh_FileGetCurrentPosition(GF)    ((GF)->c)
+#define gmsh_FileIsBinary(GF)              ((GF)->binary)
+#define gmsh_FileGetDataSize(GF)           ((GF)->datasize)
+
+#define gmsh_IsSpace(C) \
+        ((C) == ' ' || (C) == '\n' || (C) == '\r' || (C) == '\t')
+
+#define gmsh_IsDigit(C) \
+        ((C) >= '0' && (C) <= '9')
+
+
+/* Nodes and elements as read in a GMSH file */
+struct gmsh_Data_s ; typedef struct gmsh_Data_s gmsh_Data_t ;
+
+struct gmsh_Data_s {
+  int     nbofnodes ;
+  int*    nodetag ;
+  double* coordinate ;     /* 3 per node */
+  int     nbofelements ;
+  int     maxnbofelements ;
+  int*    elementtag ;
+  int*    elementtype ;
+  int*    physical ;
+  int*    elementary ;
+  int     nbofelementnodes ;
+  int     maxnbofelementnodes ;
+  int*    elementnode ;    /* node tags of the elements */
+  int     nbofentities[4] ;
+  int*    entitytag[4] ;   /* pairs (tag,physical) per dimension */
+} ;
+
+
 static int*      (Mesh_ComputeInversePermutationOfNodes)(Mesh_t*,const char*) ;
 static int*      (Mesh_ComputeInversePermutationOfElements)(Mesh_t*,const char*) ;
 static Graph_t*  (Mesh_CreateGraph)(Mesh_t*) ;
@@ -46,7 +102,7 @@ static void   Mesh_ReadInline1d(Mesh_t*,char*) ;
 
 static void   Mesh_ReadFormatGmsh(Mesh_t*,const char*) ;
 static void   Mesh_ReadFormatGmsh_1(Mesh_t*,const char*) ;
-static void   Mesh_ReadFormatGmsh_2(Mesh_t*,const char*) ;
+static void   Mesh_ReadFormatGmsh_2(Mesh_t*,gmsh_File_t*) ;
 static void   Mesh_Readm1d(Mesh_t*,const char*) ;
 static void   Mesh_ReadFormatCesar(Mesh_t*,const char*) ;
 
@@ -58,6 +114,31 @@ static int    gmsh_ElmType(int,int) ;
 static int    gmsh_NbNodes(int) ;
 static int    gmsh_DimElement(int) ;
 
+static gmsh_File_t* gmsh_FileCreate(const char*) ;
+static void     gmsh_FileDelete(gmsh_File_t*) ;
+static void     gmsh_SkipSpaces(gmsh_File_t*) ;
+static void     gmsh_SkipLine(gmsh_File_t*) ;
+static void     gmsh_ReadSectionName(gmsh_File_t*,const char*) ;
+static char*    gmsh_FindNextSection(gmsh_File_t*) ;
+static void     gmsh_SkipSection(gmsh_File_t*) ;
+static long int gmsh_ReadAsciiInteger(gmsh_File_t*) ;
+static double   gmsh_ReadAsciiReal(gmsh_File_t*) ;
+static int      gmsh_ReadInt(gmsh_File_t*) ;
+static size_t   gmsh_ReadSize(gmsh_File_t*) ;
+static double   gmsh_ReadReal(gmsh_File_t*) ;
+static void     gmsh_ReadBinary(gmsh_File_t*,void*,size_t) ;
+
+static int*     gmsh_DataAddElement(gmsh_Data_t*,int,int,int,int) ;
+static void     gmsh_DataReserveElements(gmsh_Data_t*,int) ;
+static void     gmsh_DataReserveNodes(gmsh_Data_t*,int) ;
+static void     gmsh_DataFree(gmsh_Data_t*) ;
+static int      gmsh_DataFindPhysical(gmsh_Data_t*,int,int) ;
+static void     gmsh_ReadNodes_2(gmsh_File_t*,gmsh_Data_t*) ;
+static void     gmsh_ReadNodes_4(gmsh_File_t*,gmsh_Data_t*) ;
+static void     gmsh_ReadElements_2(gmsh_File_t*,gmsh_Data_t*) ;
+static void     gmsh_ReadElements_4(gmsh_File_t*,gmsh_Data_t*) ;
+static void     gmsh_ReadEntities_4(gmsh_File_t*,gmsh_Data_t*) ;
+
 
 
 
@@ -68,11 +149,11 @@ static int    gmsh_DimElement(int) ;
 
 Mesh_t*  Mesh_New(void)
 {
-  Mesh_t* mesh = (Mesh_t*) Mry_New(Mesh_t) ;
+  Mesh_t* mesh = (Mesh_t*) Mry_NewIn(Mesh,Mesh_t) ;
   
-  Mesh_GetElements(mesh) = (Elements_t*) Mry_New(Elements_t) ;
+  Mesh_GetElements(mesh) = (Elements_t*) Mry_NewIn(Mesh,Elements_t) ;
   
-  Mesh_GetNodes(mesh) = (Nodes_t*) Mry_New(Nodes_t) ;
+  Mesh_GetNodes(mesh) = (Nodes_t*) Mry_NewIn(Mesh,Nodes_t) ;
   
   return(mesh) ;
 }
@@ -82,7 +163,7 @@ Mesh_t*  Mesh_New(void)
 Mesh_t*  Mesh_Create(DataFile_t* datafile,Materials_t* materials,Geometry_t* geometry)
 {
   //Mesh_t* mesh = Mesh_New() ;
-  Mesh_t* mesh = (Mesh_t*) Mry_New(Mesh_t) ;
+  Mesh_t* mesh = (Mesh_t*) Mry_NewIn(Mesh,Mesh_t) ;
   
   {
     char* filecontent = DataFile_GetFileContent(datafile) ;
@@ -162,14 +243,14 @@ void Mesh_Delete(void* self)
     Nodes_t* nodes = Mesh_GetNodes(mesh) ;
     Elements_t* elts = Mesh_GetElements(mesh) ;
     
-    Mesh_DeleteMore(pmesh) ;
+    /* The pointers to elements are freed by Nodes_Delete */
     Nodes_DeleteMore(&nodes) ;
     Elements_DeleteMore(&elts) ;
     Nodes_Delete(&nodes) ;
     Elements_Delete(&elts) ;
   }
   
-  free(mesh) ;
+  Mry_Free(mesh) ;
 }
 
 
@@ -183,7 +264,7 @@ void Mesh_DeleteMore(void* self)
     Node_t* node = Mesh_GetNode(mesh) ;
     Element_t** pel = Node_GetPointerToElement(node) ;
     
-    free(pel) ;
+    Mry_Free(pel) ;
   }
 }
 
@@ -274,7 +355,7 @@ void Mesh_CreateMore(Mesh_t* mesh)
   /* Allocation of space for the pointers to elements */
   {
     int nc = Mesh_GetNbOfConnectivities(mesh) ;
-    Element_t** pel = (Element_t**) Mry_New(Element_t*[nc]) ;
+    Element_t** pel = (Element_t**) Mry_NewIn(Mesh,Element_t*[nc]) ;
     int nno = Mesh_GetNbOfNodes(mesh) ;
     Node_t* node = Mesh_GetNode(mesh) ;
     
@@ -344,11 +425,7 @@ Graph_t* Mesh_CreateGraph(Mesh_t* mesh)
   {
     int    n_no = Mesh_GetNbOfNodes(mesh) ;
     /* Nb of connections per node (useful to size graph) */
-    int*   nnz_no = (int*) calloc(n_no,sizeof(int)) ;
-  
-    if(!nnz_no) {
-      arret("Mesh_CreateGraph(1): impossible d\'allouer la memoire") ;
-    }
+    int*   nnz_no = (int*) Mry_NewIn(Mesh,int[n_no]) ;
   
   
     /* An overestimation of nnz_no */
@@ -372,7 +449,7 @@ Graph_t* Mesh_CreateGraph(Mesh_t* mesh)
     
     graph = Graph_Create(n_no,nnz_no) ;
 
-    free(nnz_no) ;
+    Mry_Free(nnz_no) ;
   }
 
 
@@ -658,7 +735,7 @@ void   Mesh_WriteInversePermutation(Mesh_t* mesh,const char* nom,const char* for
         fprintf(fic_iperm,"%d\n",iperm[i] - 1) ;
       }
         
-      free(iperm) ;
+      Mry_Free(iperm) ;
     } else if(!strcmp(format,"hsl_mc43")) {
       int    nelt = Mesh_GetNbOfNodes(mesh) ;
       int*   norder = Mesh_ComputeInversePermutationOfElements(mesh,format) ;
@@ -668,7 +745,7 @@ void   Mesh_WriteInversePermutation(Mesh_t* mesh,const char* nom,const char* for
         fprintf(fic_iperm,"%d\n",norder[i] - 1) ;
       }
       
-      free(norder) ;
+      Mry_Free(norder) ;
     }
   
     fclose(fic_iperm) ;
@@ -679,23 +756,15 @@ void   Mesh_WriteInversePermutation(Mesh_t* mesh,const char* nom,const char* for
 int*   Mesh_ComputeInversePermutationOfNodes(Mesh_t* mesh,const char* format)
 {
   int    n_no = Mesh_GetNbOfNodes(mesh) ;
-  int*   iperm = (int*) malloc(n_no*sizeof(int)) ;
-  
-  if(!iperm) {
-    arret("Mesh_ComputeInversePermutationOfNodes(1): not enough memory") ;
-  }
+  int*   iperm = (int*) Mry_NewIn(Mesh,int[n_no]) ;
   
   
   if(!strcmp(format,"hsl") || !strcmp(format,"hsl_mc40")) {
     Graph_t*  graph = Mesh_CreateGraph(mesh) ;
     int    nnz  = Graph_GetNbOfEdges(graph) ;
-    int*   irn = (int*) malloc(2*nnz*sizeof(int)) ;
-    int*   jcn = (int*) malloc(nnz*sizeof(int)) ;
+    int*   irn = (int*) Mry_NewIn(Mesh,int[2*nnz]) ;
+    int*   jcn = (int*) Mry_NewIn(Mesh,int[nnz]) ;
   
-    if(!irn || !jcn) {
-      arret("Mesh_ComputeInversePermutationOfNodes(2): not enough memory") ;
-    }
-
     /* Compute the row and column indexes: irn and jcn */
     {
       int  in ;
@@ -725,13 +794,9 @@ int*   Mesh_ComputeInversePermutationOfNodes(Mesh_t* mesh,const char* format)
       int   iflag ;
       int   itype = 1 ;
       int   iprof[2] ;
-      int*  icptr = (int*) malloc((n_no + 1)*sizeof(int)) ;
-      int*  iw = (int*) malloc((3*n_no + 2)*sizeof(int)) ;
+      int*  icptr = (int*) Mry_NewIn(Mesh,int[n_no + 1]) ;
+      int*  iw = (int*) Mry_NewIn(Mesh,int[3*n_no + 2]) ;
     
-      if(!icptr || !iw) {
-        arret("Mesh_ComputeInversePermutationOfNodes(4): not enough memory") ;
-      }
-      
       mc40ad_(&itype,(int*) &n_no,&nnz,irn,jcn,icptr,iperm,iw,iprof,&iflag) ;
       
       if(iflag < 0) {
@@ -748,12 +813,12 @@ int*   Mesh_ComputeInversePermutationOfNodes(Mesh_t* mesh,const char* format)
       Message_Direct("entry in its row is excluded.\n") ;
       */
     
-      free(icptr) ;
-      free(iw) ;
+      Mry_Free(icptr) ;
+      Mry_Free(iw) ;
     }
   
-    free(irn) ;
-    free(jcn) ;
+    Mry_Free(irn) ;
+    Mry_Free(jcn) ;
   } else {
     arret("Mesh_ComputeInversePermutationOfNodes(5): format %s unknown",format) ;
   }
@@ -766,11 +831,7 @@ int*   Mesh_ComputeInversePermutationOfNodes(Mesh_t* mesh,const char* format)
 int*   Mesh_ComputeInversePermutationOfElements(Mesh_t* mesh,const char* format)
 {
   int    nelt = Mesh_GetNbOfNodes(mesh) ;
-  int*   norder = (int*) malloc(nelt*sizeof(int)) ;
-  
-  if(!norder) {
-    arret("Mesh_ComputeInversePermutationOfElements(1): not enough memory") ;
-  }
+  int*   norder = (int*) Mry_NewIn(Mesh,int[nelt]) ;
   
   
   if(!strcmp(format,"hsl_mc43")) {
@@ -792,11 +853,7 @@ int*   Mesh_ComputeInversePermutationOfElements(Mesh_t* mesh,const char* format)
       int  mxwave[2] ;
       int  iflag ;
       
-      eltptr = (int*) malloc((nelt + 1)*sizeof(int)) ;
-      
-      if(!eltptr) {
-        arret("Mesh_ComputeInversePermutationOfElements(4): not enough memory") ;
-      }
+      eltptr = (int*) Mry_NewIn(Mesh,int[nelt + 1]) ;
       
       {
         int i ;
@@ -811,11 +868,7 @@ int*   Mesh_ComputeInversePermutationOfElements(Mesh_t* mesh,const char* format)
       
       nz = eltptr[nelt] - 1 ;
       
-      eltvar = (int*) malloc(nz*sizeof(int)) ;
-      
-      if(!eltvar) {
-        arret("Mesh_ComputeInversePermutationOfElements(4): not enough memory") ;
-      }
+      eltvar = (int*) Mry_NewIn(Mesh,int[nz]) ;
       
       {
         int i ;
@@ -857,11 +910,8 @@ int*   Mesh_ComputeInversePermutationOfElements(Mesh_t* mesh,const char* format)
           if(liw < 2*n) liw = 2*n ;
         }
         
-        iw = (int*) malloc(liw*sizeof(int)) ;
+        iw = (int*) Mry_NewIn(Mesh,int[liw]) ;
         
-        if(!iw) {
-          arret("Mesh_ComputeInversePermutationOfElements(4): not enough memory") ;
-        }
       }
       
       
@@ -876,9 +926,9 @@ int*   Mesh_ComputeInversePermutationOfElements(Mesh_t* mesh,const char* format)
       Message_Direct("    original ordering  %d\n",mxwave[0]) ;
       Message_Direct("    new ordering       %d\n",mxwave[1]) ;
       
-      free(eltptr) ;
-      free(eltvar) ;
-      free(iw) ;
+      Mry_Free(eltptr) ;
+      Mry_Free(eltvar) ;
+      Mry_Free(iw) ;
     }
   } else {
     arret("Mesh_ComputeInversePermutationOfElements(5): format %s unknown",format) ;
@@ -917,7 +967,7 @@ void Mesh_CreateEquationContinuity(Mesh_t* mesh,Materials_t* materials)
       Node_t* no = Mesh_GetNode(mesh) ;
       int n_no = Mesh_GetNbOfNodes(mesh) ;
       int    n_names = n_no*maxnbofequationspernode ;
-      char** uname = (char**) Mry_New(char*[2*n_names]) ;
+      char** uname = (char**) Mry_NewIn(Mesh,char*[2*n_names]) ;
       char** ename = uname + n_names ;
       int in ;
   
@@ -1297,22 +1347,22 @@ int (Mesh_StoreCurrentSolution)(Mesh_t* mesh,DataFile_t* datafile,double t)
   fprintf(fic_sto,"\n") ;
   
   
-  /* Unknowns */
+  /* Unknowns (one line per node) */
   {
+    Nodes_t* nodes = Mesh_GetNodes(mesh) ;
     int n_no = Mesh_GetNbOfNodes(mesh) ;
-    Node_t* no = Mesh_GetNode(mesh) ;
+    unsigned int* offset = Nodes_GetDOFOffset(nodes) ;
+    double* u = Nodes_GetCurrentUnknown(nodes) ;
     int    i ;
     
     for(i = 0 ; i < n_no ; i++) {
-      double* u = Node_GetCurrentUnknown(no + i) ;
-      int    nb_unk = Node_GetNbOfUnknowns(no + i) ;
-      int j ;
+      unsigned int j ;
       
-      for(j = 0 ; j < nb_unk ; j++) {
+      for(j = offset[i] ; j < offset[i + 1] ; j++) {
         fprintf(fic_sto,"%.12e ",u[j]) ;
       }
       
-      if(nb_unk) fprintf(fic_sto,"\n") ;
+      if(offset[i + 1] > offset[i]) fprintf(fic_sto,"\n") ;
     }
   }
   
@@ -1376,20 +1426,12 @@ void (Mesh_SetCurrentUnknownsWithBoundaryConditions)(Mesh_t* mesh,BConds_t* bcon
     1. .. with previous ones
   */
   {
-    unsigned int   nb_nodes = Mesh_GetNbOfNodes(mesh) ;
-    Node_t*        node = Mesh_GetNode(mesh) ;
-    unsigned int   i ;
+    Nodes_t* nodes = Mesh_GetNodes(mesh) ;
+    unsigned int n_dof = Nodes_GetNbOfDOF(nodes) ;
+    double* u_n = Nodes_GetPreviousUnknown(nodes) ;
+    double* u_1 = Nodes_GetCurrentUnknown(nodes) ;
   
-    for(i = 0 ; i < nb_nodes ; i++) {
-      int  nb_unk = Node_GetNbOfUnknowns(node + i) ;
-      double* u_n = Node_GetPreviousUnknown(node + i) ;
-      double* u_1 = Node_GetCurrentUnknown(node + i) ;
-      int j ;
-        
-      for(j = 0 ; j < nb_unk ; j++) {
-        u_1[j] = u_n[j] ;
-      }
-    }
+    memcpy(u_1,u_n,n_dof*sizeof(double)) ;
   }
       
   /*
@@ -1400,29 +1442,123 @@ void (Mesh_SetCurrentUnknownsWithBoundaryConditions)(Mesh_t* mesh,BConds_t* bcon
 
 
 
+int (Mesh_SetCurrentUnknownsWithPredictor)(Mesh_t* mesh,Solutions_t* sols,BConds_t* bconds,int order)
+/** Set the current values by extrapolating in time the last converged
+ *  solutions with a polynomial of the given order (at most), then with
+ *  the boundary conditions. The change of an unknown is bounded by the
+ *  limit of its objective variation, if any.
+ *  Return the order actually used which is lowered as long as
+ *  the previous solutions are not available. */
+{
+  double t = Solutions_GetCurrentTime(sols) ;
+  double w[Mesh_MaxOrderOfPredictor + 1] ;
+  
+  if(order > Mesh_MaxOrderOfPredictor) order = Mesh_MaxOrderOfPredictor ;
+  
+  order = Solutions_ComputeExtrapolationWeights(sols,order,w) ;
+  
+  /* Extrapolation */
+  {
+    Nodes_t* nodes = Mesh_GetNodes(mesh) ;
+    ObVals_t* obvals = Nodes_GetObjectiveValues(nodes) ;
+    ObVal_t* obval = ObVals_GetObVal(obvals) ;
+    unsigned int n_dof = Nodes_GetNbOfDOF(nodes) ;
+    unsigned short int* obvalind = Nodes_GetObValIndex(nodes) ;
+    double* u_1 = Nodes_GetCurrentUnknown(nodes) ;
+    double* u_n = Nodes_GetPreviousUnknown(nodes) ;
+    double* u_k[Mesh_MaxOrderOfPredictor + 1] ;
+    unsigned int i ;
+      
+    {
+      int k ;
+        
+      for(k = 0 ; k <= order ; k++) {
+        u_k[k] = Nodes_GetDeepUnknown(nodes,k + 1) ;
+      }
+    }
+    
+    for(i = 0 ; i < n_dof ; i++) {
+      double u = 0 ;
+      int k ;
+        
+      for(k = 0 ; k <= order ; k++) {
+        u += w[k] * u_k[k][i] ;
+      }
+        
+      if(order > 0) {
+        ObVal_t* obval_i = obval + obvalind[i] ;
+          
+        if(ObVal_IncrementIsLimited(obval_i)) {
+          double dumax = ObVal_GetMaxIncrement(obval_i) ;
+            
+          if(u > u_n[i] + dumax) u = u_n[i] + dumax ;
+          if(u < u_n[i] - dumax) u = u_n[i] - dumax ;
+        }
+      } else {
+        u = u_n[i] ;
+      }
+        
+      u_1[i] = u ;
+    }
+  }
+      
+  BConds_AssignBoundaryConditions(bconds,mesh,t) ;
+  
+  return(order) ;
+}
+
+
+
 void (Mesh_UpdateCurrentUnknowns)(Mesh_t* mesh,Solver_t* solver)
+{
+  Mesh_UpdateCurrentUnknownsWithStepLength(mesh,solver,1) ;
+}
+
+
+
+int (Mesh_UpdateCurrentUnknownsWithStepLength)(Mesh_t* mesh,Solver_t* solver,double step)
+/** Add to the current unknowns the correction found in the solver,
+ *  relaxed and limited as required by the objective variations,
+ *  then multiplied by the step length.
+ *  Return the nb of increments reduced by their trust limit. */
 {
   double* x = Solver_GetSolution(solver) ;
   Nodes_t* nodes = Mesh_GetNodes(mesh) ;
-  Node_t* node = Mesh_GetNode(mesh) ;
   ObVals_t* obvals = Nodes_GetObjectiveValues(nodes) ;
   ObVal_t* obval = ObVals_GetObVal(obvals) ;
-  unsigned int nb_nodes = Mesh_GetNbOfNodes(mesh) ;
-  unsigned int i ;
+  int n_dof = Nodes_GetNbOfDOF(nodes) ;
+  int* colind = Nodes_GetMatrixColumnIndex(nodes) ;
+  unsigned short int* obvalind = Nodes_GetObValIndex(nodes) ;
+  double* u_1 = Nodes_GetCurrentUnknown(nodes) ;
+  int nlimited = 0 ;
+  int i ;
+  
+  /* Loop over all the dof at once */
+  #ifdef _OPENMP
+  #pragma omp parallel for schedule(static) reduction(+:nlimited) if(n_dof > Nodes_MinNbOfDOFForThreads)
+  #endif
+  for(i = 0 ; i < n_dof ; i++) {
+    int   k = colind[i] ;
+      
+    if(k >= 0) {
+      ObVal_t* obval_i = obval + obvalind[i] ;
+      double rfac = ObVal_GetRelaxationFactor(obval_i) ;
+      double du = rfac * x[k] ;
+        
+      if(ObVal_IncrementIsLimited(obval_i)) {
+        double dumax = ObVal_GetMaxIncrement(obval_i) ;
           
-  for(i = 0 ; i < nb_nodes ; i++) {
-    int nin = Node_GetNbOfUnknowns(node + i) ;
-    double* u_1 = Node_GetCurrentUnknown(node + i) ;
-    int j ;
-            
-    for(j = 0 ; j < nin ; j++) {
-      int   k = Node_GetMatrixColumnIndex(node + i)[j] ;
-      int  iobval = Node_GetObValIndex(node + i)[j] ;
-      double rfac = ObVal_GetRelaxationFactor(obval + iobval) ;
-              
-      if(k >= 0) u_1[j] += rfac * x[k] ;
+        if(fabs(du) > dumax) {
+          du = (du > 0) ? dumax : - dumax ;
+          nlimited += 1 ;
+        }
+      }
+        
+      u_1[i] += step * du ;
     }
   }
+  
+  return(nlimited) ;
 }
 
 
@@ -1473,9 +1609,9 @@ void Mesh_ReadInline1d(Mesh_t* mesh,char* str)
   /* Nb of points */
   str += String_Scan(str,"%d",&npt) ;
 
-  pt = (double*) Mry_New(double[npt]) ;
+  pt = (double*) Mry_NewIn(Mesh,double[npt]) ;
 
-  ne = (int*) Mry_New(int[npt]) ;
+  ne = (int*) Mry_NewIn(Mesh,int[npt]) ;
 
   /* Points */
   {
@@ -1549,8 +1685,8 @@ void Mesh_ReadInline1d(Mesh_t* mesh,char* str)
     maillage(pt,ne,dx_ini,npt,no) ;
   }
 
-  free(pt) ;
-  free(ne) ;
+  Mry_Free(pt) ;
+  Mry_Free(ne) ;
 
 
   /* Set the remaining attributes of element */
@@ -1603,27 +1739,23 @@ void Mesh_ReadInline1d(Mesh_t* mesh,char* str)
 void Mesh_ReadFormatGmsh(Mesh_t* mesh,const char* nom_msh)
 /* Read a mesh in a file under the format GMSH */
 {
-  char   line[Mesh_MaxLengthOfTextLine] ;
-  FILE*  fic_msh ;
+  gmsh_File_t* gmshfile = gmsh_FileCreate(nom_msh) ;
+  char* c = gmsh_FileGetBegin(gmshfile) ;
+  char* end = gmsh_FileGetEnd(gmshfile) ;
 
-  /* ouverture du fichier */
-  fic_msh = fopen(nom_msh,"r") ;
-  if(!fic_msh) {
-    arret("lit_mail_gmsh (1) :impossible d\'ouvrir le fichier") ;
+  /* The first line beginning by $ */
+  while(c < end && *c != '$') {
+    while(c < end && *c != '\n') c++ ;
+    if(c < end) c++ ;
   }
 
-  do {
-    fgets(line,sizeof(line),fic_msh) ;
-  } while(line[0] != '$') ;
-
-  /* fermeture du fichier */
-  fclose(fic_msh) ;
-
-  if(!strncmp(&line[1],"NOD",3)) { /* Version 1.0 */
+  if(end - c > 3 && !strncmp(c + 1,"NOD",3)) { /* Version 1.0 */
+    gmsh_FileDelete(gmshfile) ;
     Mesh_ReadFormatGmsh_1(mesh,nom_msh) ;
     return ;
-  } else if(!strncmp(&line[1],"MeshFormat",10)) { /* Version 2.0 */
-    Mesh_ReadFormatGmsh_2(mesh,nom_msh) ;
+  } else if(end - c > 10 && !strncmp(c + 1,"MeshFormat",10)) { /* Version 2.x and 4.1 */
+    Mesh_ReadFormatGmsh_2(mesh,gmshfile) ;
+    gmsh_FileDelete(gmshfile) ;
     return ;
   }
   arret("Mesh_ReadFormatGmsh: not available") ;
@@ -1832,237 +1964,190 @@ void Mesh_ReadFormatGmsh_1(Mesh_t* mesh,const char* name)
 
 
 
-void Mesh_ReadFormatGmsh_2(Mesh_t* mesh,const char* nom_msh)
-/* Read a mesh in a file under the format GMSH version 2.0 */
+void Mesh_ReadFormatGmsh_2(Mesh_t* mesh,gmsh_File_t* gmshfile)
+/* Read a mesh in a file under the format GMSH version 2.x or 4.1,
+ * ASCII or binary. The file is mapped in memory and read in one pass:
+ * the nodes and the elements are stored as read before being copied
+ * into the mesh. */
 {
-  TextFile_t* textfile = TextFile_Create(nom_msh) ;
-  FILE*  fic_msh = TextFile_OpenFile(textfile,"r") ;
+  gmsh_Data_t data ;
   double version ;
-  int    file_type,data_size ;
-  char   mot[Mesh_MaxLengthOfKeyWord] ;
-  char   line[Mesh_MaxLengthOfTextLine] ;
-  int n_no = 0 ;
-  int n_el = 0 ;
-  int n_c = 0 ;
-
-  /* Which version? */
-  fscanf(fic_msh,"%s",mot) ;
-  if(strcmp(mot,"$MeshFormat")) arret("lit_mail_gmsh_2 (2) : pas de $MeshFormat") ;
-  fscanf(fic_msh, "%lf %d %d\n",&version,&file_type,&data_size) ;
-  if(floor(version) != 2) arret("Error: Wrong msh file version") ;
-  fscanf(fic_msh,"%s",mot) ;
-  if(strcmp(mot,"$EndMeshFormat")) arret("lit_mail_gmsh_2 (2) : pas de $EndFormat") ;
 
+  memset(&data,0,sizeof(gmsh_Data_t)) ;
 
-  /* The file should begin by $Nodes */
-  fscanf(fic_msh,"%s",mot) ;
-  if(strcmp(mot,"$Nodes")) {
-    arret("lit_mail_gmsh_2 (2) : pas de $Nodes") ;
-  }
-  
-  /* Read the nb of nodes */
+  /* Which version? */
   {
-    int  nb_nodes ;
-    int i ;
+    int file_type ;
     
-    fscanf(fic_msh,"%d",&nb_nodes) ;
+    gmsh_ReadSectionName(gmshfile,"$MeshFormat") ;
     
-    n_no = 0 ;
-    for(i = 0 ; i < nb_nodes ; i++) {
-      int n ;
-      
-      /* le numero du noeud */
-      fscanf(fic_msh,"%d",&n) ;
+    version   = gmsh_ReadAsciiReal(gmshfile) ;
+    file_type = (int) gmsh_ReadAsciiInteger(gmshfile) ;
+    gmsh_FileGetDataSize(gmshfile) = (int) gmsh_ReadAsciiInteger(gmshfile) ;
+    
+    if(floor(version) != 2 && version != 4.1) {
+      arret("Mesh_ReadFormatGmsh_2: msh file version %g not available",version) ;
+    }
+    
+    if(file_type == 1) {
+      gmsh_FileIsBinary(gmshfile) = 1 ;
+      gmsh_SkipLine(gmshfile) ;
       
-      if(n_no < n) n_no = n ;
+      /* The integer 1 written in binary to detect the endianness */
+      if(gmsh_ReadInt(gmshfile) != 1) {
+        arret("Mesh_ReadFormatGmsh_2: byte swapped binary files not available") ;
+      }
+    }
+    
+    {
+      int datasize = gmsh_FileGetDataSize(gmshfile) ;
       
-      /* on lit le reste de la ligne */
-      if(!fgets(line,sizeof(line),fic_msh)) {
-        arret("lit_mail_gmsh_2 (3) : erreur ou fin de fichier") ;
+      if(datasize != 4 && datasize != 8) {
+        arret("Mesh_ReadFormatGmsh_2: data size %d not available",datasize) ;
       }
     }
     
-    //Mesh_GetNbOfNodes(mesh) = n_no ;
+    gmsh_ReadSectionName(gmshfile,"$EndMeshFormat") ;
   }
 
-  fscanf(fic_msh,"%s",mot) ;
-  if(strcmp(mot,"$EndNodes")) arret("lit_mail_gmsh_2 (4) : pas de $EndNodes") ;
-
-
 
-  /* Elements */
-  fscanf(fic_msh,"%s",mot) ;
-  if(strcmp(mot,"$Elements")) {
-    arret("lit_mail_gmsh_2 (5) : pas de $Elements") ;
-  }
-
-  /* Read the nb of elements */
+  /* The sections */
   {
-    int nb_elements ;
-    int i ;
-    
-    fscanf(fic_msh,"%d",&nb_elements) ;
+    char* name ;
     
-    /* calcul de n_el et de n_c */
-    n_el = 0 ;
-    n_c = 0 ;
-    for(i = 0 ; i < nb_elements ; i++) {
-      int n,elm_type ;
-      
-      /* le numero d'element */
-      fscanf(fic_msh,"%d",&n) ;
-      
-      if(n_el < n) n_el = n ;
-      
-      /* on lit le reste de la ligne */
-      if(!fgets(line,sizeof(line),fic_msh)) {
-        arret("lit_mail_gmsh_2 (6) : erreur ou fin de fichier") ;
+    while((name = gmsh_FindNextSection(gmshfile))) {
+      if(!strncmp(name,"$Nodes",6) && gmsh_IsSpace(name[6])) {
+        gmsh_ReadSectionName(gmshfile,"$Nodes") ;
+        
+        if(version < 4) {
+          gmsh_ReadNodes_2(gmshfile,&data) ;
+        } else {
+          gmsh_ReadNodes_4(gmshfile,&data) ;
+        }
+        
+        gmsh_ReadSectionName(gmshfile,"$EndNodes") ;
+        
+      } else if(!strncmp(name,"$Elements",9) && gmsh_IsSpace(name[9])) {
+        gmsh_ReadSectionName(gmshfile,"$Elements") ;
+        
+        if(version < 4) {
+          gmsh_ReadElements_2(gmshfile,&data) ;
+        } else {
+          gmsh_ReadElements_4(gmshfile,&data) ;
+        }
+        
+        gmsh_ReadSectionName(gmshfile,"$EndElements") ;
+        
+      } else if(!strncmp(name,"$Entities",9) && gmsh_IsSpace(name[9]) && version >= 4) {
+        gmsh_ReadSectionName(gmshfile,"$Entities") ;
+        gmsh_ReadEntities_4(gmshfile,&data) ;
+        gmsh_ReadSectionName(gmshfile,"$EndEntities") ;
+        
+      } else {
+        gmsh_SkipSection(gmshfile) ;
       }
-      
-      /* elm_type */
-      sscanf(line,"%d",&elm_type) ;
-      
-      n_c += gmsh_NbNodes(elm_type) ;
     }
-    
-    //Mesh_GetNbOfElements(mesh) = n_el ;
-    //Mesh_GetNbOfConnectivities(mesh) = n_c ;
   }
   
-  fscanf(fic_msh,"%s",mot) ;
-  if(strcmp(mot,"$EndElements")) {
-    arret("lit_mail_gmsh_2 (7) : pas de $EndElements") ;
+  if(!data.nodetag) {
+    arret("Mesh_ReadFormatGmsh_2: no $Nodes") ;
   }
   
+  if(!data.elementtag) {
+    arret("Mesh_ReadFormatGmsh_2: no $Elements") ;
+  }
   
   
   /* Allocation of space for "nodes" and "elements" */
   {
-    //int n_no = Mesh_GetNbOfNodes(mesh) ;
-    //int n_el = Mesh_GetNbOfElements(mesh) ;
-    //int n_c  = Mesh_GetNbOfConnectivities(mesh) ;
+    int n_no = 0 ;
+    int n_el = 0 ;
+    int n_c  = data.nbofelementnodes ;
     int dim  = Mesh_GetDimension(mesh) ;
-    Nodes_t* nodes = Nodes_New(n_no,dim,n_c) ;
-    Elements_t* elements = Elements_New(n_el,n_c) ;
-  
-    Mesh_GetNodes(mesh) = nodes ;
-    Mesh_GetElements(mesh) = elements ;
+    int i ;
+    
+    for(i = 0 ; i < data.nbofnodes ; i++) {
+      if(n_no < data.nodetag[i]) n_no = data.nodetag[i] ;
+    }
+    
+    for(i = 0 ; i < data.nbofelements ; i++) {
+      if(n_el < data.elementtag[i]) n_el = data.elementtag[i] ;
+    }
+    
+    Mesh_GetNodes(mesh) = Nodes_New(n_no,dim,n_c) ;
+    Mesh_GetElements(mesh) = Elements_New(n_el,n_c) ;
   }
   
 
-  /* Re-start */
-  rewind(fic_msh) ;
-
-  /* FORMAT */
-  fscanf(fic_msh,"%s",mot) ;
-  fscanf(fic_msh, "%lf %d %d\n",&version,&file_type,&data_size) ;
-  fscanf(fic_msh,"%s",mot) ;
-  
-
   /* Nodes */
   {
     Node_t* no = Mesh_GetNode(mesh) ;
     int dim  = Mesh_GetDimension(mesh) ;
-    int nb_nodes ;
     int i ;
     
-    fscanf(fic_msh,"%s",mot) ;
-    /* nombre de noeuds */
-    fscanf(fic_msh,"%d",&nb_nodes) ;
-  
-
-    for(i = 0 ; i < nb_nodes ; i++) {
-      int n,j ;
+    for(i = 0 ; i < data.nbofnodes ; i++) {
+      int n = data.nodetag[i] - 1 ;
+      double* x = data.coordinate + 3*i ;
+      int j ;
       
-      /* le numero du noeud */
-      fscanf(fic_msh,"%d",&n) ; n -= 1 ;
+      if(n < 0) arret("Mesh_ReadFormatGmsh_2: bad node tag") ;
       
       /* les coordonnees*/
       for(j = 0 ; j < dim ; j++) {
-        fscanf(fic_msh,"%le",Node_GetCoordinate(no + n) + j) ;
-      }
-      
-      /* on lit le reste de la ligne */
-      if(!fgets(line,sizeof(line),fic_msh)) {
-        arret("lit_mail_gmsh_2 (10) : erreur ou fin de fichier") ;
+        Node_GetCoordinate(no + n)[j] = x[j] ;
       }
     }
-    
-    fscanf(fic_msh,"%s",mot) ;
   }
   
 
   /* Elements */
   {
+    int n_no = Mesh_GetNbOfNodes(mesh) ;
     Node_t* no = Mesh_GetNode(mesh) ;
     Element_t* el = Mesh_GetElement(mesh) ;
     Node_t** p_node = Element_GetPointerToNode(el) ;
-    int nb_elements ;
+    int* nodetag = data.elementnode ;
+    int n_c = 0 ;
     int i ;
-    
-    fscanf(fic_msh,"%s",mot) ;
-    /* nombre d'elements */
-    fscanf(fic_msh,"%d",&nb_elements) ;
 
-
-    n_c = 0 ;
-    for(i = 0 ; i < nb_elements ; i++) {
-      int n ;
+    for(i = 0 ; i < data.nbofelements ; i++) {
+      int n = data.elementtag[i] - 1 ;
+      int elm_type = data.elementtype[i] ;
+      int nn = gmsh_NbNodes(elm_type) ;
       int j ;
-      int elm_type,nb_tags ;
-      int physical,elementary,partition ;
-      
-      /* le numero d'element */
-      fscanf(fic_msh,"%d",&n) ; n -= 1 ;
       
-      /* elm_type */
-      fscanf(fic_msh,"%d %d",&elm_type,&nb_tags) ;
-      
-      elementary = physical = partition = 1;
-      
-      for(j = 0; j < nb_tags; j++){
-        int tag ;
-        
-        fscanf(fic_msh, "%d", &tag);
-          
-        if(j == 0)      physical   = tag ;
-        else if(j == 1) elementary = tag ;
-        else if(j == 2) partition  = tag ;
-        /* ignore any other tags for now */
-      }
+      if(n < 0) arret("Mesh_ReadFormatGmsh_2: bad element tag") ;
       
       Element_GetElementIndex(el + n) = n ;
-      Element_GetMaterialIndex(el + n) = physical - 1 ;
-      Element_GetRegionIndex(el + n) = elementary ;
-      Element_GetNbOfNodes(el + n) = gmsh_NbNodes(elm_type) ;
+      Element_GetMaterialIndex(el + n) = data.physical[i] - 1 ;
+      Element_GetRegionIndex(el + n) = data.elementary[i] ;
+      Element_GetNbOfNodes(el + n) = nn ;
       Element_GetDimension(el + n) = gmsh_DimElement(elm_type) ;
       
-      if(!Element_GetNbOfNodes(el + n)){
-        arret("lit_mail_gmsh_2 (13) : Error: Unknown type for element"); 
-      }
-      
       if(Element_GetNbOfNodes(el + n) > Element_MaxNbOfNodes) {
-        arret("lit_mail_gmsh_2 (14) : trop de noeuds") ;
+        arret("Mesh_ReadFormatGmsh_2: trop de noeuds") ;
       }
       
       /* numerotation */
       Element_GetPointerToNode(el + n) = p_node + n_c ;
       
-      n_c += Element_GetNbOfNodes(el + n) ;
+      n_c += nn ;
       
-      for(j = 0; j < Element_GetNbOfNodes(el + n) ; j++) {
-        int nodeindex ;
+      for(j = 0 ; j < nn ; j++) {
+        int nodeindex = nodetag[j] ;
         
-        fscanf(fic_msh,"%d",&nodeindex) ;
+        if(nodeindex < 1 || nodeindex > n_no) {
+          arret("Mesh_ReadFormatGmsh_2: unknown node %d",nodeindex) ;
+        }
         
         Element_GetNode(el + n,j) = no + nodeindex - 1 ;
       }
+      
+      nodetag += nn ;
     }
-  
-    fscanf(fic_msh,"%s",mot) ;
   }
   
-  TextFile_Delete(&textfile) ;
+  gmsh_DataFree(&data) ;
 }
 
 
@@ -2084,7 +2169,7 @@ void Mesh_Readm1d(Mesh_t* mesh,const char* nom_m1d)
     /* nombre de points */
     fscanf(fic_m1d,"%d",&npt) ;
 
-    pt = (double*) Mry_New(double[2*npt]) ;
+    pt = (double*) Mry_NewIn(Mesh,double[2*npt]) ;
 
     lc = pt + npt ;
     
@@ -2138,7 +2223,7 @@ void Mesh_Readm1d(Mesh_t* mesh,const char* nom_m1d)
     }
   }
 
-  free(pt) ;
+  Mry_Free(pt) ;
   
   /* Set the remaining attributes of element */
   {
@@ -2610,6 +2695,751 @@ int gmsh_DimElement(int type)
 
 
 
+/* Mesh files under the format GMSH mapped in memory
+ * -------------------------------------------------- */
+gmsh_File_t* gmsh_FileCreate(const char* name)
+/** Map the content of the file "name" in memory (or read it where
+ *  mmap is not available). */
+{
+  gmsh_File_t* gmshfile = (gmsh_File_t*) Mry_NewIn(Mesh,gmsh_File_t) ;
+  size_t size ;
+  char*  begin ;
+
+#ifdef _POSIX_MAPPED_FILES
+  {
+    int fd = open(name,O_RDONLY) ;
+    struct stat st ;
+    
+    if(fd < 0 || fstat(fd,&st) < 0) {
+      arret("gmsh_FileCreate: can't open %s",name) ;
+    }
+    
+    size = st.st_size ;
+    
+    if(!size) {
+      arret("gmsh_FileCreate: empty file %s",name) ;
+    }
+    
+    begin = (char*) mmap(NULL,size,PROT_READ,MAP_PRIVATE,fd,0) ;
+    
+    if(begin == MAP_FAILED) {
+      arret("gmsh_FileCreate: can't map %s",name) ;
+    }
+    
+    close(fd) ;
+  }
+#else
+  {
+    FILE* str = fopen(name,"rb") ;
+    long int len ;
+    
+    if(!str) {
+      arret("gmsh_FileCreate: can't open %s",name) ;
+    }
+    
+    fseek(str,0,SEEK_END) ;
+    len = ftell(str) ;
+    rewind(str) ;
+    
+    if(len <= 0) {
+      arret("gmsh_FileCreate: empty file %s",name) ;
+    }
+    
+    size = len ;
+    
+    /* Null-terminated */
+    begin = (char*) Mry_NewIn(Mesh,char[size + 1]) ;
+    
+    if(fread(begin,1,size,str) != size) {
+      arret("gmsh_FileCreate: can't read %s",name) ;
+    }
+    
+    fclose(str) ;
+  }
+#endif
+
+  gmsh_FileGetBegin(gmshfile) = begin ;
+  gmsh_FileGetEnd(gmshfile) = begin + size ;
+  gmsh_FileGetCurrentPosition(gmshfile) = begin ;
+  gmsh_FileIsBinary(gmshfile) = 0 ;
+  gmsh_FileGetDataSize(gmshfile) = sizeof(size_t) ;
+  
+  return(gmshfile) ;
+}
+
+
+
+void gmsh_FileDelete(gmsh_File_t* gmshfile)
+{
+  char* begin = gmsh_FileGetBegin(gmshfile) ;
+  
+#ifdef _POSIX_MAPPED_FILES
+  munmap(begin,gmsh_FileGetEnd(gmshfile) - begin) ;
+#else
+  Mry_Free(begin) ;
+#endif
+
+  Mry_Free(gmshfile) ;
+}
+
+
+
+void gmsh_SkipSpaces(gmsh_File_t* gmshfile)
+{
+  char* c = gmsh_FileGetCurrentPosition(gmshfile) ;
+  char* end = gmsh_FileGetEnd(gmshfile) ;
+  
+  while(c < end && gmsh_IsSpace(*c)) c++ ;
+  
+  gmsh_FileGetCurrentPosition(gmshfile) = c ;
+}
+
+
+
+void gmsh_SkipLine(gmsh_File_t* gmshfile)
+/** Move to the beginning of the next line. */
+{
+  char* c = gmsh_FileGetCurrentPosition(gmshfile) ;
+  char* end = gmsh_FileGetEnd(gmshfile) ;
+  
+  while(c < end && *c != '\n') c++ ;
+  
+  gmsh_FileGetCurrentPosition(gmshfile) = (c < end) ? c + 1 : end ;
+}
+
+
+
+void gmsh_ReadSectionName(gmsh_File_t* gmshfile,const char* name)
+/** Read the line beginning by the section name "name". */
+{
+  size_t len = strlen(name) ;
+  char* c ;
+  
+  gmsh_SkipSpaces(gmshfile) ;
+  
+  c = gmsh_FileGetCurrentPosition(gmshfile) ;
+  
+  if((size_t) (gmsh_FileGetEnd(gmshfile) - c) < len || strncmp(c,name,len)) {
+    arret("gmsh_ReadSectionName: no %s",name) ;
+  }
+  
+  gmsh_FileGetCurrentPosition(gmshfile) = c + len ;
+  
+  gmsh_SkipLine(gmshfile) ;
+}
+
+
+
+char* gmsh_FindNextSection(gmsh_File_t* gmshfile)
+/** Return the name of the next section or NULL at the end of file. */
+{
+  char* c ;
+  
+  gmsh_SkipSpaces(gmshfile) ;
+  
+  c = gmsh_FileGetCurrentPosition(gmshfile) ;
+  
+  if(c == gmsh_FileGetEnd(gmshfile)) return(NULL) ;
+  
+  if(*c != '$') {
+    arret("gmsh_FindNextSection: no section") ;
+  }
+  
+  return(c) ;
+}
+
+
+
+void gmsh_SkipSection(gmsh_File_t* gmshfile)
+/** Move after the end of the current section "$Name" i.e. after the
+ *  line "$EndName". */
+{
+  char* name = gmsh_FileGetCurrentPosition(gmshfile) + 1 ;
+  char* end = gmsh_FileGetEnd(gmshfile) ;
+  size_t len = 0 ;
+  char* c ;
+  
+  while(name + len < end && !gmsh_IsSpace(name[len])) len++ ;
+  
+  for(c = name + len ; c + 5 + len <= end ; c++) {
+    if(c[0] == '\n' && !strncmp(c + 1,"$End",4) && !strncmp(c + 5,name,len)) {
+      gmsh_FileGetCurrentPosition(gmshfile) = c + 5 + len ;
+      gmsh_SkipLine(gmshfile) ;
+      return ;
+    }
+  }
+  
+  arret("gmsh_SkipSection: no $End%.*s",(int) len,name) ;
+}
+
+
+
+long int gmsh_ReadAsciiInteger(gmsh_File_t* gmshfile)
+{
+  char* c ;
+  char* end = gmsh_FileGetEnd(gmshfile) ;
+  int   neg = 0 ;
+  long int n = 0 ;
+  
+  gmsh_SkipSpaces(gmshfile) ;
+  
+  c = gmsh_FileGetCurrentPosition(gmshfile) ;
+  
+  if(c < end && (*c == '-' || *c == '+')) {
+    neg = (*c == '-') ;
+    c++ ;
+  }
+  
+  if(c == end || !gmsh_IsDigit(*c)) {
+    arret("gmsh_ReadAsciiInteger: no integer") ;
+  }
+  
+  while(c < end && gmsh_IsDigit(*c)) {
+    n = 10*n + (*c - '0') ;
+    c++ ;
+  }
+  
+  gmsh_FileGetCurrentPosition(gmshfile) = c ;
+  
+  return((neg) ? -n : n) ;
+}
+
+
+
+double gmsh_ReadAsciiReal(gmsh_File_t* gmshfile)
+/** The mantissa and the exponent are scanned by hand. The value is
+ *  computed directly when exactly representable as a product or
+ *  a quotient of two doubles (mantissa < 2^53, |exponent| <= 22),
+ *  which gives the same result as strtod. Otherwise strtod is used
+ *  on a copy of the token. */
+{
+  static const double pow10[] = {
+    1e0,1e1,1e2,1e3,1e4,1e5,1e6,1e7,1e8,1e9,1e10,1e11,
+    1e12,1e13,1e14,1e15,1e16,1e17,1e18,1e19,1e20,1e21,1e22
+  } ;
+  char* c ;
+  char* c0 ;
+  char* end = gmsh_FileGetEnd(gmshfile) ;
+  int   neg = 0 ;
+  uint64_t m = 0 ;
+  int   nd = 0 ;       /* significant digits */
+  int   e = 0 ;
+  int   nodigit = 1 ;
+  
+  gmsh_SkipSpaces(gmshfile) ;
+  
+  c = c0 = gmsh_FileGetCurrentPosition(gmshfile) ;
+  
+  if(c < end && (*c == '-' || *c == '+')) {
+    neg = (*c == '-') ;
+    c++ ;
+  }
+  
+  /* Mantissa */
+  for(; c < end && gmsh_IsDigit(*c) ; c++) {
+    if(nd < 19) {
+      m = 10*m + (*c - '0') ;
+      if(m) nd++ ;
+    } else {
+      e++ ;
+      nd++ ;
+    }
+    nodigit = 0 ;
+  }
+  
+  if(c < end && *c == '.') {
+    for(c++ ; c < end && gmsh_IsDigit(*c) ; c++) {
+      if(nd < 19) {
+        m = 10*m + (*c - '0') ;
+        if(m) nd++ ;
+        e-- ;
+      } else {
+        nd++ ;
+      }
+      nodigit = 0 ;
+    }
+  }
+  
+  if(nodigit) {
+    arret("gmsh_ReadAsciiReal: no real") ;
+  }
+  
+  /* Exponent */
+  if(c < end && (*c == 'e' || *c == 'E')) {
+    char* ce = c + 1 ;
+    int   eneg = 0 ;
+    int   ee = 0 ;
+    
+    if(ce < end && (*ce == '-' || *ce == '+')) {
+      eneg = (*ce == '-') ;
+      ce++ ;
+    }
+    
+    if(ce < end && gmsh_IsDigit(*ce)) {
+      for(; ce < end && gmsh_IsDigit(*ce) ; ce++) {
+        if(ee < 10000) ee = 10*ee + (*ce - '0') ;
+      }
+      
+      e += (eneg) ? -ee : ee ;
+      c = ce ;
+    }
+  }
+  
+  gmsh_FileGetCurrentPosition(gmshfile) = c ;
+  
+  /* Fast path */
+  if(nd < 19 && m < ((uint64_t) 1 << 53) && e >= -22 && e <= 22) {
+    double x = (double) m ;
+    
+    x = (e < 0) ? x/pow10[-e] : x*pow10[e] ;
+    
+    return((neg) ? -x : x) ;
+  }
+  
+  /* The mapped file is not null-terminated: strtod works on a copy
+   * of the token scanned above */
+  {
+    size_t len = c - c0 ;
+    char   buf[64] ;
+    char*  token = (len < sizeof(buf)) ? buf : (char*) Mry_NewIn(Mesh,char[len + 1]) ;
+    double x ;
+    
+    memcpy(token,c0,len) ;
+    token[len] = '\0' ;
+    
+    x = strtod(token,NULL) ;
+    
+    if(token != buf) Mry_Free(token) ;
+    
+    return(x) ;
+  }
+}
+
+
+
+int gmsh_ReadInt(gmsh_File_t* gmshfile)
+/** Read an int (ASCII or binary). */
+{
+  if(gmsh_FileIsBinary(gmshfile)) {
+    int n ;
+    
+    gmsh_ReadBinary(gmshfile,&n,sizeof(int)) ;
+    
+    return(n) ;
+  }
+  
+  return((int) gmsh_ReadAsciiInteger(gmshfile)) ;
+}
+
+
+
+size_t gmsh_ReadSize(gmsh_File_t* gmshfile)
+/** Read a size_t of data size bytes (ASCII or binary). */
+{
+  if(gmsh_FileIsBinary(gmshfile)) {
+    if(gmsh_FileGetDataSize(gmshfile) == 8) {
+      uint64_t n ;
+      
+      gmsh_ReadBinary(gmshfile,&n,8) ;
+      
+      return((size_t) n) ;
+    } else {
+      uint32_t n ;
+      
+      gmsh_ReadBinary(gmshfile,&n,4) ;
+      
+      return((size_t) n) ;
+    }
+  }
+  
+  return((size_t) gmsh_ReadAsciiInteger(gmshfile)) ;
+}
+
+
+
+double gmsh_ReadReal(gmsh_File_t* gmshfile)
+/** Read a double (ASCII or binary). */
+{
+  if(gmsh_FileIsBinary(gmshfile)) {
+    double x ;
+    
+    gmsh_ReadBinary(gmshfile,&x,sizeof(double)) ;
+    
+    return(x) ;
+  }
+  
+  return(gmsh_ReadAsciiReal(gmshfile)) ;
+}
+
+
+
+void gmsh_ReadBinary(gmsh_File_t* gmshfile,void* v,size_t size)
+{
+  char* c = gmsh_FileGetCurrentPosition(gmshfile) ;
+  
+  if((size_t) (gmsh_FileGetEnd(gmshfile) - c) < size) {
+    arret("gmsh_ReadBinary: unexpected end of file") ;
+  }
+  
+  memcpy(v,c,size) ;
+  
+  gmsh_FileGetCurrentPosition(gmshfile) = c + size ;
+}
+
+
+
+
+/* Nodes and elements as read in a file under the format GMSH
+ * ---------------------------------------------------------- */
+int* gmsh_DataAddElement(gmsh_Data_t* data,int tag,int type,int physical,int elementary)
+/** Store the element and return where its node tags are to be stored. */
+{
+  int nn = gmsh_NbNodes(type) ;
+  int i = data->nbofelements ;
+  
+  if(!nn) {
+    arret("gmsh_DataAddElement: Unknown type %d for element",type) ;
+  }
+  
+  if(i == data->maxnbofelements) {
+    gmsh_DataReserveElements(data,(i) ? i : 1024) ;
+  }
+  
+  if(data->nbofelementnodes + nn > data->maxnbofelementnodes) {
+    int n = 2*data->maxnbofelementnodes + nn ;
+    
+    data->elementnode = (int*) Mry_ReallocIn(data->elementnode,n*sizeof(int),Mry_Category(Mesh)) ;
+    data->maxnbofelementnodes = n ;
+  }
+  
+  data->elementtag[i]  = tag ;
+  data->elementtype[i] = type ;
+  data->physical[i]    = physical ;
+  data->elementary[i]  = elementary ;
+  data->nbofelements  += 1 ;
+  
+  {
+    int* nodetag = data->elementnode + data->nbofelementnodes ;
+    
+    data->nbofelementnodes += nn ;
+    
+    return(nodetag) ;
+  }
+}
+
+
+
+void gmsh_DataReserveElements(gmsh_Data_t* data,int n)
+/** Make room for n more elements. */
+{
+  int nmax = data->nbofelements + n ;
+  size_t sz = nmax*sizeof(int) ;
+  
+  if(nmax <= data->maxnbofelements) return ;
+  
+  data->elementtag  = (int*) Mry_ReallocIn(data->elementtag,sz,Mry_Category(Mesh)) ;
+  data->elementtype = (int*) Mry_ReallocIn(data->elementtype,sz,Mry_Category(Mesh)) ;
+  data->physical    = (int*) Mry_ReallocIn(data->physical,sz,Mry_Category(Mesh)) ;
+  data->elementary  = (int*) Mry_ReallocIn(data->elementary,sz,Mry_Category(Mesh)) ;
+  data->maxnbofelements = nmax ;
+}
+
+
+
+void gmsh_DataReserveNodes(gmsh_Data_t* data,int n)
+/** Make room for n more nodes. */
+{
+  int nmax = data->nbofnodes + n ;
+  
+  data->nodetag = (int*) Mry_ReallocIn(data->nodetag,(nmax + 1)*sizeof(int),Mry_Category(Mesh)) ;
+  data->coordinate = (double*) Mry_ReallocIn(data->coordinate,(3*nmax + 1)*sizeof(double),Mry_Category(Mesh)) ;
+}
+
+
+
+void gmsh_DataFree(gmsh_Data_t* data)
+{
+  int d ;
+  
+  Mry_Free(data->nodetag) ;
+  Mry_Free(data->coordinate) ;
+  Mry_Free(data->elementtag) ;
+  Mry_Free(data->elementtype) ;
+  Mry_Free(data->physical) ;
+  Mry_Free(data->elementary) ;
+  Mry_Free(data->elementnode) ;
+  
+  for(d = 0 ; d < 4 ; d++) {
+    Mry_Free(data->entitytag[d]) ;
+  }
+}
+
+
+
+int gmsh_DataFindPhysical(gmsh_Data_t* data,int dim,int tag)
+/** Return the first physical tag of the entity (dim,tag) or 0. */
+{
+  int i ;
+  
+  if(dim < 0 || dim > 3) return(0) ;
+  
+  for(i = 0 ; i < data->nbofentities[dim] ; i++) {
+    if(data->entitytag[dim][2*i] == tag) return(data->entitytag[dim][2*i + 1]) ;
+  }
+  
+  return(0) ;
+}
+
+
+
+void gmsh_ReadNodes_2(gmsh_File_t* gmshfile,gmsh_Data_t* data)
+/** Read the section $Nodes of version 2.x. */
+{
+  int nb_nodes = (int) gmsh_ReadAsciiInteger(gmshfile) ;
+  int i ;
+  
+  if(gmsh_FileIsBinary(gmshfile)) gmsh_SkipLine(gmshfile) ;
+  
+  gmsh_DataReserveNodes(data,nb_nodes) ;
+  
+  for(i = 0 ; i < nb_nodes ; i++) {
+    int k = data->nbofnodes + i ;
+    double* x = data->coordinate + 3*k ;
+    
+    data->nodetag[k] = gmsh_ReadInt(gmshfile) ;
+    
+    x[0] = gmsh_ReadReal(gmshfile) ;
+    x[1] = gmsh_ReadReal(gmshfile) ;
+    x[2] = gmsh_ReadReal(gmshfile) ;
+  }
+  
+  data->nbofnodes += nb_nodes ;
+}
+
+
+
+void gmsh_ReadNodes_4(gmsh_File_t* gmshfile,gmsh_Data_t* data)
+/** Read the section $Nodes of version 4.1. */
+{
+  size_t nb_blocks = gmsh_ReadSize(gmshfile) ;
+  int    nb_nodes  = (int) gmsh_ReadSize(gmshfile) ;
+  int    first = data->nbofnodes ;
+  size_t ib ;
+  
+  /* minNodeTag maxNodeTag */
+  gmsh_ReadSize(gmshfile) ;
+  gmsh_ReadSize(gmshfile) ;
+  
+  gmsh_DataReserveNodes(data,nb_nodes) ;
+  
+  for(ib = 0 ; ib < nb_blocks ; ib++) {
+    int entitydim  = gmsh_ReadInt(gmshfile) ;
+    int parametric ;
+    int nb ;
+    int i ;
+    
+    /* entityTag */
+    gmsh_ReadInt(gmshfile) ;
+    
+    parametric = gmsh_ReadInt(gmshfile) ;
+    nb = (int) gmsh_ReadSize(gmshfile) ;
+    
+    if(data->nbofnodes + nb > nb_nodes + first) {
+      arret("gmsh_ReadNodes_4: too many nodes") ;
+    }
+    
+    for(i = 0 ; i < nb ; i++) {
+      data->nodetag[data->nbofnodes + i] = (int) gmsh_ReadSize(gmshfile) ;
+    }
+    
+    for(i = 0 ; i < nb ; i++) {
+      double* x = data->coordinate + 3*(data->nbofnodes + i) ;
+      int j ;
+      
+      x[0] = gmsh_ReadReal(gmshfile) ;
+      x[1] = gmsh_ReadReal(gmshfile) ;
+      x[2] = gmsh_ReadReal(gmshfile) ;
+      
+      /* The parametric coordinates are ignored */
+      if(parametric) {
+        for(j = 0 ; j < entitydim ; j++) gmsh_ReadReal(gmshfile) ;
+      }
+    }
+    
+    data->nbofnodes += nb ;
+  }
+}
+
+
+
+void gmsh_ReadElements_2(gmsh_File_t* gmshfile,gmsh_Data_t* data)
+/** Read the section $Elements of version 2.x. In binary files the
+ *  elements are grouped by type and number of tags. */
+{
+  int nb_elements = (int) gmsh_ReadAsciiInteger(gmshfile) ;
+  
+  gmsh_DataReserveElements(data,nb_elements) ;
+  
+  if(gmsh_FileIsBinary(gmshfile)) {
+    int i = 0 ;
+    
+    gmsh_SkipLine(gmshfile) ;
+    
+    while(i < nb_elements) {
+      int elm_type = gmsh_ReadInt(gmshfile) ;
+      int nb       = gmsh_ReadInt(gmshfile) ;
+      int nb_tags  = gmsh_ReadInt(gmshfile) ;
+      int nn = gmsh_NbNodes(elm_type) ;
+      int k ;
+      
+      if(nb <= 0 || i + nb > nb_elements) {
+        arret("gmsh_ReadElements_2: bad element block") ;
+      }
+      
+      for(k = 0 ; k < nb ; k++) {
+        int n = gmsh_ReadInt(gmshfile) ;
+        int physical = 1 ;
+        int elementary = 1 ;
+        int* nodetag ;
+        int j ;
+        
+        for(j = 0 ; j < nb_tags ; j++) {
+          int tag = gmsh_ReadInt(gmshfile) ;
+          
+          if(j == 0)      physical   = tag ;
+          else if(j == 1) elementary = tag ;
+        }
+        
+        nodetag = gmsh_DataAddElement(data,n,elm_type,physical,elementary) ;
+        
+        for(j = 0 ; j < nn ; j++) {
+          nodetag[j] = gmsh_ReadInt(gmshfile) ;
+        }
+      }
+      
+      i += nb ;
+    }
+    
+  } else {
+    int i ;
+    
+    for(i = 0 ; i < nb_elements ; i++) {
+      int n        = gmsh_ReadInt(gmshfile) ;
+      int elm_type = gmsh_ReadInt(gmshfile) ;
+      int nb_tags  = gmsh_ReadInt(gmshfile) ;
+      int physical = 1 ;
+      int elementary = 1 ;
+      int nn = gmsh_NbNodes(elm_type) ;
+      int* nodetag ;
+      int j ;
+      
+      for(j = 0 ; j < nb_tags ; j++) {
+        int tag = gmsh_ReadInt(gmshfile) ;
+        
+        if(j == 0)      physical   = tag ;
+        else if(j == 1) elementary = tag ;
+        /* ignore any other tags for now */
+      }
+      
+      nodetag = gmsh_DataAddElement(data,n,elm_type,physical,elementary) ;
+      
+      for(j = 0 ; j < nn ; j++) {
+        nodetag[j] = gmsh_ReadInt(gmshfile) ;
+      }
+    }
+  }
+}
+
+
+
+void gmsh_ReadElements_4(gmsh_File_t* gmshfile,gmsh_Data_t* data)
+/** Read the section $Elements of version 4.1. The physical tag of
+ *  an element is the first one of its entity (0 if none). */
+{
+  size_t nb_blocks   = gmsh_ReadSize(gmshfile) ;
+  int    nb_elements = (int) gmsh_ReadSize(gmshfile) ;
+  size_t ib ;
+  
+  /* minElementTag maxElementTag */
+  gmsh_ReadSize(gmshfile) ;
+  gmsh_ReadSize(gmshfile) ;
+  
+  gmsh_DataReserveElements(data,nb_elements) ;
+  
+  for(ib = 0 ; ib < nb_blocks ; ib++) {
+    int entitydim = gmsh_ReadInt(gmshfile) ;
+    int entitytag = gmsh_ReadInt(gmshfile) ;
+    int elm_type  = gmsh_ReadInt(gmshfile) ;
+    size_t nb = gmsh_ReadSize(gmshfile) ;
+    int nn = gmsh_NbNodes(elm_type) ;
+    int physical = gmsh_DataFindPhysical(data,entitydim,entitytag) ;
+    size_t k ;
+    
+    for(k = 0 ; k < nb ; k++) {
+      int n = (int) gmsh_ReadSize(gmshfile) ;
+      int* nodetag = gmsh_DataAddElement(data,n,elm_type,physical,entitytag) ;
+      int j ;
+      
+      for(j = 0 ; j < nn ; j++) {
+        nodetag[j] = (int) gmsh_ReadSize(gmshfile) ;
+      }
+    }
+  }
+}
+
+
+
+void gmsh_ReadEntities_4(gmsh_File_t* gmshfile,gmsh_Data_t* data)
+/** Read the section $Entities of version 4.1 and store the first
+ *  physical tag of each entity. */
+{
+  int nb[4] ;
+  int d ;
+  
+  for(d = 0 ; d < 4 ; d++) {
+    nb[d] = (int) gmsh_ReadSize(gmshfile) ;
+  }
+  
+  for(d = 0 ; d < 4 ; d++) {
+    int* entitytag = (int*) Mry_NewIn(Mesh,int[2*nb[d] + 1]) ;
+    int i ;
+    
+    Mry_Free(data->entitytag[d]) ;
+    data->entitytag[d] = entitytag ;
+    data->nbofentities[d] = nb[d] ;
+    
+    for(i = 0 ; i < nb[d] ; i++) {
+      int nreal = (d == 0) ? 3 : 6 ;
+      size_t nphys ;
+      size_t j ;
+      
+      entitytag[2*i] = gmsh_ReadInt(gmshfile) ;
+      entitytag[2*i + 1] = 0 ;
+      
+      /* Coordinates or bounding box */
+      for(j = 0 ; j < (size_t) nreal ; j++) gmsh_ReadReal(gmshfile) ;
+      
+      nphys = gmsh_ReadSize(gmshfile) ;
+      
+      for(j = 0 ; j < nphys ; j++) {
+        int tag = gmsh_ReadInt(gmshfile) ;
+        
+        if(j == 0) entitytag[2*i + 1] = tag ;
+      }
+      
+      /* Bounding entities */
+      if(d > 0) {
+        size_t nbound = gmsh_ReadSize(gmshfile) ;
+        
+        for(j = 0 ; j < nbound ; j++) gmsh_ReadInt(gmshfile) ;
+      }
+    }
+  }
+}
+
+
+
+
 /* Not used anymore */
 
 
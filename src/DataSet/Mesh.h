@@ -30,7 +30,9 @@ extern void     (Mesh_InitializeSolutionPointers)(Mesh_t*,Solutions_t*) ;
 extern int      (Mesh_LoadCurrentSolution)(Mesh_t*,DataFile_t*,double*) ;
 extern int      (Mesh_StoreCurrentSolution)(Mesh_t*,DataFile_t*,double) ;
 extern void     (Mesh_SetCurrentUnknownsWithBoundaryConditions)(Mesh_t*,BConds_t*,double) ;
+extern int      (Mesh_SetCurrentUnknownsWithPredictor)(Mesh_t*,Solutions_t*,BConds_t*,int) ;
 extern void     (Mesh_UpdateCurrentUnknowns)(Mesh_t*,Solver_t*) ;
+extern int      (Mesh_UpdateCurrentUnknownsWithStepLength)(Mesh_t*,Solver_t*,double) ;
 //extern void     (Mesh_CreateEquationContinuity)(Mesh_t*,Materials_t*) ;
 extern void     (Mesh_SetEquationContinuity)(Mesh_t*) ;
 extern void     (Mesh_PrintData)(Mesh_t*,char*) ;
@@ -41,6 +43,7 @@ extern void     (Mesh_PrintData)(Mesh_t*,char*) ;
 #define Mesh_MaxLengthOfKeyWord        (30)
 #define Mesh_MaxLengthOfFileName       (60)
 #define Mesh_MaxLengthOfTextLine       (500)
+#define Mesh_MaxOrderOfPredictor       (2)
 
 
 
@@ -11,14 +11,17 @@
 
 Nodes_t*  Nodes_New(const int nn,const int dim,const int nc)
 {
-  Nodes_t* nodes = (Nodes_t*) Mry_New(Nodes_t) ;
+  Nodes_t* nodes = (Nodes_t*) Mry_NewIn(Mesh,Nodes_t) ;
   
   Nodes_GetNbOfNodes(nodes) = nn ;
   Nodes_GetNbOfConnectivities(nodes) = nc ;
+  Nodes_GetDOFOffset(nodes) = NULL ;
+  Nodes_GetObjectiveValueOfDOF(nodes) = NULL ;
+  Nodes_GetObjectiveTypeOfDOF(nodes) = NULL ;
   
   /* Allocation of space for the nodes */
   {
-    Node_t* node = (Node_t*) Mry_New(Node_t[nn]) ;
+    Node_t* node = (Node_t*) Mry_NewIn(Mesh,Node_t[nn]) ;
     
     Nodes_GetNode(nodes) = node ;
   }
@@ -26,14 +29,14 @@ Nodes_t*  Nodes_New(const int nn,const int dim,const int nc)
   /* Allocation of space for the coordinates */
   {
     Node_t* node = Nodes_GetNode(nodes) ;
-    double* x = (double*) Mry_New(double[nn*dim]) ;
+    double* x = (double*) Mry_NewIn(Mesh,double[nn*dim]) ;
     
     Node_GetCoordinate(node) = x ;
   }
   
   /* Allocation of space for the pointers to "element" */
   {
-    Element_t** pel = (Element_t**) Mry_New(Element_t*[nc]) ;
+    Element_t** pel = (Element_t**) Mry_NewIn(Mesh,Element_t*[nc]) ;
     Node_t* node = Nodes_GetNode(nodes) ;
         
     Node_GetPointerToElement(node) = pel ;
@@ -79,12 +82,12 @@ void Nodes_Delete(void* self)
     double* x = Node_GetCoordinate(node) ;
     Element_t** pel = Node_GetPointerToElement(node) ;
     
-    free(node) ;
-    free(x) ;
-    free(pel) ;
+    Mry_Free(node) ;
+    Mry_Free(x) ;
+    Mry_Free(pel) ;
   }
   
-  free(nodes) ;
+  Mry_Free(nodes) ;
 }
 
 
@@ -217,11 +220,26 @@ void  Nodes_CreateMore(Nodes_t* nodes)
   }
   
   
+  /* The offsets of the degrees of freedom of the nodes */
+  {
+    unsigned int* offset = (unsigned int*) Mry_NewIn(Mesh,unsigned int[n_no + 1]) ;
+    int    i ;
+    
+    offset[0] = 0 ;
+    
+    for(i = 0 ; i < n_no ; i++) {
+      offset[i + 1] = offset[i] + Node_GetNbOfUnknowns(node + i) ;
+    }
+    
+    Nodes_GetDOFOffset(nodes) = offset ;
+  }
+  
+  
   /* Allocate memory space for names of equations and unknowns */
   {
     {
       int n_dof = Nodes_GetNbOfDOF(nodes) ;
-      char** uname = (char**) Mry_New(char*[2*n_dof]) ;
+      char** uname = (char**) Mry_NewIn(Mesh,char*[2*n_dof]) ;
       char** ename = uname + n_dof ;
       int in ;
   
@@ -238,7 +256,7 @@ void  Nodes_CreateMore(Nodes_t* nodes)
   /* Allocation of space for the matrix column indexes */
   {
     int n_dof = Nodes_GetNbOfDOF(nodes) ;
-    int* colind = (int*) Mry_New(int[n_dof]) ;
+    int* colind = (int*) Mry_NewIn(Mesh,int[n_dof]) ;
     int    i ;
     
     for(i = 0 ; i < n_no ; i++) {
@@ -251,7 +269,7 @@ void  Nodes_CreateMore(Nodes_t* nodes)
   /* Allocation of space for the matrix row indexes */
   {
     int n_dof = Nodes_GetNbOfDOF(nodes) ;
-    int* rowind = (int*) Mry_New(int[n_dof]) ;
+    int* rowind = (int*) Mry_NewIn(Mesh,int[n_dof]) ;
     int    i ;
     
     for(i = 0 ; i < n_no ; i++) {
@@ -265,7 +283,7 @@ void  Nodes_CreateMore(Nodes_t* nodes)
   /* Allocation of space for the index of objective values */
   {
     unsigned int n_dof = Nodes_GetNbOfDOF(nodes) ;
-    unsigned short int* index = (unsigned short int*) Mry_New(unsigned short int[n_dof]) ;
+    unsigned short int* index = (unsigned short int*) Mry_NewIn(Mesh,unsigned short int[n_dof]) ;
     
     {
       int i ;
@@ -303,17 +321,47 @@ void Nodes_DeleteMore(void* self)
     int* rowind = Node_GetMatrixRowIndex(node) ;
     unsigned short int* index = Node_GetObValIndex(node) ;
     Buffer_t* buf = Node_GetBuffer(node) ;
+    unsigned int* offset = Nodes_GetDOFOffset(nodes) ;
+    double* obval = Nodes_GetObjectiveValueOfDOF(nodes) ;
+    char*   obtype = Nodes_GetObjectiveTypeOfDOF(nodes) ;
     
-    free(uname) ;
-    free(colind) ;
-    free(rowind) ;
-    free(index) ;
+    Mry_Free(uname) ;
+    Mry_Free(colind) ;
+    Mry_Free(rowind) ;
+    Mry_Free(index) ;
+    Mry_Free(offset) ;
+    Mry_Free(obval) ;
+    Mry_Free(obtype) ;
     Buffer_Delete(&buf) ;
   }
 }
 
 
 
+unsigned int (Nodes_FindNodeIndexOfDOF)(Nodes_t* nodes,const unsigned int idof)
+/** Return the index of the node owning the degree of freedom idof
+ *  of the arrays of all the degrees of freedom. */
+{
+  unsigned int* offset = Nodes_GetDOFOffset(nodes) ;
+  unsigned int i0 = 0 ;
+  unsigned int i1 = Nodes_GetNbOfNodes(nodes) ;
+  
+  /* Bisection: offset[i0] <= idof < offset[i1] */
+  while(i1 - i0 > 1) {
+    unsigned int i = (i0 + i1)/2 ;
+    
+    if(offset[i] <= idof) {
+      i0 = i ;
+    } else {
+      i1 = i ;
+    }
+  }
+  
+  return(i0) ;
+}
+
+
+
 void  Nodes_InitializeMatrixRowColumnIndexes(Nodes_t* nodes)
 /** Initialization to arbitrarily negative value (-1) 
   * so as to eliminate dof of isolated nodes or
@@ -388,7 +436,7 @@ void Nodes_SetMatrixRowColumnIndexes(Nodes_t* nodes,DataFile_t* datafile)
       }
     }
   
-    if(perm) free(perm) ;
+    if(perm) Mry_Free(perm) ;
   }
   
   
@@ -398,6 +446,9 @@ void Nodes_SetMatrixRowColumnIndexes(Nodes_t* nodes,DataFile_t* datafile)
   
   Nodes_GetNbOfMatrixRows(nodes) = NbOfMatrixRows ;
   Nodes_GetNbOfMatrixColumns(nodes) = NbOfMatrixColumns ;
+  
+  /* Any structure built on the previous numbering is now out of date */
+  Nodes_GetNbOfMatrixNumberings(nodes) += 1 ;
 }
 
 
@@ -486,6 +537,31 @@ void Nodes_InitializeObValIndexes(Nodes_t* nodes)
       }
     }
   }
+  
+  /* The objective variations of the dof as flat arrays */
+  {
+    unsigned int n_dof = Nodes_GetNbOfDOF(nodes) ;
+    unsigned short int* obvalind = Nodes_GetObValIndex(nodes) ;
+    ObVal_t* obval = ObVals_GetObVal(obvals) ;
+    double* dofobval = Nodes_GetObjectiveValueOfDOF(nodes) ;
+    char*   dofobtype = Nodes_GetObjectiveTypeOfDOF(nodes) ;
+    unsigned int i ;
+    
+    if(!dofobval) {
+      dofobval  = (double*) Mry_NewIn(Mesh,double[n_dof]) ;
+      dofobtype = (char*) Mry_NewIn(Mesh,char[n_dof]) ;
+      
+      Nodes_GetObjectiveValueOfDOF(nodes) = dofobval ;
+      Nodes_GetObjectiveTypeOfDOF(nodes) = dofobtype ;
+    }
+    
+    for(i = 0 ; i < n_dof ; i++) {
+      ObVal_t* obval_i = obval + obvalind[i] ;
+      
+      dofobval[i]  = ObVal_GetValue(obval_i) ;
+      dofobtype[i] = ObVal_GetType(obval_i) ;
+    }
+  }
 }
 
 
@@ -18,6 +18,7 @@ extern int       (Nodes_ComputeNbOfUnknownFields)    (Nodes_t*) ;
 extern void      (Nodes_InitializeObValIndexes)      (Nodes_t*) ;
 extern void      (Nodes_SetMatrixRowColumnIndexes)   (Nodes_t*,DataFile_t*) ;
 extern void      (Nodes_InitializeMatrixRowColumnIndexes)(Nodes_t*) ;
+extern unsigned int (Nodes_FindNodeIndexOfDOF)       (Nodes_t*,const unsigned int) ;
 
 
 
@@ -27,6 +28,47 @@ extern void      (Nodes_InitializeMatrixRowColumnIndexes)(Nodes_t*) ;
 #define Nodes_GetNbOfMatrixRows(NODS)     ((NODS)->n_rows)
 #define Nodes_GetNbOfDOF(NODS)            ((NODS)->n_dof)
 #define Nodes_GetObjectiveValues(NODS)    ((NODS)->obvals)
+#define Nodes_GetNbOfMatrixNumberings(NODS) ((NODS)->n_numb)
+#define Nodes_GetDOFOffset(NODS)          ((NODS)->dofoffset)
+#define Nodes_GetObjectiveValueOfDOF(NODS) ((NODS)->dofobval)
+#define Nodes_GetObjectiveTypeOfDOF(NODS) ((NODS)->dofobtype)
+
+
+
+/* The objective variation of each dof, its value and its type
+ * (see ObVal.h), copied from the objective values */
+#define Nodes_ObjectiveValueOfDOFIsRelative(NODS,i) \
+        (Nodes_GetObjectiveTypeOfDOF(NODS)[i] == 'r')
+
+
+
+/* Arrays of all the degrees of freedom.
+ * The values of a node are stored contiguously after those of the
+ * previous node, the first one of node i being at Nodes_GetDOFOffset(NODS)[i].
+ * So these arrays can be looped over as a whole. */
+#define Nodes_GetMatrixColumnIndex(NODS) \
+        Node_GetMatrixColumnIndex(Nodes_GetNode(NODS))
+        
+#define Nodes_GetMatrixRowIndex(NODS) \
+        Node_GetMatrixRowIndex(Nodes_GetNode(NODS))
+        
+#define Nodes_GetObValIndex(NODS) \
+        Node_GetObValIndex(Nodes_GetNode(NODS))
+        
+#define Nodes_GetCurrentUnknown(NODS) \
+        Node_GetCurrentUnknown(Nodes_GetNode(NODS))
+        
+#define Nodes_GetPreviousUnknown(NODS) \
+        Node_GetPreviousUnknown(Nodes_GetNode(NODS))
+        
+#define Nodes_GetDeepUnknown(NODS,i) \
+        Node_GetDeepUnknown(Nodes_GetNode(NODS),i)
+
+
+/* Loops over all the dof are multithreaded (if OpenMP is enabled)
+ * only above this nb of dof */
+#define Nodes_MinNbOfDOFForThreads        (10000)
+
 
 
 /* Synonyms */
@@ -45,6 +87,10 @@ struct Nodes_s {              /* nodes */
   unsigned int n_no ;         /* nb of nodes */
   unsigned int n_con ;        /* nb of connectivities */
   unsigned int n_dof ;        /* nb of degrees of freedom */
+  unsigned int n_numb ;       /* nb of times the matrix rows/columns were numbered */
+  unsigned int* dofoffset ;   /* offset of the dof of the nodes */
+  double* dofobval ;          /* objective variation of the dof */
+  char*   dofobtype ;         /* type of the objective variation of the dof */
   Node_t* no ;                /* node */
   ObVals_t* obvals ;          /* Objective values */
 } ;
@@ -27,6 +27,7 @@ ObVal_t*  ObVal_New(void)
   ObVal_GetValue(obval) = -1 ; /* arbitrary negative */
   ObVal_SetTypeToAbsolute(obval) ;
   ObVal_GetRelaxationFactor(obval) = 1 ;
+  ObVal_GetMaxIncrement(obval) = 0 ;
   
   return(obval) ;
 }
@@ -94,4 +95,19 @@ void  ObVal_Scan(ObVal_t* obval,DataFile_t* datafile)
       ObVal_GetRelaxationFactor(obval) = r ;
     }
   }
+  
+  
+  /* Max increment per iteration (if any) */
+  {
+    double d ;
+    int n = String_FindAndScanExp(line,"Limit",","," = %le",&d) ;
+    
+    if(n) {
+      if(d <= 0.) {
+        arret("ObVal_Scan: the limit should be positive") ;
+      }
+      
+      ObVal_GetMaxIncrement(obval) = d ;
+    }
+  }
 }
@@ -22,6 +22,7 @@ extern void      (ObVal_Scan)(ObVal_t*,DataFile_t*) ;
 #define ObVal_GetNameOfUnknown(OV)    ((OV)->inc)
 #define ObVal_GetValue(OV)            ((OV)->val)
 #define ObVal_GetRelaxationFactor(OV) ((OV)->relaxfactor)
+#define ObVal_GetMaxIncrement(OV)     ((OV)->maxincrement)
 
 
 
@@ -48,6 +49,11 @@ extern void      (ObVal_Scan)(ObVal_t*,DataFile_t*) ;
         (ObVal_GetValue(OV) / ((ObVal_IsRelativeValue(OV)) ? 1 : fabs(U)))
 
 
+/* Trust limit of the increment of the unknown per iteration */
+#define ObVal_IncrementIsLimited(OV) \
+        (ObVal_GetMaxIncrement(OV) > 0.)
+
+
 
 
 struct ObVal_s {              /* Objective variation */
@@ -55,6 +61,7 @@ struct ObVal_s {              /* Objective variation */
   char*   inc ;               /* Name of the unknown */
   double  val ;               /* Objective variation */
   double  relaxfactor ;       /* Relaxation factor */
+  double  maxincrement ;      /* Max increment per iteration (none if <= 0) */
 } ;
 
 #endif
@@ -46,9 +46,7 @@ ObVals_t*  ObVals_New(const int n_obvals)
 #if 0
 ObVals_t*  ObVals_Create(DataFile_t* datafile,Mesh_t* mesh,Materials_t* mats)
 {
-  ObVals_t* obvals = (ObVals_t*) malloc(sizeof(ObVals_t)) ;
-  
-  if(!obvals) arret("ObVals_Create") ;
+  ObVals_t* obvals = (ObVals_t*) Mry_NewIn(Mesh,ObVals_t) ;
   
   DataFile_OpenFile(datafile,"r") ;
   
@@ -60,10 +58,8 @@ ObVals_t*  ObVals_Create(DataFile_t* datafile,Mesh_t* mesh,Materials_t* mats)
   
   /* Allocation of space for the objective values */
   {
-    ObVal_t* obval = (ObVal_t*) malloc(Model_MaxNbOfEquations*sizeof(ObVal_t)) ;
+    ObVal_t* obval = (ObVal_t*) Mry_NewIn(Mesh,ObVal_t[Model_MaxNbOfEquations]) ;
     
-    if(!obval) arret("ObVals_Create (7) : impossible d\'allouer la memoire") ;
-
     ObVals_GetObVal(obvals) = obval ;
   }
   
@@ -73,9 +69,7 @@ ObVals_t*  ObVals_Create(DataFile_t* datafile,Mesh_t* mesh,Materials_t* mats)
   #if 0
   {
     unsigned int n_dof = Nodes_GetNbOfDOF(Mesh_GetNodes(mesh)) ;
-    unsigned short int* index = (unsigned short int*) malloc(n_dof*sizeof(unsigned short int)) ;
-    
-    if(!index) arret("ObVals_Create (1) : impossible d\'allouer la memoire") ;
+    unsigned short int* index = (unsigned short int*) Mry_NewIn(Mesh,unsigned short int[n_dof]) ;
     
     {
       Node_t* node = Mesh_GetNode(mesh) ;
@@ -151,9 +151,9 @@ void Periodicities_Delete(void* self)
   {
     Periodicity_t* periodicity = Periodicities_GetPeriodicity(periodicities) ;
     
-    free(Periodicity_GetPeriodVector(periodicity)) ;
+    Mry_Free(Periodicity_GetPeriodVector(periodicity)) ;
   }
-  free(periodicities) ;
+  Mry_Free(periodicities) ;
   
   //*pperiodicities = NULL ;
 }
@@ -174,11 +174,7 @@ Graph_t*  (Periodicities_ComputeGraph)(Mesh_t* mesh)
   {
     int    n_no = Mesh_GetNbOfNodes(mesh) ;
     /* Nb of connections per node (useful to size graph) */
-    int*   nnz_no = (int*) calloc(n_no,sizeof(int)) ;
-  
-    if(!nnz_no) {
-      arret("Periodicities_ComputeGraph(1): impossible d\'allouer la memoire") ;
-    }
+    int*   nnz_no = (int*) Mry_NewIn(Mesh,int[n_no]) ;
   
   
     /* An overestimation of nnz_no */
@@ -215,7 +211,7 @@ Graph_t*  (Periodicities_ComputeGraph)(Mesh_t* mesh)
     
     graph = Graph_Create(n_no,nnz_no) ;
 
-    free(nnz_no) ;
+    Mry_Free(nnz_no) ;
   }
   
   
@@ -32,8 +32,8 @@ void Periodicity_Delete(void* self)
   Periodicity_t** pperiodicity = (Periodicity_t**) self ;
   Periodicity_t*   periodicity = *pperiodicity ;
   
-  free(Periodicity_GetPeriodVector(periodicity)) ;
-  free(periodicity) ;
+  Mry_Free(Periodicity_GetPeriodVector(periodicity)) ;
+  Mry_Free(periodicity) ;
   
   //*pperiodicity = NULL ;
 }
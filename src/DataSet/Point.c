@@ -37,8 +37,8 @@ void Point_Delete(void* self)
   Point_t** ppoint = (Point_t**) self ;
   Point_t*   point = *ppoint ;
   
-  free(Point_GetCoordinate(point)) ;
-  free(point) ;
+  Mry_Free(Point_GetCoordinate(point)) ;
+  Mry_Free(point) ;
   
   *ppoint = NULL ;
 }
@@ -36,6 +36,14 @@ Points_t*  Points_New(const int n_points)
     Points_GetPoint(points) = point ;
   }
   
+  
+  /* Outputs at each step in ASCII format */
+  {
+    Points_GetOutputPeriod(points) = 1 ;
+    Points_GetOutputInterval(points) = 0 ;
+    Points_GetOutputFormat(points) = 'a' ;
+  }
+  
   return(points) ;
 }
 
@@ -44,13 +52,12 @@ Points_t*  Points_New(const int n_points)
 #if 0
 Points_t*  Points_Create(DataFile_t* datafile,Mesh_t* mesh)
 {
-  Points_t* points = (Points_t*) malloc(sizeof(Points_t)) ;
+  Points_t* points = (Points_t*) Mry_NewIn(Mesh,Points_t) ;
   int dim = Mesh_GetDimension(mesh) ;
   int n_points ;
   FILE *ficd ;
   int   i ;
   
-  if(!points) arret("Points_Create") ;
   
   DataFile_OpenFile(datafile,"r") ;
   
@@ -72,9 +79,7 @@ Points_t*  Points_Create(DataFile_t* datafile,Mesh_t* mesh)
   
   /* Memory space for points */
   {
-    Point_t* point = (Point_t*) malloc(n_points*sizeof(Point_t)) ;
-    
-    if(!point) arret("Points_Create (2)") ;
+    Point_t* point = (Point_t*) Mry_NewIn(Mesh,Point_t[n_points]) ;
     
     Points_GetPoint(points) = point ;
   }
@@ -82,9 +87,7 @@ Points_t*  Points_Create(DataFile_t* datafile,Mesh_t* mesh)
   
   /* Memory space for coordinates */
   {
-    double* coor = (double*) calloc(3*n_points,sizeof(double)) ;
-    
-    if(!coor) arret("Points_Create (1)") ;
+    double* coor = (double*) Mry_NewIn(Mesh,double[3*n_points]) ;
     
     for(i = 0 ; i < n_points ; i++) {
       Point_t* point_i = Points_GetPoint(points) + i ;
@@ -130,6 +133,7 @@ Points_t*  Points_Create(DataFile_t* datafile,Mesh_t* mesh)
 {
   char* filecontent = DataFile_GetFileContent(datafile) ;
   char* c  = String_FindToken(filecontent,"POIN,Points",",") ;
+  char* header = c ;
   int n_points = (c = String_SkipLine(c)) ? atoi(c) : 0 ;
   Points_t* points = Points_New(n_points) ;
   
@@ -138,6 +142,39 @@ Points_t*  Points_Create(DataFile_t* datafile,Mesh_t* mesh)
   Message_Direct("\n") ;
   
   
+  /* Options of the outputs on the line of the keyword:
+   * Period = k     outputs every k steps
+   * Interval = dt  outputs separated by at least dt
+   * Binary         outputs in binary format */
+  if(header) {
+    char* line = String_CopyLine(header) ;
+    
+    {
+      int k ;
+      
+      if(String_FindAndScanExp(line,"Period",","," = %d",&k)) {
+        if(k < 1) {
+          arret("Points_Create: the period should be at least 1") ;
+        }
+        
+        Points_GetOutputPeriod(points) = k ;
+      }
+    }
+    
+    {
+      double dt ;
+      
+      if(String_FindAndScanExp(line,"Interval",","," = %lf",&dt)) {
+        Points_GetOutputInterval(points) = dt ;
+      }
+    }
+    
+    if(String_FindToken(line,"Binary")) {
+      Points_GetOutputFormat(points) = 'b' ;
+    }
+  }
+  
+  
   c = String_SkipLine(c) ;
 
 
@@ -168,7 +205,7 @@ Points_t*  Points_Create(DataFile_t* datafile,Mesh_t* mesh)
         }
       }
     
-      free(x) ;
+      Mry_Free(x) ;
 
     /* If a token "Reg" is found in the line */
     } else {
@@ -18,6 +18,13 @@ extern Points_t*  (Points_Create)  (DataFile_t*,Mesh_t*) ;
 
 #define Points_GetNbOfPoints(PTS)    ((PTS)->n_points)
 #define Points_GetPoint(PTS)         ((PTS)->point)
+#define Points_GetOutputPeriod(PTS)  ((PTS)->period)
+#define Points_GetOutputInterval(PTS) ((PTS)->interval)
+#define Points_GetOutputFormat(PTS)  ((PTS)->format)
+
+
+#define Points_IsBinaryOutput(PTS) \
+        (Points_GetOutputFormat(PTS) == 'b')
 
 
 
@@ -26,6 +33,9 @@ extern Points_t*  (Points_Create)  (DataFile_t*,Mesh_t*) ;
 struct Points_s {
   unsigned int n_points ;     /* nb of points */
   Point_t*  point ;           /* Point */
+  int    period ;             /* Outputs every period steps */
+  double interval ;           /* Min time interval between outputs */
+  char   format ;             /* Format of the outputs: 'a' ASCII, 'b' binary */
 } ;
 
 
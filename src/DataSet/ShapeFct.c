@@ -37,10 +37,10 @@ void  ShapeFct_Delete(void* self)
   {
     double* b = ShapeFct_GetCoordinate(shapefct) ;
     
-    free(b) ;
+    Mry_Free(b) ;
   }
   
-  //free(shapefct) ;
+  //Mry_Free(shapefct) ;
 }
 
 
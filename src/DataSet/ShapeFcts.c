@@ -48,10 +48,10 @@ void  ShapeFcts_Delete(void* self)
       ShapeFct_Delete(&shapefct_i) ;
     }
     
-    free(shapefct) ;
+    Mry_Free(shapefct) ;
   }
   
-  free(shapefcts) ;
+  Mry_Free(shapefcts) ;
 }
 
 
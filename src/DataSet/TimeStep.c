@@ -7,6 +7,7 @@
 #include "TimeStep.h"
 #include "DataFile.h"
 #include "ObVals.h"
+#include "Mry.h"
 
 
 static TimeStep_t*  TimeStep_New(void) ;
@@ -15,12 +16,8 @@ static TimeStep_t*  TimeStep_New(void) ;
 
 TimeStep_t*  TimeStep_New(void)
 {
-  TimeStep_t* timestep = (TimeStep_t*) malloc(sizeof(TimeStep_t)) ;
+  TimeStep_t* timestep = (TimeStep_t*) Mry_NewIn(Mesh,TimeStep_t) ;
   
-  if(!timestep) {
-    arret("TimeStep_New") ;
-  }
-
   /* default values */
   TimeStep_GetInitialTimeStep(timestep)    = 0 ;
   TimeStep_GetMaximumTimeStep(timestep)    = 0 ;
@@ -30,6 +27,16 @@ TimeStep_t*  TimeStep_New(void)
   TimeStep_GetObVals(timestep)             = NULL ;
   TimeStep_GetLocation(timestep)           = 0 ;
   TimeStep_SetLocationAtBegin(timestep) ;
+  TimeStep_GetPredictorOrder(timestep)     = 0 ;
+  TimeStep_SetControllerToObjectiveVariations(timestep) ;
+  TimeStep_GetErrorTolerance(timestep)     = 0.1 ;
+  TimeStep_GetSafetyFactor(timestep)       = 0.9 ;
+  TimeStep_GetPreviousErrorRatio(timestep) = 0 ;
+  TimeStep_GetProposedTimeStep(timestep)   = 0 ;
+  TimeStep_GetNbOfAcceptedSteps(timestep)  = 0 ;
+  TimeStep_GetNbOfRejectedSteps(timestep)  = 0 ;
+  TimeStep_GetMaxNbOfRejections(timestep)  = 10 ;
+  TimeStep_GetRejectionIndex(timestep)     = 0 ;
 
   return(timestep) ;
 }
@@ -104,6 +111,61 @@ TimeStep_t*  TimeStep_Create(DataFile_t* datafile,ObVals_t* obvals)
   } else {
     TimeStep_GetMaximumCommonRatio(timestep) = 1.5 ;
   }
+    
+  /* Predictor: order of the extrapolation of the unknowns
+   * from the last converged solutions (0 = none, 1 = linear, 2 = quadratic) */
+  DataFile_MoveToStoredFilePosition(datafile) ;
+  while((line = DataFile_ReadLineFromCurrentFilePosition(datafile)) && !(pline = strstr(line,"Predictor"))) ;
+  if(line && (pline = strstr(line,"Predictor"))) {
+    pline = strchr(pline,'=') + 1 ;
+    TimeStep_GetPredictorOrder(timestep) = atoi(pline) ;
+  } else {
+    TimeStep_GetPredictorOrder(timestep) = 0 ;
+  }
+  
+  if(TimeStep_GetPredictorOrder(timestep) < 0 || TimeStep_GetPredictorOrder(timestep) > 2) {
+    arret("TimeStep_Create : the order of the predictor should be 0, 1 or 2") ;
+  }
+    
+  /* Controller: "Objective Variations" (default) or "Error" (PI control
+   * of the local truncation error estimated with a linear predictor) */
+  DataFile_MoveToStoredFilePosition(datafile) ;
+  while((line = DataFile_ReadLineFromCurrentFilePosition(datafile)) && !(pline = strstr(line,"Controller"))) ;
+  if(line && (pline = strstr(line,"Controller"))) {
+    pline = strchr(pline,'=') + 1 ;
+    
+    if(strstr(pline,"Error")) {
+      TimeStep_SetControllerToErrorEstimate(timestep) ;
+    } else if(strstr(pline,"Objective")) {
+      TimeStep_SetControllerToObjectiveVariations(timestep) ;
+    } else {
+      arret("TimeStep_Create : unknown controller") ;
+    }
+  }
+    
+  /* Error tolerance, relative to the objective variations */
+  DataFile_MoveToStoredFilePosition(datafile) ;
+  while((line = DataFile_ReadLineFromCurrentFilePosition(datafile)) && !(pline = strstr(line,"Error Tolerance"))) ;
+  if(line && (pline = strstr(line,"Error Tolerance"))) {
+    pline = strchr(pline,'=') + 1 ;
+    TimeStep_GetErrorTolerance(timestep) = atof(pline) ;
+    
+    if(TimeStep_GetErrorTolerance(timestep) <= 0) {
+      arret("TimeStep_Create : the error tolerance should be positive") ;
+    }
+  }
+    
+  /* Max nb of rejections of a step by the error controller */
+  DataFile_MoveToStoredFilePosition(datafile) ;
+  while((line = DataFile_ReadLineFromCurrentFilePosition(datafile)) && !(pline = strstr(line,"Max Rejections"))) ;
+  if(line && (pline = strstr(line,"Max Rejections"))) {
+    pline = strchr(pline,'=') + 1 ;
+    TimeStep_GetMaxNbOfRejections(timestep) = atoi(pline) ;
+    
+    if(TimeStep_GetMaxNbOfRejections(timestep) < 0) {
+      arret("TimeStep_Create : the max nb of rejections should be positive") ;
+    }
+  }
   
   DataFile_CloseFile(datafile) ;
   
@@ -133,48 +195,89 @@ double TimeStep_ComputeTimeStep(TimeStep_t* timestep,Nodes_t* nodes,double tn,do
     dt = TimeStep_GetInitialTimeStep(timestep) ;
     
 //  } else if(tn == t1 && step == fin) { /* beginning of a new date */
+  } else if(TimeStep_IsErrorControlled(timestep) && TimeStep_GetProposedTimeStep(timestep) > zero) {
+    /* The error controller goes on through the dates */
+    if(tn == t1) {
+      TimeStep_SetLocationAtBegin(timestep) ;
+    } else {
+      TimeStep_SetLocationInBetween(timestep) ;
+    }
+    
+    dt = TimeStep_GetProposedTimeStep(timestep) ;
+
+    if(dt > TimeStep_GetMaximumTimeStep(timestep)) {
+      dt = TimeStep_GetMaximumTimeStep(timestep) ;
+    }
+    
+    if(dt < TimeStep_GetMinimumTimeStep(timestep)) {
+      dt = TimeStep_GetMinimumTimeStep(timestep) ;
+    }
+    
   } else if(tn == t1 && TimeStep_IsLocatedAtEnd(timestep)) { /* beginning of a new date */
     TimeStep_SetLocationAtBegin(timestep) ;
     /* To get around the fact that for very tiny dt: (t1 - tn) = 0 ! */
     dt = TimeStep_GetInitialTimeStep(timestep) ;
     
   } else {
-    unsigned int n_no = Nodes_GetNbOfNodes(nodes) ;
-    Node_t* no = Nodes_GetNode(nodes) ;
-    ObVal_t* obval = TimeStep_GetObVal(timestep) ;
+    int n_dof = Nodes_GetNbOfDOF(nodes) ;
+    double* obval = Nodes_GetObjectiveValueOfDOF(nodes) ;
+    double* u_n = Nodes_GetPreviousUnknown(nodes) ;
+    /* The solution before u_n (the current one if only 2 solutions are stored) */
+    double* u_nm1 = Nodes_GetDeepUnknown(nodes,2) ;
     int    obvalindex = 0 ;
     int    nodeindex = 0 ;
+    int    dofindex = -1 ;
     double varmax = zero ;
     double rs ;
-    unsigned int i ;
     
     //step = entre ;
     TimeStep_SetLocationInBetween(timestep) ;
     
-    for(i = 0 ; i < n_no ; i++) {
-      Node_t* nodi = no + i ;
-      int neq = Node_GetNbOfEquations(nodi) ;
-      double* u_1 = Node_GetCurrentUnknown(nodi) ;
-      double* u_n = Node_GetPreviousUnknown(nodi) ;
-      int j ;
+    /* Max-norm over all the dof. Each thread reduces a chunk of
+     * the dof then the partial maxima are merged. */
+    #ifdef _OPENMP
+    #pragma omp parallel if(n_dof > Nodes_MinNbOfDOFForThreads)
+    #endif
+    {
+      double varmax_th = zero ;
+      int    dof_th = -1 ;
+      int    i ;
       
-      for(j = 0 ; j < neq ; j++) {
-        ObVal_t* obval_j = obval + Node_GetObValIndex(nodi)[j] ;
-        double val = ObVal_GetValue(obval_j) ;
-        double varrel = fabs(u_1[j] - u_n[j])/val ;
+      #ifdef _OPENMP
+      #pragma omp for schedule(static) nowait
+      #endif
+      for(i = 0 ; i < n_dof ; i++) {
+        double varrel = fabs(u_nm1[i] - u_n[i])/obval[i] ;
         
-        if(ObVal_IsRelativeValue(obval_j)) {
-          if(fabs(u_n[j]) > 0.) varrel /= fabs(u_n[j]) ;
+        if(Nodes_ObjectiveValueOfDOFIsRelative(nodes,i)) {
+          if(fabs(u_n[i]) > 0.) varrel /= fabs(u_n[i]) ;
         }
         
-        if(varrel > varmax) {
-          varmax = varrel ;
-          obvalindex = Node_GetObValIndex(nodi)[j] ;
-          nodeindex = i ;
+        if(varrel > varmax_th) {
+          varmax_th = varrel ;
+          dof_th = i ;
+        }
+      }
+      
+      /* Keep the first dof of maximum variation as in a serial loop */
+      #ifdef _OPENMP
+      #pragma omp critical
+      #endif
+      {
+        if(dof_th >= 0) {
+          if(varmax_th > varmax || (varmax_th == varmax && dof_th < dofindex)) {
+            varmax = varmax_th ;
+            dofindex = dof_th ;
+          }
         }
       }
     }
     
+    if(dofindex >= 0) {
+      obvalindex = Nodes_GetObValIndex(nodes)[dofindex] ;
+      nodeindex  = Nodes_FindNodeIndexOfDOF(nodes,dofindex) ;
+    }
+    
     rs = TimeStep_GetMaximumCommonRatio(timestep) ;
     if(varmax > zero) rs = 1./varmax ;
     if(rs > TimeStep_GetMaximumCommonRatio(timestep)) {
@@ -198,6 +301,17 @@ double TimeStep_ComputeTimeStep(TimeStep_t* timestep,Nodes_t* nodes,double tn,do
   /* tn + dt should not be greater than the next date */
   if(tn + dt > t2) {
     dt = t2 - tn ;
+  } else if(TimeStep_IsErrorControlled(timestep) && tn + dt < t2) {
+    /* Avoid a tiny leftover step before the next date:
+     * stretch the step up to the date if it is close enough,
+     * otherwise split what is left in two equal steps */
+    double eps = TimeStep_StretchingTolerance ;
+    
+    if(t2 - tn <= (1 + eps)*dt) {
+      dt = t2 - tn ;
+    } else if(tn + 2*dt > t2) {
+      dt = 0.5*(t2 - tn) ;
+    }
   }
 
   //if(tn + dt == t2) step = fin ; 
@@ -209,3 +323,135 @@ double TimeStep_ComputeTimeStep(TimeStep_t* timestep,Nodes_t* nodes,double tn,do
   if(dt < zero) arret("ComputeTimeStep: dt < 0") ;
   return(dt) ;
 }
+
+
+
+void TimeStep_LocateTimeStep(TimeStep_t* timestep,double tn,double dt,double t1,double t2)
+/** Set again the location of the time step dt within the range [t1:t2]
+ *  after it has been reduced (repetition or rejection of the step)
+ *  so that a reduced step is no longer located at the end.
+ **/
+{
+  if(tn + dt == t2) {
+    TimeStep_SetLocationAtEnd(timestep) ;
+  } else if(tn == t1) {
+    TimeStep_SetLocationAtBegin(timestep) ;
+  } else {
+    TimeStep_SetLocationInBetween(timestep) ;
+  }
+}
+
+
+
+int TimeStep_ControlTimeStep(TimeStep_t* timestep,Nodes_t* nodes,Solutions_t* sols)
+/** Estimate the local truncation error of the converged current solution
+ *  from its difference with the linear extrapolation of the two previous
+ *  ones and propose the next time step with a PI controller (Gustafsson).
+ *  Return 1 if the error is too large, the current step should then be
+ *  computed again with the proposed time step, 0 otherwise.
+ *  Return always 0 if the error controller is not selected.
+ **/
+{
+  Solution_t* sol_1 = Solutions_GetCurrentSolution(sols) ;
+  Solution_t* sol_n = Solutions_GetPreviousSolution(sols) ;
+  double dt  = Solution_GetTimeStep(sol_1) ;
+  double dtn = Solution_GetTimeStep(sol_n) ;
+  double w[2] ;
+  /* Backward Euler: the error behaves like dt^2 */
+  double k = 2 ;
+  double ratio = 0 ;
+  
+  if(!TimeStep_IsErrorControlled(timestep)) return(0) ;
+  
+  /* The estimate needs two previous solutions */
+  if(Solutions_ComputeExtrapolationWeights(sols,1,w) < 1) {
+    TimeStep_GetProposedTimeStep(timestep) = 0 ;
+    TimeStep_GetPreviousErrorRatio(timestep) = 0 ;
+    return(0) ;
+  }
+  
+  /* Max of the scaled error estimates */
+  {
+    int n_dof = Nodes_GetNbOfDOF(nodes) ;
+    int* colind = Nodes_GetMatrixColumnIndex(nodes) ;
+    double* obval = Nodes_GetObjectiveValueOfDOF(nodes) ;
+    double* u_1 = Nodes_GetCurrentUnknown(nodes) ;
+    double* u_n = Nodes_GetPreviousUnknown(nodes) ;
+    double* u_nm1 = Nodes_GetDeepUnknown(nodes,2) ;
+    /* The predictor error is (dt + dtn)/dt times the one of Euler's scheme */
+    double c = dt/(dt + dtn) ;
+    double errmax = 0 ;
+    int i ;
+    
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(static) reduction(max:errmax) if(n_dof > Nodes_MinNbOfDOFForThreads)
+    #endif
+    for(i = 0 ; i < n_dof ; i++) {
+      if(colind[i] >= 0) {
+        double u_p = w[0]*u_n[i] + w[1]*u_nm1[i] ;
+        double err = c*fabs(u_1[i] - u_p)/obval[i] ;
+        
+        if(Nodes_ObjectiveValueOfDOFIsRelative(nodes,i)) {
+          if(fabs(u_n[i]) > 0.) err /= fabs(u_n[i]) ;
+        }
+          
+        if(err > errmax) errmax = err ;
+      }
+    }
+    
+    ratio = errmax/TimeStep_GetErrorTolerance(timestep) ;
+  }
+  
+  /* PI controller */
+  {
+    double safety = TimeStep_GetSafetyFactor(timestep) ;
+    double facmin = 0.2 ;
+    double facmax = TimeStep_GetMaximumCommonRatio(timestep) ;
+    double dtmin  = TimeStep_GetMinimumTimeStep(timestep) ;
+    double fac ;
+    
+    if(ratio < 1.e-10) ratio = 1.e-10 ;
+    
+    /* Rejection */
+    if(ratio > 1 && dt > dtmin) {
+      fac = safety * pow(ratio,-1/k) ;
+      
+      if(fac < facmin) fac = facmin ;
+      if(fac > safety) fac = safety ;
+      
+      TimeStep_GetProposedTimeStep(timestep) = dt * fac ;
+      
+      return(1) ;
+    }
+    
+    {
+      double kI = 0.3/k ;
+      double kP = 0.4/k ;
+      double ratio_n = TimeStep_GetPreviousErrorRatio(timestep) ;
+      
+      if(ratio_n <= 0) ratio_n = ratio ;
+      
+      fac = safety * pow(ratio,-kI) * pow(ratio_n/ratio,kP) ;
+    }
+    
+    if(fac < facmin) fac = facmin ;
+    if(fac > facmax) fac = facmax ;
+    
+    TimeStep_GetProposedTimeStep(timestep) = dt * fac ;
+    TimeStep_GetPreviousErrorRatio(timestep) = ratio ;
+  }
+  
+  return(0) ;
+}
+
+
+
+void TimeStep_PrintStatistics(TimeStep_t* timestep)
+{
+  unsigned long nbacc = TimeStep_GetNbOfAcceptedSteps(timestep) ;
+  unsigned long nbrej = TimeStep_GetNbOfRejectedSteps(timestep) ;
+  
+  if(TimeStep_IsErrorControlled(timestep)) {
+    Message_Info("%lu accepted time steps, %lu rejected by the error controller\n",nbacc,nbrej) ;
+  }
+}
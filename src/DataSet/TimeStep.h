@@ -10,9 +10,13 @@ struct TimeStep_s     ; typedef struct TimeStep_s     TimeStep_t ;
 #include "DataFile.h"
 #include "ObVals.h"
 #include "Nodes.h"
+#include "Solutions.h"
 
 extern TimeStep_t*  TimeStep_Create(DataFile_t*,ObVals_t*) ;
 extern double       TimeStep_ComputeTimeStep(TimeStep_t*,Nodes_t*,double,double,double,double) ;
+extern int          TimeStep_ControlTimeStep(TimeStep_t*,Nodes_t*,Solutions_t*) ;
+extern void         TimeStep_LocateTimeStep(TimeStep_t*,double,double,double,double) ;
+extern void         TimeStep_PrintStatistics(TimeStep_t*) ;
 
 
 #define TimeStep_GetInitialTimeStep(TS)       ((TS)->dtini)
@@ -22,6 +26,16 @@ extern double       TimeStep_ComputeTimeStep(TimeStep_t*,Nodes_t*,double,double,
 #define TimeStep_GetReductionFactor(TS)       ((TS)->fr)
 #define TimeStep_GetObVals(TS)                ((TS)->obvals)
 #define TimeStep_GetLocation(TS)              ((TS)->loc)
+#define TimeStep_GetPredictorOrder(TS)        ((TS)->predictor)
+#define TimeStep_GetController(TS)            ((TS)->controller)
+#define TimeStep_GetErrorTolerance(TS)        ((TS)->errtol)
+#define TimeStep_GetSafetyFactor(TS)          ((TS)->safety)
+#define TimeStep_GetPreviousErrorRatio(TS)    ((TS)->ratio_n)
+#define TimeStep_GetProposedTimeStep(TS)      ((TS)->dtproposed)
+#define TimeStep_GetNbOfAcceptedSteps(TS)     ((TS)->nbaccepted)
+#define TimeStep_GetNbOfRejectedSteps(TS)     ((TS)->nbrejected)
+#define TimeStep_GetMaxNbOfRejections(TS)     ((TS)->nrejmax)
+#define TimeStep_GetRejectionIndex(TS)        ((TS)->irej)
 
 
 
@@ -30,6 +44,43 @@ extern double       TimeStep_ComputeTimeStep(TimeStep_t*,Nodes_t*,double,double,
         ObVals_GetObVal(TimeStep_GetObVals(TS))
 
 
+/* Controllers of the time step */
+#define TimeStep_SetControllerToObjectiveVariations(TS) \
+        do {TimeStep_GetController(TS) = 'o' ;} while(0)
+        
+#define TimeStep_SetControllerToErrorEstimate(TS) \
+        do {TimeStep_GetController(TS) = 'e' ;} while(0)
+        
+#define TimeStep_IsErrorControlled(TS) \
+        (TimeStep_GetController(TS) == 'e')
+
+
+/* Rejections of a step by the error controller. They are counted
+ * apart from the repetitions of the iterative process. */
+#define TimeStep_IncrementRejectionIndex(TS) \
+        (TimeStep_GetNbOfRejectedSteps(TS)++, \
+         TimeStep_GetRejectionIndex(TS)++)
+
+#define TimeStep_LastRejectionIsNotReached(TS) \
+        (TimeStep_GetRejectionIndex(TS) < TimeStep_GetMaxNbOfRejections(TS))
+
+#define TimeStep_InitializeRejections(TS) \
+        (TimeStep_GetRejectionIndex(TS) = 0)
+
+
+/* With the error controller the last step before a date is stretched
+ * up to the date if it is exceeded by less than this relative amount,
+ * otherwise the leftover is split into two equal steps. */
+#define TimeStep_StretchingTolerance   (0.1)
+
+
+/* Nb of solutions to be kept in memory by the algorithm (at least 2).
+ * The error estimate needs the solution preceding the previous one. */
+#define TimeStep_GetNbOfSolutionsToBeStored(TS) \
+        ((TimeStep_IsErrorControlled(TS) && TimeStep_GetPredictorOrder(TS) == 0) ? \
+        3 : 2 + TimeStep_GetPredictorOrder(TS))
+
+
 /* Time location management */
 #define TimeStep_SetLocationAtBegin(TS) \
         do {TimeStep_GetLocation(TS) = 0 ;} while(0)
@@ -59,6 +110,16 @@ struct TimeStep_s {           /* Time step management */
   double fr ;                 /* Factor reducing the time step */
   ObVals_t* obvals ;          /* Objective variations */
   char   loc ;                /* Time location */
+  int    predictor ;          /* Order of the predictor (0 = none) */
+  char   controller ;         /* Controller = o(bjective variations) or e(rror) */
+  double errtol ;             /* Tolerance on the local truncation error */
+  double safety ;             /* Safety factor of the error controller */
+  double ratio_n ;            /* Previous ratio error/tolerance */
+  double dtproposed ;         /* Time step proposed by the error controller */
+  unsigned long nbaccepted ;  /* Nb of accepted time steps */
+  unsigned long nbrejected ;  /* Nb of time steps rejected by the error controller */
+  int    nrejmax ;            /* Max nb of rejections of a step by the error controller */
+  int    irej ;               /* Nb of rejections of the current step */
 } ;
 
 #endif
@@ -33,8 +33,8 @@ void Unit_Delete(void* self)
   Unit_t** punit = (Unit_t**) self ;
   Unit_t*   unit = *punit ;
   
-  free(Unit_GetName(unit)) ;
-  free(unit) ;
+  Mry_Free(Unit_GetName(unit)) ;
+  Mry_Free(unit) ;
   *punit = NULL ;
 }
 
@@ -4,18 +4,21 @@
 #include <string.h>
 #include <time.h>
 #include <assert.h>
+#include <ctype.h>
 #include "DataSet.h"
 #include "Message.h"
 #include "Context.h"
 #include "CommandLine.h"
 #include "Help.h"
 #include "Modules.h"
+#include "Sweep.h"
 #include "OutputFiles.h"
 #include "CementSolutionChemistry.h"
 #include "HardenedCementChemistry.h"
 #include "Models.h"
 #include "Bil.h"
 #include "Exception.h"
+#include "GenericData.h"
 #include "BilVersion.h"
 #include "BilInfo.h"
 #include "Session.h"
@@ -39,6 +42,15 @@ Bil_t*    (Bil_Create)(int argc,char** argv)
     Context_t* ctx = Context_Create(argc,argv) ;
     
     Bil_GetContext(bil) = ctx ;
+    
+    /* Account the memory per category */
+    if(Context_GetDebug(ctx)) {
+      char* debug = ((char**) Context_GetDebug(ctx))[1] ;
+      
+      if(!strcmp(debug,"mem")) {
+        Mry_EnableTracking() ;
+      }
+    }
   }
     
   Session_Close() ;
@@ -77,9 +89,17 @@ int Bil_Main(Bil_t* bil)
       Message_Direct("An exception occurs with value %d\n",val) ;
     }
   }
+  
+  Mry_PrintMemoryUsage() ;
     
   Session_Close() ;
   
+  /* The handles cached by the models are not used any longer */
+  GenericData_DeleteInternedNames() ;
+  
+  /* Nor the temperature tables shared by the chemistry databases */
+  HardenedCementChemistry_DeleteChemicalConstantTable() ;
+  
   return(val) ;
 }
 
@@ -257,6 +277,26 @@ void Bil_CLI(Bil_t* bil)
     return ;
   }
   
+  if(Context_IsSweep(ctx)) {
+    char** argv = (char**) Context_GetSweep(ctx) ;
+    char* filename = ((char**) Context_GetInputFileName(ctx))[0] ;
+    Options_t* options = Context_GetOptions(ctx) ;
+    DataSet_t* jdd =  DataSet_Create(filename,options) ;
+    char* codename = Options_GetModule(options) ;
+    Modules_t* modules = DataSet_GetModules(jdd) ;
+    Module_t* module_i = Modules_FindModule(modules,codename) ;
+    /* The nb of workers is optional */
+    int nworkers = (argv[2] && isdigit(argv[2][0])) ? atoi(argv[2]) : 1 ;
+    Sweep_t* sweep = Sweep_Create(argv[1],nworkers) ;
+  
+    Message_Direct("Sweep\n") ;
+    
+    Sweep_Run(sweep,jdd,module_i) ;
+    Sweep_Delete(&sweep) ;
+    Message_Info("CPU time %g seconds\n",Message_CPUTime()) ;
+    return ;
+  }
+  
   if(1) {
     char* filename = ((char**) Context_GetInputFileName(ctx))[0] ;
     Options_t* options = Context_GetOptions(ctx) ;
@@ -285,6 +325,7 @@ void Bil_PrintUsage(char* path)
   Message_Direct("Options:\n") ;
   
   Message_Direct("  -debug \"input\"       Display the data structure of \"input\".\n") ;
+  Message_Direct("                       \"mem\" displays the memory usage per category.\n") ;
   #if 0
   Message_Direct("                       Available inputs are:\n") ;
   Message_Direct("                       - geom   : geometry\n") ;
@@ -366,6 +407,8 @@ void Bil_PrintUsage(char* path)
   #endif
   
   Message_Direct("  -readonly            Read \"file\" only.\n") ;
+  Message_Direct("  -sweep \"plan\" [N]    Run the cases of \"plan\" with the same data set,\n") ;
+  Message_Direct("                       each one in its own directory, by N processes.\n") ;
   Message_Direct("  -with \"mod\"          Use the module \"mod\".\n") ;
 }
 
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 
 #include "Help.h"
 #include "BilVersion.h"
@@ -120,6 +121,12 @@ void (Context_Initialize)(Context_t* ctx)
           }
         }
       }
+      
+      /* Skip one more entry if the following entry is "-sp"
+       * i.e. a factorization in single precision for Crout method */
+      if(i + 1 < argc) {
+        if(!strcmp(argv[i + 1],"-sp")) i++ ;
+      }
     
     } else if(strncmp(argv[i],"-debug",strlen(argv[i])) == 0) {
       Context_GetDebug(ctx) = (char**) argv + i ;
@@ -197,7 +204,20 @@ void (Context_Initialize)(Context_t* ctx)
 
     } else if(strncmp(argv[i],"-test",strlen(argv[i])) == 0) {
       Context_GetTest(ctx) = (char**) argv + i ;
-      
+
+    } else if(strncmp(argv[i],"-sweep",strlen(argv[i])) == 0) {
+      Context_GetSweep(ctx) = (char**) argv + i ;
+      if(i + 1 < argc) {
+        i++ ;
+      } else {
+        Message_FatalError("Missing plan file") ;
+      }
+
+      /* Skip one more entry if it is the nb of workers */
+      if(i + 1 < argc && isdigit(argv[i + 1][0])) {
+        i++ ;
+      }
+
     } else {
       Message_FatalError("Unknown option") ;
     }
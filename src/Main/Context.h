@@ -32,6 +32,7 @@ extern void          (Context_Delete)(void*) ;
 #define Context_GetCommandLine(CTX)        ((CTX)->commandline)
 #define Context_GetOptions(CTX)            ((CTX)->options)
 #define Context_GetTest(CTX)               ((CTX)->test)
+#define Context_GetSweep(CTX)              ((CTX)->sweep)
 
 
 
@@ -77,6 +78,9 @@ extern void          (Context_Delete)(void*) ;
 #define Context_IsTest(CTX) \
         Context_GetTest(CTX)
 
+#define Context_IsSweep(CTX) \
+        Context_GetSweep(CTX)
+
 
 #include "CommandLine.h"
 #include "Options.h"
@@ -102,6 +106,7 @@ struct Context_s {        /* Context */
   void*   eorder ;
   void*   norder ;
   void*   test ;
+  void*   sweep ;
 } ;
 
 
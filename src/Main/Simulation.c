@@ -0,0 +1,374 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Message.h"
+#include "Exception.h"
+#include "Session.h"
+#include "Mry.h"
+#include "OutputFiles.h"
+#include "Simulation.h"
+
+
+static int    (Simulation_Solve)(Simulation_t*,const double,const double,const int) ;
+static int    (Simulation_Initialize)(Simulation_t*) ;
+
+
+/* Nb of open simulations (at most 1, see Simulation.h) */
+static int nbofsimulations = 0 ;
+
+
+
+/* Global functions */
+
+Simulation_t*  (Simulation_Open)(char* filename)
+/** Read the data file, build the solutions and the solver and compute
+ *  the initial state. Return NULL if an error occured or if a simulation
+ *  is already open. */
+{
+  Simulation_t* sim ;
+
+  /* The error environment is the one of the session */
+  if(nbofsimulations) {
+    Message_Warning("Simulation_Open: a simulation is already open") ;
+    return(NULL) ;
+  }
+
+  Session_Open() ;
+
+  nbofsimulations++ ;
+
+  sim = (Simulation_t*) Mry_New(Simulation_t) ;
+
+  /* The objects are stored in sim as soon as they are built so that
+   * those built before an error are freed by Simulation_Close */
+  if(Exception_SaveErrorEnvironment) {
+    Simulation_Close(&sim) ;
+    return(NULL) ;
+  }
+
+  Exception_CatchErrors(1) ;
+
+  {
+    FILE* fic = fopen(filename,"r") ;
+
+    if(!fic) {
+      arret("Simulation_Open: can't open %s",filename) ;
+    }
+
+    fclose(fic) ;
+  }
+
+  {
+    Simulation_GetOptions(sim) = Options_Create(NULL) ;
+    Simulation_GetDataSet(sim) = DataSet_Create(filename,Simulation_GetOptions(sim)) ;
+  }
+
+  {
+    DataSet_t* jdd = Simulation_GetDataSet(sim) ;
+    char* codename = Options_GetModule(Simulation_GetOptions(sim)) ;
+    Modules_t* modules = DataSet_GetModules(jdd) ;
+    Module_t* module = Modules_FindModule(modules,codename) ;
+
+    if(!Module_GetSolveProblem(module)) {
+      arret("Simulation_Open: the module has no algorithm to be reused") ;
+    }
+
+    Simulation_GetModule(sim) = module ;
+  }
+
+  {
+    DataSet_t* jdd = Simulation_GetDataSet(sim) ;
+    Mesh_t* mesh = DataSet_GetMesh(jdd) ;
+    TimeStep_t* timestep = DataSet_GetTimeStep(jdd) ;
+    const int n_sol = TimeStep_GetNbOfSolutionsToBeStored(timestep) ;
+
+    Simulation_GetSolutions(sim) = Solutions_Create(mesh,n_sol) ;
+
+    Solutions_MergeExplicitTerms(Simulation_GetSolutions(sim)) ;
+
+    Simulation_GetSolver(sim) = Solver_Create(mesh,Simulation_GetOptions(sim),1) ;
+  }
+
+  {
+    DataSet_t* jdd = Simulation_GetDataSet(sim) ;
+    Materials_t* materials = DataSet_GetMaterials(jdd) ;
+    int n_mat = Materials_GetNbOfMaterials(materials) ;
+
+    Simulation_GetDates(sim) = Dates_New(2) ;
+    Simulation_GetOverrides(sim) = (SweepCase_t*) Mry_New(SweepCase_t) ;
+    Simulation_GetTextOfOverrides(sim) = (char*) Mry_New(char[n_mat*Sweep_MaxLengthOfOverrides]) ;
+    Simulation_GetOverridden(sim) = (int*) Mry_New(int[n_mat]) ;
+    Simulation_GetResults(sim) = Results_Create(OutputFiles_MaxNbOfViews) ;
+
+    strcpy(SweepCase_GetName(Simulation_GetOverrides(sim)),"Simulation") ;
+  }
+
+  if(Simulation_Initialize(sim)) {
+    arret("Simulation_Open: the initial state could not be computed") ;
+  }
+
+  Exception_CatchErrors(0) ;
+
+  return(sim) ;
+}
+
+
+
+void  (Simulation_Close)(void* self)
+/** Free the simulation in the reverse order of its creation (only
+ *  the objects already built if it failed to open) and close the
+ *  session. */
+{
+  Simulation_t** psim = (Simulation_t**) self ;
+  Simulation_t*   sim = *psim ;
+
+  if(sim) {
+    Dates_t* dates = Simulation_GetDates(sim) ;
+
+    if(Simulation_GetResults(sim)) Results_Delete(&Simulation_GetResults(sim)) ;
+
+    Mry_Free(Simulation_GetOverridden(sim)) ;
+    Mry_Free(Simulation_GetTextOfOverrides(sim)) ;
+    Mry_Free(Simulation_GetOverrides(sim)) ;
+
+    if(dates) {
+      Mry_Free(Dates_GetDate(dates)) ;
+      Mry_Free(dates) ;
+    }
+
+    if(Simulation_GetSolver(sim))    Solver_Delete(&Simulation_GetSolver(sim)) ;
+    if(Simulation_GetSolutions(sim)) Solutions_Delete(&Simulation_GetSolutions(sim)) ;
+    if(Simulation_GetDataSet(sim))   DataSet_Delete(&Simulation_GetDataSet(sim)) ;
+    if(Simulation_GetOptions(sim))   Options_Delete(&Simulation_GetOptions(sim)) ;
+
+    Mry_Free(sim) ;
+    *psim = NULL ;
+  }
+
+  if(nbofsimulations > 0) {
+    nbofsimulations-- ;
+
+    Session_Close() ;
+  }
+}
+
+
+
+int  (Simulation_SetProperty)(Simulation_t* sim,const char* name,const int imat,const double v)
+/** Override the property name of the material imat (starting from 0,
+ *  -1 = all the materials knowing the property) with v. The override
+ *  applies to the next steps. */
+{
+  if(Exception_SaveErrorEnvironment) return(Simulation_Error) ;
+
+  Exception_CatchErrors(1) ;
+
+  {
+    DataSet_t* jdd = Simulation_GetDataSet(sim) ;
+    SweepCase_t* overrides = Simulation_GetOverrides(sim) ;
+
+    /* The override is checked on a copy so that an invalid one
+     * is not kept for the next calls */
+    {
+      SweepCase_t newoverrides = *overrides ;
+
+      if(SweepCase_AddOverride(&newoverrides,name,imat,v)) {
+        arret("Simulation_SetProperty: can't override %s",name) ;
+      }
+
+      SweepCase_CheckOverrides(&newoverrides,DataSet_GetMaterials(jdd)) ;
+
+      *overrides = newoverrides ;
+    }
+
+    SweepCase_SetProperties(overrides,jdd,Simulation_GetTextOfOverrides(sim),Simulation_GetOverridden(sim)) ;
+  }
+
+  Exception_CatchErrors(0) ;
+
+  return(Simulation_Success) ;
+}
+
+
+
+int  (Simulation_StepTo)(Simulation_t* sim,const double t)
+/** Step from the current time up to t. Return Simulation_NotConverged
+ *  if the algorithm failed to converge, the solution being then the last
+ *  converged one. */
+{
+  int i ;
+
+  if(Exception_SaveErrorEnvironment) return(Simulation_Error) ;
+
+  Exception_CatchErrors(1) ;
+
+  {
+    double t_1 = Simulation_GetTime(sim) ;
+
+    if(t < t_1) {
+      arret("Simulation_StepTo: %e is before the current time %e",t,t_1) ;
+    }
+
+    i = (t > t_1) ? Simulation_Solve(sim,t_1,t,2) : 0 ;
+  }
+
+  Exception_CatchErrors(0) ;
+
+  return((i) ? Simulation_NotConverged : Simulation_Success) ;
+}
+
+
+
+int  (Simulation_Restart)(Simulation_t* sim)
+/** Go back to the initial state, the overrides being kept. */
+{
+  int i ;
+
+  if(Exception_SaveErrorEnvironment) return(Simulation_Error) ;
+
+  Exception_CatchErrors(1) ;
+
+  {
+    DataSet_t* jdd = Simulation_GetDataSet(sim) ;
+
+    Sweep_ResetDataSet(jdd,Simulation_GetSolutions(sim)) ;
+
+    i = Simulation_Initialize(sim) ;
+  }
+
+  Exception_CatchErrors(0) ;
+
+  return((i) ? Simulation_Error : Simulation_Success) ;
+}
+
+
+
+double  (Simulation_GetTime)(Simulation_t* sim)
+{
+  Solution_t* sol = Solutions_GetSolution(Simulation_GetSolutions(sim)) ;
+
+  return(Solution_GetTime(sol)) ;
+}
+
+
+
+int  (Simulation_GetNbOfPoints)(Simulation_t* sim)
+{
+  Points_t* points = DataSet_GetPoints(Simulation_GetDataSet(sim)) ;
+
+  return(Points_GetNbOfPoints(points)) ;
+}
+
+
+
+int  (Simulation_GetPointValues)(Simulation_t* sim,const int p,double* v,const int n)
+/** Compute the outputs at the point p (starting from 0) at the current
+ *  time, and copy at most n of them in v, the views being concatenated
+ *  in the order of the point output files. Return the total nb of values
+ *  (which may exceed n). */
+{
+  int nv = 0 ;
+
+  if(Exception_SaveErrorEnvironment) return(Simulation_Error) ;
+
+  Exception_CatchErrors(1) ;
+
+  {
+    Points_t* points = DataSet_GetPoints(Simulation_GetDataSet(sim)) ;
+    Point_t* point = Points_GetPoint(points) + p ;
+    Element_t* elt ;
+
+    if(p < 0 || p >= Points_GetNbOfPoints(points)) {
+      arret("Simulation_GetPointValues: no point %d",p) ;
+    }
+
+    elt = Point_GetEnclosingElement(point) ;
+
+    if(!elt || !Element_GetMaterial(elt)) {
+      arret("Simulation_GetPointValues: point %d is not in the mesh",p) ;
+    }
+
+    {
+      Result_t* r_s = Results_GetResult(Simulation_GetResults(sim)) ;
+      double* xp = Point_GetCoordinate(point) ;
+      double t = Simulation_GetTime(sim) ;
+      int nso ;
+      int i ;
+
+      Element_FreeBuffer(elt) ;
+      nso = Element_ComputeOutputs(elt,t,xp,r_s) ;
+
+      if(nso > OutputFiles_MaxNbOfViews) {
+        arret("Simulation_GetPointValues: too much values") ;
+      }
+
+      for(i = 0 ; i < nso ; i++) {
+        int n_r = Result_GetNbOfValues(r_s + i) ;
+        int j ;
+
+        for(j = 0 ; j < n_r ; j++) {
+          if(nv < n) v[nv] = Result_GetValue(r_s + i)[j] ;
+          nv++ ;
+        }
+      }
+    }
+  }
+
+  Exception_CatchErrors(0) ;
+
+  return(nv) ;
+}
+
+
+
+/* Intern functions */
+
+int  (Simulation_Solve)(Simulation_t* sim,const double t1,const double t2,const int nbofdates)
+/** Run the algorithm of the module over the dates t1 (and t2 if
+ *  nbofdates is 2) without output files. */
+{
+  DataSet_t* jdd = Simulation_GetDataSet(sim) ;
+  Dates_t* dates = Simulation_GetDates(sim) ;
+  Dates_t* datesofdatafile = DataSet_GetDates(jdd) ;
+  Date_t* date = Dates_GetDate(dates) ;
+  int i ;
+
+  Dates_GetNbOfDates(dates) = nbofdates ;
+  Date_GetTime(date) = t1 ;
+  Date_GetTime(date + 1) = t2 ;
+
+  DataSet_GetDates(jdd) = dates ;
+
+  i = Module_SolveProblem(Simulation_GetModule(sim),jdd,Simulation_GetSolutions(sim),Simulation_GetSolver(sim),NULL) ;
+
+  DataSet_GetDates(jdd) = datesofdatafile ;
+
+  return(i) ;
+}
+
+
+
+int  (Simulation_Initialize)(Simulation_t* sim)
+/** Compute the initial state at the first date of the data file, the
+ *  next steps being computed without initialization. */
+{
+  DataSet_t* jdd = Simulation_GetDataSet(sim) ;
+  DataFile_t* datafile = DataSet_GetDataFile(jdd) ;
+  Date_t* date = Dates_GetDate(DataSet_GetDates(jdd)) ;
+  double t0 = Date_GetTime(date) ;
+  int i ;
+
+  {
+    Solution_t* sol = Solutions_GetSolution(Simulation_GetSolutions(sim)) ;
+
+    Solution_GetTime(sol) = t0 ;
+  }
+
+  DataFile_ContextSetToFullInitialization(datafile) ;
+
+  i = Simulation_Solve(sim,t0,t0,1) ;
+
+  DataFile_ContextSetToNoInitialization(datafile) ;
+
+  return(i) ;
+}
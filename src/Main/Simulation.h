@@ -0,0 +1,80 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+/* vacuous declarations and typedef names */
+
+/* class-like structure */
+struct Simulation_s  ; typedef struct Simulation_s  Simulation_t ;
+
+
+/* Embedding API.
+ * A simulation is driven step by step from another program linked
+ * against the library:
+ *
+ *   Simulation_t* sim = Simulation_Open("file") ;
+ *   Simulation_SetProperty(sim,"young",-1,2.e9) ;
+ *   Simulation_StepTo(sim,t) ;
+ *   Simulation_GetPointValues(sim,0,v,n) ;
+ *   Simulation_Close(&sim) ;
+ *
+ * The errors met by the library are returned as Simulation_Error
+ * (NULL for Simulation_Open) instead of terminating the program.
+ * After an error the simulation should only be closed.
+ *
+ * The errors are caught through the error environment of the session
+ * and the models keep their own static data: only one simulation can be
+ * open at a time, Simulation_Open returns NULL while another is open. */
+
+
+extern Simulation_t* (Simulation_Open)(char*) ;
+extern void          (Simulation_Close)(void*) ;
+extern int           (Simulation_SetProperty)(Simulation_t*,const char*,const int,const double) ;
+extern int           (Simulation_StepTo)(Simulation_t*,const double) ;
+extern int           (Simulation_Restart)(Simulation_t*) ;
+extern double        (Simulation_GetTime)(Simulation_t*) ;
+extern int           (Simulation_GetNbOfPoints)(Simulation_t*) ;
+extern int           (Simulation_GetPointValues)(Simulation_t*,const int,double*,const int) ;
+
+
+/* Return codes */
+#define Simulation_Success                 (0)
+#define Simulation_NotConverged            (1)
+#define Simulation_Error                   (-1)
+
+
+#define Simulation_GetOptions(SIM)         ((SIM)->options)
+#define Simulation_GetDataSet(SIM)         ((SIM)->dataset)
+#define Simulation_GetModule(SIM)          ((SIM)->module)
+#define Simulation_GetSolutions(SIM)       ((SIM)->solutions)
+#define Simulation_GetSolver(SIM)          ((SIM)->solver)
+#define Simulation_GetDates(SIM)           ((SIM)->dates)
+#define Simulation_GetOverrides(SIM)       ((SIM)->overrides)
+#define Simulation_GetTextOfOverrides(SIM) ((SIM)->textofoverrides)
+#define Simulation_GetOverridden(SIM)      ((SIM)->overridden)
+#define Simulation_GetResults(SIM)         ((SIM)->results)
+
+
+
+#include "Options.h"
+#include "DataSet.h"
+#include "Module.h"
+#include "Solutions.h"
+#include "Solver.h"
+#include "Dates.h"
+#include "Sweep.h"
+#include "Results.h"
+
+struct Simulation_s {         /* Simulation driven by another program */
+  Options_t*    options ;
+  DataSet_t*    dataset ;
+  Module_t*     module ;
+  Solutions_t*  solutions ;
+  Solver_t*     solver ;
+  Dates_t*      dates ;       /* The dates of the current step */
+  SweepCase_t*  overrides ;   /* The property overrides */
+  char*         textofoverrides ; /* The overrides per material */
+  int*          overridden ;  /* The materials scanned with overrides */
+  Results_t*    results ;     /* The outputs at points */
+} ;
+
+#endif
@@ -6,7 +6,9 @@
 #include "Exception.h"
 #include "Tools/Math.h"
 #include "Temperature.h"
+#include "TemperatureTable.h"
 #include "CementSolutionChemistry.h"
+#include "Mry.h"
 
 #define Ln10      Math_Ln10
 
@@ -31,6 +33,7 @@ static double poly4(double,double,double,double,double,double,double) ;
 
 static void   (CementSolutionChemistry_AllocateMemory)             (CementSolutionChemistry_t*) ;
 static void   (CementSolutionChemistry_UpdateChemicalConstants)    (CementSolutionChemistry_t*) ;
+static void   (CementSolutionChemistry_ComputeChemicalConstants)   (const double,double*) ;
 static double (CementSolutionChemistry_ComputeChargeDensity)       (CementSolutionChemistry_t*) ;
 static double (CementSolutionChemistry_ComputeLiquidMassDensity)   (CementSolutionChemistry_t*) ;
 static void   (CementSolutionChemistry_UpdateElementConcentrations)(CementSolutionChemistry_t*) ;
@@ -49,6 +52,8 @@ static void CementSolutionChemistry_SupplementSystemWith_SO3_2(CementSolutionChe
 
 static double* instancevalence = NULL ;
 
+static TemperatureTable_t* instancelog10keqtable = NULL ;
+
 
 
 double* CementSolutionChemistry_GetValence()
@@ -61,9 +66,48 @@ double* CementSolutionChemistry_GetValence()
 }
 
 
+TemperatureTable_t* CementSolutionChemistry_GetLog10EquilibriumConstantTable()
+{
+  if(!instancelog10keqtable) {
+    double tmin = TemperatureTable_DefaultMinTemperature ;
+    double tmax = TemperatureTable_DefaultMaxTemperature ;
+    int    n    = TemperatureTable_DefaultNbOfPoints ;
+    int    nv   = CementSolutionChemistry_NbOfSpecies ;
+    
+    instancelog10keqtable = TemperatureTable_Create(tmin,tmax,n,nv,CementSolutionChemistry_ComputeChemicalConstants) ;
+  }
+  
+  return(instancelog10keqtable) ;
+}
+
+
+
+void CementSolutionChemistry_DeleteLog10EquilibriumConstantTable()
+/** Free the shared table. To be called once no instance is used. */
+{
+  if(instancelog10keqtable) {
+    TemperatureTable_Delete(&instancelog10keqtable) ;
+  }
+}
+
+
+
+void CementSolutionChemistry_SetTemperature(CementSolutionChemistry_t* csc,const double T)
+/** Set the temperature and the equilibrium constants interpolated
+ *  in the shared table at this temperature. */
+{
+  TemperatureTable_t* table = CementSolutionChemistry_GetLog10EquilibriumConstantTable() ;
+  
+  CementSolutionChemistry_SetRoomTemperature(csc,T) ;
+  
+  TemperatureTable_Interpolate(table,T,CementSolutionChemistry_GetLog10Keq(csc)) ;
+}
+
+
+
 CementSolutionChemistry_t* CementSolutionChemistry_Create(const int n)
 {
-  CementSolutionChemistry_t* csc = (CementSolutionChemistry_t*) malloc(n*sizeof(CementSolutionChemistry_t)) ;
+  CementSolutionChemistry_t* csc = (CementSolutionChemistry_t*) Mry_NewIn(Chemistry,CementSolutionChemistry_t[n]) ;
   
   assert(csc) ;
   
@@ -105,7 +149,7 @@ void CementSolutionChemistry_AllocateMemory(CementSolutionChemistry_t* csc)
   /* Allocation of space for the primary variable indexes */
   {
     size_t sz = CementSolutionChemistry_NbOfPrimaryVariables*sizeof(int) ;
-    int* ind = (int*) malloc(sz) ;
+    int* ind = (int*) Mry_AllocateIn(sz,Mry_Category(Chemistry)) ;
     
     assert(ind) ;
     
@@ -116,7 +160,7 @@ void CementSolutionChemistry_AllocateMemory(CementSolutionChemistry_t* csc)
   /* Allocation of space for the primary variables */
   {
     size_t sz = CementSolutionChemistry_NbOfPrimaryVariables*sizeof(double) ;
-    double* var = (double*) malloc(sz) ;
+    double* var = (double*) Mry_AllocateIn(sz,Mry_Category(Chemistry)) ;
     
     assert(var) ;
     
@@ -127,7 +171,7 @@ void CementSolutionChemistry_AllocateMemory(CementSolutionChemistry_t* csc)
   /* Allocation of space for the activities */
   {
     size_t sz = CementSolutionChemistry_NbOfSpecies*sizeof(double) ;
-    double* a = (double*) malloc(sz) ;
+    double* a = (double*) Mry_AllocateIn(sz,Mry_Category(Chemistry)) ;
     
     assert(a) ;
     
@@ -138,7 +182,7 @@ void CementSolutionChemistry_AllocateMemory(CementSolutionChemistry_t* csc)
   /* Allocation of space for the log of activities */
   {
     size_t sz = CementSolutionChemistry_NbOfSpecies*sizeof(double) ;
-    double* loga = (double*) malloc(sz) ;
+    double* loga = (double*) Mry_AllocateIn(sz,Mry_Category(Chemistry)) ;
     
     assert(loga) ;
     
@@ -149,7 +193,7 @@ void CementSolutionChemistry_AllocateMemory(CementSolutionChemistry_t* csc)
   /* Allocation of space for the concentrations */
   {
     size_t sz = CementSolutionChemistry_NbOfSpecies*sizeof(double) ;
-    double* c = (double*) malloc(sz) ;
+    double* c = (double*) Mry_AllocateIn(sz,Mry_Category(Chemistry)) ;
     
     assert(c) ;
     
@@ -160,7 +204,7 @@ void CementSolutionChemistry_AllocateMemory(CementSolutionChemistry_t* csc)
   /* Allocation of space for the log of concentrations */
   {
     size_t sz = CementSolutionChemistry_NbOfSpecies*sizeof(double) ;
-    double* logc = (double*) malloc(sz) ;
+    double* logc = (double*) Mry_AllocateIn(sz,Mry_Category(Chemistry)) ;
     
     assert(logc) ;
     
@@ -171,7 +215,7 @@ void CementSolutionChemistry_AllocateMemory(CementSolutionChemistry_t* csc)
   /* Allocation of space for the element concentrations */
   {
     size_t sz = CementSolutionChemistry_NbOfElementConcentrations*sizeof(double) ;
-    double* ec = (double*) malloc(sz) ;
+    double* ec = (double*) Mry_AllocateIn(sz,Mry_Category(Chemistry)) ;
     
     assert(ec) ;
     
@@ -182,7 +226,7 @@ void CementSolutionChemistry_AllocateMemory(CementSolutionChemistry_t* csc)
   /* Allocation of space for other variables */
   {
     size_t sz = CementSolutionChemistry_NbOfOtherVariables*sizeof(double) ;
-    double* var = (double*) malloc(sz) ;
+    double* var = (double*) Mry_AllocateIn(sz,Mry_Category(Chemistry)) ;
     
     assert(var) ;
     
@@ -193,7 +237,7 @@ void CementSolutionChemistry_AllocateMemory(CementSolutionChemistry_t* csc)
   /* Allocation of space for the equilibrium constants */
   {
     size_t sz = CementSolutionChemistry_NbOfSpecies*sizeof(double) ;
-    double* keq = (double*) malloc(sz) ;
+    double* keq = (double*) Mry_AllocateIn(sz,Mry_Category(Chemistry)) ;
     
     assert(keq) ;
     
@@ -206,7 +250,7 @@ void CementSolutionChemistry_AllocateMemory(CementSolutionChemistry_t* csc)
 double* CementSolutionChemistry_CreateValence(void)
 {
   size_t sz = CementSolutionChemistry_NbOfSpecies*sizeof(double) ;
-  double* z = (double*) malloc(sz) ;
+  double* z = (double*) Mry_AllocateIn(sz,Mry_Category(Chemistry)) ;
     
   assert(z) ;
     
@@ -298,6 +342,15 @@ void CementSolutionChemistry_UpdateChemicalConstants(CementSolutionChemistry_t*
 {
   double T = CementSolutionChemistry_GetRoomTemperature(csc) ;
   
+  CementSolutionChemistry_ComputeChemicalConstants(T,CementSolutionChemistry_GetLog10Keq(csc)) ;
+}
+
+
+
+void CementSolutionChemistry_ComputeChemicalConstants(const double T,double* logkeq)
+/** Compute the log10 of the equilibrium constants at temperature T
+ *  (indexed as the species, zero for the primary species). */
+{
   #define LogKr(R) Log10EquilibriumConstantOfHomogeneousReactionInWater(R,T)
   double logk_h2o      = LogKr(H2O__H_OH) ;
   
@@ -351,38 +404,48 @@ void CementSolutionChemistry_UpdateChemicalConstants(CementSolutionChemistry_t*
   
   
   /* Backup */
-  LogKeq(H2O)      = logk_h2o ;
+  {
+    int i ;
+    
+    for(i = 0 ; i < CementSolutionChemistry_NbOfSpecies ; i++) {
+      logkeq[i] = 0 ;
+    }
+  }
+  
+  #define LogK(CPD)  (logkeq[CementSolutionChemistry_GetIndexOf(CPD)])
+  LogK(H2O)      = logk_h2o ;
   
-  LogKeq(CaOH)     = logk_caoh ;
-  LogKeq(CaO2H2)   = logk_caoh2 ;
+  LogK(CaOH)     = logk_caoh ;
+  LogK(CaO2H2)   = logk_caoh2 ;
   
-  LogKeq(H3SiO4)   = logk_h3sio4 ;
-  LogKeq(H2SiO4)   = logk_h2sio4 ;
+  LogK(H3SiO4)   = logk_h3sio4 ;
+  LogK(H2SiO4)   = logk_h2sio4 ;
   
-  LogKeq(NaOH)     = logk_naoh ;
+  LogK(NaOH)     = logk_naoh ;
   
-  LogKeq(KOH)      = logk_koh ;
+  LogK(KOH)      = logk_koh ;
   
-  LogKeq(H2CO3)    = logk_h2co3 ;
-  LogKeq(HCO3)     = logk_hco3 ;
-  LogKeq(CO3)      = logk_co3 ;
+  LogK(H2CO3)    = logk_h2co3 ;
+  LogK(HCO3)     = logk_hco3 ;
+  LogK(CO3)      = logk_co3 ;
   
-  LogKeq(H2SO4)    = logk_h2so4 ;
-  LogKeq(HSO4)     = logk_hso4 ;
+  LogK(H2SO4)    = logk_h2so4 ;
+  LogK(HSO4)     = logk_hso4 ;
   
-  LogKeq(AlO4H4)   = logk_alo4h4 ;
+  LogK(AlO4H4)   = logk_alo4h4 ;
   
-  LogKeq(CaH3SiO4) = logk_cah3sio4 ;
-  LogKeq(CaH2SiO4) = logk_cah2sio4 ;
+  LogK(CaH3SiO4) = logk_cah3sio4 ;
+  LogK(CaH2SiO4) = logk_cah2sio4 ;
   
-  LogKeq(CaHCO3)   = logk_cahco3 ;
-  LogKeq(CaCO3)    = logk_caco3 ;
+  LogK(CaHCO3)   = logk_cahco3 ;
+  LogK(CaCO3)    = logk_caco3 ;
   
-  LogKeq(NaHCO3)   = logk_nahco3 ;
-  LogKeq(NaCO3)    = logk_naco3 ;
+  LogK(NaHCO3)   = logk_nahco3 ;
+  LogK(NaCO3)    = logk_naco3 ;
   
-  LogKeq(CaHSO4)   = logk_cahso4 ;
-  LogKeq(CaSO4)    = logk_caso4 ;
+  LogK(CaHSO4)   = logk_cahso4 ;
+  LogK(CaSO4)    = logk_caso4 ;
+  #undef LogK
 }
 
 
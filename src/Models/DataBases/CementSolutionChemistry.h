@@ -38,6 +38,12 @@ extern void   (CementSolutionChemistry_CopyChemicalPotential)(CementSolutionChem
 
 extern double*   (CementSolutionChemistry_GetValence)(void) ;
 
+#include "TemperatureTable.h"
+
+extern TemperatureTable_t* (CementSolutionChemistry_GetLog10EquilibriumConstantTable)(void) ;
+extern void      (CementSolutionChemistry_DeleteLog10EquilibriumConstantTable)(void) ;
+extern void      (CementSolutionChemistry_SetTemperature)(CementSolutionChemistry_t*,const double) ;
+
 
 
 #define CementSolutionChemistry_GetTemperature(CSC) \
@@ -87,6 +93,8 @@ extern double*   (CementSolutionChemistry_GetValence)(void) ;
 
 
 
+
+
 /* Macros for primary variables
  * ----------------------------*/
  
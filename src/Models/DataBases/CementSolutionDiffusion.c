@@ -7,6 +7,7 @@
 #include "Temperature.h"
 #include "CementSolutionChemistry.h"
 #include "CementSolutionDiffusion.h"
+#include "Mry.h"
 
 
 
@@ -21,9 +22,7 @@ static void  (CementSolutionDiffusion_UpdateElementFluxes)(CementSolutionDiffusi
 
 CementSolutionDiffusion_t* CementSolutionDiffusion_Create(void)
 {
-  CementSolutionDiffusion_t* csd = (CementSolutionDiffusion_t*) malloc(sizeof(CementSolutionDiffusion_t)) ;
-  
-  if(!csd) arret("CementSolutionDiffusion_Create") ;
+  CementSolutionDiffusion_t* csd = (CementSolutionDiffusion_t*) Mry_NewIn(Chemistry,CementSolutionDiffusion_t) ;
   
   {
     /* Memory allocation */
@@ -52,9 +51,7 @@ void CementSolutionDiffusion_AllocateMemory(CementSolutionDiffusion_t* csd)
   /* Allocation of space for the diffusion coefficients */
   {
     size_t sz = CementSolutionDiffusion_NbOfSpecies*sizeof(double) ;
-    double* d = (double*) malloc(sz) ;
-    
-    if(!d) arret("CementSolutionDiffusion_AllocateMemory(10)") ;
+    double* d = (double*) Mry_AllocateIn(sz,Mry_Category(Chemistry)) ;
     
     CementSolutionDiffusion_GetDiffusionCoefficient(csd) = d ;
   }
@@ -63,9 +60,7 @@ void CementSolutionDiffusion_AllocateMemory(CementSolutionDiffusion_t* csd)
   /* Allocation of space for the gradients */
   {
     size_t sz = CementSolutionDiffusion_NbOfSpecies*sizeof(double) ;
-    double* grd = (double*) malloc(sz) ;
-    
-    if(!grd) arret("CementSolutionDiffusion_AllocateMemory(11)") ;
+    double* grd = (double*) Mry_AllocateIn(sz,Mry_Category(Chemistry)) ;
     
     CementSolutionDiffusion_GetGradient(csd) = grd ;
   }
@@ -75,9 +70,7 @@ void CementSolutionDiffusion_AllocateMemory(CementSolutionDiffusion_t* csd)
   {
     int n = CementSolutionDiffusion_MaxNbOfPotentialVectors ;
     size_t sz = n*CementSolutionDiffusion_NbOfSpecies*sizeof(double) ;
-    double* pot = (double*) malloc(sz) ;
-    
-    if(!pot) arret("CementSolutionDiffusion_AllocateMemory(11)") ;
+    double* pot = (double*) Mry_AllocateIn(sz,Mry_Category(Chemistry)) ;
     
     CementSolutionDiffusion_GetPotential(csd) = pot ;
   }
@@ -87,9 +80,7 @@ void CementSolutionDiffusion_AllocateMemory(CementSolutionDiffusion_t* csd)
   {
     int n = CementSolutionDiffusion_MaxNbOfPotentialVectors ;
     size_t sz = n*sizeof(double*) ;
-    double** ppot = (double**) malloc(sz) ;
-    
-    if(!ppot) arret("CementSolutionDiffusion_AllocateMemory(11)") ;
+    double** ppot = (double**) Mry_AllocateIn(sz,Mry_Category(Chemistry)) ;
     
     CementSolutionDiffusion_GetPointerToPotentials(csd) = ppot ;
     
@@ -107,9 +98,7 @@ void CementSolutionDiffusion_AllocateMemory(CementSolutionDiffusion_t* csd)
   /* Allocation of space for the concentration fluxes */
   {
     size_t sz = CementSolutionDiffusion_NbOfSpecies*sizeof(double) ;
-    double* flx = (double*) malloc(sz) ;
-    
-    if(!flx) arret("CementSolutionDiffusion_AllocateMemory(11)") ;
+    double* flx = (double*) Mry_AllocateIn(sz,Mry_Category(Chemistry)) ;
     
     CementSolutionDiffusion_GetFlux(csd) = flx ;
   }
@@ -118,9 +107,7 @@ void CementSolutionDiffusion_AllocateMemory(CementSolutionDiffusion_t* csd)
   /* Allocation of space for the element fluxes */
   {
     size_t sz = CementSolutionDiffusion_NbOfElementFluxes*sizeof(double) ;
-    double* efx = (double*) malloc(sz) ;
-    
-    if(!efx) arret("CementSolutionDiffusion_AllocateMemory(6)") ;
+    double* efx = (double*) Mry_AllocateIn(sz,Mry_Category(Chemistry)) ;
     
     CementSolutionDiffusion_GetElementFlux(csd) = efx ;
   }
@@ -8,8 +8,10 @@
 #include "Curves.h"
 #include "BilPath.h"
 #include "Temperature.h"
+#include "TemperatureTable.h"
 #include "HardenedCementChemistry.h"
 #include "CementSolutionChemistry.h"
+#include "Mry.h"
 
 
 #define DEBUG  0
@@ -20,6 +22,12 @@ static void (HardenedCementChemistry_AllocateMemory)(HardenedCementChemistry_t*)
 
 static void (HardenedCementChemistry_UpdateChemicalConstants)(HardenedCementChemistry_t*) ;
 
+static void (HardenedCementChemistry_ComputeChemicalConstants)(const double,double*) ;
+
+static void (HardenedCementChemistry_StoreChemicalConstants)(HardenedCementChemistry_t*,double*) ;
+
+static TemperatureTable_t* instancechemicalconstanttable = NULL ;
+
 
 static void (HardenedCementChemistry_ComputeSystem_CaO_SiO2_Na2O_K2O_CO2_H2O_1)      (HardenedCementChemistry_t*) ;
 
@@ -37,11 +45,54 @@ static void (HardenedCementChemistry_ComputeSystem_CaO_SiO2_Na2O_K2O_SO3_Al2O3_H
 
 
 
-HardenedCementChemistry_t* HardenedCementChemistry_Create(void)
+TemperatureTable_t* HardenedCementChemistry_GetChemicalConstantTable()
+{
+  if(!instancechemicalconstanttable) {
+    double tmin = TemperatureTable_DefaultMinTemperature ;
+    double tmax = TemperatureTable_DefaultMaxTemperature ;
+    int    n    = TemperatureTable_DefaultNbOfPoints ;
+    int    nv   = HardenedCementChemistry_NbOfChemicalConstants ;
+    
+    instancechemicalconstanttable = TemperatureTable_Create(tmin,tmax,n,nv,HardenedCementChemistry_ComputeChemicalConstants) ;
+  }
+  
+  return(instancechemicalconstanttable) ;
+}
+
+
+
+void HardenedCementChemistry_DeleteChemicalConstantTable()
+/** Free the shared tables of the solid and liquid phases. To be called
+ *  once no instance is used. */
 {
-  HardenedCementChemistry_t* hcc = (HardenedCementChemistry_t*) malloc(sizeof(HardenedCementChemistry_t)) ;
+  if(instancechemicalconstanttable) {
+    TemperatureTable_Delete(&instancechemicalconstanttable) ;
+  }
+  
+  CementSolutionChemistry_DeleteLog10EquilibriumConstantTable() ;
+}
+
+
+
+void HardenedCementChemistry_SetTemperature(HardenedCementChemistry_t* hcc,const double T)
+/** Set the temperature and the chemical constants of the solid and
+ *  liquid phases interpolated in the shared tables at this temperature. */
+{
+  TemperatureTable_t* table = HardenedCementChemistry_GetChemicalConstantTable() ;
+  double cst[HardenedCementChemistry_NbOfChemicalConstants] ;
+  
+  CementSolutionChemistry_SetTemperature(HardenedCementChemistry_GetCementSolutionChemistry(hcc),T) ;
+  
+  TemperatureTable_Interpolate(table,T,cst) ;
   
-  if(!hcc) arret("HardenedCementChemistry_Create") ;
+  HardenedCementChemistry_StoreChemicalConstants(hcc,cst) ;
+}
+
+
+
+HardenedCementChemistry_t* HardenedCementChemistry_Create(void)
+{
+  HardenedCementChemistry_t* hcc = (HardenedCementChemistry_t*) Mry_NewIn(Chemistry,HardenedCementChemistry_t) ;
   
   
   HardenedCementChemistry_AllocateMemory(hcc) ;
@@ -99,7 +150,7 @@ void HardenedCementChemistry_AllocateMemory(HardenedCementChemistry_t* hcc)
   /* Allocation of space for the primary variable indexes */
   {
     size_t sz = HardenedCementChemistry_NbOfPrimaryVariables*sizeof(int) ;
-    int* ind = (int*) malloc(sz) ;
+    int* ind = (int*) Mry_AllocateIn(sz,Mry_Category(Chemistry)) ;
     
     assert(ind) ;
     
@@ -110,9 +161,7 @@ void HardenedCementChemistry_AllocateMemory(HardenedCementChemistry_t* hcc)
   /* Allocation of space for the primary variables */
   {
     size_t sz = HardenedCementChemistry_NbOfPrimaryVariables*sizeof(double) ;
-    double* var = (double*) malloc(sz) ;
-    
-    if(!var) arret("HardenedCementChemistry_Create(1)") ;
+    double* var = (double*) Mry_AllocateIn(sz,Mry_Category(Chemistry)) ;
     
     HardenedCementChemistry_GetPrimaryVariable(hcc) = var ;
   }
@@ -121,9 +170,7 @@ void HardenedCementChemistry_AllocateMemory(HardenedCementChemistry_t* hcc)
   /* Allocation of space for the variables */
   {
     size_t sz = HardenedCementChemistry_NbOfVariables*sizeof(double) ;
-    double* var = (double*) malloc(sz) ;
-    
-    if(!var) arret("HardenedCementChemistry_Create(2)") ;
+    double* var = (double*) Mry_AllocateIn(sz,Mry_Category(Chemistry)) ;
     
     HardenedCementChemistry_GetVariable(hcc) = var ;
   }
@@ -132,9 +179,7 @@ void HardenedCementChemistry_AllocateMemory(HardenedCementChemistry_t* hcc)
   /* Allocation of space for saturation indexes */
   {
     size_t sz = HardenedCementChemistry_NbOfSaturationIndexes*sizeof(double) ;
-    double* sat = (double*) malloc(sz) ;
-    
-    if(!sat) arret("HardenedCementChemistry_Create(3)") ;
+    double* sat = (double*) Mry_AllocateIn(sz,Mry_Category(Chemistry)) ;
     
     HardenedCementChemistry_GetSaturationIndex(hcc) = sat ;
   }
@@ -143,9 +188,7 @@ void HardenedCementChemistry_AllocateMemory(HardenedCementChemistry_t* hcc)
   /* Allocation of space for Log10 saturation indexes */
   {
     size_t sz = HardenedCementChemistry_NbOfSaturationIndexes*sizeof(double) ;
-    double* sat = (double*) malloc(sz) ;
-    
-    if(!sat) arret("HardenedCementChemistry_Create(4)") ;
+    double* sat = (double*) Mry_AllocateIn(sz,Mry_Category(Chemistry)) ;
     
     HardenedCementChemistry_GetLog10SaturationIndex(hcc) = sat ;
   }
@@ -154,9 +197,7 @@ void HardenedCementChemistry_AllocateMemory(HardenedCementChemistry_t* hcc)
   /* Allocation of space for the constants */
   {
     size_t sz = HardenedCementChemistry_NbOfConstants*sizeof(double) ;
-    double* cst = (double*) malloc(sz) ;
-    
-    if(!cst) arret("HardenedCementChemistry_Create(5)") ;
+    double* cst = (double*) Mry_AllocateIn(sz,Mry_Category(Chemistry)) ;
     
     HardenedCementChemistry_GetConstant(hcc) = cst ;
   }
@@ -165,9 +206,7 @@ void HardenedCementChemistry_AllocateMemory(HardenedCementChemistry_t* hcc)
   /* Allocation of space for solubility product constants */
   {
     size_t sz = HardenedCementChemistry_NbOfSolubilityProductConstants*sizeof(double) ;
-    double* ksp = (double*) malloc(sz) ;
-    
-    if(!ksp) arret("HardenedCementChemistry_Create(6)") ;
+    double* ksp = (double*) Mry_AllocateIn(sz,Mry_Category(Chemistry)) ;
     
     HardenedCementChemistry_GetLog10Ksp(hcc) = ksp ;
   }
@@ -204,7 +243,37 @@ void HardenedCementChemistry_AllocateMemory(HardenedCementChemistry_t* hcc)
 void HardenedCementChemistry_UpdateChemicalConstants(HardenedCementChemistry_t* hcc)
 {
   double T = HardenedCementChemistry_GetRoomTemperature(hcc) ;
+  double cst[HardenedCementChemistry_NbOfChemicalConstants] ;
+  
+  HardenedCementChemistry_ComputeChemicalConstants(T,cst) ;
+  
+  HardenedCementChemistry_StoreChemicalConstants(hcc,cst) ;
+}
+
+
+
+void HardenedCementChemistry_StoreChemicalConstants(HardenedCementChemistry_t* hcc,double* cst)
+/** Store the constants ordered as in HardenedCementChemistry_ComputeChemicalConstants */
+{
+  double* ksp = cst ;
+  double* oth = cst + HardenedCementChemistry_NbOfSolubilityProductConstants ;
+  int i ;
+  
+  for(i = 0 ; i < HardenedCementChemistry_NbOfSolubilityProductConstants ; i++) {
+    HardenedCementChemistry_GetLog10Ksp(hcc)[i] = ksp[i] ;
+  }
   
+  for(i = 0 ; i < HardenedCementChemistry_NbOfConstants ; i++) {
+    HardenedCementChemistry_GetConstant(hcc)[i] = oth[i] ;
+  }
+}
+
+
+
+void HardenedCementChemistry_ComputeChemicalConstants(const double T,double* cst)
+/** Compute the log10 of the solubility product constants followed by
+ *  the other constants at temperature T. */
+{
   /* Some solubility product constants */
   #define LogKd(R) Log10DissociationConstantOfCementHydrationProduct(R,T)
   double logk_ch       = LogKd(CH__Ca_2OH) ;
@@ -244,22 +313,26 @@ void HardenedCementChemistry_UpdateChemicalConstants(HardenedCementChemistry_t*
   
   
   /* Backup */
-  LogKsp(CH)    = logk_ch ;
-  LogKsp(SH)    = logk_sh ;
-  LogKsp(CC)    = logk_cc ;
-  LogKsp(CSH2)  = logk_csh2 ;
-  LogKsp(AH3)   = logk_ah3 ;
-  LogKsp(AFm)   = logk_afm ;
-  LogKsp(AFt)   = logk_aft ;
-  LogKsp(C3AH6) = logk_c3ah6 ;
-  LogKsp(C2AH8) = logk_c2ah8 ;
-  LogKsp(CAH10) = logk_cah10 ;
-  LogKsp(FriedelSalt) = logk_friedelsalt ;
-  LogKsp(KuzelSalt)   = logk_kuzelsalt ;
-  
-  
-  HardenedCementChemistry_GetLog10EquilibriumCO2Activity(hcc) = loga_co2eq ;
-  HardenedCementChemistry_GetLog10EquilibriumH2SO4Activity(hcc) = loga_h2so4eq ;
+  #define LogK(S)  (cst[HardenedCementChemistry_K_##S])
+  #define Cst(A)   (cst[HardenedCementChemistry_NbOfSolubilityProductConstants + HardenedCementChemistry_##A])
+  LogK(CH)    = logk_ch ;
+  LogK(SH)    = logk_sh ;
+  LogK(CC)    = logk_cc ;
+  LogK(CSH2)  = logk_csh2 ;
+  LogK(AH3)   = logk_ah3 ;
+  LogK(AFm)   = logk_afm ;
+  LogK(AFt)   = logk_aft ;
+  LogK(C3AH6) = logk_c3ah6 ;
+  LogK(C2AH8) = logk_c2ah8 ;
+  LogK(CAH10) = logk_cah10 ;
+  LogK(FriedelSalt) = logk_friedelsalt ;
+  LogK(KuzelSalt)   = logk_kuzelsalt ;
+  
+  
+  Cst(A_CO2_EQ)   = loga_co2eq ;
+  Cst(A_H2SO4_EQ) = loga_h2so4eq ;
+  #undef Cst
+  #undef LogK
 }
 
 
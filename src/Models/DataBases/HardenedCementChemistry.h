@@ -20,6 +20,12 @@ extern void (HardenedCementChemistry_ComputeSystem_CaO_SiO2_Na2O_K2O_Al2O3_CO2_C
 extern void (HardenedCementChemistry_ComputeSystem_CaO_SiO2_Na2O_K2O_SO3_H2O)        (HardenedCementChemistry_t*) ;
 extern void (HardenedCementChemistry_ComputeSystem_CaO_SiO2_Na2O_K2O_SO3_Al2O3_H2O)  (HardenedCementChemistry_t*) ;
 extern void (HardenedCementChemistry_PrintChemicalConstants)(HardenedCementChemistry_t*) ;
+extern void (HardenedCementChemistry_SetTemperature)(HardenedCementChemistry_t*,const double) ;
+
+#include "TemperatureTable.h"
+
+extern TemperatureTable_t* (HardenedCementChemistry_GetChemicalConstantTable)(void) ;
+extern void                (HardenedCementChemistry_DeleteChemicalConstantTable)(void) ;
 
 
 /* Synonyms */
@@ -354,6 +360,11 @@ extern void (HardenedCementChemistry_PrintChemicalConstants)(HardenedCementChemi
         (HardenedCementChemistry_GetLog10Ksp(HCC)[HardenedCementChemistry_K_##CPD])
 
 
+/* Solubility product constants followed by the other constants */
+#define HardenedCementChemistry_NbOfChemicalConstants \
+        (HardenedCementChemistry_NbOfSolubilityProductConstants + HardenedCementChemistry_NbOfConstants)
+
+
 
 /* Macros for the resolution of the systems
  * ----------------------------------------*/
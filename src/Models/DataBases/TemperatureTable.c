@@ -0,0 +1,93 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "Message.h"
+#include "Mry.h"
+#include "TemperatureTable.h"
+
+
+
+TemperatureTable_t* (TemperatureTable_Create)(const double tmin,const double tmax,const unsigned int n,const unsigned int nv,TemperatureTable_ComputeValues_t* computevalues)
+/** Tabulate the nv values computed by computevalues on the uniform
+ *  grid of n temperatures ranging from tmin to tmax. */
+{
+  TemperatureTable_t* table = (TemperatureTable_t*) Mry_NewIn(Chemistry,TemperatureTable_t) ;
+
+  if(n < 2 || tmax <= tmin) {
+    arret("TemperatureTable_Create: bad temperature grid") ;
+  }
+
+  TemperatureTable_GetNbOfPoints(table) = n ;
+  TemperatureTable_GetNbOfValues(table) = nv ;
+  TemperatureTable_GetMinTemperature(table) = tmin ;
+  TemperatureTable_GetTemperatureIncrement(table) = (tmax - tmin)/(n - 1) ;
+  TemperatureTable_GetComputeValues(table) = computevalues ;
+
+
+  /* The values on the grid */
+  {
+    double  dt = TemperatureTable_GetTemperatureIncrement(table) ;
+    double* v  = (double*) Mry_NewIn(Chemistry,double[n*nv]) ;
+    unsigned int i ;
+
+    for(i = 0 ; i < n ; i++) {
+      computevalues(tmin + i*dt,v + i*nv) ;
+    }
+
+    TemperatureTable_GetValue(table) = v ;
+  }
+
+  return(table) ;
+}
+
+
+
+void (TemperatureTable_Delete)(void* self)
+{
+  TemperatureTable_t** ptable = (TemperatureTable_t**) self ;
+  TemperatureTable_t*   table = *ptable ;
+
+  Mry_Free(TemperatureTable_GetValue(table)) ;
+  Mry_Free(table) ;
+  *ptable = NULL ;
+}
+
+
+
+int (TemperatureTable_Interpolate)(TemperatureTable_t* table,const double temp,double* v)
+/** Interpolate the values at the temperature temp. Outside the range
+ *  of the grid the values are evaluated directly. Return 0 if the values
+ *  were interpolated, 1 otherwise. */
+{
+  unsigned int nv = TemperatureTable_GetNbOfValues(table) ;
+
+  if(!TemperatureTable_IsInRange(table,temp)) {
+    TemperatureTable_ComputeValues_t* computevalues = TemperatureTable_GetComputeValues(table) ;
+
+    computevalues(temp,v) ;
+
+    return(1) ;
+  }
+
+  {
+    unsigned int n  = TemperatureTable_GetNbOfPoints(table) ;
+    double  dt = TemperatureTable_GetTemperatureIncrement(table) ;
+    double  x  = (temp - TemperatureTable_GetMinTemperature(table))/dt ;
+    unsigned int i = (unsigned int) x ;
+
+    if(i > n - 2) i = n - 2 ;
+
+    {
+      double* y0 = TemperatureTable_GetValue(table) + i*nv ;
+      double* y1 = y0 + nv ;
+      double  t  = x - i ;
+      unsigned int j ;
+
+      for(j = 0 ; j < nv ; j++) {
+        v[j] = y0[j] + t*(y1[j] - y0[j]) ;
+      }
+    }
+  }
+
+  return(0) ;
+}
+
@@ -0,0 +1,61 @@
+#ifndef TEMPERATURETABLE_H
+#define TEMPERATURETABLE_H
+
+/* class-like structures "TemperatureTable_t" */
+
+/* vacuous declarations and typedef names */
+struct TemperatureTable_s ; typedef struct TemperatureTable_s TemperatureTable_t ;
+
+
+/* Function computing the values to be tabulated at a given temperature */
+typedef void (TemperatureTable_ComputeValues_t)(const double,double*) ;
+
+
+extern TemperatureTable_t* (TemperatureTable_Create)(const double,const double,const unsigned int,const unsigned int,TemperatureTable_ComputeValues_t*) ;
+extern void                (TemperatureTable_Delete)(void*) ;
+extern int                 (TemperatureTable_Interpolate)(TemperatureTable_t*,const double,double*) ;
+
+
+
+/* Default grid: 0 to 100 Celsius degrees every 0.1 K. The grid should
+ * include the breakpoints of the piecewise linear temperature dependences
+ * (see PiecewiseLinearTemperatureDependence.h) */
+#define TemperatureTable_DefaultMinTemperature      (Temperature_0C)
+#define TemperatureTable_DefaultMaxTemperature      (Temperature_0C + 100.)
+#define TemperatureTable_DefaultNbOfPoints          (1001)
+
+
+#define TemperatureTable_GetNbOfPoints(TT)          ((TT)->nbofpoints)
+#define TemperatureTable_GetNbOfValues(TT)          ((TT)->nbofvalues)
+#define TemperatureTable_GetMinTemperature(TT)      ((TT)->mintemperature)
+#define TemperatureTable_GetTemperatureIncrement(TT) ((TT)->increment)
+#define TemperatureTable_GetValue(TT)               ((TT)->value)
+#define TemperatureTable_GetComputeValues(TT)       ((TT)->computevalues)
+
+
+#define TemperatureTable_GetMaxTemperature(TT) \
+        (TemperatureTable_GetMinTemperature(TT) + \
+        (TemperatureTable_GetNbOfPoints(TT) - 1)*TemperatureTable_GetTemperatureIncrement(TT))
+
+
+#define TemperatureTable_IsInRange(TT,T) \
+        (((T) >= TemperatureTable_GetMinTemperature(TT)) && \
+         ((T) <= TemperatureTable_GetMaxTemperature(TT)))
+
+
+
+#include "Temperature.h"
+
+/* Values on a uniform temperature grid, interpolated linearly
+ * (value[i*nbofvalues + j] is the j-th value at the i-th temperature
+ * of the grid) */
+struct TemperatureTable_s {
+  unsigned int nbofpoints ;
+  unsigned int nbofvalues ;
+  double  mintemperature ;
+  double  increment ;
+  double* value ;
+  TemperatureTable_ComputeValues_t* computevalues ;
+} ;
+
+#endif
@@ -117,7 +117,12 @@ FEM_t* FEM_GetInstance0(Element_t* el)
 
 FEM_t*  (FEM_GetInstance)(Element_t* el)
 {
-  GenericData_t* gdat = Session_FindGenericData(FEM_t,"FEM") ;
+  static const char* handle = NULL ;
+  GenericData_t* gdat ;
+  
+  if(!handle) handle = GenericData_InternName("FEM") ;
+  
+  gdat = Session_FindGenericDataWithHandle(FEM_t,handle) ;
   
   if(!gdat) {
     FEM_t* fem = FEM_Create() ;
@@ -126,7 +131,7 @@ FEM_t*  (FEM_GetInstance)(Element_t* el)
     
     Session_AddGenericData(gdat) ;
     
-    assert(gdat == Session_FindGenericData(FEM_t,"FEM")) ;
+    assert(gdat == Session_FindGenericDataWithHandle(FEM_t,handle)) ;
   }
   
   {
@@ -97,7 +97,12 @@ void FVM_Delete(void* self)
 
 FVM_t*  (FVM_GetInstance)(Element_t* el)
 {
-  GenericData_t* gdat = Session_FindGenericData(FVM_t,"FVM") ;
+  static const char* handle = NULL ;
+  GenericData_t* gdat ;
+  
+  if(!handle) handle = GenericData_InternName("FVM") ;
+  
+  gdat = Session_FindGenericDataWithHandle(FVM_t,handle) ;
   
   if(!gdat) {
     FVM_t* fvm = FVM_Create() ;
@@ -106,7 +111,7 @@ FVM_t*  (FVM_GetInstance)(Element_t* el)
     
     Session_AddGenericData(gdat) ;
     
-    assert(gdat == Session_FindGenericData(FVM_t,"FVM")) ;
+    assert(gdat == Session_FindGenericDataWithHandle(FVM_t,handle)) ;
   }
   
   {
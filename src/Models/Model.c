@@ -111,6 +111,15 @@ Model_t* Model_New(void)
       
       Model_GetViews(model) = views ;
     }
+
+    
+    /* Allocation of space for the structural zeros (the last one flags any) */
+    {
+      int n = Model_MaxNbOfEquations*Model_MaxNbOfEquations + 1 ;
+      char* zero = (char*) Mry_New(char,n) ;
+      
+      Model_GetStructuralZero(model) = zero ;
+    }
   
   
     /* Allocation of space for the local variables */
@@ -310,6 +319,7 @@ void  Model_Free(void* self)
     free(Model_GetShortTitle(model)) ;
     free(Model_GetNameOfAuthors(model)) ;
     free(Model_GetObjectiveValue(model)) ;
+    free(Model_GetStructuralZero(model)) ;
     {
       Views_t* views = Model_GetViews(model) ;
       
@@ -357,6 +367,25 @@ Model_t* (Model_Initialize)(Model_t* model,const char* codename,Geometry_t* geom
 
 
 
+void (Model_UncoupleEquationFromUnknown)(Model_t* model,const int i,const int j)
+/** Declare that the equation i doesn't depend on the unknown j, i.e. the
+ *  entries (i,j) of the element matrices are structural zeros. */
+{
+  if(i < 0 || i >= Model_MaxNbOfEquations || j < 0 || j >= Model_MaxNbOfEquations) {
+    arret("Model_UncoupleEquationFromUnknown: bad index") ;
+  }
+  
+  if(i == j) {
+    arret("Model_UncoupleEquationFromUnknown: the diagonal can't be uncoupled") ;
+  }
+  
+  Model_GetStructuralZero(model)[i*Model_MaxNbOfEquations + j] = 1 ;
+  Model_GetStructuralZero(model)[Model_MaxNbOfEquations*Model_MaxNbOfEquations] = 1 ;
+}
+
+
+
+
 double* Model_ComputeVariableDerivatives(Element_t* el,double t,double dt,double dxi,int i,int n)
 {
   Model_t* model = Element_GetModel(el) ;
@@ -31,6 +31,7 @@ typedef int    (Model_ComputeExplicitTerms_t)(Element_t*,double) ;
 typedef int    (Model_ComputeImplicitTerms_t)(Element_t*,double,double) ;
 typedef int    (Model_ComputeMatrix_t)       (Element_t*,double,double,double*) ;
 typedef int    (Model_ComputeResidu_t)       (Element_t*,double,double,double*) ;
+typedef int    (Model_ComputeResiduAndMatrix_t)(Element_t*,double,double,double*,double*) ;
 
 typedef void*  (Model_ComputeVariables_t)(Element_t*,void*,void*,void*,const double,const double,const int) ;
 //typedef double*   (Model_ComputeVariableFluxes_t)(Element_t* el,double** u,double t,double dt,int i,int j,...) ;
@@ -66,6 +67,7 @@ extern Model_t*  (Model_Create)    (int) ;
 extern void      (Model_Delete)    (void*,const int) ;
 extern Model_t*  (Model_Initialize)(Model_t*,const char*,Geometry_t*,DataFile_t*) ;
 extern double*   (Model_ComputeVariableDerivatives)(Element_t*,double,double,double,int,int) ;
+extern void      (Model_UncoupleEquationFromUnknown)(Model_t*,const int,const int) ;
 
 
 #include "Views.h"
@@ -94,6 +96,8 @@ extern double*   (Model_ComputeVariableDerivatives)(Element_t*,double,double,dou
 #define Model_GetViews(MOD)                ((MOD)->views)
 #define Model_GetLocalVariableVectors(MOD) ((MOD)->localvariable)
 #define Model_GetLocalFluxVectors(MOD)     ((MOD)->localflux)
+#define Model_GetJacobianFree(MOD)         ((MOD)->jacobianfree)
+#define Model_GetStructuralZero(MOD)       ((MOD)->structuralzero)
 //#define Model_GetNbOfVariables(MOD)        ((MOD)->nbofvariables)
 //#define Model_GetNbOfVariableFluxes(MOD)   ((MOD)->nbofvariablefluxes)
 
@@ -107,6 +111,7 @@ extern double*   (Model_ComputeVariableDerivatives)(Element_t*,double,double,dou
 #define Model_GetComputeImplicitTerms(MOD)    ((MOD)->computeimplicitterms)
 #define Model_GetComputeMatrix(MOD)           ((MOD)->computematrix)
 #define Model_GetComputeResidu(MOD)           ((MOD)->computeresidu)
+#define Model_GetComputeResiduAndMatrix(MOD)  ((MOD)->computeresiduandmatrix)
 #define Model_GetComputeLoads(MOD)            ((MOD)->computeloads)
 #define Model_GetComputeOutputs(MOD)          ((MOD)->computeoutputs)
 #define Model_GetComputePropertyIndex(MOD)    ((MOD)->computepropertyindex)
@@ -138,6 +143,39 @@ extern double*   (Model_ComputeVariableDerivatives)(Element_t*,double,double,dou
         Geometry_GetDimension(Model_GetGeometry(MOD))
 
 
+/* Jacobian-free Newton-Krylov resolution.
+ * A model opts in by setting Model_GetJacobianFree(model) = 1
+ * in its SetModelProp: its matrix is then only used to precondition
+ * the linear solve, the products by the jacobian being approximated
+ * by finite differences of the residu. */
+#define Model_IsJacobianFree(MOD) \
+        (Model_GetJacobianFree(MOD) != 0)
+
+
+
+/* Fused residu and matrix.
+ * A model may provide Model_GetComputeResiduAndMatrix(model) computing
+ * both the residu and the matrix of an element from one evaluation of
+ * its constitutive equations. It is then called instead of the residu
+ * and the matrix methods whenever both are needed at once. */
+#define Model_HasFusedResiduAndMatrix(MOD) \
+        (Model_GetComputeResiduAndMatrix(MOD) != NULL)
+
+
+
+/* Coupling of the equations with the unknowns.
+ * A model declares in its SetModelProp that the equation i never
+ * depends on the unknown j by Model_UncoupleEquationFromUnknown(model,i,j).
+ * The corresponding entries of the element matrices are then neither
+ * stored in the global matrix nor assembled. */
+#define Model_EquationIsCoupledToUnknown(MOD,i,j) \
+        (!Model_GetStructuralZero(MOD)[(i)*Model_MaxNbOfEquations + (j)])
+
+#define Model_HasStructuralZeros(MOD) \
+        (Model_GetStructuralZero(MOD)[Model_MaxNbOfEquations*Model_MaxNbOfEquations])
+
+
+
 /* Short hands */
 #define Model_SetModelProp(MOD) \
         Model_GetSetModelProp(MOD)(MOD)
@@ -190,6 +228,7 @@ struct Model_s {              /* model */
   Model_ComputeImplicitTerms_t*     computeimplicitterms ;
   Model_ComputeMatrix_t*            computematrix ;
   Model_ComputeResidu_t*            computeresidu ;
+  Model_ComputeResiduAndMatrix_t*   computeresiduandmatrix ;
   Model_ComputeLoads_t*             computeloads ;
   Model_ComputeOutputs_t*           computeoutputs ;
   Model_ComputePropertyIndex_t*     computepropertyindex ;
@@ -214,6 +253,9 @@ struct Model_s {              /* model */
   LocalVariableVectors_t* localvariable ;
   LocalVariableVectors_t* localflux ;
   
+  unsigned short jacobianfree ; /* Jacobian-free resolution (1) or not (0) */
+  char*    structuralzero ;   /* Equation i uncoupled from unknown j (1) or not (0) */
+  
   //unsigned int nbofvariables ;
   //unsigned int nbofvariablefluxes ;
 } ;
@@ -624,6 +624,7 @@ static int     TangentCoefficients(Element_t*,double,double*) ;
 
 
 static void    ComputePhysicoChemicalProperties(double) ;
+static void    SetTemperature(double) ;
 
 static int     concentrations_oh_na_k(double,double,double,double,double,double) ;
 
@@ -676,6 +677,9 @@ static double rho_l0 ;
 static CementSolutionDiffusion_t* csd = NULL ;
 static HardenedCementChemistry_t* hcc = NULL ;
 
+/* Temperature of the material set in csd and hcc (0 = TEMPERATURE) */
+static double temperature = 0 ;
+
 
 
 #include "PhysicalConstant.h"
@@ -717,6 +721,28 @@ void ComputePhysicoChemicalProperties(double TK)
 
 
 
+void SetTemperature(double TK)
+/** Set the properties and the chemical constants at TK. The constants
+ *  are interpolated in the tables shared by the instances of hcc.
+ *  TK = 0 restores the defaults set by ReadMatProp. */
+{
+  if(TK > 0) {
+    ComputePhysicoChemicalProperties(TK) ;
+    HardenedCementChemistry_SetTemperature(hcc,TK) ;
+    CementSolutionDiffusion_SetRoomTemperature(csd,TK) ;
+  } else {
+    ComputePhysicoChemicalProperties(TEMPERATURE) ;
+    /* The constants of HardenedCementChemistry_Create */
+    HardenedCementChemistry_SetTemperature(hcc,Temperature_DefaultValue) ;
+    HardenedCementChemistry_SetRoomTemperature(hcc,TEMPERATURE) ;
+    CementSolutionDiffusion_SetRoomTemperature(csd,TEMPERATURE) ;
+  }
+  
+  temperature = TK ;
+}
+
+
+
 enum {
 I_P_L  = NEQ   ,
 
@@ -803,6 +829,7 @@ int pm(const char* s)
   else if(strcmp(s,"Rate_Calcite") == 0)  return (16) ;
   else if(strcmp(s,"kg_int") == 0)        return (17) ;
   else if(strcmp(s,"p_c3") == 0)          return (18) ;
+  else if(strcmp(s,"temperature") == 0)   return (19) ;
   else return(-1) ;
 }
 
@@ -824,6 +851,13 @@ void GetProperties(Element_t* el)
   rate_cc  = GetProperty("Rate_Calcite") ;
   p_c3     = GetProperty("p_c3") ;
   
+  /* Materials at different temperatures share csd and hcc */
+  {
+    double TK = GetProperty("temperature") ;
+    
+    if(TK != temperature) SetTemperature(TK) ;
+  }
+  
   saturationcurve         = Element_FindCurve(el,"s_l") ;
   relativepermliqcurve    = Element_FindCurve(el,"kl_r") ;
 #ifdef E_Air
@@ -909,6 +943,15 @@ int SetModelProp(Model_t* model)
 #ifdef E_Air
   Model_CopyNameOfUnknown(model,E_Air, "p_g") ;
 #endif
+
+#ifdef E_eneutral
+  /** Structural zeros: the liquid charge density depends only on the
+   *  concentrations, neither on the liquid pressure nor on the electric
+   *  potential (the ion current does depend on the liquid pressure
+   *  through the tortuosity) */
+  Model_UncoupleEquationFromUnknown(model,E_eneutral,E_mass) ;
+  Model_UncoupleEquationFromUnknown(model,E_eneutral,E_charge) ;
+#endif
   
   //Model_GetNbOfVariables(model) = NbOfVariables ;
   //Model_GetNbOfVariableFluxes(model) = NbOfVariableFluxes ;
@@ -921,7 +964,7 @@ int SetModelProp(Model_t* model)
 int ReadMatProp(Material_t* mat,DataFile_t* datafile)
 /* Lecture des donnees materiaux dans le fichier ficd */
 {
-  int  NbOfProp = 19 ;
+  int  NbOfProp = 20 ;
   
   InternationalSystemOfUnits_UseAsLength("decimeter") ;
   InternationalSystemOfUnits_UseAsMass("hectogram") ;
@@ -984,6 +1027,8 @@ int ReadMatProp(Material_t* mat,DataFile_t* datafile)
     HardenedCementChemistry_SetRoomTemperature(hcc,TEMPERATURE) ;
     
     CementSolutionDiffusion_SetRoomTemperature(csd,TEMPERATURE) ;
+    
+    temperature = 0 ;
   }
   
   
@@ -1109,6 +1154,7 @@ int PrintModelChar(Model_t* model,FILE *ficd)
   fprintf(ficd,"A_2 = 1e-2        # Kinetic coef 2 (dm/mol/s)\n") ;
   fprintf(ficd,"frac = 0.8        # Fractionnal length of pore bodies\n") ;
   fprintf(ficd,"phi_r = 0.7       # Porosity for which permeability vanishes\n") ;
+  fprintf(ficd,"temperature = 313 # Temperature (K), 298 by default\n") ;
   fprintf(ficd,"Curves = my_file  # File name: p_c S_l kl_r\n") ;  
   fprintf(ficd,"Curves = my_file  # File name: si_ch C/S H/S V_csh\n") ;  
   fprintf(ficd,"Curves = my_file  # File name: s_l kl_r kg_r\n") ;  
@@ -1799,12 +1845,21 @@ int  ComputeResidu(Element_t* el,double t,double dt,double* r)
 
 
 
+/* Indexes of the views of ComputeOutputs read from the unknowns and
+ * the implicit terms, which do not need the chemistry to be solved.
+ * They follow the order of the Result_Store sequence. */
+#define I_VIEW_P_L       (0)
+#define I_VIEW_W_TOT     (46)
+#define I_VIEW_W_CL      (52)
+#define I_VIEW_PSI       (54)
+
 int  ComputeOutputs(Element_t* el,double t,double* s,Result_t* r)
 {
   double* f = Element_GetCurrentImplicitTerm(el) ;
   FVM_t* fvm = FVM_GetInstance(el) ;
   double** u = Element_ComputePointerToNodalUnknowns(el) ;
   int    nso = 68 ;
+  int    chemistry = 0 ;
   int    i ;
 
   if(Element_IsSubmanifold(el)) return(0) ;
@@ -1822,9 +1877,29 @@ int  ComputeOutputs(Element_t* el,double t,double* s,Result_t* r)
 
   {
     int j = FVM_FindLocalCellIndex(fvm,s) ;
-    double* x = ComputeVariables(el,u,u,f,t,0,j) ;
+    double* x = Variables[j] ;
+    
+    /* The chemistry is solved only if a requested view needs it.
+     * The liquid pressure, the mass flows and the electric potential
+     * are read from the unknowns and the implicit terms. */
+    {
+      for(i = 0 ; i < nso ; i++) {
+        if(i == I_VIEW_P_L) continue ;
+        if(i >= I_VIEW_W_TOT && i <= I_VIEW_W_CL) continue ;
+        if(i == I_VIEW_PSI) continue ;
+        
+        if(Result_IsRequested(r + i)) {
+          chemistry = 1 ;
+          break ;
+        }
+      }
       
-    if(!x) return(0) ;
+      if(chemistry) {
+        x = ComputeVariables(el,u,u,f,t,0,j) ;
+      
+        if(!x) return(0) ;
+      }
+    }
     
     /* Macros */
 #define ptC(CPD)   &(HardenedCementChemistry_GetAqueousConcentrationOf(hcc,CPD))
@@ -1836,92 +1911,110 @@ int  ComputeOutputs(Element_t* el,double t,double* s,Result_t* r)
 
 
 
+    /* The views needing the chemistry are left to zero,
+     * only their names are stored, if it was not solved */
+#define StoreChemistryView(PT,NAME,N) \
+    do { \
+      if(chemistry) { \
+        Result_Store(r + i,PT,NAME,N) ; \
+      } else { \
+        strcpy(Result_GetNameOfView(r + i),NAME) ; \
+      } \
+      i++ ; \
+    } while(0)
+
+
     /* Outputs */
     i = 0 ;
     
     /* Liquid pressure */
-    Result_Store(r + i++,x + I_P_L,"p_l",1) ;
+    {
+      double p_l = P_L(j) ;
+      
+      Result_Store(r + i++,&p_l,"p_l",1) ;
+    }
     
     /* Liquid saturation degree */
-    Result_Store(r + i++,x + I_S_L,"saturation",1) ;
+    StoreChemistryView(x + I_S_L,"saturation",1) ;
     
-    Result_Store(r + i++,x + I_Phi,"porosity",1) ;
+    StoreChemistryView(x + I_Phi,"porosity",1) ;
     
     /* Concentration in gas phase */
-    Result_Store(r + i++,x + I_C_CO2,"c_co2",1) ;
+    StoreChemistryView(x + I_C_CO2,"c_co2",1) ;
     
     /* Element concentrations in liquid phase */
-    Result_Store(r + i++,ptEC(Ca ),"c_ca_l",1) ;
-    Result_Store(r + i++,ptEC(Si ),"c_si_l",1) ;
-    Result_Store(r + i++,ptEC(Na ),"c_na_l",1) ;
-    Result_Store(r + i++,ptEC(K  ),"c_k_l" ,1) ;
-    Result_Store(r + i++,ptEC(C  ),"c_c_l" ,1) ;
-    Result_Store(r + i++,ptEC(Cl ),"c_cl_l",1) ;
+    StoreChemistryView(ptEC(Ca ),"c_ca_l",1) ;
+    StoreChemistryView(ptEC(Si ),"c_si_l",1) ;
+    StoreChemistryView(ptEC(Na ),"c_na_l",1) ;
+    StoreChemistryView(ptEC(K  ),"c_k_l" ,1) ;
+    StoreChemistryView(ptEC(C  ),"c_c_l" ,1) ;
+    StoreChemistryView(ptEC(Cl ),"c_cl_l",1) ;
     
     /* Portlandite */
-    Result_Store(r + i++,x + I_N_CH,"n_CH",1) ;
-    Result_Store(r + i++,ptS(CH),"s_ch",1) ;
+    StoreChemistryView(x + I_N_CH,"n_CH",1) ;
+    StoreChemistryView(ptS(CH),"s_ch",1) ;
     
     /* C-S-H */
-    Result_Store(r + i++,x + I_N_CSH,"n_CSH",1) ;
-    Result_Store(r + i++,ptX_CSH,"x_csh",1) ;
-    Result_Store(r + i++,ptS(SH),"s_sh",1) ;
+    StoreChemistryView(x + I_N_CSH,"n_CSH",1) ;
+    StoreChemistryView(ptX_CSH,"x_csh",1) ;
+    StoreChemistryView(ptS(SH),"s_sh",1) ;
     
     /* Calcite */
-    Result_Store(r + i++,x + I_N_CC,"n_CC",1) ;
-    Result_Store(r + i++,ptS(CC),"s_cc",1) ;
+    StoreChemistryView(x + I_N_CC,"n_CC",1) ;
+    StoreChemistryView(ptS(CC),"s_cc",1) ;
     
     
     /* Ion concentrations in liquid phase */
-    Result_Store(r + i++,ptC(H ),"c_h",1) ;
-    Result_Store(r + i++,ptC(OH),"c_oh",1) ;
+    StoreChemistryView(ptC(H ),"c_h",1) ;
+    StoreChemistryView(ptC(OH),"c_oh",1) ;
     {
       double c_h       = *(ptC(H )) ;
       double ph        = - log10(c_h) ;
       
-      Result_Store(r + i++,&ph,"ph",1) ;
+      StoreChemistryView(&ph,"ph",1) ;
     }
     
-    Result_Store(r + i++,ptC(Ca  ),"c_ca",1) ;
-    Result_Store(r + i++,ptC(CaOH),"c_caoh",1) ;
+    StoreChemistryView(ptC(Ca  ),"c_ca",1) ;
+    StoreChemistryView(ptC(CaOH),"c_caoh",1) ;
     
-    Result_Store(r + i++,ptC(H2SiO4),"c_h2sio4",1) ;
-    Result_Store(r + i++,ptC(H3SiO4),"c_h3sio4",1) ;
-    Result_Store(r + i++,ptC(H4SiO4),"c_h4sio4",1) ;
+    StoreChemistryView(ptC(H2SiO4),"c_h2sio4",1) ;
+    StoreChemistryView(ptC(H3SiO4),"c_h3sio4",1) ;
+    StoreChemistryView(ptC(H4SiO4),"c_h4sio4",1) ;
     
-    Result_Store(r + i++,ptC(Na  ),"c_na",1) ;
-    Result_Store(r + i++,ptC(NaOH),"c_naoh",1) ;
+    StoreChemistryView(ptC(Na  ),"c_na",1) ;
+    StoreChemistryView(ptC(NaOH),"c_naoh",1) ;
     
-    Result_Store(r + i++,ptC(K  ),"c_k",1) ;
-    Result_Store(r + i++,ptC(KOH),"c_koh",1) ;
+    StoreChemistryView(ptC(K  ),"c_k",1) ;
+    StoreChemistryView(ptC(KOH),"c_koh",1) ;
     
-    Result_Store(r + i++,ptC(CO3 ),"c_co3",1) ;
-    Result_Store(r + i++,ptC(HCO3),"c_hco3",1) ;
+    StoreChemistryView(ptC(CO3 ),"c_co3",1) ;
+    StoreChemistryView(ptC(HCO3),"c_hco3",1) ;
     
-    Result_Store(r + i++,ptC(CaH2SiO4),"c_cah2sio4",1) ;
-    Result_Store(r + i++,ptC(CaH3SiO4),"c_cah3sio4",1) ;
+    StoreChemistryView(ptC(CaH2SiO4),"c_cah2sio4",1) ;
+    StoreChemistryView(ptC(CaH3SiO4),"c_cah3sio4",1) ;
     
-    Result_Store(r + i++,ptC(CaHCO3),"c_cahco3",1) ;
-    Result_Store(r + i++,ptC(CaCO3),"c_caco3aq",1) ;
-    Result_Store(r + i++,ptC(CaO2H2),"c_caoh2aq",1) ;
+    StoreChemistryView(ptC(CaHCO3),"c_cahco3",1) ;
+    StoreChemistryView(ptC(CaCO3),"c_caco3aq",1) ;
+    StoreChemistryView(ptC(CaO2H2),"c_caoh2aq",1) ;
     
-    Result_Store(r + i++,ptC(NaHCO3),"c_nahco3",1) ;
-    Result_Store(r + i++,ptC(NaCO3),"c_naco3",1) ;
+    StoreChemistryView(ptC(NaHCO3),"c_nahco3",1) ;
+    StoreChemistryView(ptC(NaCO3),"c_naco3",1) ;
     
-    Result_Store(r + i++,ptC(Cl),"c_cl",1) ;
+    StoreChemistryView(ptC(Cl),"c_cl",1) ;
     
     /* Total element contents */
-    Result_Store(r + i++,x + I_N_Ca,"n_Ca",1) ;
-    Result_Store(r + i++,x + I_N_Si,"n_Si",1) ;
-    Result_Store(r + i++,x + I_N_Na,"n_Na",1) ;
-    Result_Store(r + i++,x + I_N_K ,"n_K" ,1) ;
-    Result_Store(r + i++,x + I_N_C ,"n_C" ,1) ;
-    Result_Store(r + i++,x + I_N_Cl,"n_Cl" ,1) ;
+    StoreChemistryView(x + I_N_Ca,"n_Ca",1) ;
+    StoreChemistryView(x + I_N_Si,"n_Si",1) ;
+    StoreChemistryView(x + I_N_Na,"n_Na",1) ;
+    StoreChemistryView(x + I_N_K ,"n_K" ,1) ;
+    StoreChemistryView(x + I_N_C ,"n_C" ,1) ;
+    StoreChemistryView(x + I_N_Cl,"n_Cl" ,1) ;
     
     /* Total mass content */
-    Result_Store(r + i++,x + I_Mass,"total mass",1) ;
+    StoreChemistryView(x + I_Mass,"total mass",1) ;
     
     /* Mass flows */
+    if(i != I_VIEW_W_TOT) arret("ComputeOutputs: index of the mass flows") ;
     Result_Store(r + i++,&(W_tot(0,1)),"total mass flow",1) ;
     Result_Store(r + i++,&(W_C(0,1)),"carbon mass flow",1) ;
     Result_Store(r + i++,&(W_Ca(0,1)),"calcium mass flow",1) ;
@@ -1935,38 +2028,39 @@ int  ComputeOutputs(Element_t* el,double t,double* s,Result_t* r)
     {
       double CS = x[I_N_Ca_S]/x[I_N_Si_S] ;
       
-      Result_Store(r + i++,&CS,"Ca/Si ratio",1) ;
+      StoreChemistryView(&CS,"Ca/Si ratio",1) ;
     }
     
     {
       double psi = PSI(j) ;
       
+      if(i != I_VIEW_PSI) arret("ComputeOutputs: index of the electric potential") ;
       Result_Store(r + i++,&psi,"Electric potential",1) ;
     }
     
-    Result_Store(r + i++,x + I_N_Q,"charge",1) ;
+    StoreChemistryView(x + I_N_Q,"charge",1) ;
     
     {
       double I = HardenedCementChemistry_GetIonicStrength(hcc) ;
       
-      Result_Store(r + i++,&I,"I",1) ;
+      StoreChemistryView(&I,"I",1) ;
     }
     
     /* Molar volumes */
     {
       double v_solide_csh   = x[I_V_CSH] * x[I_N_CSH] ;
       
-      Result_Store(r + i++,&v_solide_csh,"v_csh",1) ;
+      StoreChemistryView(&v_solide_csh,"v_csh",1) ;
     }
     {
       double v_solide_ch    = V_CH * x[I_N_CH] ;
       
-      Result_Store(r + i++,&v_solide_ch,"v_ch",1) ;
+      StoreChemistryView(&v_solide_ch,"v_ch",1) ;
     }
     {
       double v_solide_cc    = V_CC * x[I_N_CC] ;
       
-      Result_Store(r + i++,&v_solide_cc,"v_cc",1) ;
+      StoreChemistryView(&v_solide_cc,"v_cc",1) ;
     }
     
     /* Gas pressures */
@@ -1980,10 +2074,10 @@ int  ComputeOutputs(Element_t* el,double t,double* s,Result_t* r)
       double c_co2      = p_co2 / p_atm * 1.e6 ;
       double p_air      = p_g - p_v - p_co2 ;
       
-      Result_Store(r + i++,&p_air,"air pressure",1) ;
-      Result_Store(r + i++,&h_r,"humidity",1) ;
-      Result_Store(r + i++,&c_co2,"CO2 ppm",1) ;
-      Result_Store(r + i++,&p_g,"gas pressure",1) ;
+      StoreChemistryView(&p_air,"air pressure",1) ;
+      StoreChemistryView(&h_r,"humidity",1) ;
+      StoreChemistryView(&c_co2,"CO2 ppm",1) ;
+      StoreChemistryView(&p_g,"gas pressure",1) ;
     }
       
 
@@ -1994,8 +2088,8 @@ int  ComputeOutputs(Element_t* el,double t,double* s,Result_t* r)
       double coeff_permeability = PermeabilityCoefficient(el,phi) ;
       double k_l  = (kl_int/mu_l)*RelativePermeabilityToLiquid(s_l)*coeff_permeability ;
 
-      Result_Store(r + i++,&k_l,"permeability to liquid",1) ;
-      Result_Store(r + i++,&coeff_permeability,"permeability coef",1) ;
+      StoreChemistryView(&k_l,"permeability to liquid",1) ;
+      StoreChemistryView(&coeff_permeability,"permeability coef",1) ;
     }
     
     /* Adsorbed chloride */
@@ -2005,20 +2099,21 @@ int  ComputeOutputs(Element_t* el,double t,double* s,Result_t* r)
       double x_csh  = (ptX_CSH)[0] ;
       double n_cl_s = n_csh * AdsorbedChloridePerUnitMoleOfCSH(c_cl,x_csh) ;
       
-      Result_Store(r + i++,&n_cl_s,"adsorbed chloride",1) ;
+      StoreChemistryView(&n_cl_s,"adsorbed chloride",1) ;
     }
     
     /* Liquid mass density */
     {
       double rho_l  = HardenedCementChemistry_GetLiquidMassDensity(hcc) ;
       
-      Result_Store(r + i++,&rho_l,"liquid mass density",1) ;
+      StoreChemistryView(&rho_l,"liquid mass density",1) ;
     }
   }
   
   
   if(i != nso) arret("ComputeOutputs") ;
   return(nso) ;
+#undef StoreChemistryView
 }
 
 
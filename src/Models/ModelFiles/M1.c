@@ -53,6 +53,7 @@ static int    pm(const char *s) ;
 //static int    c1(Element_t*,double*) ;
 //static int    k1(Element_t*,double*) ;
 static int    TangentCoefficients(Element_t*,double,double*) ;
+static Model_ComputeResiduAndMatrix_t ComputeResiduAndMatrix ;
 
 
 /* Parametres */
@@ -79,6 +80,9 @@ int SetModelProp(Model_t *model)
   Model_CopyNameOfEquation(model,E_liq,"liq") ;
   Model_CopyNameOfUnknown(model,I_p_l,"p_l") ;
   
+  Model_GetComputeResiduAndMatrix(model) = ComputeResiduAndMatrix ;
+  Model_GetJacobianFree(model) = 1 ;
+  
   return(0) ;
 }
 
@@ -345,6 +349,57 @@ int  ComputeResidu(Element_t *el,double t,double dt,double *r)
 }
 
 
+int  ComputeResiduAndMatrix(Element_t *el,double t,double dt,double *r,double *k)
+/* Residu (r) and matrix (k) in a single pass over the element */
+{
+  double *f = Element_GetCurrentImplicitTerm(el) ;
+  double *f_n = Element_GetPreviousImplicitTerm(el) ;
+  int    nn = Element_GetNbOfNodes(el) ;
+  int    ndof = nn*NEQ ;
+  FVM_t *fvm = FVM_GetInstance(el) ;
+  int    i ;
+  double zero = 0. ;
+  
+  /* initialisation */
+  for(i = 0 ; i < ndof ; i++) r[i] = zero ;
+  for(i = 0 ; i < ndof*ndof ; i++) k[i] = zero ;
+
+  if(Element_IsSubmanifold(el)) return(0) ;
+  
+  /*
+    Residu
+  */
+  {
+    double *volume = FVM_ComputeCellVolumes(fvm) ;
+    double *surface = FVM_ComputeCellSurfaceAreas(fvm) ;
+    double surf = surface[1] ;
+    
+    r[0] -= volume[0]*(M_l(0) - M_ln(0)) + dt*surf*W_l ;
+    r[1] -= volume[1]*(M_l(1) - M_ln(1)) - dt*surf*W_l ;
+  }
+  
+  /*
+    Matrix
+  */
+  {
+    double c[Element_MaxNbOfNodes*Element_MaxNbOfNodes*NEQ*NEQ] ;
+    
+    phi     = GetProperty("phi") ;
+    rho_l   = GetProperty("rho_l") ;
+    p_g     = GetProperty("p_g") ;
+  
+    TangentCoefficients(el,dt,c) ;
+    {
+      double *km = FVM_ComputeMassAndIsotropicConductionMatrix(fvm,c,1) ;
+    
+      for(i = 0 ; i < ndof*ndof ; i++) k[i] = km[i] ;
+    }
+  }
+  
+  return(0) ;
+}
+
+
 int  ComputeOutputs(Element_t *el,double t,double *s,Result_t *r)
 /* Les valeurs exploitees (s) */
 {
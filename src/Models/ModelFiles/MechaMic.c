@@ -886,22 +886,12 @@ int ComputeMicrostructureMatrix(Mesh_t* mesh,Solver_t* solver,double t,double dt
   }
 
 
-  /* The solutions */
+  /* The solutions
+   * (the r.h.s. used are stored up to pb[4 * (dim - 1)]) */
   {
-    int k ;
-
-    for(k = 0 ; k < dim ; k++) {
-      int l ;
-          
-      for(l = k ; l < dim ; l++) {
-        Solver_GetRHS(solver) = pb[3 * k + l] ;
-        Solver_GetSolution(solver) = pu[3 * k + l] ;
-        Solver_Solve(solver) ;
-      }
-    }
+    int nrhs = (pb[4 * (dim - 1)] - b) / ncol + 1 ;
     
-    Solver_GetRHS(solver) = b ;
-    Solver_GetSolution(solver) = u ;
+    Solver_SolveMultiple(solver,nrhs) ;
   }
 
 
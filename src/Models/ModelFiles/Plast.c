@@ -253,7 +253,13 @@ void GetProperties(Element_t* el,double t)
   sig0    = &GetProperty("sig0") ;
   //hardv0  = GetProperty("hardv0") ;
   
-  plasty = Element_FindMaterialData(el,Plasticity_t,"Plasticity") ;
+  {
+    static const char* handle = NULL ;
+    
+    if(!handle) handle = GenericData_InternName("Plasticity") ;
+    
+    plasty = Element_FindMaterialDataWithHandle(el,Plasticity_t,handle) ;
+  }
   {
     Elasticity_t* elasty = Plasticity_GetElasticity(plasty) ;
     
@@ -1020,7 +1020,11 @@ void ComputeTransferCoefficients(Element_t *el,double **u,double *f)
     Donnees
   */
   phi0      = GetProperty("porosite") ;
+  n_ca_ref  = GetProperty("N_CH") ;
+  n_si_ref  = GetProperty("N_Si") ;
   c_h2s_eq = GetProperty("C_H2S_eq") ;
+  t_ch      = GetProperty("T_CH") ;
+  t_cas     = GetProperty("T_CaS") ;
   /*k_int     = GetProperty("k_int") ;*/
   
   /* initialisation */
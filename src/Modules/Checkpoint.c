@@ -0,0 +1,504 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Message.h"
+#include "DataSet.h"
+#include "Checkpoint.h"
+#include "String.h"
+#include "Mry.h"
+
+
+static int   (Checkpoint_WriteState)(FILE*,DataSet_t*,Solutions_t*,OutputFiles_t*) ;
+static int   (Checkpoint_ReadState)(FILE*,DataSet_t*,Solutions_t*,OutputFiles_t*) ;
+static int   (Checkpoint_WriteElementTerms)(FILE*,Solution_t*,char) ;
+static int   (Checkpoint_ReadElementTerms)(FILE*,Solution_t*,char) ;
+
+
+/* Shorthands for the binary records */
+#define WRITE(V,N)  (fwrite(V,sizeof(*(V)),N,stream) == (size_t) (N))
+#define READ(V,N)   (fread(V,sizeof(*(V)),N,stream) == (size_t) (N))
+
+
+
+/* Extern functions */
+
+Checkpoint_t*  (Checkpoint_Create)(DataFile_t* datafile)
+/** Read the section "Checkpoint" of the data file. The periods of the
+ *  saves are given on the line of the keyword:
+ *  Minutes = m     saves every m minutes of wall time
+ *  Steps = k       saves every k steps
+ *  Return NULL if there is no such section. */
+{
+  char* filecontent = DataFile_GetFileContent(datafile) ;
+  char* c  = String_FindToken(filecontent,"CHECKPOINT,Checkpoint",",") ;
+  Checkpoint_t* checkpoint ;
+
+  if(!c) return(NULL) ;
+
+  Message_Direct("Enter in %s","Checkpoint") ;
+  Message_Direct("\n") ;
+
+  checkpoint = (Checkpoint_t*) Mry_New(Checkpoint_t) ;
+
+  {
+    char* line = String_CopyLine(c) ;
+    double m ;
+    int k ;
+
+    if(String_FindAndScanExp(line,"Minutes",","," = %lf",&m)) {
+      Checkpoint_GetWallTimePeriod(checkpoint) = 60*m ;
+    }
+
+    if(String_FindAndScanExp(line,"Steps",","," = %d",&k)) {
+      Checkpoint_GetStepPeriod(checkpoint) = k ;
+    }
+
+    if(Checkpoint_GetWallTimePeriod(checkpoint) <= 0 && Checkpoint_GetStepPeriod(checkpoint) <= 0) {
+      arret("Checkpoint_Create: no period (Minutes = m or Steps = k)") ;
+    }
+  }
+
+  Checkpoint_SetFileName(checkpoint,DataFile_GetFileName(datafile)) ;
+
+  return(checkpoint) ;
+}
+
+
+
+void  (Checkpoint_Delete)(void* self)
+{
+  Checkpoint_t** pcheckpoint = (Checkpoint_t**) self ;
+  Checkpoint_t*   checkpoint = *pcheckpoint ;
+
+  Mry_Free(Checkpoint_GetFileName(checkpoint)) ;
+  Mry_Free(Checkpoint_GetKeptNodalValue(checkpoint)) ;
+  Mry_Free(checkpoint) ;
+  *pcheckpoint = NULL ;
+}
+
+
+
+void  (Checkpoint_SetFileName)(Checkpoint_t* checkpoint,char* name)
+/** Name the checkpoint file "name.chk" and restart the periods. The runs
+ *  writing their outputs under different names (e.g. the cases of a
+ *  sweep) should not share the same checkpoint file. */
+{
+  char* filename = (char*) Mry_New(char[strlen(name) + 5]) ;
+
+  sprintf(filename,"%s.chk",name) ;
+
+  Mry_Free(Checkpoint_GetFileName(checkpoint)) ;
+
+  Checkpoint_GetFileName(checkpoint) = filename ;
+  Checkpoint_GetWallTimeOfLastWriting(checkpoint) = time(NULL) ;
+  Checkpoint_GetStepOfLastWriting(checkpoint) = 0 ;
+}
+
+
+
+int  (Checkpoint_IsDue)(Checkpoint_t* checkpoint,int step)
+/** Return 1 if a period has elapsed since the last save, 0 otherwise. */
+{
+  int nbofsteps = Checkpoint_GetStepPeriod(checkpoint) ;
+  double period = Checkpoint_GetWallTimePeriod(checkpoint) ;
+
+  if(nbofsteps > 0 && step - Checkpoint_GetStepOfLastWriting(checkpoint) >= nbofsteps) {
+    return(1) ;
+  }
+
+  if(period > 0 && difftime(time(NULL),Checkpoint_GetWallTimeOfLastWriting(checkpoint)) >= period) {
+    return(1) ;
+  }
+
+  return(0) ;
+}
+
+
+
+int  (Checkpoint_Write)(Checkpoint_t* checkpoint,DataSet_t* jdd,Solutions_t* sols,OutputFiles_t* outputfiles)
+/** Save the state reached by the current solution of sols. The file is
+ *  written under a temporary name then renamed, so that a run killed
+ *  meanwhile leaves the previous checkpoint intact.
+ *  Return 0 if succeeded, -1 otherwise (the run goes on). */
+{
+  char* filename = Checkpoint_GetFileName(checkpoint) ;
+  char* tmpname = (char*) Mry_New(char[strlen(filename) + 5]) ;
+  int i = -1 ;
+
+  sprintf(tmpname,"%s.tmp",filename) ;
+
+  {
+    FILE* stream = fopen(tmpname,"wb") ;
+
+    if(stream) {
+      i = Checkpoint_WriteState(stream,jdd,sols,outputfiles) ;
+
+      if(fclose(stream)) i = -1 ;
+
+      if(i == 0 && rename(tmpname,filename)) i = -1 ;
+
+      if(i != 0) remove(tmpname) ;
+    }
+  }
+
+  Mry_Free(tmpname) ;
+
+  if(i != 0) {
+    Message_Warning("Checkpoint_Write: unable to write %s",filename) ;
+    return(i) ;
+  }
+
+  {
+    Solution_t* sol = Solutions_GetSolution(sols) ;
+
+    Checkpoint_GetWallTimeOfLastWriting(checkpoint) = time(NULL) ;
+    Checkpoint_GetStepOfLastWriting(checkpoint) = Solution_GetStepIndex(sol) ;
+    Checkpoint_GetNbOfWritings(checkpoint) += 1 ;
+  }
+
+  return(0) ;
+}
+
+
+
+int  (Checkpoint_Read)(Checkpoint_t* checkpoint,DataSet_t* jdd,Solutions_t* sols,OutputFiles_t* outputfiles)
+/** Restore the state saved in the checkpoint file if it exists, the
+ *  point files being cut to their sizes at the time of the save.
+ *  Return 1 if the state was restored, 0 if there is no checkpoint file. */
+{
+  char* filename = Checkpoint_GetFileName(checkpoint) ;
+  FILE* stream = fopen(filename,"rb") ;
+
+  if(!stream) return(0) ;
+
+  if(Checkpoint_ReadState(stream,jdd,sols,outputfiles)) {
+    arret("Checkpoint_Read: %s doesn't match the data set",filename) ;
+  }
+
+  fclose(stream) ;
+
+  {
+    DataFile_t* datafile = DataSet_GetDataFile(jdd) ;
+    Mesh_t* mesh = DataSet_GetMesh(jdd) ;
+    Solution_t* sol = Solutions_GetSolution(sols) ;
+
+    Mesh_InitializeSolutionPointers(mesh,sols) ;
+
+    DataFile_ContextSetToNoInitialization(datafile) ;
+
+    Checkpoint_GetWallTimeOfLastWriting(checkpoint) = time(NULL) ;
+    Checkpoint_GetStepOfLastWriting(checkpoint) = Solution_GetStepIndex(sol) ;
+
+    Message_Direct("Resumed from %s at step %d\n",filename,Solution_GetStepIndex(sol)) ;
+  }
+
+  return(1) ;
+}
+
+
+
+void  (Checkpoint_Remove)(Checkpoint_t* checkpoint)
+/** Remove the checkpoint file once the run is complete. */
+{
+  remove(Checkpoint_GetFileName(checkpoint)) ;
+}
+
+
+
+void  (Checkpoint_KeepStepState)(Checkpoint_t* checkpoint,DataSet_t* jdd,Solutions_t* sols)
+/** Keep what the next step overwrites before it converges: the oldest
+ *  solution (the next one in the loop) and the state of the time step
+ *  management. To be called before stepping forward. */
+{
+  Solution_t* sol = Solution_GetNextSolution(Solutions_GetSolution(sols)) ;
+  TimeStep_t* timestep = DataSet_GetTimeStep(jdd) ;
+  int n_dof = Solution_GetNbOfDOF(sol) ;
+
+  if(!Checkpoint_GetKeptNodalValue(checkpoint)) {
+    Checkpoint_GetKeptNodalValue(checkpoint) = (double*) Mry_New(double[n_dof]) ;
+  }
+
+  memcpy(Checkpoint_GetKeptNodalValue(checkpoint),Solution_GetNodalValue(sol),n_dof*sizeof(double)) ;
+
+  Checkpoint_GetKeptTime(checkpoint)      = Solution_GetTime(sol) ;
+  Checkpoint_GetKeptTimeStep(checkpoint)  = Solution_GetTimeStep(sol) ;
+  Checkpoint_GetKeptStepIndex(checkpoint) = Solution_GetStepIndex(sol) ;
+
+  Checkpoint_GetKeptLocation(checkpoint)         = TimeStep_GetLocation(timestep) ;
+  Checkpoint_GetKeptErrorRatio(checkpoint)       = TimeStep_GetPreviousErrorRatio(timestep) ;
+  Checkpoint_GetKeptProposedTimeStep(checkpoint) = TimeStep_GetProposedTimeStep(timestep) ;
+}
+
+
+
+void  (Checkpoint_RestoreStepState)(Checkpoint_t* checkpoint,DataSet_t* jdd,Solutions_t* sols)
+/** Restore what was kept by Checkpoint_KeepStepState for a step which
+ *  did not complete, once stepped backward. The state written next is
+ *  then the one at the beginning of the step. */
+{
+  Solution_t* sol = Solution_GetNextSolution(Solutions_GetSolution(sols)) ;
+  TimeStep_t* timestep = DataSet_GetTimeStep(jdd) ;
+  int n_dof = Solution_GetNbOfDOF(sol) ;
+
+  if(!Checkpoint_GetKeptNodalValue(checkpoint)) return ;
+
+  memcpy(Solution_GetNodalValue(sol),Checkpoint_GetKeptNodalValue(checkpoint),n_dof*sizeof(double)) ;
+
+  Solution_GetTime(sol)      = Checkpoint_GetKeptTime(checkpoint) ;
+  Solution_GetTimeStep(sol)  = Checkpoint_GetKeptTimeStep(checkpoint) ;
+  Solution_GetStepIndex(sol) = Checkpoint_GetKeptStepIndex(checkpoint) ;
+
+  TimeStep_GetLocation(timestep)           = Checkpoint_GetKeptLocation(checkpoint) ;
+  TimeStep_GetPreviousErrorRatio(timestep) = Checkpoint_GetKeptErrorRatio(checkpoint) ;
+  TimeStep_GetProposedTimeStep(timestep)   = Checkpoint_GetKeptProposedTimeStep(checkpoint) ;
+}
+
+
+
+/* Intern functions */
+
+int  (Checkpoint_WriteState)(FILE* stream,DataSet_t* jdd,Solutions_t* sols,OutputFiles_t* outputfiles)
+/* The records are, in this order:
+ * 1. the signature and the sizes checked at the reading
+ * 2. the solutions from the current one backward: time, time step,
+ *    step index, nodal values, implicit and explicit terms
+ * 3. the constant terms (shared by the solutions)
+ * 4. the state of the time step management and the statistics
+ * 5. the state of the point outputs and the sizes of the point files */
+{
+  int ok = 1 ;
+
+  /* 1. Signature and sizes */
+  {
+    Solution_t* sol = Solutions_GetSolution(sols) ;
+    int size[4] ;
+
+    size[0] = Solutions_GetNbOfSolutions(sols) ;
+    size[1] = Solution_GetNbOfDOF(sol) ;
+    size[2] = Solution_GetNbOfElements(sol) ;
+    size[3] = (outputfiles) ? OutputFiles_GetNbOfPointFiles(outputfiles) : 0 ;
+
+    ok = ok && WRITE(Checkpoint_Signature,sizeof(Checkpoint_Signature)) ;
+    ok = ok && WRITE(size,4) ;
+  }
+
+  /* 2. Solutions */
+  {
+    int n_sol = Solutions_GetNbOfSolutions(sols) ;
+    Solution_t* sol = Solutions_GetSolution(sols) ;
+    int i ;
+
+    for(i = 0 ; i < n_sol ; i++) {
+      int n_dof = Solution_GetNbOfDOF(sol) ;
+
+      ok = ok && WRITE(&Solution_GetTime(sol),1) ;
+      ok = ok && WRITE(&Solution_GetTimeStep(sol),1) ;
+      ok = ok && WRITE(&Solution_GetStepIndex(sol),1) ;
+      ok = ok && WRITE(Solution_GetNodalValue(sol),n_dof) ;
+      ok = ok && !Checkpoint_WriteElementTerms(stream,sol,'i') ;
+      ok = ok && !Checkpoint_WriteElementTerms(stream,sol,'e') ;
+
+      sol = Solution_GetPreviousSolution(sol) ;
+    }
+  }
+
+  /* 3. Constant terms */
+  ok = ok && !Checkpoint_WriteElementTerms(stream,Solutions_GetSolution(sols),'c') ;
+
+  /* 4. Time step management and statistics */
+  {
+    TimeStep_t* timestep = DataSet_GetTimeStep(jdd) ;
+    IterProcess_t* iterprocess = DataSet_GetIterProcess(jdd) ;
+
+    ok = ok && WRITE(&TimeStep_GetLocation(timestep),1) ;
+    ok = ok && WRITE(&TimeStep_GetPreviousErrorRatio(timestep),1) ;
+    ok = ok && WRITE(&TimeStep_GetProposedTimeStep(timestep),1) ;
+    ok = ok && WRITE(&TimeStep_GetNbOfAcceptedSteps(timestep),1) ;
+    ok = ok && WRITE(&TimeStep_GetNbOfRejectedSteps(timestep),1) ;
+
+    ok = ok && WRITE(&IterProcess_GetNbOfFactorizations(iterprocess),1) ;
+    ok = ok && WRITE(&IterProcess_GetNbOfSavedFactorizations(iterprocess),1) ;
+    ok = ok && WRITE(&IterProcess_GetTotalNbOfIterations(iterprocess),1) ;
+    ok = ok && WRITE(&IterProcess_GetNbOfBacktrackings(iterprocess),1) ;
+    ok = ok && WRITE(&IterProcess_GetNbOfLimitedIncrements(iterprocess),1) ;
+    ok = ok && WRITE(&IterProcess_GetNbOfRejectedSteps(iterprocess),1) ;
+    ok = ok && WRITE(&IterProcess_GetNbOfKrylovIterations(iterprocess),1) ;
+    ok = ok && WRITE(&IterProcess_GetNbOfSkippedResolutions(iterprocess),1) ;
+  }
+
+  /* 5. Point outputs */
+  if(outputfiles) {
+    OutputFile_t* outputfile = OutputFiles_GetPointOutputFile(outputfiles) ;
+    int n_points = OutputFiles_GetNbOfPointFiles(outputfiles) ;
+    int p ;
+
+    OutputFiles_FlushPointFiles(outputfiles) ;
+
+    ok = ok && WRITE(&OutputFiles_GetPointStepIndex(outputfiles),1) ;
+    ok = ok && WRITE(&OutputFiles_GetPointTime(outputfiles),1) ;
+
+    for(p = 0 ; p < n_points ; p++) {
+      TextFile_t* textfile = OutputFile_GetTextFile(outputfile + p) ;
+      FILE* ficp = TextFile_GetFileStream(textfile) ;
+      long int size = (ficp) ? ftell(ficp) : 0 ;
+
+      ok = ok && WRITE(&size,1) ;
+    }
+  }
+
+  return((ok) ? 0 : -1) ;
+}
+
+
+
+int  (Checkpoint_ReadState)(FILE* stream,DataSet_t* jdd,Solutions_t* sols,OutputFiles_t* outputfiles)
+/* Read the records written by Checkpoint_WriteState.
+ * Return 0 if succeeded, -1 if the file doesn't match the data set. */
+{
+  int ok = 1 ;
+
+  /* 1. Signature and sizes */
+  {
+    Solution_t* sol = Solutions_GetSolution(sols) ;
+    char signature[sizeof(Checkpoint_Signature)] ;
+    int size[4] ;
+
+    ok = ok && READ(signature,sizeof(Checkpoint_Signature)) ;
+    ok = ok && !memcmp(signature,Checkpoint_Signature,sizeof(Checkpoint_Signature)) ;
+    ok = ok && READ(size,4) ;
+
+    ok = ok && size[0] == (int) Solutions_GetNbOfSolutions(sols) ;
+    ok = ok && size[1] == (int) Solution_GetNbOfDOF(sol) ;
+    ok = ok && size[2] == (int) Solution_GetNbOfElements(sol) ;
+    ok = ok && size[3] == ((outputfiles) ? OutputFiles_GetNbOfPointFiles(outputfiles) : 0) ;
+
+    if(!ok) return(-1) ;
+  }
+
+  /* 2. Solutions */
+  {
+    int n_sol = Solutions_GetNbOfSolutions(sols) ;
+    Solution_t* sol = Solutions_GetSolution(sols) ;
+    int i ;
+
+    for(i = 0 ; i < n_sol ; i++) {
+      int n_dof = Solution_GetNbOfDOF(sol) ;
+
+      ok = ok && READ(&Solution_GetTime(sol),1) ;
+      ok = ok && READ(&Solution_GetTimeStep(sol),1) ;
+      ok = ok && READ(&Solution_GetStepIndex(sol),1) ;
+      ok = ok && READ(Solution_GetNodalValue(sol),n_dof) ;
+      ok = ok && !Checkpoint_ReadElementTerms(stream,sol,'i') ;
+      ok = ok && !Checkpoint_ReadElementTerms(stream,sol,'e') ;
+
+      sol = Solution_GetPreviousSolution(sol) ;
+    }
+  }
+
+  /* 3. Constant terms */
+  ok = ok && !Checkpoint_ReadElementTerms(stream,Solutions_GetSolution(sols),'c') ;
+
+  /* 4. Time step management and statistics */
+  {
+    TimeStep_t* timestep = DataSet_GetTimeStep(jdd) ;
+    IterProcess_t* iterprocess = DataSet_GetIterProcess(jdd) ;
+
+    ok = ok && READ(&TimeStep_GetLocation(timestep),1) ;
+    ok = ok && READ(&TimeStep_GetPreviousErrorRatio(timestep),1) ;
+    ok = ok && READ(&TimeStep_GetProposedTimeStep(timestep),1) ;
+    ok = ok && READ(&TimeStep_GetNbOfAcceptedSteps(timestep),1) ;
+    ok = ok && READ(&TimeStep_GetNbOfRejectedSteps(timestep),1) ;
+
+    ok = ok && READ(&IterProcess_GetNbOfFactorizations(iterprocess),1) ;
+    ok = ok && READ(&IterProcess_GetNbOfSavedFactorizations(iterprocess),1) ;
+    ok = ok && READ(&IterProcess_GetTotalNbOfIterations(iterprocess),1) ;
+    ok = ok && READ(&IterProcess_GetNbOfBacktrackings(iterprocess),1) ;
+    ok = ok && READ(&IterProcess_GetNbOfLimitedIncrements(iterprocess),1) ;
+    ok = ok && READ(&IterProcess_GetNbOfRejectedSteps(iterprocess),1) ;
+    ok = ok && READ(&IterProcess_GetNbOfKrylovIterations(iterprocess),1) ;
+    ok = ok && READ(&IterProcess_GetNbOfSkippedResolutions(iterprocess),1) ;
+  }
+
+  /* 5. Point outputs */
+  if(ok && outputfiles) {
+    int n_points = OutputFiles_GetNbOfPointFiles(outputfiles) ;
+    long int* size = (long int*) Mry_New(long int[n_points + 1]) ;
+
+    ok = ok && READ(&OutputFiles_GetPointStepIndex(outputfiles),1) ;
+    ok = ok && READ(&OutputFiles_GetPointTime(outputfiles),1) ;
+    ok = ok && READ(size,n_points) ;
+
+    if(ok) OutputFiles_ResumePointFiles(outputfiles,jdd,size) ;
+
+    Mry_Free(size) ;
+  }
+
+  return((ok) ? 0 : -1) ;
+}
+
+
+
+int  (Checkpoint_WriteElementTerms)(FILE* stream,Solution_t* sol,char type)
+/* Write the implicit (type = 'i'), explicit ('e') or constant ('c')
+ * terms of the elements. Return 0 if succeeded, -1 otherwise. */
+{
+  int n_el = Solution_GetNbOfElements(sol) ;
+  ElementSol_t* elementsol = Solution_GetElementSol(sol) ;
+  int i ;
+
+  for(i = 0 ; i < n_el ; i++) {
+    ElementSol_t* elementsol_i = elementsol + i ;
+    int n ;
+    double* v ;
+
+    if(type == 'i') {
+      n = ElementSol_GetNbOfImplicitTerms(elementsol_i) ;
+      v = (double*) ElementSol_GetImplicitTerm(elementsol_i) ;
+    } else if(type == 'e') {
+      n = ElementSol_GetNbOfExplicitTerms(elementsol_i) ;
+      v = (double*) ElementSol_GetExplicitTerm(elementsol_i) ;
+    } else {
+      n = ElementSol_GetNbOfConstantTerms(elementsol_i) ;
+      v = (double*) ElementSol_GetConstantTerm(elementsol_i) ;
+    }
+
+    if(n > 0 && !WRITE(v,n)) return(-1) ;
+  }
+
+  return(0) ;
+}
+
+
+
+int  (Checkpoint_ReadElementTerms)(FILE* stream,Solution_t* sol,char type)
+{
+  int n_el = Solution_GetNbOfElements(sol) ;
+  ElementSol_t* elementsol = Solution_GetElementSol(sol) ;
+  int i ;
+
+  for(i = 0 ; i < n_el ; i++) {
+    ElementSol_t* elementsol_i = elementsol + i ;
+    int n ;
+    double* v ;
+
+    if(type == 'i') {
+      n = ElementSol_GetNbOfImplicitTerms(elementsol_i) ;
+      v = (double*) ElementSol_GetImplicitTerm(elementsol_i) ;
+    } else if(type == 'e') {
+      n = ElementSol_GetNbOfExplicitTerms(elementsol_i) ;
+      v = (double*) ElementSol_GetExplicitTerm(elementsol_i) ;
+    } else {
+      n = ElementSol_GetNbOfConstantTerms(elementsol_i) ;
+      v = (double*) ElementSol_GetConstantTerm(elementsol_i) ;
+    }
+
+    if(n > 0 && !READ(v,n)) return(-1) ;
+  }
+
+  return(0) ;
+}
+
+
+#undef WRITE
+#undef READ
@@ -0,0 +1,63 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+/* vacuous declarations and typedef names */
+
+/* class-like structure */
+struct Checkpoint_s   ; typedef struct Checkpoint_s   Checkpoint_t ;
+
+
+#include <time.h>
+#include "DataFile.h"
+#include "Solutions.h"
+#include "OutputFiles.h"
+
+extern Checkpoint_t*  (Checkpoint_Create)(DataFile_t*) ;
+extern void           (Checkpoint_Delete)(void*) ;
+extern void           (Checkpoint_SetFileName)(Checkpoint_t*,char*) ;
+extern int            (Checkpoint_IsDue)(Checkpoint_t*,int) ;
+extern int            (Checkpoint_Write)(Checkpoint_t*,DataSet_t*,Solutions_t*,OutputFiles_t*) ;
+extern int            (Checkpoint_Read)(Checkpoint_t*,DataSet_t*,Solutions_t*,OutputFiles_t*) ;
+extern void           (Checkpoint_Remove)(Checkpoint_t*) ;
+extern void           (Checkpoint_KeepStepState)(Checkpoint_t*,DataSet_t*,Solutions_t*) ;
+extern void           (Checkpoint_RestoreStepState)(Checkpoint_t*,DataSet_t*,Solutions_t*) ;
+
+
+#define Checkpoint_GetFileName(CP)              ((CP)->filename)
+#define Checkpoint_GetWallTimePeriod(CP)        ((CP)->period)
+#define Checkpoint_GetStepPeriod(CP)            ((CP)->nbofsteps)
+#define Checkpoint_GetWallTimeOfLastWriting(CP) ((CP)->lastwalltime)
+#define Checkpoint_GetStepOfLastWriting(CP)     ((CP)->laststep)
+#define Checkpoint_GetNbOfWritings(CP)          ((CP)->nbofwritings)
+#define Checkpoint_GetKeptNodalValue(CP)        ((CP)->nodalvalue)
+#define Checkpoint_GetKeptTime(CP)              ((CP)->t)
+#define Checkpoint_GetKeptTimeStep(CP)          ((CP)->dt)
+#define Checkpoint_GetKeptStepIndex(CP)         ((CP)->step)
+#define Checkpoint_GetKeptLocation(CP)          ((CP)->loc)
+#define Checkpoint_GetKeptErrorRatio(CP)        ((CP)->ratio_n)
+#define Checkpoint_GetKeptProposedTimeStep(CP)  ((CP)->dtproposed)
+
+
+/* First bytes of a checkpoint file */
+#define Checkpoint_Signature                    "Bil checkpoint 2"
+
+
+struct Checkpoint_s {           /* Periodic saves of the whole state */
+  char*  filename ;             /* Name of the checkpoint file */
+  double period ;               /* Wall time between two saves in s (0 = none) */
+  int    nbofsteps ;            /* Nb of steps between two saves (0 = none) */
+  time_t lastwalltime ;         /* Wall time of the last save */
+  int    laststep ;             /* Step index of the last save */
+  unsigned long nbofwritings ;  /* Nb of saves */
+  /* State at the beginning of the current step which is overwritten
+   * by the step (see Checkpoint_KeepStepState) */
+  double* nodalvalue ;          /* Nodal values of the oldest solution */
+  double t ;                    /* Its time */
+  double dt ;                   /* Its time step */
+  int    step ;                 /* Its step index */
+  char   loc ;                  /* Location of the time step */
+  double ratio_n ;              /* Previous error ratio */
+  double dtproposed ;           /* Time step proposed by the error controller */
+} ;
+
+#endif
@@ -12,12 +12,12 @@ static void   (ElementSol_Initialize)(ElementSol_t*) ;
 
 ElementsSol_t*   (ElementsSol_Create)(Mesh_t* mesh)
 {
-  ElementsSol_t* elementssol = (ElementsSol_t*) Mry_New(ElementsSol_t) ;
+  ElementsSol_t* elementssol = (ElementsSol_t*) Mry_NewIn(ElementTerms,ElementsSol_t) ;
   
   
   {
     int NbOfElements = Mesh_GetNbOfElements(mesh) ;
-    ElementSol_t* elementsol = (ElementSol_t*) Mry_New(ElementSol_t[NbOfElements]) ;
+    ElementSol_t* elementsol = (ElementSol_t*) Mry_NewIn(ElementTerms,ElementSol_t[NbOfElements]) ;
 
     ElementsSol_GetElementSol(elementssol)   = elementsol ;
     ElementsSol_GetNbOfElements(elementssol) = NbOfElements ;
@@ -45,16 +45,31 @@ ElementsSol_t*   (ElementsSol_Create)(Mesh_t* mesh)
 
 
 void ElementsSol_Delete(void* self)
+/** Free the element solutions. The terms themselves are stored in
+ *  blocks shared between the elements (and possibly between the
+ *  solutions), they are freed by the owner (see Solutions_Delete). */
 {
   ElementsSol_t** pelementssol = (ElementsSol_t**) self ;
   ElementsSol_t*   elementssol = *pelementssol ;
   
   {
+    int NbOfElements = ElementsSol_GetNbOfElements(elementssol) ;
     ElementSol_t* elementsol = ElementsSol_GetElementSol(elementssol) ;
+    int i ;
+    
+    for(i = 0 ; i < NbOfElements ; i++) {
+      ElementSol_t* elementsol_i = elementsol + i ;
+      
+      Mry_Free(ElementSol_GetImplicitGenericData(elementsol_i)) ;
+      Mry_Free(ElementSol_GetExplicitGenericData(elementsol_i)) ;
+      Mry_Free(ElementSol_GetConstantGenericData(elementsol_i)) ;
+    }
     
+    Mry_Free(elementsol) ;
   }
   
-  free(elementssol) ;
+  Mry_Free(elementssol) ;
+  *pelementssol = NULL ;
 }
 
 
@@ -91,7 +106,7 @@ void (ElementsSol_AllocateMemoryForImplicitTerms)(ElementsSol_t* elementssol)
       int NbOfElements = ElementsSol_GetNbOfElements(elementssol) ;
       ElementSol_t* elementsol = ElementsSol_GetElementSol(elementssol) ;
       int    i ;
-      double* vi = (double*) Mry_New(double[n_vi]) ;
+      double* vi = (double*) Mry_NewIn(ElementTerms,double[n_vi]) ;
   
   
       for(i = 0 ; i < NbOfElements ; i++) {
@@ -141,11 +156,7 @@ void (ElementsSol_AllocateMemoryForExplicitTerms)(ElementsSol_t* elementssol)
       int NbOfElements = ElementsSol_GetNbOfElements(elementssol) ;
       ElementSol_t* elementsol = ElementsSol_GetElementSol(elementssol) ;
       int    i ;
-      double* ve = (double*) calloc(n_ve,sizeof(double)) ;
-      
-      if(!ve) {
-        arret("ElementsSol_AllocateMemoryForExplicitTerms") ;
-      }
+      double* ve = (double*) Mry_NewIn(ElementTerms,double[n_ve]) ;
 
   
       for(i = 0 ; i < NbOfElements ; i++) {
@@ -195,11 +206,7 @@ void (ElementsSol_AllocateMemoryForConstantTerms)(ElementsSol_t* elementssol)
       int NbOfElements = ElementsSol_GetNbOfElements(elementssol) ;
       ElementSol_t* elementsol = ElementsSol_GetElementSol(elementssol) ;
       int    i ;
-      double* v0 = (double*) calloc(n_v0,sizeof(double)) ;
-      
-      if(!v0) {
-        arret("ElementsSol_AllocateMemoryForConstantTerms") ;
-      }
+      double* v0 = (double*) Mry_NewIn(ElementTerms,double[n_v0]) ;
   
   
       for(i = 0 ; i < NbOfElements ; i++) {
@@ -4,8 +4,11 @@
 #include <time.h>
 #include <string.h>
 #include <ctype.h>
+#include <float.h>
 #include "Context.h"
 #include "CommonModule.h"
+#include "GMRES.h"
+#include "Mry.h"
 
 
 #define AUTHORS  "Dangla"
@@ -19,7 +22,52 @@ static int    ComputeInitialState(Mesh_t*,double) ;
 static int    ComputeExplicitTerms(Mesh_t*,double) ;
 static int    ComputeMatrix(Mesh_t*,double,double,Matrix_t*) ;
 static void   ComputeResidu(Mesh_t*,double,double,double*,Loads_t*) ;
+static int    ComputeResiduAndMatrix(Mesh_t*,double,double,double*,Loads_t*,Matrix_t*) ;
+static void   AssembleLoads(Mesh_t*,double,double,double*,Loads_t*) ;
+static void   AssembleElementResidu(Element_t*,double*,double*) ;
+static int    HasFusedResiduAndMatrix(Mesh_t*) ;
 static int    ComputeImplicitTerms(Mesh_t*,double,double) ;
+static double ComputeResiduNorm(double*,unsigned int) ;
+static int    ComputeSensitivities(DataSet_t*,Solutions_t*,Solver_t*,Sensitivity_t*,double,double) ;
+
+
+
+/* Jacobian-free Newton-Krylov resolution:
+ * the products by the jacobian are finite differences of the residu,
+ * the matrix (lagged) being only used as a preconditioner. The Krylov
+ * solver is set in the Iterative Process section. */
+struct JacobianFree_s   ; typedef struct JacobianFree_s   JacobianFree_t ;
+
+#define JacobianFree_GetMesh(JF)                 ((JF)->mesh)
+#define JacobianFree_GetLoads(JF)                ((JF)->loads)
+#define JacobianFree_GetSolver(JF)               ((JF)->solver)
+#define JacobianFree_GetGMRES(JF)                ((JF)->gmres)
+#define JacobianFree_GetCurrentTime(JF)          ((JF)->t)
+#define JacobianFree_GetTimeIncrement(JF)        ((JF)->dt)
+#define JacobianFree_GetResidu(JF)               ((JF)->r0)
+#define JacobianFree_GetPerturbedResidu(JF)      ((JF)->r1)
+#define JacobianFree_GetCorrection(JF)           ((JF)->dx)
+#define JacobianFree_GetUnknown(JF)              ((JF)->u)
+
+struct JacobianFree_s {
+  Mesh_t*   mesh ;
+  Loads_t*  loads ;
+  Solver_t* solver ;
+  GMRES_t*  gmres ;
+  double    t ;
+  double    dt ;
+  double*   r0 ;          /* Residu at the current unknowns */
+  double*   r1 ;          /* Residu at the perturbed unknowns */
+  double*   dx ;          /* Correction found by the Krylov solver */
+  double*   u ;           /* Copy of the current unknowns */
+} ;
+
+static int    IsJacobianFree(Mesh_t*) ;
+static JacobianFree_t* JacobianFree_Create(Mesh_t*,Loads_t*,Solver_t*,IterProcess_t*) ;
+static void   JacobianFree_Delete(void*) ;
+static int    JacobianFree_Solve(JacobianFree_t*,double,double) ;
+static GMRES_Operator_t JacobianFree_Product ;
+static GMRES_Operator_t JacobianFree_Precondition ;
 
 
 
@@ -43,7 +91,9 @@ int SetModuleProp(Module_t* module)
 int calcul(DataSet_t* jdd)
 {
   Mesh_t* mesh = DataSet_GetMesh(jdd) ;
-  const int n_sol = 2 ; /* Must be 2 at minimum but works with more */
+  TimeStep_t* timestep = DataSet_GetTimeStep(jdd) ;
+  /* Must be 2 at minimum but works with more (needed by the predictor) */
+  const int n_sol = TimeStep_GetNbOfSolutionsToBeStored(timestep) ;
   Solutions_t* sols = Solutions_Create(mesh,n_sol) ;
 
   /* Execute this line to set only one allocation of space for explicit terms. */
@@ -85,7 +135,10 @@ int calcul(DataSet_t* jdd)
       Points_t* points   = DataSet_GetPoints(jdd) ;
       int     n_points   = Points_GetNbOfPoints(points) ;
       Options_t* options = DataSet_GetOptions(jdd) ;
-      Solver_t* solver = Solver_Create(mesh,options,1) ;
+      Sensitivity_t* sensitivity = DataSet_GetSensitivity(jdd) ;
+      /* One r.h.s. per parameter plus the unperturbed residu */
+      int nrhs = (sensitivity) ? Sensitivity_GetNbOfParameters(sensitivity) + 1 : 1 ;
+      Solver_t* solver = Solver_Create(mesh,options,nrhs) ;
       OutputFiles_t* outputfiles = OutputFiles_Create(filename,nbofdates,n_points) ;
       
       i = Algorithm(jdd,sols,solver,outputfiles) ;
@@ -139,13 +192,51 @@ static int   Algorithm(DataSet_t* jdd,Solutions_t* sols,Solver_t* solver,OutputF
   Dates_t*       dates       = DataSet_GetDates(jdd) ;
   TimeStep_t*    timestep    = DataSet_GetTimeStep(jdd) ;
   IterProcess_t* iterprocess = DataSet_GetIterProcess(jdd) ;
+  /* Checkpoints only for the runs writing output files */
+  Checkpoint_t*  checkpoint  = (outputfiles) ? DataSet_GetCheckpoint(jdd) : NULL ;
+  Sensitivity_t* sensitivity = (outputfiles) ? DataSet_GetSensitivity(jdd) : NULL ;
   
   Nodes_t*       nodes       = Mesh_GetNodes(mesh) ;
   unsigned int   nbofdates   = Dates_GetNbOfDates(dates) ;
   Date_t*        date        = Dates_GetDate(dates) ;
 
   unsigned int   idate ;
+  int resumed = 0 ; /* Resumed from a checkpoint */
   double t_0 ;
+  double norm_n = 0 ; /* Norm of the residu at the previous iteration */
+  JacobianFree_t* jf = NULL ;
+  int fused ;
+  /* Previous solution and time of the last computation of the explicit
+   * terms (volatile since they are modified after the environment is
+   * saved by 3.1.1b) */
+  Solution_t* volatile sol_ex = NULL ;
+  volatile double t_ex = 0 ;
+  
+  
+  /*
+   * 0. Jacobian-free resolution if all the models opt in
+   */
+  if(IsJacobianFree(mesh)) {
+    if(Solver_KeepsFactorization(solver)) {
+      jf = JacobianFree_Create(mesh,loads,solver,iterprocess) ;
+    } else {
+      Message_Warning("Algorithm: the jacobian-free resolution needs a solver keeping its factorization") ;
+    }
+  }
+  
+  /* The residu and the matrix are computed in one pass over the elements
+   * if some model provides the fused method. Not with a line search
+   * (the residu may be computed several times) nor with the jacobian-free
+   * resolution (the matrix is computed less often). */
+  fused = (!jf && !IterProcess_IsLineSearch(iterprocess) && HasFusedResiduAndMatrix(mesh)) ;
+  
+  /* The sensitivities need room for one r.h.s. per parameter */
+  if(sensitivity) {
+    if((int) Solver_GetNbOfRHS(solver) <= Sensitivity_GetNbOfParameters(sensitivity)) {
+      Message_Warning("Algorithm: not enough r.h.s. in the solver for the sensitivities") ;
+      sensitivity = NULL ;
+    }
+  }
   
   
   /*
@@ -155,7 +246,16 @@ static int   Algorithm(DataSet_t* jdd,Solutions_t* sols,Solver_t* solver,OutputF
 
   
   {
-    int i = Mesh_LoadCurrentSolution(mesh,datafile,&T_1) ;
+    int i ;
+    
+    /* The state saved in a checkpoint has priority. The checkpoint
+     * is named after the output files (one per case of a sweep). */
+    if(checkpoint) {
+      Checkpoint_SetFileName(checkpoint,OutputFiles_GetDataFileName(outputfiles)) ;
+      resumed = Checkpoint_Read(checkpoint,jdd,sols,outputfiles) ;
+    }
+    
+    i = (resumed) ? resumed : Mesh_LoadCurrentSolution(mesh,datafile,&T_1) ;
     
     idate = 0 ;
     
@@ -187,10 +287,13 @@ static int   Algorithm(DataSet_t* jdd,Solutions_t* sols,Solver_t* solver,OutputF
   
   /*
    * 2. Backup
+   * (already done by the run resumed from a checkpoint)
    */
   t_0 = T_1 ;
-  OutputFiles_BackupSolutionAtPoint(outputfiles,jdd,T_1,t_0) ;
-  OutputFiles_BackupSolutionAtTime(outputfiles,jdd,T_1,idate) ;
+  if(!resumed) {
+    OutputFiles_BackupSolutionAtPoint(outputfiles,jdd,T_1,t_0) ;
+    OutputFiles_BackupSolutionAtTime(outputfiles,jdd,T_1,idate) ;
+  }
   
   
   /*
@@ -203,6 +306,18 @@ static int   Algorithm(DataSet_t* jdd,Solutions_t* sols,Solver_t* solver,OutputF
      * 3.1 Loop on time steps
      */
     do {
+      /*
+       * 3.1.0 Checkpoint of the last converged solution
+       * (its outputs are done)
+       */
+      if(checkpoint) {
+        if(Checkpoint_IsDue(checkpoint,STEP_1)) {
+          Checkpoint_Write(checkpoint,jdd,sols,outputfiles) ;
+        }
+        
+        Checkpoint_KeepStepState(checkpoint,jdd,sols) ;
+      }
+      
       /*
        * 3.1.1 Looking for a new solution at t + dt
        * We step forward (point to the next solution) 
@@ -228,16 +343,37 @@ static int   Algorithm(DataSet_t* jdd,Solutions_t* sols,Solver_t* solver,OutputF
           backupandreturn :
           Solutions_StepBackward(sols) ;
           Mesh_InitializeSolutionPointers(mesh,sols) ;
+          /* A last checkpoint if the run is stopped by a signal
+           * (e.g. SIGTERM), none if it failed. The state is the one
+           * at the beginning of the interrupted step. */
+          if(checkpoint) {
+            if(Exception_OrderToBackupAndTerminate) {
+              Checkpoint_RestoreStepState(checkpoint,jdd,sols) ;
+              Checkpoint_Write(checkpoint,jdd,sols,outputfiles) ;
+            } else {
+              Checkpoint_Remove(checkpoint) ;
+            }
+          }
           OutputFiles_BackupSolutionAtTime(outputfiles,jdd,T_1,idate+1) ;
+          if(jf) JacobianFree_Delete(&jf) ;
           return(-1) ;
         }
       }
       
       /*
-       * 3.1.2 Compute the explicit terms with the previous solution
+       * 3.1.2 Compute the explicit terms with the previous solution.
+       * Skipped if they were computed with the same previous solution
+       * at the same time, i.e. when the step is repeated after a jump
+       * to 3.1.1b. They are stored in the current solution (or shared by
+       * all the solutions if merged) which is also the same one then.
        */
-      {
-        int i = ComputeExplicitTerms(mesh,T_n) ;
+      if(sol_ex != SOL_n || t_ex != T_n) {
+        int i ;
+        
+        /* Not valid until fully computed */
+        sol_ex = NULL ;
+        
+        i = ComputeExplicitTerms(mesh,T_n) ;
         
         if(i != 0) {
           Message_Direct("\n") ;
@@ -246,8 +382,12 @@ static int   Algorithm(DataSet_t* jdd,Solutions_t* sols,Solver_t* solver,OutputF
           if(T_n > t_0) {
             goto backupandreturn ;
           }
+          if(jf) JacobianFree_Delete(&jf) ;
           return(-1) ;
         }
+        
+        sol_ex = SOL_n ;
+        t_ex = T_n ;
       }
         
       /*
@@ -263,9 +403,10 @@ static int   Algorithm(DataSet_t* jdd,Solutions_t* sols,Solver_t* solver,OutputF
       }
       
       /*
-       * 3.1.3b Initialize the repetition index
+       * 3.1.3b Initialize the repetition and rejection indexes
        */
       IterProcess_GetRepetitionIndex(iterprocess) = 0 ;
+      TimeStep_InitializeRejections(timestep) ;
       
       
       /*
@@ -277,12 +418,14 @@ static int   Algorithm(DataSet_t* jdd,Solutions_t* sols,Solver_t* solver,OutputF
           repeatwithreducedtimestep :
           
           IterProcess_IncrementRepetitionIndex(iterprocess) ;
+          IterProcess_OrderToRefactorize(iterprocess) ;
           DT_1 *= TimeStep_GetReductionFactor(timestep) ;
           
         } else if(Exception_OrderToReiterateWithInitialTimeStep) {
           repeatwithinitialtimestep :
           
           IterProcess_IncrementRepetitionIndex(iterprocess) ;
+          IterProcess_OrderToRefactorize(iterprocess) ;
           DT_1 *= TimeStep_GetReductionFactor(timestep) ;
           {
             double t_ini = TimeStep_GetInitialTimeStep(timestep) ;
@@ -290,164 +433,294 @@ static int   Algorithm(DataSet_t* jdd,Solutions_t* sols,Solver_t* solver,OutputF
             if(DT_1 > t_ini) DT_1 = t_ini ;
           }
         }
-      }
-
-      
-      /*
-       * 3.1.3d The time at which we compute
-       */
-      {
-        int irecom = IterProcess_GetRepetitionIndex(iterprocess) ;
         
-        if(irecom > 0) Message_Direct("Repetition no %d\n",irecom) ;
+        /* A reduced time step no longer reaches the next date */
+        if(IterProcess_GetRepetitionIndex(iterprocess) > 0) {
+          double t1 = Date_GetTime(date_i) ;
+          double t2 = Date_GetTime(date_i + 1) ;
+          
+          TimeStep_LocateTimeStep(timestep,T_n,DT_1,t1,t2) ;
+        }
       }
-      T_1 = T_n + DT_1 ;
-      Message_Direct("Step %d  t = %e (dt = %4.2e)",STEP_1,T_1,DT_1) ;
-      
-      /*
-       * 3.1.4 Initialize the unknowns
-       */
-      Mesh_SetCurrentUnknownsWithBoundaryConditions(mesh,bconds,T_1) ;
+
       
       /*
-       * 3.1.5 Loop on iterations
+       * 3.1.3e Steps 3.1.3d to 3.1.6b are computed again with the time
+       * step proposed by the error controller as long as the error is
+       * too large (see 3.1.6b)
        */
-      IterProcess_GetIterationIndex(iterprocess) = 0 ;
-      while(IterProcess_LastIterationIsNotReached(iterprocess)) {
-        IterProcess_IncrementIterationIndex(iterprocess) ;
-        
+      while(1) {
         /*
-         * 3.1.5.1 The implicit terms (constitutive equations)
+         * 3.1.3d The time at which we compute
          */
         {
-          int i = ComputeImplicitTerms(mesh,T_1,DT_1) ;
+          int irecom = IterProcess_GetRepetitionIndex(iterprocess) ;
           
-          if(i != 0) {
-            if(IterProcess_LastRepetitionIsNotReached(iterprocess)) {
-              goto repeatwithinitialtimestep ;
-            } else {
-              int iter = IterProcess_GetIterationIndex(iterprocess) ;
-              
-              Message_Direct("\n") ;
-              Message_Direct("Algorithm(2): undefined implicit terms at iteration %d\n",iter) ;
-              goto backupandreturn ;
-            }
-          }
+          if(irecom > 0) Message_Direct("Repetition no %d\n",irecom) ;
         }
+        T_1 = T_n + DT_1 ;
+        Message_Direct("Step %d  t = %e (dt = %4.2e)",STEP_1,T_1,DT_1) ;
         
         /*
-         * 3.1.5.2 The residu
+         * 3.1.4 Initialize the unknowns
+         * (extrapolated from the last solutions if required)
          */
-        {
-          double*  rhs = Solver_GetRHS(solver) ;
+        if(TimeStep_GetPredictorOrder(timestep) > 0) {
+          int order = TimeStep_GetPredictorOrder(timestep) ;
+          
+          Mesh_SetCurrentUnknownsWithPredictor(mesh,sols,bconds,order) ;
+        } else {
+          Mesh_SetCurrentUnknownsWithBoundaryConditions(mesh,bconds,T_1) ;
+        }
+        
+        /*
+         * 3.1.5 Loop on iterations
+         */
+        IterProcess_GetIterationIndex(iterprocess) = 0 ;
+        while(IterProcess_LastIterationIsNotReached(iterprocess)) {
+          int  matrixisdecided = 0 ; /* The refactorization was decided with the residu */
+          int  matrixisdone = 0 ; /* The matrix was computed with the residu */
+          int  imatrix = 0 ;
           
-          ComputeResidu(mesh,T_1,DT_1,rhs,loads) ;
+          IterProcess_IncrementIterationIndex(iterprocess) ;
           
+          /*
+           * 3.1.5.1 The implicit terms (constitutive equations)
+           * 3.1.5.2 The residu
+           * With a line search the last correction is halved as long as
+           * the implicit terms are undefined or the norm of the residu
+           * does not decrease enough (Armijo's condition).
+           */
           {
-            char*  debug = Options_GetPrintedInfos(options) ;
+            double*  rhs = Solver_GetRHS(solver) ;
+            int    iter = IterProcess_GetIterationIndex(iterprocess) ;
+            int    nbt = 0 ;
+            double step = 1 ;
+            int    i ;
             
-            if(!strcmp(debug,"residu")) {
-              Solver_Print(solver,debug) ;
+            while(1) {
+              double norm = 0 ;
+              
+              i = ComputeImplicitTerms(mesh,T_1,DT_1) ;
+            
+              if(i == 0) {
+                /* Not if the check on the residu may spare the matrix */
+                if(fused && !IterProcess_ResidualConvergenceMayBeMet(iterprocess)) {
+                  if(!Solver_KeepsFactorization(solver)) {
+                    IterProcess_OrderToRefactorize(iterprocess) ;
+                  }
+                  
+                  matrixisdone = IterProcess_MatrixIsToBeFactorized(iterprocess) ;
+                  matrixisdecided = 1 ;
+                }
+                
+                if(matrixisdone) {
+                  Matrix_t*  a = Solver_GetMatrix(solver) ;
+                  
+                  imatrix = ComputeResiduAndMatrix(mesh,T_1,DT_1,rhs,loads,a) ;
+                } else {
+                  ComputeResidu(mesh,T_1,DT_1,rhs,loads) ;
+                }
+                
+                if(!IterProcess_IsLineSearch(iterprocess)) break ;
+                
+                norm = ComputeResiduNorm(rhs,Solver_GetNbOfColumns(solver)) ;
+                
+                {
+                  double alpha = IterProcess_LineSearchSufficientDecrease ;
+                  
+                  if(iter == 1 || norm <= (1 - alpha*step)*norm_n) {
+                    norm_n = norm ;
+                    break ;
+                  }
+                }
+              }
+              
+              if(iter > 1 && nbt < IterProcess_GetMaxNbOfBacktrackings(iterprocess)) {
+                Mesh_UpdateCurrentUnknownsWithStepLength(mesh,solver,-0.5*step) ;
+                step *= 0.5 ;
+                nbt += 1 ;
+                IterProcess_GetNbOfBacktrackings(iterprocess) += 1 ;
+              } else {
+                norm_n = norm ;
+                break ;
+              }
+            }
+            
+            if(i != 0) {
+              if(IterProcess_LastRepetitionIsNotReached(iterprocess)) {
+                goto repeatwithinitialtimestep ;
+              } else {
+                Message_Direct("\n") ;
+                Message_Direct("Algorithm(2): undefined implicit terms at iteration %d\n",iter) ;
+                goto backupandreturn ;
+              }
+            }
+            
+            {
+              char*  debug = Options_GetPrintedInfos(options) ;
+              
+              if(!strcmp(debug,"residu")) {
+                Solver_Print(solver,debug) ;
+              }
             }
           }
-        }
-        
-        /*
-         * 3.1.5.3 The matrix
-         */
-        {
-          Matrix_t*  a = Solver_GetMatrix(solver) ;
-          int i = ComputeMatrix(mesh,T_1,DT_1,a) ;
           
-          if(i != 0) {
-            if(IterProcess_LastRepetitionIsNotReached(iterprocess)) {
-              goto repeatwithinitialtimestep ;
-            } else {
-              int iter = IterProcess_GetIterationIndex(iterprocess) ;
+          /*
+           * 3.1.5.3 We get out if the residu is small enough
+           * (this saves the resolution that would prove convergence)
+           */
+          if(IterProcess_ResidualConvergenceIsMet(iterprocess,nodes,solver)) break ;
+          
+          /*
+           * 3.1.5.4 The matrix
+           * (may be skipped to reuse the last factorization).
+           * With the fused method the refactorization was decided with
+           * the residu, unless the check on the residu was expected to
+           * spare the matrix: it is then decided here.
+           */
+          if(!matrixisdecided && !Solver_KeepsFactorization(solver)) {
+            IterProcess_OrderToRefactorize(iterprocess) ;
+          }
+          
+          /* With the jacobian-free resolution the matrix is only a
+           * preconditioner computed at the first iteration of each step
+           * (or when the convergence slows down) */
+          if((matrixisdecided) ? matrixisdone : ((jf) ? IterProcess_PreconditionerIsToBeUpdated(iterprocess) : IterProcess_MatrixIsToBeFactorized(iterprocess))) {
+            Matrix_t*  a = Solver_GetMatrix(solver) ;
+            int i = (matrixisdone) ? imatrix : ComputeMatrix(mesh,T_1,DT_1,a) ;
+            
+            if(i != 0) {
+              if(IterProcess_LastRepetitionIsNotReached(iterprocess)) {
+                goto repeatwithinitialtimestep ;
+              } else {
+                int iter = IterProcess_GetIterationIndex(iterprocess) ;
+                
+                Message_Direct("\n") ;
+                Message_Direct("Algorithm(3): undefined matrix at iteration %d\n",iter) ;
+                goto backupandreturn ;
+              }
+            }
+            
+            {
+              char*  debug = Options_GetPrintedInfos(options) ;
               
-              Message_Direct("\n") ;
-              Message_Direct("Algorithm(3): undefined matrix at iteration %d\n",iter) ;
-              goto backupandreturn ;
+              if(!strncmp(debug,"matrix",4)) {
+                Solver_Print(solver,debug) ;
+              }
             }
           }
           
+          /*
+           * 3.1.5.5 Resolution
+           */
           {
-            char*  debug = Options_GetPrintedInfos(options) ;
+            int i = (jf) ? JacobianFree_Solve(jf,T_1,DT_1) : Solver_Solve(solver) ;
             
-            if(!strncmp(debug,"matrix",4)) {
-              Solver_Print(solver,debug) ;
+            /* The Krylov solver didn't converge: the correction is kept
+             * but the preconditioner is updated at the next iteration */
+            if(jf) {
+              IterProcess_GetNbOfKrylovIterations(iterprocess) += GMRES_GetNbOfIterations(JacobianFree_GetGMRES(jf)) ;
+              
+              if(i > 0) {
+                IterProcess_OrderToRefactorize(iterprocess) ;
+                i = 0 ;
+              }
+            }
+            
+            if(i != 0) {
+              if(IterProcess_LastRepetitionIsNotReached(iterprocess)) {
+                goto repeatwithinitialtimestep ;
+              } else {
+                int iter = IterProcess_GetIterationIndex(iterprocess) ;
+                
+                Message_Direct("\n") ;
+                Message_Direct("Algorithm(4): unable to solve at iteration %d\n",iter) ;
+                goto backupandreturn ;
+              }
             }
           }
-        }
-        
-        /*
-         * 3.1.5.4 Resolution
-         */
-        {
-          int i = Solver_Solve(solver) ;
           
-          if(i != 0) {
-            if(IterProcess_LastRepetitionIsNotReached(iterprocess)) {
-              goto repeatwithinitialtimestep ;
-            } else {
-              int iter = IterProcess_GetIterationIndex(iterprocess) ;
-              
-              Message_Direct("\n") ;
-              Message_Direct("Algorithm(4): unable to solve at iteration %d\n",iter) ;
-              goto backupandreturn ;
+          /*
+           * 3.1.5.6 Update the unknowns
+           */
+          {
+            int n = Mesh_UpdateCurrentUnknownsWithStepLength(mesh,solver,1) ;
+            
+            IterProcess_GetNbOfLimitedIncrements(iterprocess) += n ;
+          }
+          
+          /*
+           * 3.1.5.7 The error
+           */
+          {
+            int i = IterProcess_SetCurrentError(iterprocess,nodes,solver) ;
+            
+            if(i != 0) {
+              if(IterProcess_LastRepetitionIsNotReached(iterprocess)) {
+                goto repeatwithinitialtimestep ;
+              } else {
+                int iter = IterProcess_GetIterationIndex(iterprocess) ;
+                
+                Message_Direct("\n") ;
+                Message_Direct("Algorithm(5): unable to compute error at iteration %d\n",iter) ;
+                goto backupandreturn ;
+              }
+            }
+          }
+          
+          /*
+           * 3.1.5.8 We get out if convergence is met
+           */
+          if(IterProcess_ConvergenceIsMet(iterprocess)) break ;
+          
+          {
+            if(Options_IsToPrintOutAtEachIteration(options)) {
+              if(IterProcess_LastIterationIsNotReached(iterprocess)) {
+                IterProcess_PrintCurrentError(iterprocess) ;
+              }
             }
           }
         }
         
-        /*
-         * 3.1.5.5 Update the unknowns
-         */
-        Mesh_UpdateCurrentUnknowns(mesh,solver) ;
+        {
+          IterProcess_PrintCurrentError(iterprocess) ;
+        }
         
         /*
-         * 3.1.5.6 The error
+         * 3.1.6 Back to 3.1.3 with a smaller time step
          */
-        {
-          int i = IterProcess_SetCurrentError(iterprocess,nodes,solver) ;
-          
-          if(i != 0) {
-            if(IterProcess_LastRepetitionIsNotReached(iterprocess)) {
-              goto repeatwithinitialtimestep ;
-            } else {
-              int iter = IterProcess_GetIterationIndex(iterprocess) ;
-              
-              Message_Direct("\n") ;
-              Message_Direct("Algorithm(5): unable to compute error at iteration %d\n",iter) ;
-              goto backupandreturn ;
-            }
+        if(IterProcess_ConvergenceIsNotMet(iterprocess)) {
+          if(IterProcess_LastRepetitionIsNotReached(iterprocess)) {
+            goto repeatwithreducedtimestep ;
           }
         }
         
         /*
-         * 3.1.5.7 We get out if convergence is met
+         * 3.1.6b Back to 3.1.3d with the time step proposed
+         * by the error controller if the error is too large
          */
-        if(IterProcess_ConvergenceIsMet(iterprocess)) break ;
-        
-        {
-          if(Options_IsToPrintOutAtEachIteration(options)) {
-            if(IterProcess_LastIterationIsNotReached(iterprocess)) {
-              IterProcess_PrintCurrentError(iterprocess) ;
+        if(IterProcess_ConvergenceIsMet(iterprocess)) {
+          int i = TimeStep_ControlTimeStep(timestep,nodes,sols) ;
+          
+          if(i && TimeStep_LastRejectionIsNotReached(timestep)) {
+            Message_Direct("Error estimate too large\n") ;
+            TimeStep_IncrementRejectionIndex(timestep) ;
+            IterProcess_OrderToRefactorize(iterprocess) ;
+            DT_1 = TimeStep_GetProposedTimeStep(timestep) ;
+            {
+              double t1 = Date_GetTime(date_i) ;
+              double t2 = Date_GetTime(date_i + 1) ;
+              
+              TimeStep_LocateTimeStep(timestep,T_n,DT_1,t1,t2) ;
             }
+            continue ;
           }
+          
+          TimeStep_GetNbOfAcceptedSteps(timestep) += 1 ;
         }
-      }
-      
-      {
-        IterProcess_PrintCurrentError(iterprocess) ;
-      }
-      
-      /*
-       * 3.1.6 Back to 3.1.3 with a smaller time step
-       */
-      if(IterProcess_ConvergenceIsNotMet(iterprocess)) {
-        if(IterProcess_LastRepetitionIsNotReached(iterprocess)) {
-          goto repeatwithreducedtimestep ;
-        }
+        
+        break ;
       }
       
       /*
@@ -460,6 +733,17 @@ static int   Algorithm(DataSet_t* jdd,Solutions_t* sols,Solver_t* solver,OutputF
       if(IterProcess_ConvergenceIsNotMet(iterprocess)) break ;
     } while(T_1 < Date_GetTime(date_i + 1)) ;
     
+    /*
+     * 3.1b Sensitivities at this time
+     */
+    if(sensitivity && IterProcess_ConvergenceIsMet(iterprocess)) {
+      int i = ComputeSensitivities(jdd,sols,solver,sensitivity,T_1,DT_1) ;
+      
+      if(i != 0) {
+        Message_Warning("Algorithm: unable to compute the sensitivities at t = %e",T_1) ;
+      }
+    }
+    
     /*
      * 3.2 Backup for this time
      */
@@ -471,6 +755,15 @@ static int   Algorithm(DataSet_t* jdd,Solutions_t* sols,Solver_t* solver,OutputF
     if(IterProcess_ConvergenceIsNotMet(iterprocess)) break ;
   }
   
+  IterProcess_PrintStatistics(iterprocess) ;
+  TimeStep_PrintStatistics(timestep) ;
+  Solver_PrintStatistics(solver) ;
+  
+  if(jf) JacobianFree_Delete(&jf) ;
+  
+  /* The run is over */
+  if(checkpoint) Checkpoint_Remove(checkpoint) ;
+  
   /*
    * 4. Step backward if convergence was not met
    */
@@ -571,9 +864,7 @@ void ComputeResidu(Mesh_t* mesh,double t,double dt,double* r,Loads_t* loads)
 {
   unsigned int n_el = Mesh_GetNbOfElements(mesh) ;
   Element_t* el = Mesh_GetElement(mesh) ;
-  unsigned int n_cg = Loads_GetNbOfLoads(loads) ;
-  Load_t* cg = Loads_GetLoad(loads) ;
-  unsigned int    ie,i_cg ;
+  unsigned int    ie ;
 #define NE (Element_MaxNbOfNodes*Model_MaxNbOfEquations)
   double re[NE] ;
 #undef NE
@@ -588,59 +879,127 @@ void ComputeResidu(Mesh_t* mesh,double t,double dt,double* r,Loads_t* loads)
   
   /* Residu */
   for(ie = 0 ; ie < n_el ; ie++) {
-    int  nn = Element_GetNbOfNodes(el + ie) ;
     Material_t* mat = Element_GetMaterial(el + ie) ;
     
     if(mat) {
-      int    neq = Material_GetNbOfEquations(mat) ;
-      int i ;
-      
       Element_FreeBuffer(el + ie) ;
       Element_ComputeResidu(el + ie,t,dt,re) ;
       
-      /* assembling */
-      for(i = 0 ; i < nn ; i++) {
-        Node_t* node_i = Element_GetNode(el + ie,i) ;
-        int    j ;
-        for(j = 0 ; j < neq ; j++) {
-          int ij = i*neq + j ;
-          int ii = Element_GetUnknownPosition(el + ie)[ij] ;
-          if(ii >= 0) {
-            int k = Node_GetMatrixColumnIndex(node_i)[ii] ;
-            if(k >= 0) r[k] += re[ij] ;
-          }
-        }
+      AssembleElementResidu(el + ie,re,r) ;
+    }
+  }
+  
+  /* Loads */
+  AssembleLoads(mesh,t,dt,r,loads) ;
+}
+
+
+
+int ComputeResiduAndMatrix(Mesh_t* mesh,double t,double dt,double* r,Loads_t* loads,Matrix_t* a)
+/** Compute the residu and the matrix in one pass over the elements,
+ *  through the fused method of the models providing it.
+ *  Return the error code of the matrix (0 if succeeded). */
+{
+  unsigned int n_el = Mesh_GetNbOfElements(mesh) ;
+  Element_t* el = Mesh_GetElement(mesh) ;
+  unsigned int    ie ;
+#define NE (Element_MaxNbOfNodes*Model_MaxNbOfEquations)
+  double re[NE] ;
+  double ke[NE*NE] ;
+#undef NE
+  double zero = 0. ;
+  int    imatrix = 0 ;
+  
+  {
+    unsigned int    n_col = Mesh_GetNbOfMatrixColumns(mesh) ;
+    unsigned int    j ;
+    
+    for(j = 0 ; j < n_col ; j++) r[j] = zero ;
+  }
+
+  Matrix_SetValuesToZero(a) ;
+  
+  for(ie = 0 ; ie < n_el ; ie++) {
+    Material_t* mat = Element_GetMaterial(el + ie) ;
+    
+    if(mat) {
+      Model_t* model = Material_GetModel(mat) ;
+      int    i ;
+      
+      Element_FreeBuffer(el + ie) ;
+      
+      if(Model_HasFusedResiduAndMatrix(model)) {
+        i = Element_ComputeResiduAndMatrix(el + ie,t,dt,re,ke) ;
+      } else {
+        Element_ComputeResidu(el + ie,t,dt,re) ;
+        Element_FreeBuffer(el + ie) ;
+        i = Element_ComputeMatrix(el + ie,t,dt,ke) ;
+      }
+      
+      AssembleElementResidu(el + ie,re,r) ;
+      
+      /* The residu is still completed after a failure of the matrix */
+      if(i != 0) {
+        if(imatrix == 0) imatrix = i ;
+      } else if(imatrix == 0) {
+        Matrix_AssembleElementMatrix(a,el+ie,ke) ;
       }
     }
   }
   
   /* Loads */
+  AssembleLoads(mesh,t,dt,r,loads) ;
+  
+  return(imatrix) ;
+}
+
+
+
+void AssembleLoads(Mesh_t* mesh,double t,double dt,double* r,Loads_t* loads)
+/** Add the loads to the residu r */
+{
+  unsigned int n_el = Mesh_GetNbOfElements(mesh) ;
+  Element_t* el = Mesh_GetElement(mesh) ;
+  unsigned int n_cg = Loads_GetNbOfLoads(loads) ;
+  Load_t* cg = Loads_GetLoad(loads) ;
+  unsigned int    ie,i_cg ;
+#define NE (Element_MaxNbOfNodes*Model_MaxNbOfEquations)
+  double re[NE] ;
+#undef NE
+  
   for(i_cg = 0 ; i_cg < n_cg ; i_cg++) {
     int reg_cg = Load_GetRegionIndex(cg + i_cg) ;
     for(ie = 0 ; ie < n_el ; ie++) if(Element_GetRegionIndex(el + ie) == reg_cg) {
-      int  nn = Element_GetNbOfNodes(el + ie) ;
       Material_t* mat = Element_GetMaterial(el + ie) ;
     
       if(mat) {
-        int    neq = Material_GetNbOfEquations(mat) ;
-        int i ;
-        
         Element_FreeBuffer(el + ie) ;
         Element_ComputeLoads(el + ie,t,dt,cg + i_cg,re) ;
         
-        /* assembling */
-        for(i = 0 ; i < nn ; i++) {
-          Node_t* node_i = Element_GetNode(el + ie,i) ;
-          int    j ;
-          for(j = 0 ; j < neq ; j++) {
-            int ij = i*neq + j ;
-            int ii = Element_GetUnknownPosition(el + ie)[ij] ;
-            if(ii >= 0) {
-              int k = Node_GetMatrixColumnIndex(node_i)[ii] ;
-              if(k >= 0) r[k] += re[ij] ;
-            }
-          }
-        }
+        AssembleElementResidu(el + ie,re,r) ;
+      }
+    }
+  }
+}
+
+
+
+void AssembleElementResidu(Element_t* el,double* re,double* r)
+/** Add the element residu re to the residu r */
+{
+  int  nn = Element_GetNbOfNodes(el) ;
+  int  neq = Element_GetNbOfEquations(el) ;
+  int i ;
+  
+  for(i = 0 ; i < nn ; i++) {
+    Node_t* node_i = Element_GetNode(el,i) ;
+    int    j ;
+    for(j = 0 ; j < neq ; j++) {
+      int ij = i*neq + j ;
+      int ii = Element_GetUnknownPosition(el)[ij] ;
+      if(ii >= 0) {
+        int k = Node_GetMatrixColumnIndex(node_i)[ii] ;
+        if(k >= 0) r[k] += re[ij] ;
       }
     }
   }
@@ -667,3 +1026,303 @@ int ComputeImplicitTerms(Mesh_t* mesh,double t,double dt)
   
   return(0) ;
 }
+
+
+
+double ComputeResiduNorm(double* r,unsigned int n)
+/** Return the euclidean norm of the residu */
+{
+  double norm = 0 ;
+  unsigned int i ;
+  
+  for(i = 0 ; i < n ; i++) norm += r[i]*r[i] ;
+  
+  return(sqrt(norm)) ;
+}
+
+
+
+int ComputeSensitivities(DataSet_t* jdd,Solutions_t* sols,Solver_t* solver,Sensitivity_t* sensitivity,double t,double dt)
+/** Compute the sensitivities of the converged unknowns u to the
+ *  parameters p by the forward approach:
+ *  K.du/dp = (r(u,p + h) - r(u,p))/h
+ *  with K the matrix and r the residu at u, one r.h.s. per parameter.
+ *  The implicit terms of the converged solution are restored.
+ *  Return 0 if succeeded, -1 otherwise. */
+{
+  Mesh_t* mesh = DataSet_GetMesh(jdd) ;
+  Loads_t* loads = DataSet_GetLoads(jdd) ;
+  Solution_t* sol = Solutions_GetSolution(sols) ;
+  Matrix_t* a = Solver_GetMatrix(solver) ;
+  double* b = Solver_GetRHS(solver) ;
+  unsigned int n_col = Solver_GetNbOfColumns(solver) ;
+  int n = Sensitivity_GetNbOfParameters(sensitivity) ;
+  /* The unperturbed residu is stored after the r.h.s. */
+  double* r = b + n*n_col ;
+  int i ;
+  
+  Sensitivity_SaveImplicitTerms(sensitivity,sol) ;
+  
+  /* The matrix and the residu at u */
+  i = ComputeImplicitTerms(mesh,t,dt) ;
+  
+  if(i == 0) i = ComputeMatrix(mesh,t,dt,a) ;
+  
+  if(i == 0) ComputeResidu(mesh,t,dt,r,loads) ;
+  
+  /* The derivatives of the residu */
+  {
+    int k ;
+    
+    for(k = 0 ; k < n && i == 0 ; k++) {
+      double* b_k = b + k*n_col ;
+      double h = Sensitivity_PerturbParameter(sensitivity,jdd,k) ;
+      
+      i = ComputeImplicitTerms(mesh,t,dt) ;
+      
+      if(i == 0) {
+        unsigned int j ;
+        
+        ComputeResidu(mesh,t,dt,b_k,loads) ;
+        
+        for(j = 0 ; j < n_col ; j++) {
+          b_k[j] = (b_k[j] - r[j])/h ;
+        }
+      }
+      
+      Sensitivity_RestoreParameter(sensitivity,jdd,k) ;
+    }
+  }
+  
+  if(i == 0) i = Solver_SolveMultiple(solver,n) ;
+  
+  if(i == 0) {
+    double* s = Solver_GetSolution(solver) ;
+    
+    Sensitivity_WriteAtTime(sensitivity,mesh,s,t) ;
+  }
+  
+  Sensitivity_RestoreImplicitTerms(sensitivity,sol) ;
+  
+  return((i == 0) ? 0 : -1) ;
+}
+
+
+
+int IsJacobianFree(Mesh_t* mesh)
+/** Return 1 if all the models of the mesh opt in for the jacobian-free
+ *  resolution, 0 otherwise. */
+{
+  unsigned int n_el = Mesh_GetNbOfElements(mesh) ;
+  Element_t* el = Mesh_GetElement(mesh) ;
+  int jacobianfree = 0 ;
+  unsigned int ie ;
+  
+  for(ie = 0 ; ie < n_el ; ie++) {
+    Material_t* mat = Element_GetMaterial(el + ie) ;
+    
+    if(mat) {
+      Model_t* model = Material_GetModel(mat) ;
+      
+      if(!Model_IsJacobianFree(model)) return(0) ;
+      
+      jacobianfree = 1 ;
+    }
+  }
+  
+  return(jacobianfree) ;
+}
+
+
+
+int HasFusedResiduAndMatrix(Mesh_t* mesh)
+/** Return 1 if some model of the mesh provides the fused method
+ *  computing the residu and the matrix, 0 otherwise. */
+{
+  unsigned int n_el = Mesh_GetNbOfElements(mesh) ;
+  Element_t* el = Mesh_GetElement(mesh) ;
+  unsigned int ie ;
+  
+  for(ie = 0 ; ie < n_el ; ie++) {
+    Material_t* mat = Element_GetMaterial(el + ie) ;
+    
+    if(mat) {
+      Model_t* model = Material_GetModel(mat) ;
+      
+      if(Model_HasFusedResiduAndMatrix(model)) return(1) ;
+    }
+  }
+  
+  return(0) ;
+}
+
+
+
+JacobianFree_t* JacobianFree_Create(Mesh_t* mesh,Loads_t* loads,Solver_t* solver,IterProcess_t* iterprocess)
+{
+  JacobianFree_t* jf = (JacobianFree_t*) Mry_New(JacobianFree_t) ;
+  unsigned int n_col = Solver_GetNbOfColumns(solver) ;
+  unsigned int n_dof = Nodes_GetNbOfDOF(Mesh_GetNodes(mesh)) ;
+  
+  JacobianFree_GetMesh(jf)   = mesh ;
+  JacobianFree_GetLoads(jf)  = loads ;
+  JacobianFree_GetSolver(jf) = solver ;
+  
+  {
+    int    m     = IterProcess_GetKrylovDimension(iterprocess) ;
+    int    itmax = IterProcess_GetMaxNbOfKrylovIterations(iterprocess) ;
+    double tol   = IterProcess_GetKrylovTolerance(iterprocess) ;
+    
+    JacobianFree_GetGMRES(jf) = GMRES_Create(n_col,m,itmax,tol) ;
+  }
+  
+  {
+    double* work = (double*) Mry_New(double[3*n_col + n_dof]) ;
+    
+    JacobianFree_GetResidu(jf)          = work ;
+    JacobianFree_GetPerturbedResidu(jf) = work + n_col ;
+    JacobianFree_GetCorrection(jf)      = work + 2*n_col ;
+    JacobianFree_GetUnknown(jf)         = work + 3*n_col ;
+  }
+  
+  return(jf) ;
+}
+
+
+
+void JacobianFree_Delete(void* self)
+{
+  JacobianFree_t** pjf = (JacobianFree_t**) self ;
+  JacobianFree_t*   jf = *pjf ;
+  
+  GMRES_Delete(&JacobianFree_GetGMRES(jf)) ;
+  Mry_Free(JacobianFree_GetResidu(jf)) ;
+  Mry_Free(jf) ;
+  *pjf = NULL ;
+}
+
+
+
+int JacobianFree_Solve(JacobianFree_t* jf,double t,double dt)
+/** Solve for the correction of the unknowns by GMRES, the residu being
+ *  found in the RHS of the solver and the correction being stored as
+ *  its solution. The implicit terms are computed again at the current
+ *  unknowns. Return 0 if succeeded, 1 if GMRES didn't converge, -1 if
+ *  an operator failed. */
+{
+  Mesh_t* mesh = JacobianFree_GetMesh(jf) ;
+  Solver_t* solver = JacobianFree_GetSolver(jf) ;
+  Nodes_t* nodes = Mesh_GetNodes(mesh) ;
+  unsigned int n_col = Solver_GetNbOfColumns(solver) ;
+  unsigned int n_dof = Nodes_GetNbOfDOF(nodes) ;
+  double* u_1 = Nodes_GetCurrentUnknown(nodes) ;
+  double* r0 = JacobianFree_GetResidu(jf) ;
+  double* dx = JacobianFree_GetCorrection(jf) ;
+  double* u  = JacobianFree_GetUnknown(jf) ;
+  GMRES_t* gmres = JacobianFree_GetGMRES(jf) ;
+  int i ;
+  
+  JacobianFree_GetCurrentTime(jf)   = t ;
+  JacobianFree_GetTimeIncrement(jf) = dt ;
+  
+  memcpy(r0,Solver_GetRHS(solver),n_col*sizeof(double)) ;
+  memcpy(u,u_1,n_dof*sizeof(double)) ;
+  
+  i = GMRES_Solve(gmres,JacobianFree_Product,JacobianFree_Precondition,jf,r0,dx) ;
+  
+  memcpy(u_1,u,n_dof*sizeof(double)) ;
+  memcpy(Solver_GetRHS(solver),r0,n_col*sizeof(double)) ;
+  memcpy(Solver_GetSolution(solver),dx,n_col*sizeof(double)) ;
+  
+  if(ComputeImplicitTerms(mesh,t,dt)) return(-1) ;
+  
+  return(i) ;
+}
+
+
+
+int JacobianFree_Product(void* data,double* v,double* jv)
+/** Approximate the product of the jacobian by v by the finite
+ *  difference (R(u) - R(u + h.v))/h of the residu R, the step h being
+ *  scaled by the objective variations of the unknowns. */
+{
+  JacobianFree_t* jf = (JacobianFree_t*) data ;
+  Mesh_t* mesh = JacobianFree_GetMesh(jf) ;
+  Nodes_t* nodes = Mesh_GetNodes(mesh) ;
+  unsigned int n_col = Solver_GetNbOfColumns(JacobianFree_GetSolver(jf)) ;
+  unsigned int n_dof = Nodes_GetNbOfDOF(nodes) ;
+  int* colind = Nodes_GetMatrixColumnIndex(nodes) ;
+  double* obval = Nodes_GetObjectiveValueOfDOF(nodes) ;
+  double* u_1 = Nodes_GetCurrentUnknown(nodes) ;
+  double* u = JacobianFree_GetUnknown(jf) ;
+  double  t = JacobianFree_GetCurrentTime(jf) ;
+  double  dt = JacobianFree_GetTimeIncrement(jf) ;
+  double umax = 0 ;
+  double vmax = 0 ;
+  unsigned int i ;
+  
+  /* The max of the scaled unknowns and of the scaled direction */
+  for(i = 0 ; i < n_dof ; i++) {
+    int k = colind[i] ;
+    
+    if(k >= 0) {
+      double s = obval[i] ;
+      
+      if(Nodes_ObjectiveValueOfDOFIsRelative(nodes,i)) s *= fabs(u[i]) ;
+      if(!(s > 0)) s = 1 ;
+      
+      if(fabs(u[i]) > umax*s) umax = fabs(u[i])/s ;
+      if(fabs(v[k]) > vmax*s) vmax = fabs(v[k])/s ;
+    }
+  }
+  
+  if(vmax == 0) {
+    for(i = 0 ; i < n_col ; i++) jv[i] = 0 ;
+    return(0) ;
+  }
+  
+  {
+    double h = sqrt(DBL_EPSILON)*(1 + umax)/vmax ;
+    int ires ;
+    
+    for(i = 0 ; i < n_dof ; i++) {
+      int k = colind[i] ;
+      
+      if(k >= 0) u_1[i] = u[i] + h*v[k] ;
+    }
+    
+    ires = ComputeImplicitTerms(mesh,t,dt) ;
+    
+    if(ires == 0) {
+      double* r0 = JacobianFree_GetResidu(jf) ;
+      double* r1 = JacobianFree_GetPerturbedResidu(jf) ;
+      
+      ComputeResidu(mesh,t,dt,r1,JacobianFree_GetLoads(jf)) ;
+      
+      for(i = 0 ; i < n_col ; i++) jv[i] = (r0[i] - r1[i])/h ;
+    }
+    
+    memcpy(u_1,u,n_dof*sizeof(double)) ;
+    
+    return(ires) ;
+  }
+}
+
+
+
+int JacobianFree_Precondition(void* data,double* y,double* z)
+/** Solve M.z = y with the last factorized matrix M. */
+{
+  JacobianFree_t* jf = (JacobianFree_t*) data ;
+  Solver_t* solver = JacobianFree_GetSolver(jf) ;
+  unsigned int n_col = Solver_GetNbOfColumns(solver) ;
+  int i ;
+  
+  memcpy(Solver_GetRHS(solver),y,n_col*sizeof(double)) ;
+  
+  i = Solver_Solve(solver) ;
+  
+  memcpy(z,Solver_GetSolution(solver),n_col*sizeof(double)) ;
+  
+  return(i) ;
+}
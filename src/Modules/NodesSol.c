@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <string.h>
 #include "Mry.h"
 #include "NodesSol.h"
 #include "Message.h"
@@ -44,8 +45,10 @@ NodesSol_t* (NodesSol_Create)(Mesh_t* mesh)
       NodesSol_GetNodalValue(nodessol) = u ;
       
       
+      /* The unknowns of node i start at the offset of its dof */
       {
         Node_t* node = Mesh_GetNode(mesh) ;
+        unsigned int* offset = Nodes_GetDOFOffset(nodes) ;
         unsigned int    i ;
         
         /* The nb of unknowns per nodesol */
@@ -55,9 +58,7 @@ NodesSol_t* (NodesSol_Create)(Mesh_t* mesh)
         
           NodeSol_GetNbOfUnknowns(nodesol_i) = Node_GetNbOfUnknowns(node_i) ;
     
-          NodeSol_GetUnknown(nodesol_i) = u ;
-          
-          u += NodeSol_GetNbOfUnknowns(nodesol_i) ;
+          NodeSol_GetUnknown(nodesol_i) = u + offset[i] ;
         }
       }
     }
@@ -70,6 +71,19 @@ NodesSol_t* (NodesSol_Create)(Mesh_t* mesh)
 
 
 
+void (NodesSol_Delete)(void* self)
+{
+  NodesSol_t** pnodessol = (NodesSol_t**) self ;
+  NodesSol_t*   nodessol = *pnodessol ;
+  
+  Mry_Free(NodesSol_GetNodalValue(nodessol)) ;
+  Mry_Free(NodesSol_GetNodeSol(nodessol)) ;
+  Mry_Free(nodessol) ;
+  *pnodessol = NULL ;
+}
+
+
+
 void NodesSol_Copy(NodesSol_t* nodessol_dest,NodesSol_t* nodessol_src)
 /** Copy the nodal unknowns from nodessol_src to nodessol_dest */
 {
@@ -82,13 +96,10 @@ void NodesSol_Copy(NodesSol_t* nodessol_dest,NodesSol_t* nodessol_src)
     unsigned int ndof = NodesSol_GetNbOfDOF(nodessol_src) ;
     double* u_s = NodesSol_GetNodalValue(nodessol_src) ;
     double* u_d = NodesSol_GetNodalValue(nodessol_dest) ;
-    unsigned int i ;
     
     NodesSol_GetNbOfDOF(nodessol_dest) = ndof ;
     
-    for(i = 0 ; i < ndof ; i++) {
-      u_d[i] = u_s[i] ;
-    }
+    memcpy(u_d,u_s,ndof*sizeof(double)) ;
   }
 }
 
@@ -11,6 +11,7 @@ struct NodesSol_s     ; typedef struct NodesSol_s     NodesSol_t ;
 #include "Mesh.h"
 
 extern NodesSol_t*    (NodesSol_Create)(Mesh_t*) ;
+extern void           (NodesSol_Delete)(void*) ;
 extern void           (NodesSol_Copy)(NodesSol_t*,NodesSol_t*) ;
  
  
@@ -0,0 +1,330 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include "Message.h"
+#include "Mry.h"
+#include "String.h"
+#include "DataSet.h"
+#include "Solution.h"
+#include "Sweep.h"
+#include "Sensitivity.h"
+
+
+/* Extern functions */
+
+Sensitivity_t*  (Sensitivity_Create)(DataFile_t* datafile,Materials_t* materials)
+/** Read the section "Sensitivity" of the data file.
+ *  Return NULL if there is no such section. */
+{
+  char* filecontent = DataFile_GetFileContent(datafile) ;
+  char* c  = String_FindToken(filecontent,"SENSITIVITY,Sensitivity",",") ;
+  Sensitivity_t* sensitivity ;
+
+  if(!c) return(NULL) ;
+
+  Message_Direct("Enter in %s","Sensitivity") ;
+  Message_Direct("\n") ;
+
+  sensitivity = (Sensitivity_t*) Mry_New(Sensitivity_t) ;
+
+  {
+    char line[String_MaxLengthOfLine] ;
+    double h = Sensitivity_DefaultPerturbation ;
+
+    strcpy(line,String_CopyLine(c)) ;
+
+    if(String_FindAndScanExp(line,"Perturbation",","," = %lf",&h)) {
+      if(h <= 0) {
+        arret("Sensitivity_Create: the perturbation should be positive") ;
+      }
+    }
+
+    {
+      char* p = strstr(line,"Parameters") ;
+
+      if(!p || !(p = strchr(p,'='))) {
+        arret("Sensitivity_Create: no parameters (Parameters = prop prop[imat] ...)") ;
+      }
+
+      /* Written and scanned as the case "Sensitivity prop = h prop[imat] = h ..." */
+      {
+        SweepCase_t* parameters = (SweepCase_t*) Mry_New(SweepCase_t) ;
+        char caseline[Sweep_MaxLengthOfTextLine] ;
+        char* q = caseline + sprintf(caseline,"Sensitivity") ;
+        char* tok = strtok(p + 1," \t\n") ;
+
+        for(; tok && *tok != '#' ; tok = strtok(NULL," \t\n")) {
+          if((q - caseline) + strlen(tok) + 30 >= Sweep_MaxLengthOfTextLine) {
+            arret("Sensitivity_Create: too many parameters") ;
+          }
+
+          q += sprintf(q," %s = %.17g",tok,h) ;
+        }
+
+        if(Sweep_ScanCase(parameters,caseline) || !SweepCase_GetNbOfOverrides(parameters)) {
+          arret("Sensitivity_Create: bad parameters in\n%s",line) ;
+        }
+
+        Sensitivity_GetParameters(sensitivity) = parameters ;
+      }
+    }
+  }
+
+  SweepCase_CheckOverrides(Sensitivity_GetParameters(sensitivity),materials) ;
+
+  /* The unperturbed values */
+  {
+    int n_mat = Materials_GetNbOfMaterials(materials) ;
+    int n = Sensitivity_GetNbOfParameters(sensitivity) ;
+
+    Sensitivity_GetSavedValues(sensitivity) = (double*) Mry_New(double[n*n_mat]) ;
+    Sensitivity_GetSavedOverrides(sensitivity) = (char**) Mry_New(char*[n_mat]) ;
+  }
+
+  {
+    char* name = DataFile_GetFileName(datafile) ;
+    char* filename = (char*) Mry_New(char[strlen(name) + 6]) ;
+
+    sprintf(filename,"%s.sens",name) ;
+
+    Sensitivity_GetFileName(sensitivity) = filename ;
+  }
+
+  return(sensitivity) ;
+}
+
+
+
+void  (Sensitivity_Delete)(void* self)
+{
+  Sensitivity_t** psensitivity = (Sensitivity_t**) self ;
+  Sensitivity_t*   sensitivity = *psensitivity ;
+
+  Mry_Free(Sensitivity_GetParameters(sensitivity)) ;
+  Mry_Free(Sensitivity_GetSavedValues(sensitivity)) ;
+  Mry_Free(Sensitivity_GetSavedOverrides(sensitivity)) ;
+  Mry_Free(Sensitivity_GetFileName(sensitivity)) ;
+
+  if(Sensitivity_GetImplicitTerms(sensitivity)) {
+    Mry_Free(Sensitivity_GetImplicitTerms(sensitivity)) ;
+  }
+
+  Mry_Free(sensitivity) ;
+  *psensitivity = NULL ;
+}
+
+
+
+double  (Sensitivity_PerturbParameter)(Sensitivity_t* sensitivity,DataSet_t* jdd,int i)
+/** Add to the property of the parameter i its perturbation, the same
+ *  for all the materials concerned, and return it. The property is
+ *  overridden and the materials are scanned again (see Sweep.h) so that
+ *  the quantities the models derive from it are updated too. */
+{
+  SweepOverride_t* parameter = Sensitivity_GetParameter(sensitivity) + i ;
+  char* name = SweepOverride_GetNameOfProperty(parameter) ;
+  int imat = SweepOverride_GetMaterialIndex(parameter) ;
+  char** overrides = Sensitivity_GetSavedOverrides(sensitivity) ;
+  Materials_t* materials = DataSet_GetMaterials(jdd) ;
+  int n_mat = Materials_GetNbOfMaterials(materials) ;
+  double* value = Sensitivity_GetSavedValues(sensitivity) + i*n_mat ;
+  Material_t* mat = Materials_GetMaterial(materials) ;
+  double h = 0 ;
+  int k ;
+
+  /* The perturbation is relative to the largest value */
+  for(k = 0 ; k < n_mat ; k++) {
+    int j = (imat < 0 || imat == k) ? Sweep_FindPropertyIndex(mat + k,name) : -1 ;
+
+    if(j >= 0) {
+      double v = Material_GetProperty(mat + k)[j] ;
+
+      value[k] = v ;
+
+      if(fabs(v) > h) h = fabs(v) ;
+    }
+  }
+
+  h *= SweepOverride_GetValue(parameter) ;
+
+  if(h == 0) h = SweepOverride_GetValue(parameter) ;
+
+  for(k = 0 ; k < n_mat ; k++) {
+    int j = (imat < 0 || imat == k) ? Sweep_FindPropertyIndex(mat + k,name) : -1 ;
+
+    if(j >= 0) {
+      DataFile_t* datafile = DataSet_GetDataFile(jdd) ;
+      Geometry_t* geom = DataSet_GetGeometry(jdd) ;
+      char* ov = Material_GetPropertyOverrides(mat + k) ;
+      size_t len = (ov) ? strlen(ov) : 0 ;
+      /* The last override of a property prevails */
+      char* line = (char*) Mry_New(char[len + Material_MaxLengthOfKeyWord + 30]) ;
+
+      sprintf(line,"%s%s = %.17g\n",(ov) ? ov : "",name,value[k] + h) ;
+
+      overrides[k] = ov ;
+      Material_GetPropertyOverrides(mat + k) = line ;
+
+      Materials_RescanMaterial(materials,datafile,geom,k) ;
+    }
+  }
+
+  return(h) ;
+}
+
+
+
+void  (Sensitivity_RestoreParameter)(Sensitivity_t* sensitivity,DataSet_t* jdd,int i)
+/** Restore the property of the parameter i perturbed by
+ *  Sensitivity_PerturbParameter. */
+{
+  SweepOverride_t* parameter = Sensitivity_GetParameter(sensitivity) + i ;
+  char* name = SweepOverride_GetNameOfProperty(parameter) ;
+  int imat = SweepOverride_GetMaterialIndex(parameter) ;
+  char** overrides = Sensitivity_GetSavedOverrides(sensitivity) ;
+  Materials_t* materials = DataSet_GetMaterials(jdd) ;
+  int n_mat = Materials_GetNbOfMaterials(materials) ;
+  Material_t* mat = Materials_GetMaterial(materials) ;
+  int k ;
+
+  for(k = 0 ; k < n_mat ; k++) {
+    int j = (imat < 0 || imat == k) ? Sweep_FindPropertyIndex(mat + k,name) : -1 ;
+
+    if(j >= 0) {
+      DataFile_t* datafile = DataSet_GetDataFile(jdd) ;
+      Geometry_t* geom = DataSet_GetGeometry(jdd) ;
+
+      Mry_Free(Material_GetPropertyOverrides(mat + k)) ;
+      Material_GetPropertyOverrides(mat + k) = overrides[k] ;
+
+      Materials_RescanMaterial(materials,datafile,geom,k) ;
+    }
+  }
+}
+
+
+
+void  (Sensitivity_SaveImplicitTerms)(Sensitivity_t* sensitivity,Solution_t* sol)
+/** Copy the implicit terms of the elements of sol, which are
+ *  overwritten while computing the perturbed residus. */
+{
+  int n_el = Solution_GetNbOfElements(sol) ;
+  ElementSol_t* elementsol = Solution_GetElementSol(sol) ;
+  int i ;
+
+  if(!Sensitivity_GetImplicitTerms(sensitivity)) {
+    size_t n = 0 ;
+
+    for(i = 0 ; i < n_el ; i++) {
+      n += ElementSol_GetNbOfImplicitTerms(elementsol + i) ;
+    }
+
+    Sensitivity_GetImplicitTerms(sensitivity) = (double*) Mry_New(double[n + 1]) ;
+  }
+
+  {
+    double* w = Sensitivity_GetImplicitTerms(sensitivity) ;
+
+    for(i = 0 ; i < n_el ; i++) {
+      int n = ElementSol_GetNbOfImplicitTerms(elementsol + i) ;
+
+      if(n > 0) {
+        double* v = (double*) ElementSol_GetImplicitTerm(elementsol + i) ;
+
+        memcpy(w,v,n*sizeof(double)) ;
+        w += n ;
+      }
+    }
+  }
+}
+
+
+
+void  (Sensitivity_RestoreImplicitTerms)(Sensitivity_t* sensitivity,Solution_t* sol)
+{
+  int n_el = Solution_GetNbOfElements(sol) ;
+  ElementSol_t* elementsol = Solution_GetElementSol(sol) ;
+  double* w = Sensitivity_GetImplicitTerms(sensitivity) ;
+  int i ;
+
+  for(i = 0 ; i < n_el ; i++) {
+    int n = ElementSol_GetNbOfImplicitTerms(elementsol + i) ;
+
+    if(n > 0) {
+      double* v = (double*) ElementSol_GetImplicitTerm(elementsol + i) ;
+
+      memcpy(v,w,n*sizeof(double)) ;
+      w += n ;
+    }
+  }
+}
+
+
+
+void  (Sensitivity_WriteAtTime)(Sensitivity_t* sensitivity,Mesh_t* mesh,double* s,double t)
+/** Append to the file the sensitivities s of the nodal unknowns at time t,
+ *  s being the solutions of the nb of parameters r.h.s. stored one after
+ *  the other. One line per node: the node index, its coordinates, then
+ *  for each parameter the sensitivities of the unknowns of the node
+ *  (0 for the unknowns prescribed by boundary conditions). */
+{
+  char* filename = Sensitivity_GetFileName(sensitivity) ;
+  FILE* stream = fopen(filename,(Sensitivity_GetNbOfWritings(sensitivity)) ? "a" : "w") ;
+  int n_col = Mesh_GetNbOfMatrixColumns(mesh) ;
+  int dim = Mesh_GetDimension(mesh) ;
+  int n_no = Mesh_GetNbOfNodes(mesh) ;
+  Node_t* node = Mesh_GetNode(mesh) ;
+  int n = Sensitivity_GetNbOfParameters(sensitivity) ;
+  int i ;
+
+  if(!stream) {
+    arret("Sensitivity_WriteAtTime: can't open %s",filename) ;
+  }
+
+  fprintf(stream,"# Time = %e\n",t) ;
+  fprintf(stream,"# Parameters =") ;
+
+  for(i = 0 ; i < n ; i++) {
+    SweepOverride_t* parameter = Sensitivity_GetParameter(sensitivity) + i ;
+    int imat = SweepOverride_GetMaterialIndex(parameter) ;
+
+    fprintf(stream," %s",SweepOverride_GetNameOfProperty(parameter)) ;
+
+    if(imat >= 0) fprintf(stream,"[%d]",imat + 1) ;
+  }
+
+  fprintf(stream,"\n") ;
+
+  for(i = 0 ; i < n_no ; i++) {
+    Node_t* node_i = node + i ;
+    double* x = Node_GetCoordinate(node_i) ;
+    int nin = Node_GetNbOfUnknowns(node_i) ;
+    int k ;
+
+    fprintf(stream,"%d",i + 1) ;
+
+    for(k = 0 ; k < dim ; k++) {
+      fprintf(stream," % e",x[k]) ;
+    }
+
+    for(k = 0 ; k < n ; k++) {
+      double* s_k = s + k*n_col ;
+      int j ;
+
+      for(j = 0 ; j < nin ; j++) {
+        int col = Node_GetMatrixColumnIndex(node_i)[j] ;
+
+        fprintf(stream," % e",(col >= 0) ? s_k[col] : 0.) ;
+      }
+    }
+
+    fprintf(stream,"\n") ;
+  }
+
+  fprintf(stream,"\n") ;
+  fclose(stream) ;
+
+  Sensitivity_GetNbOfWritings(sensitivity) += 1 ;
+}
@@ -0,0 +1,67 @@
+#ifndef SENSITIVITY_H
+#define SENSITIVITY_H
+
+/* class-like structure "Sensitivity_t" */
+
+/* vacuous declarations and typedef names */
+struct Sensitivity_s          ; typedef struct Sensitivity_s          Sensitivity_t ;
+
+
+#include "DataFile.h"
+#include "Materials.h"
+#include "Mesh.h"
+#include "Solution.h"
+#include "Sweep.h"
+
+extern Sensitivity_t*  (Sensitivity_Create)(DataFile_t*,Materials_t*) ;
+extern void            (Sensitivity_Delete)(void*) ;
+extern double          (Sensitivity_PerturbParameter)(Sensitivity_t*,DataSet_t*,int) ;
+extern void            (Sensitivity_RestoreParameter)(Sensitivity_t*,DataSet_t*,int) ;
+extern void            (Sensitivity_SaveImplicitTerms)(Sensitivity_t*,Solution_t*) ;
+extern void            (Sensitivity_RestoreImplicitTerms)(Sensitivity_t*,Solution_t*) ;
+extern void            (Sensitivity_WriteAtTime)(Sensitivity_t*,Mesh_t*,double*,double) ;
+
+
+/* The section "Sensitivity" of the data file gives on one line the
+ * material properties and the relative perturbation:
+ *   Sensitivity  Perturbation = 1.e-6  Parameters = prop prop[imat] ...
+ * Without [imat] the property of all the materials the model of which
+ * knows it is perturbed. The sensitivities of the nodal unknowns to
+ * each parameter are written at each date in the file "name.sens".
+ * They are obtained by differentiating the converged residu of the
+ * last step, the state of the previous step being held fixed: this is
+ * the total sensitivity for (quasi-)static problems only.
+ * The parameters are held as a case of a sweep (see Sweep.h), the
+ * value of each override being the relative perturbation. */
+
+
+#define Sensitivity_MaxNbOfParameters           (Sweep_MaxNbOfOverridesPerCase)
+#define Sensitivity_DefaultPerturbation         (1.e-6)
+
+
+#define Sensitivity_GetFileName(SE)             ((SE)->filename)
+#define Sensitivity_GetParameters(SE)           ((SE)->parameters)
+#define Sensitivity_GetSavedValues(SE)          ((SE)->values)
+#define Sensitivity_GetImplicitTerms(SE)        ((SE)->implicitterms)
+#define Sensitivity_GetSavedOverrides(SE)       ((SE)->overrides)
+#define Sensitivity_GetNbOfWritings(SE)         ((SE)->nbofwritings)
+
+
+#define Sensitivity_GetNbOfParameters(SE) \
+        SweepCase_GetNbOfOverrides(Sensitivity_GetParameters(SE))
+
+#define Sensitivity_GetParameter(SE) \
+        SweepCase_GetOverride(Sensitivity_GetParameters(SE))
+
+
+
+struct Sensitivity_s {          /* Forward sensitivities */
+  char*  filename ;             /* Name of the output file */
+  SweepCase_t* parameters ;     /* Properties and relative perturbations */
+  double* values ;              /* Unperturbed values (per parameter and material) */
+  double* implicitterms ;       /* Copy of the converged implicit terms */
+  char** overrides ;            /* Property overrides of the materials */
+  unsigned long nbofwritings ;
+} ;
+
+#endif
@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
 #include "Solutions.h"
 #include "Mry.h"
@@ -26,6 +27,7 @@ Solutions_t*   (Solutions_Create)(Mesh_t* mesh,const int n_sol)
       Solution_t* soli = Solution_Create(mesh) ;
       
       sol[i] = soli[0] ;
+      Mry_Free(soli) ;
     }
       
     Solutions_GetSolution(sols) = sol ;
@@ -64,6 +66,66 @@ Solutions_t*   (Solutions_Create)(Mesh_t* mesh,const int n_sol)
 
 
 
+void   (Solutions_Delete)(void* self)
+/** Free the solutions. The blocks of explicit and constant terms
+ *  may be shared with the first solution (see Solutions_AllocateMemory
+ *  and Solutions_MergeExplicitTerms), they are then freed once. */
+{
+  Solutions_t** psols = (Solutions_t**) self ;
+  Solutions_t*   sols = *psols ;
+  int n_sol = Solutions_GetNbOfSolutions(sols) ;
+  Solution_t* sol = Solutions_GetSolution(sols) ;
+  int i ;
+  
+  /* The current solution moves along the loop: the first solution
+   * of the array is the lowest one */
+  {
+    Solution_t* sol_i = sol ;
+    
+    for(i = 0 ; i < n_sol ; i++) {
+      if(sol_i < sol) sol = sol_i ;
+      
+      sol_i = Solution_GetNextSolution(sol_i) ;
+    }
+  }
+  
+  for(i = 0 ; i < n_sol ; i++) {
+    Solution_t* sol_i = sol + i ;
+    
+    /* The terms of all the elements are stored in one block per kind */
+    if(Solution_GetNbOfElements(sol_i) > 0) {
+      ElementSol_t* elementsol_0 = Solution_GetElementSol(sol) ;
+      ElementSol_t* elementsol_i = Solution_GetElementSol(sol_i) ;
+      void* vi = ElementSol_GetImplicitTerm(elementsol_i) ;
+      void* ve = ElementSol_GetExplicitTerm(elementsol_i) ;
+      void* v0 = ElementSol_GetConstantTerm(elementsol_i) ;
+      
+      Mry_Free(vi) ;
+      
+      if(i == 0 || ve != ElementSol_GetExplicitTerm(elementsol_0)) {
+        Mry_Free(ve) ;
+      }
+      
+      if(i == 0 || v0 != ElementSol_GetConstantTerm(elementsol_0)) {
+        Mry_Free(v0) ;
+      }
+    }
+    
+    NodesSol_Delete(&Solution_GetNodesSol(sol_i)) ;
+  }
+  
+  /* The headers of the solution 0 locate the shared blocks above */
+  for(i = 0 ; i < n_sol ; i++) {
+    ElementsSol_Delete(&Solution_GetElementsSol(sol + i)) ;
+  }
+  
+  Mry_Free(sol) ;
+  Mry_Free(sols) ;
+  *psols = NULL ;
+}
+
+
+
 void   (Solutions_Initialize)(Solutions_t* sols)
 /** Initialized as a circularly linked list */
 {
@@ -173,6 +235,32 @@ void  (Solutions_MergeExplicitTerms)(Solutions_t* sols)
 
 
 
+void  (Solutions_Reset)(Solutions_t* sols)
+/** Reset the times, the time steps, the step indexes and the nodal
+ *  values of all the solutions so that a new calculation can be run
+ *  with the same structures. The element terms are computed again
+ *  by the initialization. */
+{
+  int n_sol = Solutions_GetNbOfSolutions(sols) ;
+  Solution_t* sol = Solutions_GetSolution(sols) ;
+  int   i ;
+  
+  for(i = 0 ; i < n_sol ; i++) {
+    unsigned int n_dof = Solution_GetNbOfDOF(sol) ;
+    double* u = Solution_GetNodalValue(sol) ;
+    
+    Solution_GetTime(sol) = 0 ;
+    Solution_GetTimeStep(sol) = 0 ;
+    Solution_GetStepIndex(sol) = 0 ;
+    
+    if(u) memset(u,0,n_dof*sizeof(double)) ;
+    
+    sol = Solution_GetNextSolution(sol) ;
+  }
+}
+
+
+
 void Solutions_StepForward(Solutions_t* sols)
 /** Step forward in the loop */
 {
@@ -192,3 +280,63 @@ void Solutions_StepBackward(Solutions_t* sols)
   
   Solutions_GetSolution(sols) = prev ;
 }
+
+
+
+int (Solutions_ComputeExtrapolationWeights)(Solutions_t* sols,int order,double* w)
+/** Compute the weights w[k], k = 0..order, of the polynomial extrapolating
+ *  at the current time the previous solutions at depth k + 1.
+ *  These previous solutions must be the successive converged steps,
+ *  which is checked with their step indices: the order is then lowered
+ *  as long as they are not available. Return the order actually used. */
+{
+  Solution_t* sol_1 = Solutions_GetSolution(sols) ;
+  Solution_t* sol_n = Solution_GetPreviousSolution(sol_1) ;
+  int n_sol = Solutions_GetNbOfSolutions(sols) ;
+  double t = Solution_GetTime(sol_1) ;
+  
+  if(order > n_sol - 2) order = n_sol - 2 ;
+  
+  {
+    Solution_t* sol_k = sol_n ;
+    int k ;
+    
+    for(k = 1 ; k <= order ; k++) {
+      Solution_t* sol_km1 = Solution_GetPreviousSolution(sol_k) ;
+      int step = Solution_GetStepIndex(sol_n) - k ;
+      
+      if(Solution_GetStepIndex(sol_km1) != step) break ;
+      if(Solution_GetTime(sol_km1) >= Solution_GetTime(sol_k)) break ;
+      
+      sol_k = sol_km1 ;
+    }
+    
+    order = k - 1 ;
+  }
+  
+  /* Lagrange's polynomials */
+  {
+    Solution_t* sol_k = sol_n ;
+    int k ;
+    
+    for(k = 0 ; k <= order ; k++) {
+      double t_k = Solution_GetTime(sol_k) ;
+      Solution_t* sol_m = sol_n ;
+      int m ;
+      
+      w[k] = 1 ;
+      
+      for(m = 0 ; m <= order ; m++) {
+        double t_m = Solution_GetTime(sol_m) ;
+        
+        if(m != k) w[k] *= (t - t_m)/(t_k - t_m) ;
+        
+        sol_m = Solution_GetPreviousSolution(sol_m) ;
+      }
+      
+      sol_k = Solution_GetPreviousSolution(sol_k) ;
+    }
+  }
+  
+  return(order) ;
+}
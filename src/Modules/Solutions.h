@@ -15,9 +15,12 @@ struct Solutions_s     ; typedef struct Solutions_s     Solutions_t ;
 #include "Mesh.h"
  
 extern Solutions_t*   (Solutions_Create)(Mesh_t*,const int) ;
+extern void           (Solutions_Delete)(void*) ;
 extern void           (Solutions_MergeExplicitTerms)(Solutions_t*) ;
+extern void           (Solutions_Reset)(Solutions_t*) ;
 extern void           (Solutions_StepForward)(Solutions_t*) ;
 extern void           (Solutions_StepBackward)(Solutions_t*) ;
+extern int            (Solutions_ComputeExtrapolationWeights)(Solutions_t*,int,double*) ;
 
 
 #define Solutions_GetNbOfSolutions(SOLS)    ((SOLS)->n_sol)
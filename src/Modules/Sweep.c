@@ -0,0 +1,542 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "Message.h"
+#include "Mry.h"
+#include "DataSet.h"
+#include "Module.h"
+#include "Solutions.h"
+#include "Solver.h"
+#include "OutputFiles.h"
+#include "Sweep.h"
+
+
+static void    (Sweep_ReadPlan)(Sweep_t*,const char*) ;
+static void    (Sweep_CheckOverrides)(Sweep_t*,Materials_t*) ;
+static int     (Sweep_RunCase)(SweepCase_t*,DataSet_t*,Module_t*,Solutions_t*,Solver_t*,char*,int*,int) ;
+
+
+/* Extern functions */
+
+Sweep_t*  (Sweep_Create)(const char* planfilename,const int nbofworkers)
+{
+  Sweep_t* sweep = (Sweep_t*) Mry_New(Sweep_t) ;
+
+  Sweep_GetNbOfWorkers(sweep) = (nbofworkers > 1) ? nbofworkers : 1 ;
+
+  Sweep_ReadPlan(sweep,planfilename) ;
+
+  return(sweep) ;
+}
+
+
+
+void  (Sweep_Delete)(void* self)
+{
+  Sweep_t** psweep = (Sweep_t**) self ;
+  Sweep_t*   sweep = *psweep ;
+
+  Mry_Free(Sweep_GetCase(sweep)) ;
+  Mry_Free(sweep) ;
+  *psweep = NULL ;
+}
+
+
+
+int  (Sweep_Run)(Sweep_t* sweep,DataSet_t* jdd,Module_t* module)
+/** Run all the cases of the sweep with the data set jdd, the mesh,
+ *  the solutions and the solver being built only once.
+ *  Return the nb of cases which failed. */
+{
+  Mesh_t* mesh = DataSet_GetMesh(jdd) ;
+  Materials_t* materials = DataSet_GetMaterials(jdd) ;
+  int n_mat = Materials_GetNbOfMaterials(materials) ;
+  TimeStep_t* timestep = DataSet_GetTimeStep(jdd) ;
+  const int n_sol = TimeStep_GetNbOfSolutionsToBeStored(timestep) ;
+  int ncases = Sweep_GetNbOfCases(sweep) ;
+  int nworkers = Sweep_GetNbOfWorkers(sweep) ;
+  int nfailed = 0 ;
+
+  if(!Module_GetSolveProblem(module)) {
+    arret("Sweep_Run: the module has no algorithm to be reused") ;
+  }
+
+  Sweep_CheckOverrides(sweep,materials) ;
+
+  if(nworkers > ncases) nworkers = ncases ;
+
+  {
+    Solutions_t* sols = Solutions_Create(mesh,n_sol) ;
+    Options_t* options = DataSet_GetOptions(jdd) ;
+    Solver_t* solver ;
+    /* The property overrides of the materials */
+    char* overrides = (char*) Mry_New(char[n_mat*Sweep_MaxLengthOfOverrides]) ;
+    /* The materials scanned with overrides */
+    int* overridden = (int*) Mry_New(int[n_mat]) ;
+    int i ;
+
+    Solutions_MergeExplicitTerms(sols) ;
+
+    solver = Solver_Create(mesh,options,1) ;
+
+    /* Sequential runs */
+    if(nworkers < 2) {
+      for(i = 0 ; i < ncases ; i++) {
+        SweepCase_t* sweepcase = Sweep_GetCase(sweep) + i ;
+
+        if(Sweep_RunCase(sweepcase,jdd,module,sols,solver,overrides,overridden,0)) nfailed++ ;
+      }
+
+    /* Runs forked into nworkers processes, the worker k running
+     * the cases k, k + nworkers, k + 2*nworkers, ... */
+    } else {
+      int k ;
+
+      fflush(stdout) ;
+      fflush(stderr) ;
+
+      for(k = 0 ; k < nworkers ; k++) {
+        pid_t pid = fork() ;
+
+        if(pid < 0) {
+          arret("Sweep_Run: fork failed") ;
+        }
+
+        if(pid == 0) {
+          int n = 0 ;
+
+          for(i = k ; i < ncases ; i += nworkers) {
+            SweepCase_t* sweepcase = Sweep_GetCase(sweep) + i ;
+
+            if(Sweep_RunCase(sweepcase,jdd,module,sols,solver,overrides,overridden,1)) n++ ;
+          }
+
+          fflush(stdout) ;
+          _exit((n < 255) ? n : 255) ;
+        }
+      }
+
+      for(k = 0 ; k < nworkers ; k++) {
+        int status ;
+
+        if(wait(&status) < 0) break ;
+
+        if(WIFEXITED(status)) {
+          nfailed += WEXITSTATUS(status) ;
+        } else {
+          Message_Warning("Sweep_Run: a worker process was terminated abnormally") ;
+          nfailed++ ;
+        }
+      }
+    }
+
+    /* Restore the materials of the data file */
+    SweepCase_SetProperties(NULL,jdd,overrides,overridden) ;
+
+    Mry_Free(overrides) ;
+    Mry_Free(overridden) ;
+    Solver_Delete(&solver) ;
+  }
+
+  Message_Direct("Sweep: %d case(s) run, %d failed\n",ncases,nfailed) ;
+
+  return(nfailed) ;
+}
+
+
+
+void  (SweepCase_CheckOverrides)(SweepCase_t* sweepcase,Materials_t* materials)
+/** Check that every override of the case applies to at least one material. */
+{
+  int n_mat = Materials_GetNbOfMaterials(materials) ;
+  Material_t* mat = Materials_GetMaterial(materials) ;
+  int n = SweepCase_GetNbOfOverrides(sweepcase) ;
+  int j ;
+
+  for(j = 0 ; j < n ; j++) {
+    SweepOverride_t* override = SweepCase_GetOverride(sweepcase) + j ;
+    char* name = SweepOverride_GetNameOfProperty(override) ;
+    int imat = SweepOverride_GetMaterialIndex(override) ;
+
+    if(imat >= n_mat) {
+      arret("SweepCase_CheckOverrides: case %s, no material %d",SweepCase_GetName(sweepcase),imat + 1) ;
+    }
+
+    if(imat >= 0) {
+      if(Sweep_FindPropertyIndex(mat + imat,name) < 0) {
+        arret("SweepCase_CheckOverrides: case %s, %s is not known in material %d",SweepCase_GetName(sweepcase),name,imat + 1) ;
+      }
+    } else {
+      int k ;
+
+      for(k = 0 ; k < n_mat ; k++) {
+        if(Sweep_FindPropertyIndex(mat + k,name) >= 0) break ;
+      }
+
+      if(k == n_mat) {
+        arret("SweepCase_CheckOverrides: case %s, %s is not known",SweepCase_GetName(sweepcase),name) ;
+      }
+    }
+  }
+}
+
+
+
+int  (SweepCase_AddOverride)(SweepCase_t* sweepcase,const char* name,const int imat,const double v)
+/** Override the property name of the material imat (-1 = all) with v,
+ *  replacing a previous override of the same property and material.
+ *  Return 0 if succeeded, -1 if there is no more room for overrides
+ *  or if the name is too long. */
+{
+  int n = SweepCase_GetNbOfOverrides(sweepcase) ;
+  SweepOverride_t* override = SweepCase_GetOverride(sweepcase) ;
+  int i ;
+
+  if(strlen(name) >= Material_MaxLengthOfKeyWord) return(-1) ;
+
+  for(i = 0 ; i < n ; i++) {
+    if(SweepOverride_GetMaterialIndex(override + i) != imat) continue ;
+    if(strcmp(SweepOverride_GetNameOfProperty(override + i),name)) continue ;
+
+    SweepOverride_GetValue(override + i) = v ;
+    return(0) ;
+  }
+
+  if(n >= Sweep_MaxNbOfOverridesPerCase) return(-1) ;
+
+  strcpy(SweepOverride_GetNameOfProperty(override + n),name) ;
+  SweepOverride_GetMaterialIndex(override + n) = imat ;
+  SweepOverride_GetValue(override + n) = v ;
+  SweepCase_GetNbOfOverrides(sweepcase) = n + 1 ;
+
+  return(0) ;
+}
+
+
+
+void  (SweepCase_SetProperties)(SweepCase_t* sweepcase,DataSet_t* jdd,char* overrides,int* overridden)
+/** Write the overrides of the case (none if sweepcase is NULL) as lines
+ *  "name = value" for every material, then scan again the materials the
+ *  overrides of which changed so that the quantities derived from the
+ *  properties are updated. */
+{
+  Materials_t* materials = DataSet_GetMaterials(jdd) ;
+  DataFile_t* datafile = DataSet_GetDataFile(jdd) ;
+  Geometry_t* geom = DataSet_GetGeometry(jdd) ;
+  int n_mat = Materials_GetNbOfMaterials(materials) ;
+  Material_t* mat = Materials_GetMaterial(materials) ;
+  int n = (sweepcase) ? SweepCase_GetNbOfOverrides(sweepcase) : 0 ;
+  int k ;
+
+  for(k = 0 ; k < n_mat ; k++) {
+    char* ov = overrides + k*Sweep_MaxLengthOfOverrides ;
+    int i ;
+
+    ov[0] = '\0' ;
+
+    for(i = 0 ; i < n ; i++) {
+      SweepOverride_t* override = SweepCase_GetOverride(sweepcase) + i ;
+      char* name = SweepOverride_GetNameOfProperty(override) ;
+      int imat = SweepOverride_GetMaterialIndex(override) ;
+      double v = SweepOverride_GetValue(override) ;
+
+      if(imat < 0 || imat == k) {
+        if(Sweep_FindPropertyIndex(mat + k,name) >= 0) {
+          char* c = ov + strlen(ov) ;
+
+          sprintf(c,"%s = %.17g\n",name,v) ;
+        }
+      }
+    }
+
+    if(ov[0] || overridden[k]) {
+      Material_GetPropertyOverrides(mat + k) = (ov[0]) ? ov : NULL ;
+
+      Materials_RescanMaterial(materials,datafile,geom,k) ;
+
+      overridden[k] = (ov[0] != '\0') ;
+    }
+  }
+}
+
+
+
+void  (Sweep_ResetDataSet)(DataSet_t* jdd,Solutions_t* sols)
+/** Reset the solutions, the state of the time step controller and
+ *  of the iterative process, as well as their statistics. The next run
+ *  starts with a full initialization (a previous run may have been
+ *  resumed from a checkpoint or a continuation file). */
+{
+  TimeStep_t* timestep = DataSet_GetTimeStep(jdd) ;
+  IterProcess_t* iterprocess = DataSet_GetIterProcess(jdd) ;
+
+  Solutions_Reset(sols) ;
+
+  DataFile_ContextSetToFullInitialization(DataSet_GetDataFile(jdd)) ;
+
+  /* Initial time */
+  {
+    Solution_t* sol = Solutions_GetSolution(sols) ;
+    Date_t* date = Dates_GetDate(DataSet_GetDates(jdd)) ;
+
+    Solution_GetTime(sol) = Date_GetTime(date) ;
+  }
+
+  TimeStep_GetPreviousErrorRatio(timestep) = 0 ;
+  TimeStep_GetProposedTimeStep(timestep)   = 0 ;
+  TimeStep_GetNbOfAcceptedSteps(timestep)  = 0 ;
+  TimeStep_GetNbOfRejectedSteps(timestep)  = 0 ;
+
+  IterProcess_GetCurrentError(iterprocess) = 0 ;
+  IterProcess_GetPreviousError(iterprocess) = 0 ;
+  IterProcess_OrderToRefactorize(iterprocess) ;
+  IterProcess_GetNbOfFactorizations(iterprocess) = 0 ;
+  IterProcess_GetNbOfSavedFactorizations(iterprocess) = 0 ;
+  IterProcess_GetTotalNbOfIterations(iterprocess) = 0 ;
+  IterProcess_GetNbOfBacktrackings(iterprocess) = 0 ;
+  IterProcess_GetNbOfLimitedIncrements(iterprocess) = 0 ;
+  IterProcess_GetNbOfRejectedSteps(iterprocess) = 0 ;
+  IterProcess_GetNbOfKrylovIterations(iterprocess) = 0 ;
+  IterProcess_GetResidualConvergence(iterprocess) = 0 ;
+  IterProcess_GetNbOfSkippedResolutions(iterprocess) = 0 ;
+}
+
+
+
+int  (Sweep_ScanCase)(SweepCase_t* sweepcase,char* line)
+/** Scan a line "name prop = value prop[imat] = value ...".
+ *  Return 0 if succeeded, -1 otherwise. */
+{
+  char* c = line ;
+  int n = 0 ;
+
+  /* The name of the case */
+  {
+    char* name = SweepCase_GetName(sweepcase) ;
+    int len = 0 ;
+
+    while(*c && !isspace(*c)) {
+      if(len + 1 >= Sweep_MaxLengthOfCaseName) return(-1) ;
+      name[len++] = *c++ ;
+    }
+
+    name[len] = '\0' ;
+  }
+
+  /* The overrides */
+  while(1) {
+    SweepOverride_t* override = SweepCase_GetOverride(sweepcase) + n ;
+    char* name = SweepOverride_GetNameOfProperty(override) ;
+    int len = 0 ;
+
+    while(isspace(*c)) c++ ;
+
+    if(!*c || *c == '#') break ;
+
+    if(n >= Sweep_MaxNbOfOverridesPerCase) return(-1) ;
+
+    while(*c && !isspace(*c) && *c != '=' && *c != '[') {
+      if(len + 1 >= Material_MaxLengthOfKeyWord) return(-1) ;
+      name[len++] = *c++ ;
+    }
+
+    name[len] = '\0' ;
+
+    if(!len) return(-1) ;
+
+    SweepOverride_GetMaterialIndex(override) = -1 ;
+
+    if(*c == '[') {
+      char* end ;
+      long imat = strtol(c + 1,&end,10) ;
+
+      if(end == c + 1 || *end != ']' || imat < 1) return(-1) ;
+
+      SweepOverride_GetMaterialIndex(override) = (int) imat - 1 ;
+      c = end + 1 ;
+    }
+
+    while(isspace(*c)) c++ ;
+
+    if(*c++ != '=') return(-1) ;
+
+    {
+      char* end ;
+      double v = strtod(c,&end) ;
+
+      if(end == c) return(-1) ;
+
+      SweepOverride_GetValue(override) = v ;
+      c = end ;
+    }
+
+    n++ ;
+  }
+
+  SweepCase_GetNbOfOverrides(sweepcase) = n ;
+
+  return(0) ;
+}
+
+
+
+int  (Sweep_FindPropertyIndex)(Material_t* mat,const char* name)
+/** Return the index of the property name of the material mat,
+ *  or -1 if the model doesn't know this property. */
+{
+  Model_t* model = Material_GetModel(mat) ;
+  Model_ComputePropertyIndex_t* pm = (model) ? Model_GetComputePropertyIndex(model) : NULL ;
+
+  if(pm) {
+    int i = pm(name) ;
+
+    if(i >= 0 && i < Material_MaxNbOfProperties) return(i) ;
+  }
+
+  return(-1) ;
+}
+
+
+
+/* Intern functions */
+
+void  (Sweep_ReadPlan)(Sweep_t* sweep,const char* planfilename)
+{
+  FILE* fic = fopen(planfilename,"r") ;
+  char line[Sweep_MaxLengthOfTextLine] ;
+  int ncases = 0 ;
+
+  if(!fic) {
+    arret("Sweep_ReadPlan: can't open %s",planfilename) ;
+  }
+
+  /* Count the cases */
+  while(fgets(line,sizeof(line),fic)) {
+    char* c = line ;
+
+    while(isspace(*c)) c++ ;
+
+    if(*c && *c != '#') ncases++ ;
+  }
+
+  if(!ncases) {
+    arret("Sweep_ReadPlan: no case in %s",planfilename) ;
+  }
+
+  Sweep_GetNbOfCases(sweep) = ncases ;
+  Sweep_GetCase(sweep) = (SweepCase_t*) Mry_New(SweepCase_t[ncases]) ;
+
+  /* Scan the cases */
+  rewind(fic) ;
+
+  {
+    SweepCase_t* sweepcase = Sweep_GetCase(sweep) ;
+    int i = 0 ;
+
+    while(fgets(line,sizeof(line),fic)) {
+      char* c = line ;
+
+      while(isspace(*c)) c++ ;
+
+      if(!*c || *c == '#') continue ;
+
+      if(Sweep_ScanCase(sweepcase + i,c)) {
+        arret("Sweep_ReadPlan: bad case in %s:\n%s",planfilename,line) ;
+      }
+
+      i++ ;
+    }
+  }
+
+  fclose(fic) ;
+}
+
+
+
+void  (Sweep_CheckOverrides)(Sweep_t* sweep,Materials_t* materials)
+/** Check that every override applies to at least one material. */
+{
+  int ncases = Sweep_GetNbOfCases(sweep) ;
+  int i ;
+
+  for(i = 0 ; i < ncases ; i++) {
+    SweepCase_t* sweepcase = Sweep_GetCase(sweep) + i ;
+
+    SweepCase_CheckOverrides(sweepcase,materials) ;
+  }
+}
+
+
+
+int  (Sweep_RunCase)(SweepCase_t* sweepcase,DataSet_t* jdd,Module_t* module,Solutions_t* sols,Solver_t* solver,char* overrides,int* overridden,int logfile)
+/** Run the case in the directory named after it. The outputs of the
+ *  run are redirected to the file "log" of this directory if logfile
+ *  is not 0. Return the value returned by the algorithm. */
+{
+  char* casename = SweepCase_GetName(sweepcase) ;
+  DataFile_t* datafile = DataSet_GetDataFile(jdd) ;
+  char* filename = DataFile_GetFileName(datafile) ;
+  char* basename = strrchr(filename,'/') ;
+  int i ;
+
+  basename = (basename) ? basename + 1 : filename ;
+
+  if(mkdir(casename,0777) && errno != EEXIST) {
+    arret("Sweep_RunCase: can't create the directory %s",casename) ;
+  }
+
+  if(logfile) {
+    char* name = (char*) Mry_New(char[strlen(casename) + 5]) ;
+
+    sprintf(name,"%s/log",casename) ;
+
+    fflush(stdout) ;
+
+    if(!freopen(name,"w",stdout)) {
+      arret("Sweep_RunCase: can't open %s",name) ;
+    }
+
+    Mry_Free(name) ;
+  }
+
+  Message_Direct("Case %s\n",casename) ;
+
+  SweepCase_SetProperties(sweepcase,jdd,overrides,overridden) ;
+
+  Sweep_ResetDataSet(jdd,sols) ;
+
+  /* The outputs are written in the directory of the case */
+  {
+    Dates_t* dates = DataSet_GetDates(jdd) ;
+    int nbofdates = Dates_GetNbOfDates(dates) ;
+    Points_t* points = DataSet_GetPoints(jdd) ;
+    int n_points = Points_GetNbOfPoints(points) ;
+    char* name = (char*) Mry_New(char[strlen(casename) + strlen(basename) + 2]) ;
+    OutputFiles_t* outputfiles ;
+
+    sprintf(name,"%s/%s",casename,basename) ;
+
+    outputfiles = OutputFiles_Create(name,nbofdates,n_points) ;
+
+    i = Module_SolveProblem(module,jdd,sols,solver,outputfiles) ;
+
+    OutputFiles_Delete(&outputfiles) ;
+    Mry_Free(name) ;
+  }
+
+  if(i) {
+    Message_Direct("Case %s failed\n",casename) ;
+  }
+
+  fflush(stdout) ;
+
+  return(i) ;
+}
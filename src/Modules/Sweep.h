@@ -0,0 +1,80 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+/* class-like structures "Sweep_t" and "SweepCase_t" */
+
+/* vacuous declarations and typedef names */
+struct Sweep_s         ; typedef struct Sweep_s         Sweep_t ;
+struct SweepCase_s     ; typedef struct SweepCase_s     SweepCase_t ;
+struct SweepOverride_s ; typedef struct SweepOverride_s SweepOverride_t ;
+
+
+#include "DataSet.h"
+#include "Module.h"
+#include "Solutions.h"
+
+extern Sweep_t*  (Sweep_Create)(const char*,const int) ;
+extern void      (Sweep_Delete)(void*) ;
+extern int       (Sweep_Run)(Sweep_t*,DataSet_t*,Module_t*) ;
+extern void      (Sweep_ResetDataSet)(DataSet_t*,Solutions_t*) ;
+extern int       (Sweep_ScanCase)(SweepCase_t*,char*) ;
+extern int       (Sweep_FindPropertyIndex)(Material_t*,const char*) ;
+
+extern int       (SweepCase_AddOverride)(SweepCase_t*,const char*,const int,const double) ;
+extern void      (SweepCase_CheckOverrides)(SweepCase_t*,Materials_t*) ;
+extern void      (SweepCase_SetProperties)(SweepCase_t*,DataSet_t*,char*,int*) ;
+
+
+/* A plan is a text file with one case per line:
+ *   name  prop = value  prop[imat] = value ...
+ * Without [imat] (1 <= imat <= nb of materials) the value is assigned
+ * to all the materials the model of which knows the property.
+ * The overridden materials are scanned again in the data file, the
+ * overrides being applied by Material_ScanProperties.
+ * Blank lines and lines starting with # are ignored. */
+
+
+#define Sweep_MaxLengthOfCaseName            (60)
+#define Sweep_MaxLengthOfTextLine            (1000)
+#define Sweep_MaxNbOfOverridesPerCase        (20)
+#define Sweep_MaxLengthOfOverrides \
+        (Sweep_MaxNbOfOverridesPerCase*(Material_MaxLengthOfKeyWord + 30))
+
+
+#define Sweep_GetNbOfCases(SW)               ((SW)->nbofcases)
+#define Sweep_GetCase(SW)                    ((SW)->cases)
+#define Sweep_GetNbOfWorkers(SW)             ((SW)->nbofworkers)
+
+
+#define SweepCase_GetName(SC)                ((SC)->name)
+#define SweepCase_GetNbOfOverrides(SC)       ((SC)->nbofoverrides)
+#define SweepCase_GetOverride(SC)            ((SC)->override)
+
+
+#define SweepOverride_GetNameOfProperty(SO)  ((SO)->name)
+#define SweepOverride_GetMaterialIndex(SO)   ((SO)->imat)
+#define SweepOverride_GetValue(SO)           ((SO)->value)
+
+
+
+struct SweepOverride_s {      /* Override of a material property */
+  char   name[Material_MaxLengthOfKeyWord] ;
+  int    imat ;               /* Material index (-1 = all) */
+  double value ;
+} ;
+
+
+struct SweepCase_s {          /* Case of a sweep */
+  char   name[Sweep_MaxLengthOfCaseName] ;
+  int    nbofoverrides ;
+  SweepOverride_t override[Sweep_MaxNbOfOverridesPerCase] ;
+} ;
+
+
+struct Sweep_s {              /* Parameter sweep */
+  int    nbofcases ;
+  SweepCase_t* cases ;
+  int    nbofworkers ;        /* Nb of worker processes (1 = sequential) */
+} ;
+
+#endif
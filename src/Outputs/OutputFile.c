@@ -19,7 +19,7 @@ char   OutputFile_TypeOfCurrentFile ;
 
 OutputFile_t*   (OutputFile_Create)(char* filename,int nfiles)
 {
-  OutputFile_t* outputfile = (OutputFile_t*) Mry_New(OutputFile_t[nfiles]) ;
+  OutputFile_t* outputfile = (OutputFile_t*) Mry_NewIn(Output,OutputFile_t[nfiles]) ;
   
   {
     char* c = filename + strlen(filename) - 1 ;
@@ -54,6 +54,6 @@ void   (OutputFile_Delete)(void* self,int nfiles)
     TextFile_Delete(&textfile) ;
   }
   
-  free(outputfile) ;
+  Mry_Free(outputfile) ;
   *poutputfile = NULL ;
 }
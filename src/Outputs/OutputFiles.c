@@ -1,8 +1,14 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 #include <time.h>
+#include <unistd.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "OutputFiles.h"
 #include "Message.h"
@@ -12,6 +18,7 @@
 #include "Models.h"
 #include "String.h"
 #include "Mry.h"
+#include "Math.h"
 
 
 //char   OutputFile_TypeOfCurrentFile ;
@@ -20,18 +27,30 @@
 static void  (OutputFiles_PostProcessForGmshASCIIFileFormatVersion2_2)(OutputFiles_t*,DataSet_t*) ;
 static void  (OutputFiles_PostProcessForGmshParsedFileFormatVersion2)(OutputFiles_t*,DataSet_t*) ;
 static Views_t* (OutputFiles_CreateGlobalViews)(OutputFiles_t*,Models_t*,TextFile_t*) ;
+static void  (OutputFiles_FlushPointFile)(OutputFiles_t*,int) ;
+static void  (OutputFiles_FlushPointFilesAtExit)(void) ;
+static void  (OutputFiles_SelectViews)(OutputFiles_t*,DataSet_t*,Element_t*,Result_t*,int) ;
+static int   (OutputFiles_CountSelectedViews)(Result_t*,int) ;
+static void  (OutputFiles_ReadElementRecords)(TextFile_t*,char*,int,Views_t*,double*,double (*)[9*Element_MaxNbOfNodes]) ;
+static int   (OutputFiles_ComputeNbOfPostProcessingThreads)(int) ;
+static int   (OutputFiles_ComputeMaxNbOfViewsPerModel)(Models_t*) ;
+
+
+/* The output files whose point records are buffered. The buffers are
+ * written if the program stops on an error. */
+static OutputFiles_t* OutputFiles_Buffered = NULL ;
 
 
 
 OutputFiles_t*   (OutputFiles_Create)(char* filename,int n_dates,int n_points)
 {
-  OutputFiles_t* outputfiles = (OutputFiles_t*) Mry_New(OutputFiles_t) ;
+  OutputFiles_t* outputfiles = (OutputFiles_t*) Mry_NewIn(Output,OutputFiles_t) ;
   
   
   /* The file name */
   {
     int LengthOfName = strlen(filename) + 1 ;
-    char* name = (char*) Mry_New(char[LengthOfName]) ;
+    char* name = (char*) Mry_NewIn(Output,char[LengthOfName]) ;
     
     strcpy(name,filename) ;
 
@@ -46,7 +65,7 @@ OutputFiles_t*   (OutputFiles_Create)(char* filename,int n_dates,int n_points)
   {
     int n = ceil(log10((double) n_dates+1)) ;
     int LengthOfName = strlen(filename) + 3 + n ;
-    char* name = (char*) Mry_New(char[LengthOfName]) ;
+    char* name = (char*) Mry_NewIn(Output,char[LengthOfName]) ;
       
     sprintf(name,"%s.t0",filename) ;
     
@@ -56,7 +75,7 @@ OutputFiles_t*   (OutputFiles_Create)(char* filename,int n_dates,int n_points)
       OutputFiles_GetDateOutputFile(outputfiles) = outputfile ;
     }
       
-    free(name) ;
+    Mry_Free(name) ;
   }
   
   
@@ -67,7 +86,7 @@ OutputFiles_t*   (OutputFiles_Create)(char* filename,int n_dates,int n_points)
   {
     int n = ceil(log10((double) n_points+1)) ;
     int LengthOfName = strlen(filename) + 3 + n ;
-    char* name = (char*) Mry_New(char[LengthOfName]) ;
+    char* name = (char*) Mry_NewIn(Output,char[LengthOfName]) ;
       
     sprintf(name,"%s.p1",filename) ;
     
@@ -77,7 +96,7 @@ OutputFiles_t*   (OutputFiles_Create)(char* filename,int n_dates,int n_points)
       OutputFiles_GetPointOutputFile(outputfiles) = outputfile ;
     }
       
-    free(name) ;
+    Mry_Free(name) ;
   }
   
   
@@ -91,12 +110,49 @@ OutputFiles_t*   (OutputFiles_Create)(char* filename,int n_dates,int n_points)
   
   /* Text line */
   {
-    char* line = (char*) Mry_New(char[OutputFiles_MaxLengthOfTextLine]) ;
+    char* line = (char*) Mry_NewIn(Output,char[OutputFiles_MaxLengthOfTextLine]) ;
     
     OutputFiles_GetTextLine(outputfiles) = line ;
   }
   
   
+  /* Masks of the requested views (unknown until the first outputs) */
+  {
+    int nmod = OutputFiles_MaxNbOfUsedModels ;
+    char* mask = (char*) Mry_NewIn(Output,char[nmod*OutputFiles_MaxNbOfViews]) ;
+    int* n = (int*) Mry_NewIn(Output,int[nmod]) ;
+    int i ;
+    
+    for(i = 0 ; i < nmod ; i++) n[i] = -1 ;
+    
+    OutputFiles_GetViewMask(outputfiles) = mask ;
+    OutputFiles_GetNbOfMaskedViews(outputfiles) = n ;
+  }
+  
+  
+  /* Buffers of the point files */
+  if(n_points > 0) {
+    double* buffer = (double*) Mry_NewIn(Output,double[n_points*OutputFiles_SizeOfPointBuffer]) ;
+    int* n = (int*) Mry_NewIn(Output,int[2*n_points]) ;
+    
+    OutputFiles_GetPointBuffer(outputfiles) = buffer ;
+    OutputFiles_GetNbOfBufferedValues(outputfiles) = n ;
+    OutputFiles_GetPointRecordLength(outputfiles) = n + n_points ;
+    OutputFiles_GetPointFormat(outputfiles) = 'a' ;
+    
+    {
+      static int registered = 0 ;
+      
+      if(!registered) {
+        atexit(OutputFiles_FlushPointFilesAtExit) ;
+        registered = 1 ;
+      }
+    }
+    
+    OutputFiles_Buffered = outputfiles ;
+  }
+  
+  
   return(outputfiles) ;
 }
 
@@ -109,16 +165,29 @@ void   (OutputFiles_Delete)(void* self)
   int n_dates = OutputFiles_GetNbOfDateFiles(outputfiles) ;
   int n_points = OutputFiles_GetNbOfPointFiles(outputfiles) ;
   
-  free(OutputFiles_GetDataFileName(outputfiles)) ;
+  Mry_Free(OutputFiles_GetDataFileName(outputfiles)) ;
+  
+  /* Write the records left in the buffers */
+  if(n_points > 0) {
+    OutputFiles_FlushPointFiles(outputfiles) ;
+    
+    Mry_Free(OutputFiles_GetPointBuffer(outputfiles)) ;
+    Mry_Free(OutputFiles_GetNbOfBufferedValues(outputfiles)) ;
+    
+    if(OutputFiles_Buffered == outputfiles) OutputFiles_Buffered = NULL ;
+  }
     
   OutputFile_Delete(&(OutputFiles_GetDateOutputFile(outputfiles)),n_dates) ;
   OutputFile_Delete(&(OutputFiles_GetPointOutputFile(outputfiles)),n_points) ;
   
   Results_Delete(&(OutputFiles_GetResults(outputfiles))) ;
   
-  free(OutputFiles_GetTextLine(outputfiles)) ;
+  Mry_Free(OutputFiles_GetTextLine(outputfiles)) ;
+  
+  Mry_Free(OutputFiles_GetViewMask(outputfiles)) ;
+  Mry_Free(OutputFiles_GetNbOfMaskedViews(outputfiles)) ;
   
-  free(outputfiles) ;
+  Mry_Free(outputfiles) ;
   *poutputfiles = NULL ;
 }
 
@@ -187,6 +256,8 @@ void (OutputFiles_PostProcessForGmshASCIIFileFormatVersion2_2)(OutputFiles_t* ou
   
   int    nbofrecords[OutputFiles_MaxNbOfViews] ;
   
+  size_t sizeofsection[OutputFiles_MaxNbOfViews] ;
+
   
   if(nbofglobalviews > OutputFiles_MaxNbOfViews) {
     arret("OutputFiles_PostProcessForGmshASCIIFileFormatVersion2_2: too many views") ;
@@ -194,7 +265,7 @@ void (OutputFiles_PostProcessForGmshASCIIFileFormatVersion2_2)(OutputFiles_t* ou
    
 
 
-  /* Nb of records */
+  /* Nb of records and upper bound of the size of the sections */
   {
     int ie ;
     
@@ -202,7 +273,10 @@ void (OutputFiles_PostProcessForGmshASCIIFileFormatVersion2_2)(OutputFiles_t* ou
       int i ;
       
       for(i = 0 ; i < nbofglobalviews ; i++) {
+        View_t* view = Views_GetView(globalviews) + i ;
+
         nbofrecords[i] = 0 ;
+        sizeofsection[i] = strlen(View_GetNameOfView(view)) + 256 ;
       }
     }
     
@@ -215,6 +289,7 @@ void (OutputFiles_PostProcessForGmshASCIIFileFormatVersion2_2)(OutputFiles_t* ou
       Views_t*  views = Model_GetViews(usedmodel) ;
       int nviews = Views_GetNbOfViews(views) ;
       View_t*   view  = Views_GetView(views) ;
+      int    nn = Element_GetNbOfNodes(elt) ;
       
       
       if(Element_IsSubmanifold(elt)) continue ;
@@ -225,9 +300,11 @@ void (OutputFiles_PostProcessForGmshASCIIFileFormatVersion2_2)(OutputFiles_t* ou
         int i ;
       
         for(i = 0 ; i < nviews ; i++) {
+          int    nc = View_GetNbOfComponents(view + i) ;
           int    jview = View_GetGlobalIndex(view + i) ;
       
           nbofrecords[jview] += 1 ;
+          sizeofsection[jview] += 32 + nc*nn*OutputFiles_MaxLengthOfPrintedNumber ;
         }
       }
     }
@@ -275,7 +352,12 @@ void (OutputFiles_PostProcessForGmshASCIIFileFormatVersion2_2)(OutputFiles_t* ou
 
   /* Record the results in the view files */
   {
-    int i_temps ;
+    int    nbofthreads = OutputFiles_ComputeNbOfPostProcessingThreads(n_dates) ;
+    size_t sizeofdate = 0 ;
+    char*  buffer ;
+    char*  line ;
+    size_t* length ;
+    int    i_temps0 ;
     
     /* First records */
     {
@@ -297,160 +379,195 @@ void (OutputFiles_PostProcessForGmshASCIIFileFormatVersion2_2)(OutputFiles_t* ou
     }
 
     
-    for(i_temps = 0 ; i_temps < n_dates ; i_temps++) {
-      TextFile_t* textfile = OutputFile_GetTextFile(outputfile + i_temps) ;
-      double temps ;
+    /* The sections of a date are printed in a buffer of the date.
+     * One date per thread is processed at a time. */
+    {
+      int i ;
 
-      /* Read the time */
-      {
-        char*  pline ;
+      for(i = 0 ; i < nbofglobalviews ; i++) {
+        sizeofdate += sizeofsection[i] ;
+      }
         
-        while((pline = OutputFiles_ReadLineFromCurrentFilePosition(outputfiles,textfile))) {
+      buffer = (char*) Mry_NewIn(Output,char[nbofthreads*sizeofdate]) ;
+      line   = (char*) Mry_NewIn(Output,char[nbofthreads*OutputFiles_MaxLengthOfTextLine]) ;
+      length = (size_t*) Mry_NewIn(Output,size_t[nbofthreads*nbofglobalviews]) ;
+    }
       
-          if(pline[0] == '#') {
         
-            /* Time */
-            if(strstr(pline,"temps") || strstr(pline,"Time")) {
+    for(i_temps0 = 0 ; i_temps0 < n_dates ; i_temps0 += nbofthreads) {
+      int nbofdates = Math_Min(nbofthreads,n_dates - i_temps0) ;
+      int error = 0 ;
+      int k ;
           
-              pline = strchr(pline,'=') + 1 ;
+      /* Parse the date files and print the sections in the buffers.
+       * No error is raised in the parallel loop but after it. */
+      #ifdef _OPENMP
+      #pragma omp parallel for schedule(dynamic,1) reduction(|:error) if(nbofdates > 1)
+      #endif
+      for(k = 0 ; k < nbofdates ; k++) {
+        int    i_temps = i_temps0 + k ;
+        TextFile_t* textfile = OutputFile_GetTextFile(outputfile + i_temps) ;
+        char*  line_k = line + k*OutputFiles_MaxLengthOfTextLine ;
+        char*  section[OutputFiles_MaxNbOfViews] ;
+        char*  c[OutputFiles_MaxNbOfViews] ;
+        double temps = 0 ;
           
-              sscanf(pline,"%le",&temps) ;
+        {
+          char* sec = buffer + k*sizeofdate ;
+          int i ;
             
-              break ;
-            }
-        
+          for(i = 0 ; i < nbofglobalviews ; i++) {
+            section[i] = sec ;
+            c[i] = sec ;
+            sec += sizeofsection[i] ;
           }
         }
-      }
-  
-      /* Build a section $ElementNodeData/$EndElementNodeData for each time step */
-      {
-        int    ie ;
-        
 
-        /* First records of the section */
+        /* Read the time */
         {
-          int    i ;
-          
-          for(i = 0 ; i < nbofglobalviews ; i++) {
-            View_t* view = Views_GetView(globalviews) + i ;
-            char*  nameofview = View_GetNameOfView(view) ;
-            int    nbcompofview = View_GetNbOfComponents(view) ;
-            FILE*  ficp = fileofview[i] ;
-            int    nb_string_tags  = 1 ;
-            int    nb_real_tags    = 1 ;
-            int    nb_integer_tags = 4 ;
-            int    partition = 0 ;
+          char*  pline ;
 
-      
-            fprintf(ficp,"$ElementNodeData\n") ;
-            fprintf(ficp,"%d\n",nb_string_tags) ;
-            fprintf(ficp,"\"%s\"\n",nameofview) ;
-            fprintf(ficp,"%d\n",nb_real_tags) ;
-            fprintf(ficp,"%e\n",temps) ;
-            fprintf(ficp,"%d\n",nb_integer_tags) ;
-            fprintf(ficp,"%d\n",i_temps) ;
-            fprintf(ficp,"%d\n",nbcompofview) ;
-            fprintf(ficp,"%d\n",nbofrecords[i]) ;
-            fprintf(ficp,"%d\n",partition) ;
+          while((pline = TextFile_ReadLineFromCurrentFilePosition(textfile,line_k,OutputFiles_MaxLengthOfTextLine))) {
+
+            if(pline[0] == '#') {
+
+              /* Time */
+              if(strstr(pline,"temps") || strstr(pline,"Time")) {
+
+                pline = strchr(pline,'=') + 1 ;
+
+                sscanf(pline,"%le",&temps) ;
+
+                break ;
+              }
+
+            }
           }
         }
 
-        
-        /* Record the results per element */
-        for(ie = 0 ; ie < n_el ; ie++) {
-          Element_t*  elt = el + ie ;
-          Material_t* mat = Element_GetMaterial(elt) ;
-          char* codename = Material_GetCodeNameOfModel(mat) ;
-          int usedmodelindex = Models_FindModelIndex(usedmodels,codename) ;
-          Model_t*  usedmodel = Models_GetModel(usedmodels) + usedmodelindex ;
-          Views_t*  views = Model_GetViews(usedmodel) ;
-          int nviews = Views_GetNbOfViews(views) ;
-          View_t*   view  = Views_GetView(views) ;
-          int    nn = Element_GetNbOfNodes(elt) ;
+        /* Build a section $ElementNodeData/$EndElementNodeData for each time step */
+        {
+          int    ie ;
 
-          double val[OutputFiles_MaxNbOfViews][9*Element_MaxNbOfNodes] ;
-          
-          if(usedmodelindex < 0) {
-            arret("OutputFiles_PostProcessForGmshASCIIFileFormat") ;
+
+          /* First records of the section */
+          {
+            int    i ;
+
+            for(i = 0 ; i < nbofglobalviews ; i++) {
+              View_t* view = Views_GetView(globalviews) + i ;
+              char*  nameofview = View_GetNameOfView(view) ;
+              int    nbcompofview = View_GetNbOfComponents(view) ;
+              int    nb_string_tags  = 1 ;
+              int    nb_real_tags    = 1 ;
+              int    nb_integer_tags = 4 ;
+              int    partition = 0 ;
+
+
+              c[i] += sprintf(c[i],"$ElementNodeData\n") ;
+              c[i] += sprintf(c[i],"%d\n",nb_string_tags) ;
+              c[i] += sprintf(c[i],"\"%s\"\n",nameofview) ;
+              c[i] += sprintf(c[i],"%d\n",nb_real_tags) ;
+              c[i] += sprintf(c[i],"%e\n",temps) ;
+              c[i] += sprintf(c[i],"%d\n",nb_integer_tags) ;
+              c[i] += sprintf(c[i],"%d\n",i_temps) ;
+              c[i] += sprintf(c[i],"%d\n",nbcompofview) ;
+              c[i] += sprintf(c[i],"%d\n",nbofrecords[i]) ;
+              c[i] += sprintf(c[i],"%d\n",partition) ;
+            }
           }
-          
-          /* We skip elements of the boundaries 
-           * (see OutputFiles_BackupSolutionAtTime) */
-          if(Element_IsSubmanifold(elt)) continue ;
 
-          if(!mat) continue ;
 
-          
-          /* Read the values */
-          {
-            int    in ;
-            
-            for(in = 0 ; in < nn ; in++) {
-              char* pline = OutputFiles_ReadLineFromCurrentFilePosition(outputfiles,textfile) ;
-              double x[3] ;
+          /* Record the results per element */
+          for(ie = 0 ; ie < n_el ; ie++) {
+            Element_t*  elt = el + ie ;
+            Material_t* mat = Element_GetMaterial(elt) ;
+            char* codename = Material_GetCodeNameOfModel(mat) ;
+            int usedmodelindex = Models_FindModelIndex(usedmodels,codename) ;
+            Model_t*  usedmodel = Models_GetModel(usedmodels) + usedmodelindex ;
+            Views_t*  views = Model_GetViews(usedmodel) ;
+            int nviews = Views_GetNbOfViews(views) ;
+            View_t*   view  = Views_GetView(views) ;
+            int    nn = Element_GetNbOfNodes(elt) ;
+
+            double x[3*Element_MaxNbOfNodes] ;
+            double val[OutputFiles_MaxNbOfViews][9*Element_MaxNbOfNodes] ;
+
+            if(usedmodelindex < 0) {
+              error = 1 ;
+              break ;
+            }
+        
+            /* We skip elements of the boundaries
+             * (see OutputFiles_BackupSolutionAtTime) */
+            if(Element_IsSubmanifold(elt)) continue ;
+
+            if(!mat) continue ;
+
+
+            /* Read the values */
+            OutputFiles_ReadElementRecords(textfile,line_k,nn,views,x,val) ;
+
+            /* Print these values in the buffers */
+            {
               int i ;
-                  
-              /* We skip the commented lines */
-              while(pline[0] == '#') {
-                pline = OutputFiles_ReadLineFromCurrentFilePosition(outputfiles,textfile) ;
-              }
 
-              /* Coordinates of nodes */
-              for(i = 0 ; i < 3 ; i++) {
-                sscanf(pline,"%le",x + i) ;
-                pline  = strchr(pline,' ') ;
-                pline += strspn(pline," ") ;
-              }
-            
-              /* Values */
               for(i = 0 ; i < nviews ; i++) {
                 int    nc = View_GetNbOfComponents(view + i) ;
+                int    jview = View_GetGlobalIndex(view + i) ;
+                char*  cj = c[jview] ;
                 int    j ;
-              
-                for(j = 0 ; j < nc ; j++) {
-                  sscanf(pline,"%le",val[i] + nc*in + j) ;
-                  pline  = strchr(pline,' ') ;
-                  pline += strspn(pline," ") ;
+
+                cj += sprintf(cj,"%d %d",ie + 1,nn) ;
+
+                for(j = 0 ; j < nc*nn ; j++) {
+                  cj += sprintf(cj," %e",val[i][j]) ;
                 }
+
+                cj += sprintf(cj,"\n") ;
+
+                c[jview] = cj ;
               }
             }
           }
 
-          /* Print these values in view files */
+
+          /* Last record of the views */
           {
             int i ;
-            
-            for(i = 0 ; i < nviews ; i++) {
-              int    nc = View_GetNbOfComponents(view + i) ;
-              int    jview = View_GetGlobalIndex(view + i) ;
-              FILE*  ficp = fileofview[jview] ;
-              int    j ;
-            
-              fprintf(ficp,"%d %d",ie + 1,nn) ;
-            
-              for(j = 0 ; j < nc*nn ; j++) {
-                fprintf(ficp," %e",val[i][j]) ;
-              }
-            
-              fprintf(ficp,"\n") ;
+
+            for(i = 0 ; i < nbofglobalviews ; i++) {
+              c[i] += sprintf(c[i],"$EndElementNodeData\n") ;
+
+              length[k*nbofglobalviews + i] = c[i] - section[i] ;
             }
           }
         }
-      
-      
-        /* Last record of the views */
-        {
-          int i ;
+      }
+  
         
-          for(i = 0 ; i < nbofglobalviews ; i++) {
-            FILE   *ficp = fileofview[i] ;
+      if(error) {
+        arret("OutputFiles_PostProcessForGmshASCIIFileFormat") ;
+      }
+  
         
-            fprintf(ficp,"$EndElementNodeData\n") ;
-          }
+      /* Write the buffers in the order of the dates */
+      for(k = 0 ; k < nbofdates ; k++) {
+        char* sec = buffer + k*sizeofdate ;
+        int i ;
+
+        for(i = 0 ; i < nbofglobalviews ; i++) {
+          FILE*  ficp = fileofview[i] ;
+          
+          fwrite(sec,1,length[k*nbofglobalviews + i],ficp) ;
+          sec += sizeofsection[i] ;
         }
       }
     }
+
+    Mry_Free(buffer) ;
+    Mry_Free(line) ;
+    Mry_Free(length) ;
   }
 
 
@@ -595,7 +712,13 @@ void (OutputFiles_PostProcessForGmshParsedFileFormatVersion2)(OutputFiles_t* out
   
   /* Record the results in the view files */
   {
-    int    ie ;
+    int    maxnbofrecords = OutputFiles_NbOfElementsPerBlock*OutputFiles_ComputeMaxNbOfViewsPerModel(usedmodels) ;
+    size_t* offset = (size_t*) Mry_NewIn(Output,size_t[maxnbofrecords + 1]) ;
+    size_t* length = (size_t*) Mry_NewIn(Output,size_t[n_dates*maxnbofrecords]) ;
+    char*  line = (char*) Mry_NewIn(Output,char[n_dates*OutputFiles_MaxLengthOfTextLine]) ;
+    char*  buffer = NULL ;
+    size_t sizeofbuffer = 0 ;
+    int    ie0 ;
     
     
     /* The first record is the name of the view */
@@ -612,123 +735,196 @@ void (OutputFiles_PostProcessForGmshParsedFileFormatVersion2)(OutputFiles_t* out
     }
 
 
-    /* Record the results per element */
-    for(ie = 0 ; ie < n_el ; ie++) {
-      Element_t* elt = el + ie ;
-      Material_t* mat = Element_GetMaterial(elt) ;
-      char* codename = Material_GetCodeNameOfModel(mat) ;
-      int usedmodelindex = Models_FindModelIndex(usedmodels,codename) ;
-      Model_t*  usedmodel = Models_GetModel(usedmodels) + usedmodelindex ;
-      Views_t*  views = Model_GetViews(usedmodel) ;
-      int nviews = Views_GetNbOfViews(views) ;
-      View_t*   view  = Views_GetView(views) ;
-      int    nn = Element_GetNbOfNodes(elt) ;
+    /* Record the results per block of elements. The records of
+     * a block are printed in a buffer per date, the dates being
+     * parsed in parallel, then merged in the view files. */
+    for(ie0 = 0 ; ie0 < n_el ; ie0 += OutputFiles_NbOfElementsPerBlock) {
+      int    ie1 = Math_Min(ie0 + OutputFiles_NbOfElementsPerBlock,n_el) ;
+      size_t sizeofdate ;
+      int    error = 0 ;
       int    i_temps ;
       
-      if(usedmodelindex < 0) {
-        arret("OutputFiles_PostProcessForGmshParsedFileFormat") ;
-      }
+      /* Upper bound of the size of the records of the block */
+      {
+        int nbofrecords = 0 ;
+        int ie ;
       
-      /* We skip elements of the boundaries 
-       * (see OutputFiles_BackupSolutionAtTime) */
-      if(Element_IsSubmanifold(elt)) continue ;
+        offset[0] = 0 ;
 
-      if(!mat) continue ;
+        for(ie = ie0 ; ie < ie1 ; ie++) {
+          Element_t* elt = el + ie ;
+          Material_t* mat = Element_GetMaterial(elt) ;
     
+          /* We skip elements of the boundaries
+           * (see OutputFiles_BackupSolutionAtTime) */
+          if(Element_IsSubmanifold(elt)) continue ;
     
-      for(i_temps = 0 ; i_temps < n_dates ; i_temps++) {
-        TextFile_t* textfile = OutputFile_GetTextFile(outputfile + i_temps) ;
-        double val[OutputFiles_MaxNbOfViews][9*Element_MaxNbOfNodes] ;
-        double x_e[3*Element_MaxNbOfNodes] ;
-        int    in ;
+          if(!mat) continue ;
       
-        for(in = 0 ; in < nn ; in++) {
-          char* pline = OutputFiles_ReadLineFromCurrentFilePosition(outputfiles,textfile) ;
-          int i ;
+          {
+            char* codename = Material_GetCodeNameOfModel(mat) ;
+            int usedmodelindex = Models_FindModelIndex(usedmodels,codename) ;
+            Model_t*  usedmodel = Models_GetModel(usedmodels) + usedmodelindex ;
+            Views_t*  views = Model_GetViews(usedmodel) ;
+            int nviews = Views_GetNbOfViews(views) ;
+            View_t*   view  = Views_GetView(views) ;
+            int    nn = Element_GetNbOfNodes(elt) ;
+            int i ;
           
-          /* We skip the commented lines */
-          while(pline[0] == '#') {
-            pline = OutputFiles_ReadLineFromCurrentFilePosition(outputfiles,textfile) ;
-          }
+            if(usedmodelindex < 0) {
+              arret("OutputFiles_PostProcessForGmshParsedFileFormat") ;
+            }
           
-          for(i = 0 ; i < 3 ; i++) {
-            sscanf(pline,"%le",x_e + 3*in + i) ;
-            pline  = strchr(pline,' ') ;
-            pline += strspn(pline," ") ;
-          }
+            for(i = 0 ; i < nviews ; i++) {
+              int    nc = View_GetNbOfComponents(view + i) ;
         
-          for(i = 0 ; i < nviews ; i++) {
-            int nc = View_GetNbOfComponents(view + i) ;
-            int j ;
-          
-            for(j = 0 ; j < nc ; j++) {
-              sscanf(pline,"%le",val[i] + nc*in + j) ;
-              pline  = strchr(pline,' ') ;
-              pline += strspn(pline," ") ;
+              offset[nbofrecords + 1] = offset[nbofrecords] + 8 + (3 + nc)*nn*OutputFiles_MaxLengthOfPrintedNumber ;
+              nbofrecords += 1 ;
             }
           }
         }
       
-        if(i_temps == 0) {
-          int i ;
+        sizeofdate = offset[nbofrecords] ;
           
-          for(i = 0 ; i < nviews ; i++) {
-            int    nvert = n_vertices[dim-1][nn-1] ;
-            int    nc = View_GetNbOfComponents(view + i) ;
-            int    jview = View_GetGlobalIndex(view + i) ;
-            FILE*  ficp = fileofview[jview] ;
-            int j ;
+        if(n_dates*sizeofdate > sizeofbuffer) {
+          Mry_Free(buffer) ;
+          sizeofbuffer = n_dates*sizeofdate ;
+          buffer = (char*) Mry_NewIn(Output,char[sizeofbuffer]) ;
+        }
+      }
 
-            if(nvert == 0) {
-              arret("OutputFiles_PostProcessForGmshParsedFileFormat (2): type non traite") ;
-            }
 
-            /* Type d'enregistrement */
-            fprintf(ficp,"%c",svt[nc - 1]) ;
-            fprintf(ficp,"%c",type[dim-1][nvert-1]) ;
-            if(nvert == nn/2) fprintf(ficp,"2") ; /* element P2 */
+      /* Parse the date files and print the records in the buffers.
+       * No error is raised in the parallel loop but after it. */
+      #ifdef _OPENMP
+      #pragma omp parallel for schedule(dynamic,1) num_threads(OutputFiles_ComputeNbOfPostProcessingThreads(n_dates)) reduction(|:error) if(n_dates > 1)
+      #endif
+      for(i_temps = 0 ; i_temps < n_dates ; i_temps++) {
+        TextFile_t* textfile = OutputFile_GetTextFile(outputfile + i_temps) ;
+        char*  line_t = line + i_temps*OutputFiles_MaxLengthOfTextLine ;
+        char*  buffer_t = buffer + i_temps*sizeofdate ;
+        size_t* length_t = length + i_temps*maxnbofrecords ;
+        int    irecord = 0 ;
+        int    ie ;
 
-            /* Coordonnees */
-            fprintf(ficp,"(%e",x_e[0]) ;
-            for(j = 1 ; j < 3*nn ; j++) {
-              fprintf(ficp,",%e",x_e[j]) ;
-            }
-            fprintf(ficp,")") ;
+        for(ie = ie0 ; ie < ie1 ; ie++) {
+          Element_t* elt = el + ie ;
+          Material_t* mat = Element_GetMaterial(elt) ;
+          double val[OutputFiles_MaxNbOfViews][9*Element_MaxNbOfNodes] ;
+          double x_e[3*Element_MaxNbOfNodes] ;
 
-            /* Valeurs */
-            fprintf(ficp,"{%e",val[i][0]) ;
-            for(j = 1 ; j < nc*nn ; j++) {
-              fprintf(ficp,",%e",val[i][j]) ;
-            }
-          }
+          if(Element_IsSubmanifold(elt)) continue ;
         
-        } else {
-          int i ;
+          if(!mat) continue ;
           
-          for(i = 0 ; i < nviews ; i++) {
-            int    nc = View_GetNbOfComponents(view + i) ;
-            int    jview = View_GetGlobalIndex(view + i) ;
-            FILE   *ficp = fileofview[jview] ;
-            int j ;
+          {
+            char* codename = Material_GetCodeNameOfModel(mat) ;
+            int usedmodelindex = Models_FindModelIndex(usedmodels,codename) ;
+            Model_t*  usedmodel = Models_GetModel(usedmodels) + usedmodelindex ;
+            Views_t*  views = Model_GetViews(usedmodel) ;
+            int nviews = Views_GetNbOfViews(views) ;
+            View_t*   view  = Views_GetView(views) ;
+            int    nn = Element_GetNbOfNodes(elt) ;
+            int i ;
           
-            for(j = 0 ; j < nc*nn ; j++) {
-              fprintf(ficp,",%e",val[i][j]) ;
+            OutputFiles_ReadElementRecords(textfile,line_t,nn,views,x_e,val) ;
+
+            for(i = 0 ; i < nviews ; i++) {
+              int    nc = View_GetNbOfComponents(view + i) ;
+              char*  c0 = buffer_t + offset[irecord] ;
+              char*  c  = c0 ;
+              int j ;
+
+              if(i_temps == 0) {
+                int    nvert = n_vertices[dim-1][nn-1] ;
+
+                if(nvert == 0) {
+                  error = 1 ;
+                  break ;
+                }
+
+                /* Type d'enregistrement */
+                c += sprintf(c,"%c",svt[nc - 1]) ;
+                c += sprintf(c,"%c",type[dim-1][nvert-1]) ;
+                if(nvert == nn/2) c += sprintf(c,"2") ; /* element P2 */
+
+                /* Coordonnees */
+                c += sprintf(c,"(%e",x_e[0]) ;
+                for(j = 1 ; j < 3*nn ; j++) {
+                  c += sprintf(c,",%e",x_e[j]) ;
+                }
+                c += sprintf(c,")") ;
+
+                /* Valeurs */
+                c += sprintf(c,"{%e",val[i][0]) ;
+                for(j = 1 ; j < nc*nn ; j++) {
+                  c += sprintf(c,",%e",val[i][j]) ;
+                }
+
+              } else {
+
+                for(j = 0 ; j < nc*nn ; j++) {
+                  c += sprintf(c,",%e",val[i][j]) ;
+                }
+              }
+
+              length_t[irecord] = c - c0 ;
+              irecord += 1 ;
             }
           }
         }
       }
       
+      if(error) {
+        arret("OutputFiles_PostProcessForGmshParsedFileFormat (2): type non traite") ;
+      }
+      
+
+      /* Merge the buffers in the view files in the order of the dates */
       {
-        int i ;
+        int irecord = 0 ;
+        int ie ;
         
-        for(i = 0 ; i < nviews ; i++) {
-          int    jview = View_GetGlobalIndex(view + i) ;
-          FILE   *ficp = fileofview[jview] ;
+        for(ie = ie0 ; ie < ie1 ; ie++) {
+          Element_t* elt = el + ie ;
+          Material_t* mat = Element_GetMaterial(elt) ;
       
-          fprintf(ficp,"};\n") ;
+          if(Element_IsSubmanifold(elt)) continue ;
+
+          if(!mat) continue ;
+
+          {
+            char* codename = Material_GetCodeNameOfModel(mat) ;
+            int usedmodelindex = Models_FindModelIndex(usedmodels,codename) ;
+            Model_t*  usedmodel = Models_GetModel(usedmodels) + usedmodelindex ;
+            Views_t*  views = Model_GetViews(usedmodel) ;
+            int nviews = Views_GetNbOfViews(views) ;
+            View_t*   view  = Views_GetView(views) ;
+            int i ;
+
+            for(i = 0 ; i < nviews ; i++) {
+              int    jview = View_GetGlobalIndex(view + i) ;
+              FILE   *ficp = fileofview[jview] ;
+
+              for(i_temps = 0 ; i_temps < n_dates ; i_temps++) {
+                char*  c = buffer + i_temps*sizeofdate + offset[irecord] ;
+                size_t n = length[i_temps*maxnbofrecords + irecord] ;
+
+                fwrite(c,1,n,ficp) ;
+              }
+
+              fprintf(ficp,"};\n") ;
+              irecord += 1 ;
+            }
+          }
         }
       }
     }
+
+    Mry_Free(buffer) ;
+    Mry_Free(line) ;
+    Mry_Free(length) ;
+    Mry_Free(offset) ;
     
     
     /* Last record of the views */
@@ -832,6 +1028,8 @@ void (OutputFiles_BackupSolutionAtTime_)(OutputFiles_t* outputfiles,DataSet_t* d
           int    nso ;
           int    j,k ;
         
+          OutputFiles_SelectViews(outputfiles,dataset,elt,r_s,-1) ;
+          
           Element_FreeBuffer(elt) ;
           nso = Element_ComputeOutputs(elt,t,x_s,r_s) ;
           
@@ -841,16 +1039,20 @@ void (OutputFiles_BackupSolutionAtTime_)(OutputFiles_t* outputfiles,DataSet_t* d
 
           if(nso == 0) continue ;
           
+          OutputFiles_SelectViews(outputfiles,dataset,elt,r_s,nso) ;
+          
           /* Headings: Model and views */
           if(entete == 0) {
             entete = 1 ;
             headings[usedmodelindex] = 1 ;
             fprintf(fict,"# Model = %s\n",codename) ;
-            fprintf(fict,"# Number of views = %d\n",nso) ;
+            fprintf(fict,"# Number of views = %d\n",OutputFiles_CountSelectedViews(r_s,nso)) ;
             fprintf(fict,"# Numbers of components per view =") ;
             for(k = 0 ; k < nso ; k++) {
               int n = Result_GetNbOfValues(r_s + k) ;
               
+              if(!Result_IsRequested(r_s + k)) continue ;
+              
               fprintf(fict," %d",n) ;
             }
             fprintf(fict,"\n") ;
@@ -860,6 +1062,8 @@ void (OutputFiles_BackupSolutionAtTime_)(OutputFiles_t* outputfiles,DataSet_t* d
             for(k = 0 ; k < nso ; k++) {
               char* name = Result_GetNameOfView(r_s + k) ;
               
+              if(!Result_IsRequested(r_s + k)) continue ;
+              
               fprintf(fict," %s(%d)",name,j) ;
               j += Result_GetNbOfValues(r_s + k) ;
             }
@@ -879,6 +1083,8 @@ void (OutputFiles_BackupSolutionAtTime_)(OutputFiles_t* outputfiles,DataSet_t* d
           for(k = 0 ; k < nso ; k++) {
             int n_r = Result_GetNbOfValues(r_s + k) ;
             
+            if(!Result_IsRequested(r_s + k)) continue ;
+            
             for(j = 0 ; j < n_r ; j++) {
               fprintf(fict,OutputFiles_RecordNumberFormat,Result_GetValue(r_s + k)[j]) ;
             }
@@ -900,7 +1106,8 @@ void (OutputFiles_BackupSolutionAtTime_)(OutputFiles_t* outputfiles,DataSet_t* d
 
 
 void (OutputFiles_BackupSolutionAtPoint_)(OutputFiles_t* outputfiles,DataSet_t* dataset,double t,double t_0)
-/* Backup solutions at given points in the approriate output files */
+/* Backup solutions at given points in the approriate output files.
+ * The records are buffered and written when a buffer is full. */
 {
   Mesh_t* mesh = DataSet_GetMesh(dataset) ;
   Points_t* points = DataSet_GetPoints(dataset) ;
@@ -910,6 +1117,8 @@ void (OutputFiles_BackupSolutionAtPoint_)(OutputFiles_t* outputfiles,DataSet_t*
   OutputFile_t* outputfile = OutputFiles_GetPointOutputFile(outputfiles) ;
   
   Result_t* r_s = Results_GetResult(OutputFiles_GetResults(outputfiles)) ;
+  int*   nbofvalues = OutputFiles_GetNbOfBufferedValues(outputfiles) ;
+  int*   recordlength = OutputFiles_GetPointRecordLength(outputfiles) ;
   int    p ;
   
   OutputFile_TypeOfCurrentFile = 'p' ;
@@ -921,9 +1130,40 @@ void (OutputFiles_BackupSolutionAtPoint_)(OutputFiles_t* outputfiles,DataSet_t*
       TextFile_t* textfile = OutputFile_GetTextFile(outputfile + p) ;
       
       TextFile_OpenFile(textfile,"w") ;
+      
+      nbofvalues[p] = 0 ;
+    }
+    
+    OutputFiles_GetPointStepIndex(outputfiles) = 0 ;
+    OutputFiles_GetPointFormat(outputfiles) = Points_GetOutputFormat(points) ;
+    
+  /* Skip the steps in between the outputs, except those reaching a date */
+  } else {
+    int    period = Points_GetOutputPeriod(points) ;
+    double interval = Points_GetOutputInterval(points) ;
+    double t_p = OutputFiles_GetPointTime(outputfiles) ;
+    Dates_t* dates = DataSet_GetDates(dataset) ;
+    Date_t* date = Dates_GetDate(dates) ;
+    int    n_dates = Dates_GetNbOfDates(dates) ;
+    int    i ;
+    
+    OutputFiles_GetPointStepIndex(outputfiles) += 1 ;
+    
+    for(i = 0 ; i < n_dates ; i++) {
+      double t_i = Date_GetTime(date + i) ;
+      
+      if(t_p < t_i && t_i <= t) break ;
+    }
+    
+    if(i == n_dates) {
+      if(OutputFiles_GetPointStepIndex(outputfiles) % period) return ;
+    
+      if(t - t_p < interval) return ;
     }
   }
   
+  OutputFiles_GetPointTime(outputfiles) = t ;
+  
   
   for(p = 0 ; p < npt ; p++) {
     TextFile_t* textfile = OutputFile_GetTextFile(outputfile + p) ;
@@ -953,24 +1193,37 @@ void (OutputFiles_BackupSolutionAtPoint_)(OutputFiles_t* outputfiles,DataSet_t*
       if(mat) {
         char*  codename = Material_GetCodeNameOfModel(mat) ;
         int    nso ;
+        int    len = 1 ;
         int    i ;
         
+        OutputFiles_SelectViews(outputfiles,dataset,elt,r_s,-1) ;
+        
         Element_FreeBuffer(elt) ;
         nso = Element_ComputeOutputs(elt,t,xp,r_s) ;
         
         if(nso > OutputFiles_MaxNbOfViews) {
           arret("BackupSolutionAtPoint: too much values") ;
         }
+        
+        OutputFiles_SelectViews(outputfiles,dataset,elt,r_s,nso) ;
+        
+        for(i = 0 ; i < nso ; i++) {
+          if(Result_IsRequested(r_s + i)) {
+            len += Result_GetNbOfValues(r_s + i) ;
+          }
+        }
   
         /* Headings: Model and views */
         if(t == t_0) {
           int    j ;
           
           fprintf(ficp,"# Model = %s\n",codename) ;
-          fprintf(ficp,"# Number of views = %d\n",nso) ;
+          fprintf(ficp,"# Number of views = %d\n",OutputFiles_CountSelectedViews(r_s,nso)) ;
           fprintf(ficp,"# Numbers of components per view =") ;
           for(i = 0 ; i < nso ; i++) {
             int n = Result_GetNbOfValues(r_s + i) ;
+            
+            if(!Result_IsRequested(r_s + i)) continue ;
               
             fprintf(ficp," %d",n) ;
           }
@@ -981,38 +1234,195 @@ void (OutputFiles_BackupSolutionAtPoint_)(OutputFiles_t* outputfiles,DataSet_t*
           for(i = 0 ; i < nso ; i++) {
             char* name = Result_GetNameOfView(r_s + i) ;
             
+            if(!Result_IsRequested(r_s + i)) continue ;
+            
             fprintf(ficp," %s(%d)",name,j) ;
             j += Result_GetNbOfValues(r_s + i) ;
           }
           fprintf(ficp,"\n") ;
+          
+          if(Points_IsBinaryOutput(points)) {
+            fprintf(ficp,"# Binary records of %d doubles\n",len) ;
+          }
+        }
+        
+        /* Make room in the buffer */
+        if(nbofvalues[p] + len > OutputFiles_SizeOfPointBuffer) {
+          OutputFiles_FlushPointFile(outputfiles,p) ;
         }
   
-        /* Results per line */
-        /* 1. Time */
-        fprintf(ficp,OutputFiles_RecordNumberFormat,t) ;
+        /* Results per record */
+        {
+          double* record = OutputFiles_GetPointBuffer(outputfiles) + p*OutputFiles_SizeOfPointBuffer + nbofvalues[p] ;
+          int    k = 0 ;
+          
+          /* 1. Time */
+          record[k++] = t ;
         
-        /* 2. Components of views */
-        for(i = 0 ; i < nso ; i++) {
-          int n_r = Result_GetNbOfValues(r_s + i) ;
-          int    j ;
+          /* 2. Components of views */
+          for(i = 0 ; i < nso ; i++) {
+            int n_r = Result_GetNbOfValues(r_s + i) ;
+            int    j ;
+            
+            if(!Result_IsRequested(r_s + i)) continue ;
           
-          for(j = 0 ; j < n_r ; j++) {
-            fprintf(ficp,OutputFiles_RecordNumberFormat,Result_GetValue(r_s + i)[j]) ;
+            for(j = 0 ; j < n_r ; j++) {
+              record[k++] = Result_GetValue(r_s + i)[j] ;
+            }
           }
+          
+          nbofvalues[p] += len ;
+          recordlength[p] = len ;
         }
+      }
+    }
+  }
+}
+
+
+
+void (OutputFiles_FlushPointFiles)(OutputFiles_t* outputfiles)
+/* Write the records buffered for all the points */
+{
+  int n_points = OutputFiles_GetNbOfPointFiles(outputfiles) ;
+  int p ;
+  
+  for(p = 0 ; p < n_points ; p++) {
+    OutputFiles_FlushPointFile(outputfiles,p) ;
+  }
+}
+
+
+
+void (OutputFiles_ResumePointFiles)(OutputFiles_t* outputfiles,DataSet_t* dataset,long int* size)
+/* Reopen the point files of a previous run to append the next records.
+ * The files are first cut to their sizes size[p] at the time the run
+ * is resumed from, the records written afterwards being dropped. */
+{
+  Points_t* points = DataSet_GetPoints(dataset) ;
+  OutputFile_t* outputfile = OutputFiles_GetPointOutputFile(outputfiles) ;
+  int n_points = OutputFiles_GetNbOfPointFiles(outputfiles) ;
+  int p ;
+  
+  for(p = 0 ; p < n_points ; p++) {
+    TextFile_t* textfile = OutputFile_GetTextFile(outputfile + p) ;
+    char* name = TextFile_GetFileName(textfile) ;
+    
+    TextFile_CloseFile(textfile) ;
+    
+    if(truncate(name,size[p])) {
+      arret("OutputFiles_ResumePointFiles: can't resume %s",name) ;
+    }
+    
+    TextFile_OpenFile(textfile,"a") ;
+    
+    OutputFiles_GetNbOfBufferedValues(outputfiles)[p] = 0 ;
+  }
+  
+  OutputFiles_GetPointFormat(outputfiles) = Points_GetOutputFormat(points) ;
+}
+
+
+
+void (OutputFiles_FlushPointFile)(OutputFiles_t* outputfiles,int p)
+/* Write the records buffered for the point p */
+{
+  OutputFile_t* outputfile = OutputFiles_GetPointOutputFile(outputfiles) ;
+  TextFile_t* textfile = OutputFile_GetTextFile(outputfile + p) ;
+  FILE *ficp = TextFile_GetFileStream(textfile) ;
+  int    n = OutputFiles_GetNbOfBufferedValues(outputfiles)[p] ;
+  int    len = OutputFiles_GetPointRecordLength(outputfiles)[p] ;
+  double* record = OutputFiles_GetPointBuffer(outputfiles) + p*OutputFiles_SizeOfPointBuffer ;
+  
+  if(!ficp || n == 0) return ;
+  
+  if(OutputFiles_GetPointFormat(outputfiles) == 'b') {
+    fwrite(record,sizeof(double),n,ficp) ;
+  } else {
+    int    i ;
+    
+    for(i = 0 ; i < n ; i++) {
+      fprintf(ficp,OutputFiles_RecordNumberFormat,record[i]) ;
+      
+      /* End of line */
+      if((i + 1) % len == 0) fprintf(ficp,"\n") ;
+    }
+  }
+  
+  OutputFiles_GetNbOfBufferedValues(outputfiles)[p] = 0 ;
+  
+  /* We clean the stream */
+  TextFile_CleanTheStream(textfile) ;
+}
+
+
+
+void (OutputFiles_SelectViews)(OutputFiles_t* outputfiles,DataSet_t* dataset,Element_t* elt,Result_t* r_s,int nso)
+/* Set the views requested from the element elt in r_s. Before the
+ * outputs are computed (nso < 0) the mask of the model is applied if
+ * known. After (nso >= 0) the mask of the model is built from the
+ * names of its nso views the first time, then applied. */
+{
+  Views_t* views = DataSet_GetRequestedViews(dataset) ;
+  
+  if(views) {
+    Materials_t* materials = DataSet_GetMaterials(dataset) ;
+    Models_t* usedmodels = Materials_GetUsedModels(materials) ;
+    char* codename = Material_GetCodeNameOfModel(Element_GetMaterial(elt)) ;
+    int usedmodelindex = Models_FindModelIndex(usedmodels,codename) ;
+    char* mask ;
+    int*  nmask ;
+    int i ;
+    
+    if(usedmodelindex < 0 || usedmodelindex >= OutputFiles_MaxNbOfUsedModels) {
+      arret("OutputFiles_SelectViews: too many used models") ;
+    }
+    
+    mask  = OutputFiles_GetViewMask(outputfiles) + usedmodelindex*OutputFiles_MaxNbOfViews ;
+    nmask = OutputFiles_GetNbOfMaskedViews(outputfiles) + usedmodelindex ;
+    
+    if(nso > 0 && *nmask < 0) {
+      for(i = 0 ; i < nso ; i++) {
+        char* name = Result_GetNameOfView(r_s + i) ;
         
-        /* 3. End of line */
-        fprintf(ficp,"\n") ;
+        mask[i] = (Views_FindViewIndex(views,name) >= 0) ;
       }
+      
+      *nmask = nso ;
     }
     
-    /* We clean the stream */
-    TextFile_CleanTheStream(textfile) ;
+    for(i = 0 ; i < OutputFiles_MaxNbOfViews ; i++) {
+      Result_GetRequest(r_s + i) = (i >= *nmask || mask[i]) ;
+    }
   }
 }
 
 
 
+int (OutputFiles_CountSelectedViews)(Result_t* r_s,int nso)
+{
+  int n = 0 ;
+  int i ;
+  
+  for(i = 0 ; i < nso ; i++) {
+    if(Result_IsRequested(r_s + i)) n++ ;
+  }
+  
+  return(n) ;
+}
+
+
+
+void (OutputFiles_FlushPointFilesAtExit)(void)
+/* Write the records left in the buffers when the program stops */
+{
+  OutputFiles_t* outputfiles = OutputFiles_Buffered ;
+  
+  if(outputfiles) OutputFiles_FlushPointFiles(outputfiles) ;
+}
+
+
+
 Views_t* (OutputFiles_CreateGlobalViews)(OutputFiles_t* outputfiles,Models_t* usedmodels,TextFile_t* textfile)
 /* We use informations found in the date file textfile to build the global views and 
  * initialize the local views per used model including the index in the global views.
@@ -1166,3 +1576,77 @@ Views_t* (OutputFiles_CreateGlobalViews)(OutputFiles_t* outputfiles,Models_t* us
   }
   
 }
+
+
+
+void (OutputFiles_ReadElementRecords)(TextFile_t* textfile,char* line,int nn,Views_t* views,double* x,double (*val)[9*Element_MaxNbOfNodes])
+/** Read the records of the nn nodes of an element in the date file
+ *  textfile, using line as the line buffer. Store the coordinates in x
+ *  and the values of the views in val. */
+{
+  int nviews = Views_GetNbOfViews(views) ;
+  View_t* view = Views_GetView(views) ;
+  int in ;
+  
+  for(in = 0 ; in < nn ; in++) {
+    char* pline = TextFile_ReadLineFromCurrentFilePosition(textfile,line,OutputFiles_MaxLengthOfTextLine) ;
+    int i ;
+    
+    /* We skip the commented lines */
+    while(pline[0] == '#') {
+      pline = TextFile_ReadLineFromCurrentFilePosition(textfile,line,OutputFiles_MaxLengthOfTextLine) ;
+    }
+    
+    /* Coordinates of nodes */
+    for(i = 0 ; i < 3 ; i++) {
+      x[3*in + i] = strtod(pline,NULL) ;
+      pline  = strchr(pline,' ') ;
+      pline += strspn(pline," ") ;
+    }
+    
+    /* Values */
+    for(i = 0 ; i < nviews ; i++) {
+      int    nc = View_GetNbOfComponents(view + i) ;
+      int    j ;
+      
+      for(j = 0 ; j < nc ; j++) {
+        val[i][nc*in + j] = strtod(pline,NULL) ;
+        pline  = strchr(pline,' ') ;
+        pline += strspn(pline," ") ;
+      }
+    }
+  }
+}
+
+
+
+int (OutputFiles_ComputeNbOfPostProcessingThreads)(int n_dates)
+/** Return the nb of threads parsing the date files (at most one per date) */
+{
+  int n = 1 ;
+  
+  #ifdef _OPENMP
+  n = omp_get_max_threads() ;
+  #endif
+  
+  return(Math_Max(1,Math_Min(n,n_dates))) ;
+}
+
+
+
+int (OutputFiles_ComputeMaxNbOfViewsPerModel)(Models_t* usedmodels)
+/** Return the max nb of views of the used models */
+{
+  int n_usedmodels = Models_GetNbOfModels(usedmodels) ;
+  int nmax = 0 ;
+  int i ;
+  
+  for(i = 0 ; i < n_usedmodels ; i++) {
+    Model_t* usedmodel = Models_GetModel(usedmodels) + i ;
+    int nviews = Views_GetNbOfViews(Model_GetViews(usedmodel)) ;
+    
+    nmax = Math_Max(nmax,nviews) ;
+  }
+  
+  return(nmax) ;
+}
@@ -19,6 +19,8 @@ extern void    (OutputFiles_PostProcessForGmshParsedFileFormat)(OutputFiles_t*,D
 extern void    (OutputFiles_PostProcessForGmshASCIIFileFormat)(OutputFiles_t*,DataSet_t*) ;
 extern void    (OutputFiles_BackupSolutionAtTime_)(OutputFiles_t*,DataSet_t*,double,int) ;
 extern void    (OutputFiles_BackupSolutionAtPoint_)(OutputFiles_t*,DataSet_t*,double,double) ;
+extern void    (OutputFiles_FlushPointFiles)(OutputFiles_t*) ;
+extern void    (OutputFiles_ResumePointFiles)(OutputFiles_t*,DataSet_t*,long int*) ;
 
 
 /* Function-like macros */
@@ -47,6 +49,18 @@ extern void    (OutputFiles_BackupSolutionAtPoint_)(OutputFiles_t*,DataSet_t*,do
 #define OutputFiles_RecordNumberFormat     "% -14.6e "
 #define OutputFiles_RecordNumberLength     (14)
 
+/* Upper bound of the length of a number printed with ",%e" */
+#define OutputFiles_MaxLengthOfPrintedNumber  (16)
+
+/* The post-processing in parsed file format merges the dates
+ * per block of elements */
+#define OutputFiles_NbOfElementsPerBlock   (256)
+
+#define OutputFiles_MaxNbOfUsedModels      (10)
+
+/* The records of each point file are buffered (nb of values) */
+#define OutputFiles_SizeOfPointBuffer      (8192)
+
 
 #define OutputFiles_GetDataFileName(OFS)            ((OFS)->filename)
 #define OutputFiles_GetNbOfDateFiles(OFS)           ((OFS)->n_dates)
@@ -57,6 +71,14 @@ extern void    (OutputFiles_BackupSolutionAtPoint_)(OutputFiles_t*,DataSet_t*,do
 #define OutputFiles_GetDateOutputFile(OFS)          ((OFS)->dateoutputfile)
 #define OutputFiles_GetPointOutputFile(OFS)         ((OFS)->pointoutputfile)
 #define OutputFiles_GetResults(OFS)                 ((OFS)->results)
+#define OutputFiles_GetPointBuffer(OFS)             ((OFS)->pointbuffer)
+#define OutputFiles_GetNbOfBufferedValues(OFS)      ((OFS)->nbofbufferedvalues)
+#define OutputFiles_GetPointRecordLength(OFS)       ((OFS)->pointrecordlength)
+#define OutputFiles_GetPointStepIndex(OFS)          ((OFS)->pointstepindex)
+#define OutputFiles_GetPointTime(OFS)               ((OFS)->pointtime)
+#define OutputFiles_GetPointFormat(OFS)             ((OFS)->pointformat)
+#define OutputFiles_GetViewMask(OFS)                ((OFS)->viewmask)
+#define OutputFiles_GetNbOfMaskedViews(OFS)         ((OFS)->nbofmaskedviews)
 
 //#define OutputFiles_GetDateFile(OFS)                ((OFS)->datefile)
 //#define OutputFiles_GetDateFile(OFS)                (OutputFile_GetTextFile(OutputFiles_GetDateOutputFile(OFS)))
@@ -85,6 +107,14 @@ struct OutputFiles_s {            /* Output files */
   OutputFile_t* pointoutputfile ; /* The point output files */
   Results_t*    results ;         /* Allocated space for the results */
   char* line ;                    /* Pointer to text lines */
+  double* pointbuffer ;           /* Buffered records of the point files */
+  int*   nbofbufferedvalues ;     /* Nb of buffered values per point file */
+  int*   pointrecordlength ;      /* Nb of values per record of the point files */
+  int    pointstepindex ;         /* Nb of steps since the first point outputs */
+  double pointtime ;              /* Time of the last point outputs */
+  char   pointformat ;            /* Format of the point files ('a' or 'b') */
+  char*  viewmask ;               /* Views requested per used model */
+  int*   nbofmaskedviews ;        /* Nb of views of the masks (-1 if unknown yet) */
 } ;
 
 
@@ -2,27 +2,20 @@
 #include "Message.h"
 #include "Result.h"
 #include "View.h"
+#include "Mry.h"
 
 
 
 
 Result_t* Result_Create(int n)
 {
-  Result_t* result = (Result_t*) malloc(n*sizeof(Result_t)) ;
-  
-  if(!result) {
-    arret("Result_Create(1)") ;
-  }
+  Result_t* result = (Result_t*) Mry_NewIn(Output,Result_t[n]) ;
   
   /* Allocate memory for the values */
   {
-    double* v = (double*) malloc(n*9*sizeof(double)) ;
+    double* v = (double*) Mry_NewIn(Output,double[n*9]) ;
     int i ;
     
-    if(!v) {
-      arret("Result_Create(2)") ;
-    }
-    
     for(i = 0 ; i < n ; i++) {
       Result_GetValue(result + i)   = v + 9*i ; ;
     }
@@ -40,6 +33,15 @@ Result_t* Result_Create(int n)
     }
   }
   
+  /* All the views are requested by default */
+  {
+    int i ;
+    
+    for(i = 0 ; i < n ; i++) {
+      Result_GetRequest(result + i) = 1 ;
+    }
+  }
+  
   return(result) ;
 }
 
@@ -53,8 +55,8 @@ void Result_Delete(void* self)
   
   View_Delete(&view) ;
   
-  free(Result_GetValue(result)) ;
-  free(result) ;
+  Mry_Free(Result_GetValue(result)) ;
+  Mry_Free(result) ;
   *presult = NULL ;
 }
 
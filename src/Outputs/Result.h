@@ -17,6 +17,7 @@ extern void      Result_SetValuesToZero(Result_t*) ;
 
 #define Result_GetValue(result)           ((result)->v)
 #define Result_GetView(result)            ((result)->view)
+#define Result_GetRequest(result)         ((result)->request)
 /* These 2 next attributes should be eliminated (used in old models only) */
 #define Result_GetNbOfValues(result)      ((result)->n)
 #define Result_GetNameOfValue(result)     ((result)->text)
@@ -26,6 +27,12 @@ extern void      Result_SetValuesToZero(Result_t*) ;
 #define Result_GetNameOfView(result)      (View_GetNameOfView(Result_GetView(result)))
 
 
+/* Views requested by the "Outputs" section of the data file.
+ * A model may skip the computation of the values of a view which is
+ * not requested but should store it at the same index anyway. */
+#define Result_IsRequested(result)        (Result_GetRequest(result) != 0)
+
+
 #include "View.h"
 
 struct Result_s {             /* Result */
@@ -33,6 +40,7 @@ struct Result_s {             /* Result */
   short int n ;               /* Nb of values (1,3,9) */
   char*   text ;              /* Name of the result */
   View_t* view ;              /* View (scalar, vector, tensor) */
+  char    request ;           /* View requested (1) or not (0) */
 } ;
 
 /* Old notations which I try to eliminate little by little */
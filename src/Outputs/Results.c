@@ -1,17 +1,14 @@
 #include <string.h>
 #include "Message.h"
 #include "Results.h"
+#include "Mry.h"
 
 
 
 
 Results_t* Results_Create(int n)
 {
-  Results_t* results = (Results_t*) malloc(sizeof(Results_t)) ;
-  
-  if(!results) {
-    arret("Results_Create") ;
-  }
+  Results_t* results = (Results_t*) Mry_NewIn(Output,Results_t) ;
   
   Results_GetNbOfResults(results) = n ;
   
@@ -29,6 +26,6 @@ void Results_Delete(void* self)
   Result_t* result = Results_GetResult(results) ;
   
   Result_Delete(&result) ;
-  free(results) ;
+  Mry_Free(results) ;
   *presults = NULL ;
 }
@@ -1,27 +1,20 @@
 #include <string.h>
 #include "Message.h"
 #include "View.h"
+#include "Mry.h"
 
 
 
 View_t* View_Create(int n)
 {
-  View_t* view = (View_t*) malloc(n*sizeof(View_t)) ;
-  
-  if(!view) {
-    arret("View_Create(1)") ;
-  }
+  View_t* view = (View_t*) Mry_NewIn(Output,View_t[n]) ;
   
   
   /* Allocate memory for the names */
   {
-    char* text = (char*) malloc(n*View_MaxLengthOfViewName*sizeof(char)) ;
+    char* text = (char*) Mry_NewIn(Output,char[n*View_MaxLengthOfViewName]) ;
     int i ;
     
-    if(!text) {
-      arret("View_Create(3)") ;
-    }
-    
     for(i = 0 ; i < n ; i++) {
       View_GetNameOfView(view + i) = text + View_MaxLengthOfViewName*i ;
     }
@@ -36,7 +29,7 @@ void View_Delete(void* self)
   View_t** pview = (View_t**) self ;
   View_t*   view = *pview ;
   
-  free(View_GetNameOfView(view)) ;
-  free(view) ;
+  Mry_Free(View_GetNameOfView(view)) ;
+  Mry_Free(view) ;
   *pview = NULL ;
 }
@@ -1,15 +1,14 @@
+#include <stdlib.h>
 #include <string.h>
 #include "Message.h"
 #include "Views.h"
+#include "String.h"
+#include "Mry.h"
 
 
 Views_t* Views_Create(int n)
 {
-  Views_t* views = (Views_t*) malloc(sizeof(Views_t)) ;
-  
-  if(!views) {
-    arret("Views_Create") ;
-  }
+  Views_t* views = (Views_t*) Mry_NewIn(Output,Views_t) ;
   
   Views_GetNbOfViews(views) = n ;
   
@@ -26,6 +25,76 @@ void Views_Delete(void* self)
   View_t* view = Views_GetView(views) ;
   
   View_Delete(&view) ;
-  free(views) ;
+  Mry_Free(views) ;
   *pviews = NULL ;
 }
+
+
+
+Views_t* Views_CreateRequestedViews(DataFile_t* datafile)
+/** Read the names of the views requested in the section "Outputs"
+ *  of the data file, one name per line after the nb of names.
+ *  Return NULL if there is no such section (all views requested). */
+{
+  char* filecontent = DataFile_GetFileContent(datafile) ;
+  char* c  = String_FindToken(filecontent,"OUTP,Outputs",",") ;
+  int n ;
+  Views_t* views ;
+  
+  if(!c) return(NULL) ;
+  
+  Message_Direct("Enter in %s","Outputs") ;
+  Message_Direct("\n") ;
+  
+  c = String_SkipLine(c) ;
+  n = atoi(c) ;
+  
+  if(n < 1 || n > Views_MaxNbOfViews) {
+    arret("Views_CreateRequestedViews: bad nb of views (%d)",n) ;
+  }
+  
+  views = Views_Create(n) ;
+  
+  {
+    View_t* view = Views_GetView(views) ;
+    int i ;
+    
+    for(i = 0 ; i < n ; i++) {
+      char* name = View_GetNameOfView(view + i) ;
+      char* line ;
+      int len ;
+      
+      c = String_SkipLine(c) ;
+      line = String_CopyLine(c) ;
+      
+      /* Names may contain spaces but not trailing ones */
+      len = strlen(line) ;
+      while(len > 0 && strchr(" \t\r",line[len - 1])) len-- ;
+      line[len] = '\0' ;
+      
+      if(len == 0 || len > View_MaxLengthOfViewName - 1) {
+        arret("Views_CreateRequestedViews: bad name of view (%d)",i + 1) ;
+      }
+      
+      strcpy(name,line) ;
+    }
+  }
+  
+  return(views) ;
+}
+
+
+
+int Views_FindViewIndex(Views_t* views,const char* name)
+/** Return the index of the view name, -1 if not found */
+{
+  View_t* view = Views_GetView(views) ;
+  int n = Views_GetNbOfViews(views) ;
+  int i ;
+  
+  for(i = 0 ; i < n ; i++) {
+    if(!strcmp(View_GetNameOfView(view + i),name)) return(i) ;
+  }
+  
+  return(-1) ;
+}
@@ -7,8 +7,13 @@
 struct Views_s      ; typedef struct Views_s      Views_t ;
 
 
+#include "DataFile.h"
+
+
 extern Views_t*   Views_Create(int) ;
 extern void       Views_Delete(void*) ;
+extern Views_t*   Views_CreateRequestedViews(DataFile_t*) ;
+extern int        Views_FindViewIndex(Views_t*,const char*) ;
 
 
 #define Views_GetNbOfViews(views)      ((views)->nbofviews)
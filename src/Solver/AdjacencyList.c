@@ -13,7 +13,7 @@
 AdjacencyList_t* (AdjacencyList_Create)(int nvert,int* vert_nedges)
 {
   int nedges ;
-  AdjacencyList_t* adj = (AdjacencyList_t*) Mry_New(AdjacencyList_t[nvert]) ;
+  AdjacencyList_t* adj = (AdjacencyList_t*) Mry_NewIn(Matrix,AdjacencyList_t[nvert]) ;
   
   
   /* Nb of directed edges */
@@ -30,7 +30,7 @@ AdjacencyList_t* (AdjacencyList_Create)(int nvert,int* vert_nedges)
   /* Allocate memory for the adjacency list */
   {
     int i ;
-    int* list = (int*) Mry_New(int[nedges]) ;
+    int* list = (int*) Mry_NewIn(Matrix,int[nedges]) ;
     
     for(i = 0 ; i < nedges ; i++) {
       list[i] = -1 ;
@@ -58,8 +58,8 @@ void (AdjacencyList_Delete)(void* self)
   AdjacencyList_t** padj = (AdjacencyList_t**) self ;
   AdjacencyList_t*  adj  = *padj ;
   
-  free(AdjacencyList_GetNeighbor(adj)) ;
-  free(adj) ;
+  Mry_Free(AdjacencyList_GetNeighbor(adj)) ;
+  Mry_Free(adj) ;
   //*padj = NULL ;
 }
 
@@ -0,0 +1,233 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "Mry.h"
+#include "Message.h"
+#include "GMRES.h"
+
+
+static double  (GMRES_Dot)(const unsigned int,double*,double*) ;
+
+
+/* Extern functions */
+
+GMRES_t*  (GMRES_Create)(const unsigned int n,const unsigned int m,const int maxiter,const double tol)
+/** Create a GMRES solver for systems of n rows, restarted every m
+ *  iterations. */
+{
+  GMRES_t* gmres = (GMRES_t*) Mry_NewIn(Matrix,GMRES_t) ;
+
+  if(m < 1) {
+    arret("GMRES_Create: bad dimension of the Krylov subspace") ;
+  }
+
+  GMRES_GetNbOfRows(gmres) = n ;
+  GMRES_GetKrylovDimension(gmres) = m ;
+  GMRES_GetMaxNbOfIterations(gmres) = maxiter ;
+  GMRES_GetTolerance(gmres) = tol ;
+
+  /* V[n*(m + 1)], w[n], z[n], H[(m + 1)*m], cs[m], sn[m], g[m + 1], y[m] */
+  {
+    size_t size = n*(m + 3) + (m + 1)*m + 4*m + 1 ;
+    double* work = (double*) Mry_NewIn(Matrix,double[size]) ;
+
+    GMRES_GetWorkSpace(gmres) = work ;
+  }
+
+  return(gmres) ;
+}
+
+
+
+void  (GMRES_Delete)(void* self)
+{
+  GMRES_t** pgmres = (GMRES_t**) self ;
+  GMRES_t*   gmres = *pgmres ;
+
+  Mry_Free(GMRES_GetWorkSpace(gmres)) ;
+  Mry_Free(gmres) ;
+  *pgmres = NULL ;
+}
+
+
+
+int  (GMRES_Solve)(GMRES_t* gmres,GMRES_Operator_t* matvec,GMRES_Operator_t* precond,void* data,double* b,double* x)
+/** Solve A.x = b by restarted GMRES with the right preconditioner M,
+ *  A and M (NULL for none) being applied through matvec and precond,
+ *  from x = 0 until the residual is reduced by the tolerance.
+ *  Return 0 if converged, 1 if the max nb of iterations is reached,
+ *  -1 if an operator failed. */
+{
+  unsigned int n = GMRES_GetNbOfRows(gmres) ;
+  unsigned int m = GMRES_GetKrylovDimension(gmres) ;
+  int maxiter = GMRES_GetMaxNbOfIterations(gmres) ;
+  double tol = GMRES_GetTolerance(gmres) ;
+  double* v  = GMRES_GetWorkSpace(gmres) ;
+  double* w  = v + n*(m + 1) ;
+  double* z  = w + n ;
+  double* h  = z + n ;
+  double* cs = h + (m + 1)*m ;
+  double* sn = cs + m ;
+  double* g  = sn + m ;
+  double* y  = g + m + 1 ;
+  double bnorm = sqrt(GMRES_Dot(n,b,b)) ;
+  double resid = bnorm ;
+  int niter = 0 ;
+  int converged = 0 ;
+  unsigned int i ;
+
+#define H(i,j)   (h[(i)*m + (j)])
+#define V(i)     (v + (i)*n)
+
+  for(i = 0 ; i < n ; i++) x[i] = 0 ;
+
+  if(bnorm == 0) {
+    GMRES_GetNbOfIterations(gmres) = 0 ;
+    GMRES_GetResidualRatio(gmres) = 0 ;
+    return(0) ;
+  }
+
+  /* Restarts */
+  while(1) {
+    unsigned int k = 0 ;
+
+    /* The residual r = b - A.x (x = 0 at the first cycle) */
+    if(niter == 0) {
+      memcpy(V(0),b,n*sizeof(double)) ;
+    } else {
+      if(matvec(data,x,w)) return(-1) ;
+
+      for(i = 0 ; i < n ; i++) V(0)[i] = b[i] - w[i] ;
+    }
+
+    resid = sqrt(GMRES_Dot(n,V(0),V(0))) ;
+
+    if(resid <= tol*bnorm) {
+      converged = 1 ;
+      break ;
+    }
+
+    if(niter >= maxiter) break ;
+
+    for(i = 0 ; i < n ; i++) V(0)[i] /= resid ;
+
+    g[0] = resid ;
+
+    /* Arnoldi process */
+    while(k < m && niter < maxiter) {
+      unsigned int j ;
+
+      niter++ ;
+
+      /* w = A.M^-1.v_k */
+      if(precond) {
+        if(precond(data,V(k),z)) return(-1) ;
+        if(matvec(data,z,w)) return(-1) ;
+      } else {
+        if(matvec(data,V(k),w)) return(-1) ;
+      }
+
+      /* Modified Gram-Schmidt */
+      for(j = 0 ; j <= k ; j++) {
+        double hjk = GMRES_Dot(n,w,V(j)) ;
+
+        H(j,k) = hjk ;
+
+        for(i = 0 ; i < n ; i++) w[i] -= hjk*V(j)[i] ;
+      }
+
+      H(k + 1,k) = sqrt(GMRES_Dot(n,w,w)) ;
+
+      if(H(k + 1,k) > 0) {
+        for(i = 0 ; i < n ; i++) V(k + 1)[i] = w[i]/H(k + 1,k) ;
+      }
+
+      /* Apply the previous Givens rotations to the new column */
+      for(j = 0 ; j < k ; j++) {
+        double a = H(j,k) ;
+        double c = H(j + 1,k) ;
+
+        H(j,k)     =   cs[j]*a + sn[j]*c ;
+        H(j + 1,k) = - sn[j]*a + cs[j]*c ;
+      }
+
+      /* The new rotation eliminates H(k + 1,k) */
+      {
+        double a = H(k,k) ;
+        double c = H(k + 1,k) ;
+        double r = sqrt(a*a + c*c) ;
+
+        cs[k] = (r > 0) ? a/r : 1 ;
+        sn[k] = (r > 0) ? c/r : 0 ;
+        H(k,k) = r ;
+        H(k + 1,k) = 0 ;
+        g[k + 1] = - sn[k]*g[k] ;
+        g[k]     =   cs[k]*g[k] ;
+      }
+
+      k++ ;
+
+      resid = fabs(g[k]) ;
+
+      if(resid <= tol*bnorm) break ;
+    }
+
+    /* Solve H.y = g and update x += M^-1.V.y */
+    {
+      int j ;
+
+      for(j = k - 1 ; j >= 0 ; j--) {
+        double s = g[j] ;
+        unsigned int l ;
+
+        for(l = j + 1 ; l < k ; l++) s -= H(j,l)*y[l] ;
+
+        if(H(j,j) == 0) return(-1) ;
+
+        y[j] = s/H(j,j) ;
+      }
+
+      for(i = 0 ; i < n ; i++) w[i] = 0 ;
+
+      for(j = 0 ; j < (int) k ; j++) {
+        for(i = 0 ; i < n ; i++) w[i] += y[j]*V(j)[i] ;
+      }
+
+      if(precond) {
+        if(precond(data,w,z)) return(-1) ;
+      } else {
+        memcpy(z,w,n*sizeof(double)) ;
+      }
+
+      for(i = 0 ; i < n ; i++) x[i] += z[i] ;
+    }
+
+    if(resid <= tol*bnorm) {
+      converged = 1 ;
+      break ;
+    }
+  }
+
+#undef H
+#undef V
+
+  GMRES_GetNbOfIterations(gmres) = niter ;
+  GMRES_GetResidualRatio(gmres) = resid/bnorm ;
+
+  return((converged) ? 0 : 1) ;
+}
+
+
+
+/* Intern functions */
+
+double  (GMRES_Dot)(const unsigned int n,double* a,double* b)
+{
+  double s = 0 ;
+  unsigned int i ;
+
+  for(i = 0 ; i < n ; i++) s += a[i]*b[i] ;
+
+  return(s) ;
+}
@@ -0,0 +1,39 @@
+#ifndef GMRES_H
+#define GMRES_H
+
+/* class-like structure "GMRES_t" */
+
+/* vacuous declarations and typedef names */
+struct GMRES_s          ; typedef struct GMRES_s GMRES_t ;
+
+
+/* Operator y = A(x) applied through a callback (the matrix needs not be
+ * stored). Return 0 if succeeded, a non zero value otherwise. */
+typedef int  GMRES_Operator_t(void*,double*,double*) ;
+
+
+extern GMRES_t*  (GMRES_Create)(const unsigned int,const unsigned int,const int,const double) ;
+extern void      (GMRES_Delete)(void*) ;
+extern int       (GMRES_Solve)(GMRES_t*,GMRES_Operator_t*,GMRES_Operator_t*,void*,double*,double*) ;
+
+
+#define GMRES_GetNbOfRows(G)                 ((G)->n)
+#define GMRES_GetKrylovDimension(G)          ((G)->m)
+#define GMRES_GetMaxNbOfIterations(G)        ((G)->maxiter)
+#define GMRES_GetTolerance(G)                ((G)->tol)
+#define GMRES_GetNbOfIterations(G)           ((G)->niter)
+#define GMRES_GetResidualRatio(G)            ((G)->ratio)
+#define GMRES_GetWorkSpace(G)                ((G)->work)
+
+
+struct GMRES_s {              /* Restarted GMRES with right preconditioning */
+  unsigned int n ;            /* Nb of rows */
+  unsigned int m ;            /* Dimension of the Krylov subspace before restart */
+  int    maxiter ;            /* Max nb of iterations */
+  double tol ;                /* Tolerance on the relative residual */
+  int    niter ;              /* Nb of iterations of the last solve */
+  double ratio ;              /* Relative residual of the last solve */
+  double* work ;              /* Work space */
+} ;
+
+#endif
@@ -16,7 +16,7 @@
 
 Graph_t*  Graph_Create(int nvert,int* vert_nedges)
 {
-  Graph_t* graph = (Graph_t*) Mry_New(Graph_t) ;
+  Graph_t* graph = (Graph_t*) Mry_NewIn(Matrix,Graph_t) ;
 
   
   {
@@ -66,7 +66,7 @@ void Graph_Delete(void* self)
   Graph_t*   graph = *pgraph ;
   
   AdjacencyList_Delete(&Graph_GetAdjacencyList(graph)) ;
-  free(graph) ;
+  Mry_Free(graph) ;
   //*pgraph = NULL ;
 }
 
@@ -24,7 +24,7 @@
 Matrix_t*   Matrix_Create(Mesh_t* mesh,Options_t* options)
 /* Alloue la memoire de la matrice */
 {
-  Matrix_t* a = (Matrix_t*) Mry_New(Matrix_t) ;
+  Matrix_t* a = (Matrix_t*) Mry_NewIn(Matrix,Matrix_t) ;
 
 
   /*  Nb of rows and columns */
@@ -76,7 +76,7 @@ Matrix_t*   Matrix_Create(Mesh_t* mesh,Options_t* options)
       /*  Work space for NCFormat_AssembleElementMatrix */
       {
         int n_col = Matrix_GetNbOfColumns(a) ;
-        void* work = (void*) Mry_New(int[n_col]) ;
+        void* work = (void*) Mry_NewIn(Matrix,int[n_col]) ;
       
         Matrix_GetWorkSpace(a) = work ;
       }
@@ -93,7 +93,7 @@ Matrix_t*   Matrix_Create(Mesh_t* mesh,Options_t* options)
       {
         int n_col = Matrix_GetNbOfColumns(a) ;
         int lwork = 4 * n_col ;
-        void* work = (void*) Mry_New(double[lwork]) ;
+        void* work = (void*) Mry_NewIn(Factor,double[lwork]) ;
       
         Matrix_GetWorkSpace(a) = work ;
       }
@@ -109,6 +109,13 @@ Matrix_t*   Matrix_Create(Mesh_t* mesh,Options_t* options)
     Matrix_GetState(a) = 0 ;
   }
   
+  
+  /* The element-to-matrix scatter map */
+  {
+    Matrix_GetMesh(a) = mesh ;
+    Matrix_UpdateScatterMap(a) ;
+  }
+  
   return(a) ;
 }
 
@@ -134,7 +141,7 @@ void Matrix_Delete(void* self)
       
     SuperLUFormat_Delete(&aslu) ;
 
-    free(Matrix_GetWorkSpace(a)) ;
+    Mry_Free(Matrix_GetWorkSpace(a)) ;
   #endif
   
   } else if(Matrix_StorageFormatIs(a,Coordinate)) {
@@ -142,13 +149,127 @@ void Matrix_Delete(void* self)
       
     CoordinateFormat_Delete(&ac) ;
 
-    free(Matrix_GetWorkSpace(a)) ;
+    Mry_Free(Matrix_GetWorkSpace(a)) ;
 
   } else {
     arret("Matrix_Delete(2): unknown format") ;
   }
   
-  free(a) ;
+  Mry_Free(Matrix_GetScatterMap(a)) ;
+  Mry_Free(Matrix_GetScatterMapIndex(a)) ;
+  Mry_Free(a) ;
+}
+
+
+
+void Matrix_UpdateScatterMap(Matrix_t* a)
+/** Build the element-to-matrix scatter map i.e., for each element, 
+ *  the offsets in the array of non zero values where the entries of 
+ *  the element matrix are added (-1 for eliminated dof).
+ *  Must be called again whenever the matrix rows/columns are renumbered
+ *  (boundary conditions, periodicities). */
+{
+  Mesh_t* mesh = Matrix_GetMesh(a) ;
+  unsigned int n_el = Mesh_GetNbOfElements(mesh) ;
+  Element_t* el = Mesh_GetElement(mesh) ;
+  
+  /* The coordinate format stores duplicate entries (no map) */
+  if(Matrix_StorageFormatIs(a,Coordinate)) return ;
+  
+  
+  /* Index in map of the first entry of each element */
+  {
+    int* mapindex = Matrix_GetScatterMapIndex(a) ;
+    unsigned int ie ;
+    
+    if(!mapindex) {
+      mapindex = (int*) Mry_NewIn(Matrix,int[n_el + 1]) ;
+      Matrix_GetScatterMapIndex(a) = mapindex ;
+    }
+    
+    mapindex[0] = 0 ;
+    
+    for(ie = 0 ; ie < n_el ; ie++) {
+      int ndof = (Element_GetMaterial(el + ie)) ? Element_GetNbOfDOF(el + ie) : 0 ;
+      
+      mapindex[ie + 1] = mapindex[ie] + ndof*ndof ;
+    }
+  }
+  
+  
+  /* Allocation of space for the map */
+  {
+    int len = Matrix_GetScatterMapIndex(a)[n_el] ;
+    
+    Mry_Free(Matrix_GetScatterMap(a)) ;
+    Matrix_GetScatterMap(a) = (len > 0) ? (int*) Mry_NewIn(Matrix,int[len]) : NULL ;
+  }
+  
+  
+  /* Compute the offsets */
+  if(Matrix_GetScatterMap(a)) {
+    unsigned int ie ;
+    
+    for(ie = 0 ; ie < n_el ; ie++) {
+      if(Element_GetMaterial(el + ie)) {
+        int  ndof = Element_GetNbOfDOF(el + ie) ;
+        int* row = Element_ComputeMatrixRowAndColumnIndices(el + ie) ;
+        int* col = row + ndof ;
+        int* map = Matrix_GetScatterMapOfElement(a,el + ie) ;
+        
+        /* The structural zeros declared by the model are flagged (-1)
+         * so as to be neither looked for in the storage nor assembled */
+        {
+          int n = ndof*ndof ;
+          int k ;
+          
+          for(k = 0 ; k < n ; k++) map[k] = 0 ;
+          
+          if(Element_HasStructuralZeros(el + ie)) {
+            int neq = Element_GetNbOfEquations(el + ie) ;
+            
+            for(k = 0 ; k < n ; k++) {
+              int ieq = (k / ndof) % neq ;
+              int jeq = (k % ndof) % neq ;
+              
+              if(!Element_EquationIsCoupledToUnknown(el + ie,ieq,jeq)) map[k] = -1 ;
+            }
+          }
+        }
+    
+        /* Skyline format */
+        if(Matrix_StorageFormatIs(a,LDUSKL)) {
+          LDUSKLFormat_t* askl = (LDUSKLFormat_t*) Matrix_GetStorage(a) ;
+      
+          LDUSKLFormat_ComputeScatterMap(askl,map,col,row,ndof) ;
+      
+#ifdef SUPERLULIB
+        /* CCS format (or Harwell-Boeing format) used in SuperLU */
+        } else if(Matrix_StorageFormatIs(a,SuperLU)) {
+          SuperLUFormat_t* aslu   = (SuperLUFormat_t*) Matrix_GetStorage(a) ;
+          NCFormat_t*    asluNC = (NCFormat_t*) SuperLUFormat_GetStorage(aslu) ;
+          int*        rowptr = (int*) Matrix_GetWorkSpace(a) ;
+          int         nrow = SuperLUFormat_GetNbOfRows(aslu) ;
+      
+          NCFormat_ComputeScatterMap(asluNC,map,col,row,ndof,rowptr,nrow) ;
+#endif
+
+        } else {
+          arret("Matrix_UpdateScatterMap: unknown format") ;
+        }
+        
+        Element_FreeBufferFrom(el + ie,row) ;
+      }
+    }
+  }
+  
+  
+  /* The numbering for which the map is valid */
+  {
+    Nodes_t* nodes = Mesh_GetNodes(mesh) ;
+    
+    Matrix_GetNumberingOfScatterMap(a) = Nodes_GetNbOfMatrixNumberings(nodes) ;
+  }
 }
 
 
@@ -157,6 +278,28 @@ void Matrix_AssembleElementMatrix(Matrix_t* a,Element_t* el,double* ke)
 /** Assemble the element matrix ke in the global matrix a */
 {
   int  ndof = Element_GetNbOfDOF(el) ;
+  
+  /* Gather-free assembly through the scatter map */
+  if(Matrix_GetScatterMap(a)) {
+    if(Matrix_ScatterMapIsOutOfDate(a)) {
+      Matrix_UpdateScatterMap(a) ;
+    }
+    
+    {
+      int*    map   = Matrix_GetScatterMapOfElement(a,el) ;
+      double* nzval = Matrix_GetNonZeroValue(a) ;
+      int     n     = ndof*ndof ;
+      int     k ;
+      
+      for(k = 0 ; k < n ; k++) {
+        int ik = map[k] ;
+        
+        if(ik >= 0) nzval[ik] += ke[k] ;
+      }
+    }
+    
+    return ;
+  }
 
   /* Skyline format */
   if(Matrix_StorageFormatIs(a,LDUSKL)) {
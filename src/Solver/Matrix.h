@@ -14,6 +14,7 @@ struct Matrix_s       ; typedef struct Matrix_s       Matrix_t ;
 extern Matrix_t*   (Matrix_Create)                (Mesh_t*,Options_t*) ;
 extern void        (Matrix_Delete)                (void*) ;
 extern void        (Matrix_AssembleElementMatrix) (Matrix_t*,Element_t*,double*) ;
+extern void        (Matrix_UpdateScatterMap)      (Matrix_t*) ;
 extern void        (Matrix_PrintMatrix)           (Matrix_t*,const char* keyword) ;
 
 
@@ -26,6 +27,22 @@ extern void        (Matrix_PrintMatrix)           (Matrix_t*,const char* keyword
 #define Matrix_GetWorkSpace(MAT)                 ((MAT)->work)
 #define Matrix_GetStorage(MAT)                   ((MAT)->store)
 #define Matrix_GetState(MAT)                     ((MAT)->state)
+#define Matrix_GetMesh(MAT)                      ((MAT)->mesh)
+#define Matrix_GetScatterMap(MAT)                ((MAT)->map)
+#define Matrix_GetScatterMapIndex(MAT)           ((MAT)->mapindex)
+#define Matrix_GetNumberingOfScatterMap(MAT)     ((MAT)->numbering)
+
+
+
+/* Access to the scatter map of an element */
+#define Matrix_GetScatterMapOfElement(MAT,ELT) \
+        (Matrix_GetScatterMap(MAT) + Matrix_GetScatterMapIndex(MAT)[Element_GetElementIndex(ELT)])
+
+
+/* The scatter map must be rebuilt if the matrix rows/columns were renumbered */
+#define Matrix_ScatterMapIsOutOfDate(MAT) \
+        (Matrix_GetNumberingOfScatterMap(MAT) != \
+         Nodes_GetNbOfMatrixNumberings(Mesh_GetNodes(Matrix_GetMesh(MAT))))
 
 
 
@@ -70,6 +87,10 @@ struct Matrix_s {             /* Matrix */
   void*   work ;              /* Pointer to a working memory space */
   void*   store ;             /* Pointer to the actual storage of the matrix */
   char    state ;             /* State of the matrix */
+  Mesh_t* mesh ;              /* Mesh */
+  int*    map ;               /* Element-to-matrix scatter map (offsets in nzval) */
+  int*    mapindex ;          /* Index in map of the first entry of each element */
+  unsigned int numbering ;    /* Numbering of rows/columns for which map was built */
 } ;
 
 #endif
@@ -8,13 +8,14 @@
 #include "Message.h"
 #include "BilLib.h"
 #include "CoordinateFormat.h"
+#include "Mry.h"
 
 
 
 CoordinateFormat_t* (CoordinateFormat_Create)(Mesh_t* mesh,Options_t* options)
 /** Create a matrix in CoordinateFormat format with duplicate entries */
 {
-  CoordinateFormat_t* ac = (CoordinateFormat_t*) malloc(sizeof(CoordinateFormat_t)) ;
+  CoordinateFormat_t* ac = (CoordinateFormat_t*) Mry_NewIn(Matrix,CoordinateFormat_t) ;
 
   assert(ac) ;
   
@@ -33,7 +34,7 @@ CoordinateFormat_t* (CoordinateFormat_Create)(Mesh_t* mesh,Options_t* options)
       int ff = Options_GetFillFactor(options) ;
       int lv  = ff*(2*nnz) ;
       size_t sz = lv * sizeof(double) ;
-      double* v = (double*) malloc(sz) ;
+      double* v = (double*) Mry_AllocateIn(sz,Mry_Category(Matrix)) ;
       
       assert(v) ;
       
@@ -51,7 +52,7 @@ CoordinateFormat_t* (CoordinateFormat_Create)(Mesh_t* mesh,Options_t* options)
       int ff = Options_GetFillFactor(options) ;
       int lindex = ff*(3*nnz + 2*n + 1) ;
       size_t sz = lindex * sizeof(int) ;
-      int* index = (int*) malloc(sz) ;
+      int* index = (int*) Mry_AllocateIn(sz,Mry_Category(Matrix)) ;
       
       assert(index) ;
       
@@ -72,9 +73,9 @@ void (CoordinateFormat_Delete)(void* self)
   CoordinateFormat_t** pac = (CoordinateFormat_t**) self ;
   CoordinateFormat_t*   ac = *pac ;
   
-  free(CoordinateFormat_GetNonZeroValue(ac)) ;
-  free(CoordinateFormat_GetIndex(ac)) ;
-  free(ac) ;
+  Mry_Free(CoordinateFormat_GetNonZeroValue(ac)) ;
+  Mry_Free(CoordinateFormat_GetIndex(ac)) ;
+  Mry_Free(ac) ;
   *pac = NULL ;
 }
 
@@ -95,6 +96,7 @@ int CoordinateFormat_AssembleElementMatrix(CoordinateFormat_t* a,Element_t* el,d
   int*  rowind = CoordinateFormat_GetRowIndexOfValue(a) ;
   int*  row    = Element_ComputeMatrixRowAndColumnIndices(el) ;
   int*  col    = row + ndof ;
+  int   neq    = Element_GetNbOfEquations(el) ;
   
   
   {
@@ -110,6 +112,9 @@ int CoordinateFormat_AssembleElementMatrix(CoordinateFormat_t* a,Element_t* el,d
         int irow = row[ie] ;
       
         if(irow < 0) continue ;
+        
+        /* The structural zeros declared by the model are not stored */
+        if(!Element_EquationIsCoupledToUnknown(el,ie % neq,je % neq)) continue ;
       
         /* Row (and column) indices outside the range 1,nnz are ignored in ma38 */
         if(KE(ie,je) == 0.) irow = -1 ;
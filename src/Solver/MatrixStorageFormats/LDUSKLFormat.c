@@ -7,6 +7,7 @@
 #include "Mesh.h"
 #include "Message.h"
 #include "LDUSKLFormat.h"
+#include "Mry.h"
 
 
 
@@ -16,7 +17,7 @@
 LDUSKLFormat_t* LDUSKLFormat_Create(Mesh_t* mesh)
 /** Create a matrix in LDU Skyline format */
 {
-  LDUSKLFormat_t* a = (LDUSKLFormat_t*) malloc(sizeof(LDUSKLFormat_t)) ;
+  LDUSKLFormat_t* a = (LDUSKLFormat_t*) Mry_NewIn(Matrix,LDUSKLFormat_t) ;
   
   assert(a) ;
 
@@ -25,7 +26,7 @@ LDUSKLFormat_t* LDUSKLFormat_Create(Mesh_t* mesh)
   {
     int n_col = Mesh_GetNbOfMatrixColumns(mesh) ;
     /*  les hauteurs de colonne (hc) */
-    int*  hc = (int*) malloc(n_col*sizeof(int)) ;
+    int*  hc = (int*) Mry_NewIn(Matrix,int[n_col]) ;
     
     assert(hc) ;
 
@@ -112,7 +113,7 @@ LDUSKLFormat_t* LDUSKLFormat_Create(Mesh_t* mesh)
       /* Allocation of space for the non zeros */
       {
         int nnz = 2*nnz_l + n_col ;
-        double* z = (double*) malloc(nnz*sizeof(double)) ;
+        double* z = (double*) Mry_NewIn(Matrix,double[nnz]) ;
       
         assert(z) ;
     
@@ -124,7 +125,7 @@ LDUSKLFormat_t* LDUSKLFormat_Create(Mesh_t* mesh)
       /* les tableaux de pointeurs de ligne et colonne */
       {
         double* z = LDUSKLFormat_GetNonZeroValue(a) ;
-        double** p = (double**) malloc(2*n_col*sizeof(double*)) ;
+        double** p = (double**) Mry_NewIn(Matrix,double*[2*n_col]) ;
         int i ;
       
         assert(p) ;
@@ -147,7 +148,7 @@ LDUSKLFormat_t* LDUSKLFormat_Create(Mesh_t* mesh)
       }
     }
 
-    free(hc) ;
+    Mry_Free(hc) ;
   }
 
   return(a) ;
@@ -160,9 +161,13 @@ void LDUSKLFormat_Delete(void* self)
 {
   LDUSKLFormat_t** a = (LDUSKLFormat_t**) self ;
   
-  free(LDUSKLFormat_GetNonZeroValue(*a)) ;
-  free(LDUSKLFormat_GetPointerToLowerRow(*a)) ;
-  free(*a) ;
+  Mry_Free(LDUSKLFormat_GetNonZeroValue(*a)) ;
+  Mry_Free(LDUSKLFormat_GetPointerToLowerRow(*a)) ;
+  if(LDUSKLFormat_GetSinglePrecisionValue(*a)) {
+    Mry_Free(LDUSKLFormat_GetSinglePrecisionValue(*a)) ;
+    Mry_Free(LDUSKLFormat_GetWorkSpace(*a)) ;
+  }
+  Mry_Free(*a) ;
   *a = NULL ;
 }
 
@@ -210,6 +215,52 @@ void LDUSKLFormat_AssembleElementMatrix(LDUSKLFormat_t* a,double* ke,int* cole,i
 
 
 
+void LDUSKLFormat_ComputeScatterMap(LDUSKLFormat_t* a,int* map,int* cole,int* lige,int n)
+/** Compute the offsets in the array of non zero values where the entries
+ *  of an element matrix ke are to be assembled, i.e. 
+ *  nzval[map[i*n+j]] += ke[i*n+j] if map[i*n+j] >= 0.
+ *  The entries flagged by map[i*n+j] < 0 on input are skipped. */
+{
+#define MAP(i,j) (map[(i)*n+(j)])
+  double* z = LDUSKLFormat_GetNonZeroValue(a) ;
+  int    ie ;
+  
+  for(ie = 0 ; ie < n ; ie++) { /* les lignes */
+    int i = lige[ie] ;
+    int je ;
+    
+    for(je = 0 ; je < n ; je++) { /* les colonnes */
+      int j = cole[je] ;
+      
+      if(i < 0 || j < 0 || MAP(ie,je) < 0) {
+        MAP(ie,je) = -1 ;
+        continue ;
+      }
+      
+      if(i < j) {
+        if(i < LDUSKLFormat_RowIndexStartingColumn(a,j)) {
+          arret("LDUSKLFormat_ComputeScatterMap: assembling not possible") ;
+        }
+        
+        MAP(ie,je) = (LDUSKLFormat_GetUpperColumn(a,j) + i) - z ;
+      } else if(i > j) {
+        if(j < LDUSKLFormat_ColumnIndexStartingRow(a,i)) {
+          arret("LDUSKLFormat_ComputeScatterMap: assembling not possible") ;
+        }
+        
+        MAP(ie,je) = (LDUSKLFormat_GetLowerRow(a,i) + j) - z ;
+      } else {
+        MAP(ie,je) = (LDUSKLFormat_GetDiagonal(a) + i) - z ;
+      }
+    }
+  }
+  
+#undef MAP
+}
+
+
+
+
 void LDUSKLFormat_PrintMatrix(LDUSKLFormat_t* a,unsigned int n,const char* keyword)
 {
   double*  d = LDUSKLFormat_GetDiagonal(a) ;
@@ -15,6 +15,7 @@ struct LDUSKLFormat_s   ; typedef struct LDUSKLFormat_s   LDUSKLFormat_t ;
 extern LDUSKLFormat_t* (LDUSKLFormat_Create)(Mesh_t*) ;
 extern void            (LDUSKLFormat_Delete)(void*) ;
 extern void LDUSKLFormat_AssembleElementMatrix(LDUSKLFormat_t*,double*,int*,int*,int) ;
+extern void LDUSKLFormat_ComputeScatterMap(LDUSKLFormat_t*,int*,int*,int*,int) ;
 extern void LDUSKLFormat_PrintMatrix(LDUSKLFormat_t*,unsigned int,const char*) ;
 
 
@@ -28,6 +29,21 @@ extern void LDUSKLFormat_PrintMatrix(LDUSKLFormat_t*,unsigned int,const char*) ;
 #define LDUSKLFormat_GetPointerToUpperColumn(a)      ((a)->u)
 
 
+/** The getters of the mixed precision resolution (see CroutMethod) */
+#define LDUSKLFormat_GetSinglePrecisionValue(a)      ((a)->sd)
+#define LDUSKLFormat_GetWorkSpace(a)                 ((a)->work)
+#define LDUSKLFormat_GetPrecision(a)                 ((a)->precision)
+#define LDUSKLFormat_GetNbOfSinglePrecisionFactorizations(a)   ((a)->nbsfact)
+#define LDUSKLFormat_GetNbOfDoublePrecisionFactorizations(a)   ((a)->nbdfact)
+#define LDUSKLFormat_GetNbOfRefinements(a)           ((a)->nbrefine)
+#define LDUSKLFormat_GetSinglePrecisionTime(a)       ((a)->stime)
+#define LDUSKLFormat_GetDoublePrecisionTime(a)       ((a)->dtime)
+#define LDUSKLFormat_GetRefinementTime(a)            ((a)->rtime)
+
+#define LDUSKLFormat_IsFactorizedInSinglePrecision(a) \
+        (LDUSKLFormat_GetPrecision(a) == 's')
+
+
 
 #define LDUSKLFormat_GetUpperColumn(a,j) \
         (LDUSKLFormat_GetPointerToUpperColumn(a)[j] - (j))
@@ -69,6 +85,16 @@ struct LDUSKLFormat_s {       /* LDU Skyline storage format */
   double* d ;                 /* Diagonal matrix values */
   double** l ;                /* Pointer to strictly lower triangular matrix values */
   double** u ;                /* Pointer to strictly upper triangular matrix values */
+  /* Mixed precision resolution */
+  float*  sd ;                /* Values factorized in single precision (same layout) */
+  double* work ;              /* Work space of the iterative refinement */
+  char    precision ;         /* Precision of the last factorization ('s' or 'd') */
+  unsigned long nbsfact ;     /* Nb of factorizations in single precision */
+  unsigned long nbdfact ;     /* Nb of fallbacks to a factorization in double precision */
+  unsigned long nbrefine ;    /* Nb of refinement iterations */
+  double  stime ;             /* CPU time of the factorizations in single precision */
+  double  dtime ;             /* CPU time of the factorizations in double precision */
+  double  rtime ;             /* CPU time of the resolutions with refinement */
 } ;
 
 
@@ -8,6 +8,7 @@
 #include "Message.h"
 #include "BilLib.h"
 #include "NCFormat.h"
+#include "Mry.h"
 
 
 
@@ -25,13 +26,13 @@ NCFormat_t* NCFormat_Create(Mesh_t* mesh)
   int    ie ;
   int    i,j ;
   int    nnz_max ;
-  NCFormat_t*    asluNC = (NCFormat_t*) malloc(sizeof(NCFormat_t)) ;
+  NCFormat_t*    asluNC = (NCFormat_t*) Mry_NewIn(Matrix,NCFormat_t) ;
 
   assert(asluNC) ;
 
 
   /* tableau de travail */
-  colptr0 = (int*) malloc((n_col + 1)*sizeof(int)) ;
+  colptr0 = (int*) Mry_NewIn(Matrix,int[n_col + 1]) ;
   
   assert(colptr0) ;
 
@@ -69,7 +70,7 @@ NCFormat_t* NCFormat_Create(Mesh_t* mesh)
 
   /* les tableaux colptr et rowind */
   {
-    int* colptr = (int*) malloc((n_col+1)*sizeof(int)) ;
+    int* colptr = (int*) Mry_NewIn(Matrix,int[n_col+1]) ;
     
     assert(colptr) ;
     
@@ -77,7 +78,7 @@ NCFormat_t* NCFormat_Create(Mesh_t* mesh)
   }
     
   {
-    int* rowind = (int*) malloc(nnz_max*sizeof(int)) ;
+    int* rowind = (int*) Mry_NewIn(Matrix,int[nnz_max]) ;
     
     assert(rowind) ;
     
@@ -123,6 +124,9 @@ NCFormat_t* NCFormat_Create(Mesh_t* mesh)
             
               jcol = Node_GetMatrixColumnIndex(node_j)[jj] ;
               if(jcol < 0) continue ;
+              
+              /* The structural zeros declared by the model are not stored */
+              if(!Element_EquationIsCoupledToUnknown(el + ie,ieq,jeq)) continue ;
             
               /* on verifie que irow n'est pas deja enregistre */
               for(k = 0 ; k < colptr[jcol + 1] ; k++) {
@@ -135,6 +139,17 @@ NCFormat_t* NCFormat_Create(Mesh_t* mesh)
               colptr[jcol + 1] += 1 ;
             
               if(irow == jcol) continue ;
+              
+              /* The symmetric entry is met by itself when the pattern
+               * is not symmetric */
+              if(Element_HasStructuralZeros(el + ie)) continue ;
+              
+              /* on verifie que jcol n'est pas deja enregistre */
+              for(k = 0 ; k < colptr[irow + 1] ; k++) {
+                if(jcol == rowind[colptr0[irow] + k]) break ;
+              }
+            
+              if(k < colptr[irow + 1]) continue ;
             
               rowind[colptr0[irow] + colptr[irow + 1]] = jcol ;
               colptr[irow + 1] += 1 ;
@@ -164,7 +179,7 @@ NCFormat_t* NCFormat_Create(Mesh_t* mesh)
     }
   }
 
-  free(colptr0) ;
+  Mry_Free(colptr0) ;
 
 
   {
@@ -182,11 +197,7 @@ NCFormat_t* NCFormat_Create(Mesh_t* mesh)
   {
     int* rowind = NCFormat_GetRowIndexOfNonZeroValue(asluNC) ;
     int nnz = NCFormat_GetNbOfNonZeroValues(asluNC) ;
-    int* rowind1 = (int*) realloc(rowind,nnz*sizeof(int)) ;
-    
-    if(!rowind1) {
-      arret("NCFormat_Create: reallocation issue") ;
-    }
+    int* rowind1 = (int*) Mry_ReallocIn(rowind,nnz*sizeof(int),Mry_Category(Matrix)) ;
     
     if(rowind1 != rowind) {
       NCFormat_GetRowIndexOfNonZeroValue(asluNC) = rowind1 ;
@@ -198,7 +209,7 @@ NCFormat_t* NCFormat_Create(Mesh_t* mesh)
   /*  1. allocation de l'espace memoire pour la matice */
   {
     int nnz = NCFormat_GetNbOfNonZeroValues(asluNC) ;
-    double* nzval = (double*) malloc(nnz*sizeof(double)) ;
+    double* nzval = (double*) Mry_NewIn(Matrix,double[nnz]) ;
     
     assert(nzval) ;
     
@@ -215,10 +226,10 @@ void NCFormat_Delete(void* self)
 {
   NCFormat_t** a = (NCFormat_t**) self ;
   
-  free(NCFormat_GetFirstNonZeroValueIndexOfColumn(*a)) ;
-  free(NCFormat_GetRowIndexOfNonZeroValue(*a)) ;
-  free(NCFormat_GetNonZeroValue(*a)) ;
-  free(*a) ;
+  Mry_Free(NCFormat_GetFirstNonZeroValueIndexOfColumn(*a)) ;
+  Mry_Free(NCFormat_GetRowIndexOfNonZeroValue(*a)) ;
+  Mry_Free(NCFormat_GetNonZeroValue(*a)) ;
+  Mry_Free(*a) ;
   *a = NULL ;
 }
 
@@ -265,6 +276,55 @@ void NCFormat_AssembleElementMatrix(NCFormat_t* a,double* ke,int* cole,int* lige
 
 
 
+void NCFormat_ComputeScatterMap(NCFormat_t* a,int* map,int* cole,int* lige,int n,int* rowptr,int n_row)
+/** Compute the offsets in nzval where the entries of an element matrix ke
+ *  are to be assembled, i.e. nzval[map[i*n+j]] += ke[i*n+j] if map[i*n+j] >= 0.
+ *  The search in the row indices of a column is thus done only once.
+ *  The entries flagged by map[i*n+j] < 0 on input (structural zeros not
+ *  stored) are skipped. */
+{
+#define MAP(i,j) (map[(i)*n+(j)])
+  int*    colptr = NCFormat_GetFirstNonZeroValueIndexOfColumn(a) ;
+  int*    rowind = NCFormat_GetRowIndexOfNonZeroValue(a) ;
+  int    je,i ;
+
+  for(i = 0 ; i < n_row ; i++) rowptr[i] = -1 ;
+  
+  for(je = 0 ; je < n ; je++) {
+    int jcol = cole[je] ;
+    int ie ;
+    
+    if(jcol < 0) {
+      for(ie = 0 ; ie < n ; ie++) MAP(ie,je) = -1 ;
+      continue ;
+    }
+
+    for(i = colptr[jcol] ; i < colptr[jcol+1] ; i++) rowptr[rowind[i]] = i ;
+
+    for(ie = 0 ; ie < n ; ie++) {
+      int irow = lige[ie] ;
+      
+      if(irow < 0 || MAP(ie,je) < 0) {
+        MAP(ie,je) = -1 ;
+        continue ;
+      }
+      
+      if(rowptr[irow] < 0) {
+        arret("NCFormat_ComputeScatterMap: assembling not possible") ;
+      }
+      
+      MAP(ie,je) = rowptr[irow] ;
+    }
+
+    for(i = colptr[jcol] ; i < colptr[jcol+1] ; i++) rowptr[rowind[i]] = -1 ;
+  }
+
+#undef MAP
+}
+
+
+
+
 void NCFormat_PrintMatrix(NCFormat_t* a,unsigned int n_col,const char* keyword)
 {
   double* nzval  = (double*) NCFormat_GetNonZeroValue(a) ;
@@ -7,6 +7,7 @@
 #include "Options.h"
 #include "Mesh.h"
 #include "Message.h"
+#include "Mry.h"
 
 #include "NCFormat.h"
 
@@ -25,7 +26,7 @@
 SuperLUFormat_t* SuperLUFormat_Create(Mesh_t* mesh)
 /* Create a matrix in SuperLUFormat format */
 {
-  SuperLUFormat_t* aslu = (SuperLUFormat_t*) malloc(sizeof(SuperLUFormat_t)) ;
+  SuperLUFormat_t* aslu = (SuperLUFormat_t*) Mry_NewIn(Matrix,SuperLUFormat_t) ;
 
   assert(aslu) ;
   
@@ -58,7 +59,7 @@ void SuperLUFormat_Delete(void* self)
   
   NCFormat_Delete(&asluNC) ;
   
-  free(*aslu) ;
+  Mry_Free(*aslu) ;
   *aslu = NULL ;
 }
 
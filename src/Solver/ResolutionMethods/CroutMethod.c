@@ -3,14 +3,34 @@
 #include <string.h>
 #include <assert.h>
 #include <math.h>
+#include <time.h>
 #include "CroutMethod.h"
 #include "Matrix.h"
 #include "Message.h"
+#include "Mry.h"
 #include "LDUSKLFormat.h"
 
 
 static int    ludcmp(LDUSKLFormat_t*,int) ;
 static void   lubksb(LDUSKLFormat_t*,double*,double*,int) ;
+static void   mlubksb(LDUSKLFormat_t*,double*,double*,int,int) ;
+static int    sludcmp(LDUSKLFormat_t*,int) ;
+static void   slubksb(LDUSKLFormat_t*,double*,double*,int) ;
+static void   matvec(LDUSKLFormat_t*,double*,double*,int) ;
+static double normmax(double*,int) ;
+
+
+
+/* Mixed precision resolution:
+ * the matrix is factorized in single precision and the solution is
+ * refined in double precision with the residu computed with the
+ * (unfactorized) matrix. The refinement is over when the correction
+ * is less than the tolerance relative to the solution. If it stalls,
+ * i.e. if the correction is not divided by at least 1/rate from one
+ * iteration to the next, the matrix is factorized in double precision. */
+#define CroutMethod_MaxNbOfRefinements     (10)
+#define CroutMethod_RefinementTolerance    (1.e-12)
+#define CroutMethod_RefinementRate         (0.5)
 
 
 
@@ -41,6 +61,151 @@ int   CroutMethod_Solve(Solver_t* solver)
 }
 
 
+int   CroutMethod_SolveMultiple(Solver_t* solver,int nrhs)
+/** Resolution of a.x_k = b_k for k = 0,...,nrhs-1 by Crout's method,
+ *  the r.h.s. (solutions) being stored one after the other in b (x) */
+{
+  Matrix_t* a = Solver_GetMatrix(solver) ;
+  double* b = Solver_GetRHS(solver) ;
+  double* x = Solver_GetSolution(solver) ;
+  int n = Solver_GetNbOfColumns(solver) ;
+  LDUSKLFormat_t* askl = (LDUSKLFormat_t*) Matrix_GetStorage(a) ;
+
+  if(Matrix_WasNotModified(a)) {
+    int i = ludcmp(askl,n) ;
+    
+    Matrix_SetToModifiedState(a) ;
+    
+    if(i < 0) return(i) ;
+  }
+  
+  mlubksb(askl,x,b,n,nrhs) ;
+  
+  return(0) ;
+}
+
+
+
+int   CroutMethod_SolveInMixedPrecision(Solver_t* solver)
+/** Resolution of a.x = b by Crout's method with a factorization in
+ *  single precision and an iterative refinement in double precision
+ *  (falling back to a factorization in double precision if needed) */
+{
+  Matrix_t* a = Solver_GetMatrix(solver) ;
+  double* b = Solver_GetRHS(solver) ;
+  double* x = Solver_GetSolution(solver) ;
+  int n = Solver_GetNbOfColumns(solver) ;
+  LDUSKLFormat_t* askl = (LDUSKLFormat_t*) Matrix_GetStorage(a) ;
+  
+  if(!LDUSKLFormat_GetSinglePrecisionValue(askl)) {
+    int nnz = LDUSKLFormat_GetNbOfNonZeroValues(askl) ;
+    
+    LDUSKLFormat_GetSinglePrecisionValue(askl) = (float*) Mry_NewIn(Matrix,float[nnz]) ;
+    LDUSKLFormat_GetWorkSpace(askl) = (double*) Mry_NewIn(Matrix,double[2*n]) ;
+  }
+  
+  /* The double precision matrix is kept for the refinement */
+  if(Matrix_WasNotModified(a)) {
+    clock_t start = clock() ;
+    int i = sludcmp(askl,n) ;
+    
+    Matrix_SetToModifiedState(a) ;
+    LDUSKLFormat_GetPrecision(askl) = 's' ;
+    LDUSKLFormat_GetNbOfSinglePrecisionFactorizations(askl) += 1 ;
+    LDUSKLFormat_GetSinglePrecisionTime(askl) += (double) (clock() - start)/CLOCKS_PER_SEC ;
+    
+    if(i < 0) goto fallback ;
+  }
+  
+  if(!LDUSKLFormat_IsFactorizedInSinglePrecision(askl)) {
+    lubksb(askl,x,b,n) ;
+    return(0) ;
+  }
+  
+  /* Iterative refinement */
+  {
+    clock_t start = clock() ;
+    double* r  = LDUSKLFormat_GetWorkSpace(askl) ;
+    double* dx = r + n ;
+    double dxnorm0 = 0 ;
+    int k ;
+    
+    slubksb(askl,x,b,n) ;
+    
+    for(k = 0 ; k < CroutMethod_MaxNbOfRefinements ; k++) {
+      double dxnorm ;
+      int i ;
+      
+      matvec(askl,x,r,n) ;
+      
+      for(i = 0 ; i < n ; i++) r[i] = b[i] - r[i] ;
+      
+      slubksb(askl,dx,r,n) ;
+      
+      for(i = 0 ; i < n ; i++) x[i] += dx[i] ;
+      
+      LDUSKLFormat_GetNbOfRefinements(askl) += 1 ;
+      
+      dxnorm = normmax(dx,n) ;
+      
+      if(dxnorm <= CroutMethod_RefinementTolerance*normmax(x,n)) {
+        LDUSKLFormat_GetRefinementTime(askl) += (double) (clock() - start)/CLOCKS_PER_SEC ;
+        return(0) ;
+      }
+      
+      if(k > 0 && dxnorm > CroutMethod_RefinementRate*dxnorm0) break ;
+      
+      dxnorm0 = dxnorm ;
+    }
+    
+    LDUSKLFormat_GetRefinementTime(askl) += (double) (clock() - start)/CLOCKS_PER_SEC ;
+  }
+  
+  /* The refinement stalls or the single precision factorization failed */
+  fallback :
+  {
+    clock_t start = clock() ;
+    int i = ludcmp(askl,n) ;
+    
+    LDUSKLFormat_GetPrecision(askl) = 'd' ;
+    LDUSKLFormat_GetNbOfDoublePrecisionFactorizations(askl) += 1 ;
+    LDUSKLFormat_GetDoublePrecisionTime(askl) += (double) (clock() - start)/CLOCKS_PER_SEC ;
+    
+    if(i < 0) return(i) ;
+  }
+  
+  lubksb(askl,x,b,n) ;
+  
+  return(0) ;
+}
+
+
+
+void  CroutMethod_PrintStatistics(Solver_t* solver)
+/** Print the statistics of the mixed precision resolution */
+{
+  Matrix_t* a = Solver_GetMatrix(solver) ;
+  LDUSKLFormat_t* askl = (LDUSKLFormat_t*) Matrix_GetStorage(a) ;
+  unsigned long nbsfact  = LDUSKLFormat_GetNbOfSinglePrecisionFactorizations(askl) ;
+  unsigned long nbdfact  = LDUSKLFormat_GetNbOfDoublePrecisionFactorizations(askl) ;
+  unsigned long nbrefine = LDUSKLFormat_GetNbOfRefinements(askl) ;
+  double stime = LDUSKLFormat_GetSinglePrecisionTime(askl) ;
+  double dtime = LDUSKLFormat_GetDoublePrecisionTime(askl) ;
+  double rtime = LDUSKLFormat_GetRefinementTime(askl) ;
+  int    n     = Solver_GetNbOfColumns(solver) ;
+  double nnz   = LDUSKLFormat_GetNbOfNonZeroValues(askl) ;
+  /* Estimated storage of the matrix with each path (MB), from the
+   * nb of stored values and not measured */
+  double dmem  = nnz*sizeof(double)/1.e6 ;
+  double smem  = dmem + (nnz*sizeof(float) + 2*n*sizeof(double))/1.e6 ;
+  
+  Message_Info("%lu single precision factorizations (%g s), %lu refinement iterations (%g s)\n",nbsfact,stime,nbrefine,rtime) ;
+  Message_Info("%lu fallbacks to double precision factorizations (%g s)\n",nbdfact,dtime) ;
+  Message_Info("estimated matrix storage %g MB (single precision path), %g MB (double precision path)\n",smem,dmem) ;
+}
+
+
+
 int ludcmp(LDUSKLFormat_t* a,int n)
 /**
  * Replace the given matrix a by the LDU decomposition (after NR).
@@ -188,6 +353,234 @@ void lubksb(LDUSKLFormat_t* a,double* x,double* b,int n)
 
 
 
+
+void mlubksb(LDUSKLFormat_t* a,double* x,double* b,int n,int nrhs)
+/* Solve a*x_k = b_k for nrhs r.h.s. stored one after the other in b.
+ * Here a is input as its LU decomposition determined by ludcmp.
+ * Each row of L and each column of U is loaded once for all the
+ * r.h.s., the backsubstitution being done column by column.
+ */
+{
+#define UpperColumn(j)      (LDUSKLFormat_GetUpperColumn(a,j))
+#define LowerRow(i)         (LDUSKLFormat_GetLowerRow(a,i))
+  double*  diag = LDUSKLFormat_GetDiagonal(a) ;
+  int    i ;
+  
+  if(x != b) {
+    for(i = 0 ; i < n*nrhs ; i++) x[i] = b[i] ;
+  }
+  
+  /* Forward substitution : y_i = b_i - sum_0^{i-1} L_ij * y_j */
+  for(i = 1 ; i < n ; i++) {
+    double* rowi = LowerRow(i) ;
+    int j1 = LDUSKLFormat_ColumnIndexStartingRow(a,i) ;
+    int k ;
+    
+    for(k = 0 ; k < nrhs ; k++) {
+      double* xk = x + k*n ;
+      double  yi = xk[i] ;
+      int j ;
+      
+      for(j = j1 ; j < i ; j++) {
+        yi -= rowi[j]*xk[j] ;
+      }
+      
+      xk[i] = yi ;
+    }
+  }
+  
+  /* Backsubstitution : x_j = y_j/D_jj then y_i -= U_ij * x_j for i < j */
+  for(i = n - 1 ; i >= 0 ; i--) {
+    double* coli = UpperColumn(i) ;
+    int i1 = LDUSKLFormat_RowIndexStartingColumn(a,i) ;
+    int k ;
+    
+    for(k = 0 ; k < nrhs ; k++) {
+      double* xk = x + k*n ;
+      double  xi = xk[i]/diag[i] ;
+      int j ;
+      
+      xk[i] = xi ;
+      
+      for(j = i1 ; j < i ; j++) {
+        xk[j] -= coli[j]*xi ;
+      }
+    }
+  }
+#undef UpperColumn
+#undef LowerRow
+}
+
+
+int sludcmp(LDUSKLFormat_t* a,int n)
+/** Same as ludcmp on a single precision copy of the matrix a,
+ *  a being unchanged. Return -1 if a pivot is zero. */
+{
+  double* d = LDUSKLFormat_GetDiagonal(a) ;
+  float* sd = LDUSKLFormat_GetSinglePrecisionValue(a) ;
+#define UpperColumn(j)      (sd + (LDUSKLFormat_GetPointerToUpperColumn(a)[j] - d) - (j))
+#define LowerRow(i)         (sd + (LDUSKLFormat_GetPointerToLowerRow(a)[i] - d) - (i))
+  float* diag = sd ;
+  int    j ;
+  
+  {
+    int nnz = LDUSKLFormat_GetNbOfNonZeroValues(a) ;
+    int k ;
+    
+    for(k = 0 ; k < nnz ; k++) sd[k] = (float) d[k] ;
+  }
+  
+  /* Loop on columns (Crout's algorithm) */
+  for(j = 0 ; j < n ; j++) {
+    float* colj = UpperColumn(j) ;
+    int i1 = (j > 0) ? LDUSKLFormat_RowIndexStartingColumn(a,j) : 0 ;
+    float dum ;
+    int i ;
+    
+    if(j > 0) {
+      for(i = i1 + 1 ; i < j ; i++) {
+        int j1 = LDUSKLFormat_ColumnIndexStartingRow(a,i) ;
+        int k1 = (i1 > j1) ? i1 : j1 ;
+        float* rowi = LowerRow(i) ;
+        int k ;
+        
+        for(k = k1 ; k < i ; k++) {
+          colj[i] -= rowi[k]*colj[k] ;
+        }
+      }
+      
+      {
+        int j1 = LDUSKLFormat_ColumnIndexStartingRow(a,j) ;
+        int k1 = (i1 > j1) ? i1 : j1 ;
+        float* rowj = LowerRow(j) ;
+        int k ;
+        
+        for(k = k1 ; k < j ; k++) {
+          diag[j] -= rowj[k]*colj[k] ;
+        }
+      }
+    }
+    
+    if(diag[j] == 0) return(-1) ;
+    
+    dum = 1.f/diag[j] ;
+    
+    for(i = j + 1 ; i < n ; i++) {
+      int j1 = LDUSKLFormat_ColumnIndexStartingRow(a,i) ;
+      
+      if(j1 <= j) {
+        int k1 = (i1 > j1) ? i1 : j1 ;
+        float* rowi = LowerRow(i) ;
+        int k ;
+      
+        for(k = k1 ; k < j ; k++) {
+          rowi[j] -= rowi[k]*colj[k] ;
+        }
+      
+        rowi[j] *= dum ;
+      }
+    }
+  }
+  
+  return(0) ;
+#undef UpperColumn
+#undef LowerRow
+}
+
+
+void slubksb(LDUSKLFormat_t* a,double* x,double* b,int n)
+/** Solve a*x = b with the single precision factorization of a
+ *  determined by sludcmp, the vectors being in double precision. */
+{
+  double* d = LDUSKLFormat_GetDiagonal(a) ;
+  float* sd = LDUSKLFormat_GetSinglePrecisionValue(a) ;
+#define UpperColumn(j)      (sd + (LDUSKLFormat_GetPointerToUpperColumn(a)[j] - d) - (j))
+#define LowerRow(i)         (sd + (LDUSKLFormat_GetPointerToLowerRow(a)[i] - d) - (i))
+  float* diag = sd ;
+  int    i ;
+  
+  if(x != b) {
+    for(i = 0 ; i < n ; i++) x[i] = b[i] ;
+  }
+  
+  /* Forward substitution */
+  for(i = 1 ; i < n ; i++) {
+    float* rowi = LowerRow(i) ;
+    int j1 = LDUSKLFormat_ColumnIndexStartingRow(a,i) ;
+    int j ;
+    
+    for(j = j1 ; j < i ; j++) {
+      x[i] -= rowi[j]*x[j] ;
+    }
+  }
+  
+  /* Backsubstitution */
+  for(i = n - 1 ; i >= 0 ; i--) {
+    int j ;
+    
+    for(j = i + 1 ; j < n ; j++) {
+      int i1 = LDUSKLFormat_RowIndexStartingColumn(a,j) ;
+      
+      if(i >= i1) {
+        float* colj = UpperColumn(j) ;
+      
+        x[i] -= colj[i]*x[j] ;
+      }
+    }
+    
+    x[i] /= diag[i] ;
+  }
+#undef UpperColumn
+#undef LowerRow
+}
+
+
+void matvec(LDUSKLFormat_t* a,double* x,double* y,int n)
+/** Compute y = a*x with the unfactorized matrix a */
+{
+#define UpperColumn(j)      (LDUSKLFormat_GetUpperColumn(a,j))
+#define LowerRow(i)         (LDUSKLFormat_GetLowerRow(a,i))
+  double*  diag = LDUSKLFormat_GetDiagonal(a) ;
+  int    i ;
+  
+  for(i = 0 ; i < n ; i++) {
+    double* rowi = LowerRow(i) ;
+    double* coli = UpperColumn(i) ;
+    /* The row i of the lower matrix and the column i of the upper matrix */
+    int j1 = LDUSKLFormat_ColumnIndexStartingRow(a,i) ;
+    int i1 = LDUSKLFormat_RowIndexStartingColumn(a,i) ;
+    double yi = diag[i]*x[i] ;
+    int j ;
+    
+    for(j = j1 ; j < i ; j++) {
+      yi += rowi[j]*x[j] ;
+    }
+    
+    y[i] = yi ;
+    
+    for(j = i1 ; j < i ; j++) {
+      y[j] += coli[j]*x[i] ;
+    }
+  }
+#undef UpperColumn
+#undef LowerRow
+}
+
+
+double normmax(double* x,int n)
+{
+  double norm = 0 ;
+  int i ;
+  
+  for(i = 0 ; i < n ; i++) {
+    if(fabs(x[i]) > norm) norm = fabs(x[i]) ;
+  }
+  
+  return(norm) ;
+}
+
+
+
 /* Not used */
 #ifdef NOTDEFINED
 
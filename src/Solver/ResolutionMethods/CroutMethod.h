@@ -5,5 +5,8 @@
 #include "Solver.h"
 
 extern int        CroutMethod_Solve(Solver_t*) ;
+extern int        CroutMethod_SolveMultiple(Solver_t*,int) ;
+extern int        CroutMethod_SolveInMixedPrecision(Solver_t*) ;
+extern void       CroutMethod_PrintStatistics(Solver_t*) ;
 
 #endif
@@ -29,6 +29,16 @@ int   MA38Method_Solve(Solver_t* solver)
 /** Solve a sparse unsymmetric system a.x = b 
  *  by a multifrontal approach through ma38 from HSL 
  */
+{
+  return(MA38Method_SolveMultiple(solver,1)) ;
+}
+
+
+
+int   MA38Method_SolveMultiple(Solver_t* solver,int nrhs)
+/** Solve a.x_k = b_k for k = 0,...,nrhs-1 with one factorization,
+ *  the r.h.s. (solutions) being stored one after the other in b (x)
+ */
 {
   Matrix_t* a = Solver_GetMatrix(solver) ;
   int     n = Solver_GetNbOfColumns(solver) ;
@@ -76,18 +86,21 @@ int   MA38Method_Solve(Solver_t* solver)
     }
   }
   
-  /* Solve a * x = b */
+  /* Solve a * x_k = b_k */
   {
     double* b = Solver_GetRHS(solver) ;
     double* x = Solver_GetSolution(solver) ;
     double* w = (double*) Matrix_GetWorkSpace(a) ;
     int job = 0 ;
     bool transc = false ;
+    int k ;
     
-    ma38cd_(&n,&job,&transc,&lvalue,&lindex,value,index,keep,b,x,w,cntl,icntl,info,rinfo) ;
+    for(k = 0 ; k < nrhs ; k++) {
+      ma38cd_(&n,&job,&transc,&lvalue,&lindex,value,index,keep,b + k*n,x + k*n,w,cntl,icntl,info,rinfo) ;
     
-    if(info[0] < 0) {
-      return(-1) ;
+      if(info[0] < 0) {
+        return(-1) ;
+      }
     }
   }
   
@@ -5,6 +5,7 @@
 #include "Solver.h"
 
 extern int        MA38Method_Solve(Solver_t*) ;
+extern int        MA38Method_SolveMultiple(Solver_t*,int) ;
 
 
 #if defined(__cplusplus)
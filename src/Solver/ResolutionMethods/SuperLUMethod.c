@@ -10,6 +10,7 @@
 
 #include "Solver.h"
 #include "Message.h"
+#include "Mry.h"
 #include "Matrix.h"
 
 #include "SuperLUMethod.h"
@@ -45,12 +46,12 @@ int   SuperLUMethod_Solve(Solver_t* solver)
   
   /* Allocate memory space for the permutations of rows and columns */
   if(!iresol) {
-    perm_r = (int*) malloc(n*sizeof(int)) ;
+    perm_r = (int*) Mry_NewIn(Factor,int[n]) ;
     //perm_r = (int*) a.work ;
     
     assert(perm_r) ;
     
-    perm_c = (int*) malloc(n*sizeof(int)) ;
+    perm_c = (int*) Mry_NewIn(Factor,int[n]) ;
     //perm_c = (int*) a.work + n ;
     
     assert(perm_c) ;
@@ -157,20 +158,20 @@ int   SuperLUMethod_Solve(Solver_t* solver)
   
     /* Allocate memory space for the static variables */
     if(!iresol) {
-      etree = (int*) malloc(n*sizeof(int)) ;
+      etree = (int*) Mry_NewIn(Factor,int[n]) ;
       
       assert(etree) ;
       
-      R = (double*) malloc(n*sizeof(double)) ;
+      R = (double*) Mry_NewIn(Factor,double[n]) ;
       
       assert(R) ;
       
-      C = (double*) malloc(n*sizeof(double)) ;
+      C = (double*) Mry_NewIn(Factor,double[n]) ;
       
       assert(C) ;
       
       if(lwork > 0) {
-        work = (double*) malloc(lwork*sizeof(double)) ;
+        work = (double*) Mry_NewIn(Factor,double[lwork]) ;
         
         assert(work) ;
       }
@@ -26,7 +26,7 @@
 
 Solver_t*  Solver_Create(Mesh_t* mesh,Options_t* options,const int n)
 {
-  Solver_t* solver = (Solver_t*) Mry_New(Solver_t) ;
+  Solver_t* solver = (Solver_t*) Mry_NewIn(Matrix,Solver_t) ;
   
   
   /*  Method */
@@ -37,12 +37,20 @@ Solver_t*  Solver_Create(Mesh_t* mesh,Options_t* options,const int n)
     
       Solver_GetResolutionMethod(solver) = ResolutionMethod_Type(CROUT) ;
       Solver_GetSolve(solver) = CroutMethod_Solve ;
+      Solver_GetSolveMultiple(solver) = CroutMethod_SolveMultiple ;
+      
+      if(Options_IsSinglePrecisionFactorization(options)) {
+        Solver_GetSolve(solver) = CroutMethod_SolveInMixedPrecision ;
+        Solver_GetSolveMultiple(solver) = NULL ;
+      }
     
     #ifdef SUPERLULIB
     } else if(!strcmp(method,"slu")) {
     
       Solver_GetResolutionMethod(solver) = ResolutionMethod_Type(SLU) ;
       Solver_GetSolve(solver) = SuperLUMethod_Solve ;
+      /* Not checked with several r.h.s. yet: one after the other */
+      Solver_GetSolveMultiple(solver) = NULL ;
     #endif
 
     #ifdef BLASLIB
@@ -50,6 +58,7 @@ Solver_t*  Solver_Create(Mesh_t* mesh,Options_t* options,const int n)
     
       Solver_GetResolutionMethod(solver) = ResolutionMethod_Type(MA38) ;
       Solver_GetSolve(solver) = MA38Method_Solve ;
+      Solver_GetSolveMultiple(solver) = MA38Method_SolveMultiple ;
     #endif
       
     } else {
@@ -80,7 +89,7 @@ Solver_t*  Solver_Create(Mesh_t* mesh,Options_t* options,const int n)
   /* Allocation of space for the right hand side */
   {
     int n_col = Solver_GetNbOfColumns(solver) ;
-    double* rhs = (double*) Mry_New(double[n*n_col]) ;
+    double* rhs = (double*) Mry_NewIn(Matrix,double[n*n_col]) ;
     
     Solver_GetRHS(solver) = rhs ;
   }
@@ -89,11 +98,13 @@ Solver_t*  Solver_Create(Mesh_t* mesh,Options_t* options,const int n)
   /* Allocation of space for the solution */
   {
     int n_col = Solver_GetNbOfColumns(solver) ;
-    double* sol = (double*) Mry_New(double[n*n_col]) ;
+    double* sol = (double*) Mry_NewIn(Matrix,double[n*n_col]) ;
     
     Solver_GetSolution(solver) = sol ;
   }
   
+  Solver_GetNbOfRHS(solver) = n ;
+  
   return(solver) ;
 }
 
@@ -107,9 +118,9 @@ void  Solver_Delete(void* self)
   Matrix_t* a = Solver_GetMatrix(solver) ;
   
   Matrix_Delete(&a) ;
-  free(Solver_GetRHS(solver)) ;
-  free(Solver_GetSolution(solver)) ;
-  free(solver) ;
+  Mry_Free(Solver_GetRHS(solver)) ;
+  Mry_Free(Solver_GetSolution(solver)) ;
+  Mry_Free(solver) ;
   *psolver = NULL ;
 }
 
@@ -145,3 +156,49 @@ void Solver_Print(Solver_t* solver,char* keyword)
 
 }
 
+
+
+void Solver_PrintStatistics(Solver_t* solver)
+/** Print the statistics of the resolution method if any */
+{
+  if(Solver_GetSolve(solver) == CroutMethod_SolveInMixedPrecision) {
+    CroutMethod_PrintStatistics(solver) ;
+  }
+}
+
+
+
+int Solver_SolveMultiple(Solver_t* solver,const int nrhs)
+/** Solve a.x_k = b_k for k = 0,...,nrhs-1 with the same matrix,
+ *  the r.h.s. b_k (solutions x_k) being stored one after the other
+ *  in Solver_GetRHS (Solver_GetSolution).
+ *  Return 0 if succeeded, a negative value otherwise. */
+{
+  if(nrhs > (int) Solver_GetNbOfRHS(solver)) {
+    arret("Solver_SolveMultiple: too many r.h.s. (%d > %d)",nrhs,Solver_GetNbOfRHS(solver)) ;
+  }
+  
+  if(Solver_GetSolveMultiple(solver)) {
+    return(Solver_GetSolveMultiple(solver)(solver,nrhs)) ;
+  }
+  
+  /* One r.h.s. after the other */
+  {
+    double* b = Solver_GetRHS(solver) ;
+    double* x = Solver_GetSolution(solver) ;
+    int n = Solver_GetNbOfColumns(solver) ;
+    int i = 0 ;
+    int k ;
+    
+    for(k = 0 ; k < nrhs && i == 0 ; k++) {
+      Solver_GetRHS(solver) = b + k*n ;
+      Solver_GetSolution(solver) = x + k*n ;
+      i = Solver_Solve(solver) ;
+    }
+    
+    Solver_GetRHS(solver) = b ;
+    Solver_GetSolution(solver) = x ;
+    
+    return(i) ;
+  }
+}
@@ -13,6 +13,8 @@ struct Solver_s       ; typedef struct Solver_s       Solver_t ;
 extern Solver_t*  (Solver_Create)(Mesh_t*,Options_t*,const int) ;
 extern void       (Solver_Delete)(void*) ;
 extern void       (Solver_Print)(Solver_t*,char*) ;
+extern void       (Solver_PrintStatistics)(Solver_t*) ;
+extern int        (Solver_SolveMultiple)(Solver_t*,const int) ;
 
 
 #define Solver_GetResolutionMethod(SV)  ((SV)->mth)
@@ -22,6 +24,8 @@ extern void       (Solver_Print)(Solver_t*,char*) ;
 #define Solver_GetRHS(SV)               ((SV)->b)
 #define Solver_GetSolution(SV)          ((SV)->x)
 #define Solver_GetSolve(SV)             ((SV)->solve)
+#define Solver_GetSolveMultiple(SV)     ((SV)->solvemultiple)
+#define Solver_GetNbOfRHS(SV)           ((SV)->nrhs)
 
 
 
@@ -30,9 +34,15 @@ extern void       (Solver_Print)(Solver_t*,char*) ;
         (Solver_GetSolve(SV)(SV))
 
 
+/* Only Crout's method keeps the factorized matrix between two solves */
+#define Solver_KeepsFactorization(SV) \
+        ResolutionMethod_Is(Solver_GetResolutionMethod(SV),CROUT)
+
+
 
 /*  Typedef names of Methods */
 typedef int  Solver_Solve_t(Solver_t*) ;
+typedef int  Solver_SolveMultiple_t(Solver_t*,int) ;
 
 
 
@@ -42,8 +52,10 @@ typedef int  Solver_Solve_t(Solver_t*) ;
 /* complete the structure types by using the typedef */
 struct Solver_s {             /* System solver */
   Solver_Solve_t* solve ;
+  Solver_SolveMultiple_t* solvemultiple ; /* Several r.h.s. (NULL = one after the other) */
   ResolutionMethod_t mth ;    /* Method */
   unsigned int    n ;         /* Nb of rows/columns */
+  unsigned int    nrhs ;      /* Nb of r.h.s. allocated */
   Matrix_t* a ;               /* Matrix */
   double* b ;                 /* RHS */
   double* x ;                 /* Solution */
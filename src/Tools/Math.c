@@ -22,7 +22,12 @@ static Math_t* (Math_Create)(void) ;
 
 Math_t* (Math_GetInstance)(void)
 {
-  GenericData_t* gdat = Session_FindGenericData(Math_t,"Math") ;
+  static const char* handle = NULL ;
+  GenericData_t* gdat ;
+  
+  if(!handle) handle = GenericData_InternName("Math") ;
+  
+  gdat = Session_FindGenericDataWithHandle(Math_t,handle) ;
   
   if(!gdat) {
     Math_t* math = Math_Create() ;
@@ -31,7 +36,7 @@ Math_t* (Math_GetInstance)(void)
     
     Session_AddGenericData(gdat) ;
     
-    assert(gdat == Session_FindGenericData(Math_t,"Math")) ;
+    assert(gdat == Session_FindGenericDataWithHandle(Math_t,handle)) ;
   }
   
   {